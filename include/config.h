@@ -32,14 +32,26 @@
 // --- DISPLAY HARDWARE CONFIGURATION ---
 
 // LED matrix panel specifications
-#define MATRIX_WIDTH 64                     // Panel width in pixels
-#define MATRIX_HEIGHT 64                    // Panel height in pixels
-#define MATRIX_CHAIN 1                      // Number of chained panels
-#define MATRIX_COLOR_DEPTH 6                // Color depth in bits (affects color quality vs performance)
-#define MATRIX_X_OFFSET 1                   // Global X-axis coordinate correction offset
-
-// Global X-axis coordinate correction offset by MATRIX_X_OFFSET
-inline int setPhysicalX(int logicalX) { int physicalX = (logicalX + MATRIX_X_OFFSET) % MATRIX_WIDTH;  return physicalX; }
+#define MATRIX_WIDTH 64                     // Width of one panel in pixels
+#define MATRIX_HEIGHT 64                    // Height of one panel in pixels
+
+// Default panel layout, overridden by "panelRows", "panelCols" and "panelChainType" in config.json.
+// Modes query the resulting size with width() / height() on the MatrixDisplay.
+#define MATRIX_PANEL_ROWS 1                 // Rows of panels in the wall
+#define MATRIX_PANEL_COLS 1                 // Columns of panels in the wall
+#define MATRIX_CHAIN_TYPE CHAIN_NONE        // Cable routing through the panels (PANEL_CHAIN_TYPE), e.g. CHAIN_TOP_LEFT_DOWN for 2x2
+#define MATRIX_MAX_PANELS 8                 // Upper limit for panelRows * panelCols
+#define MATRIX_COLOR_DEPTH 6                // Color depth in bits, used until the timing tuner has run
+#define MATRIX_DITHER_FRAMES 4              // Dither below MATRIX_COLOR_DEPTH: 0=off, 1=ordered, 2/4=temporal frames
+#define MATRIX_X_OFFSET 1                   // Column correction within each panel, applied by MatrixDisplay
+
+// Display timing tuner (tuneDisplayTiming() in main.cpp). Runs when config.json has no
+// "displayClockHz" (or it is 0) and stores clock, colour depth and min refresh rate there.
+#define DISPLAY_TARGET_REFRESH_HZ 120       // Refresh rate the tuned configuration must exceed
+#define DISPLAY_TUNE_MIN_DEPTH 4            // Colour depth search range
+#define DISPLAY_TUNE_MAX_DEPTH 8
+#define DISPLAY_TUNE_MAX_CLOCK_HZ 16000000  // Highest output clock to consider (20MHz is prone to noise)
+#define DISPLAY_TUNE_MAX_DMA_KB 128         // DMA memory budget: frame buffers + descriptors
 
 // ESP32-S3 MatrixPortal HUB75 interface pin assignments
 #define R1_PIN 42                           // Red channel 1 data pin
@@ -66,6 +78,21 @@ inline int setPhysicalX(int logicalX) { int physicalX = (logicalX + MATRIX_X_OFF
 
 // Display buffer configuration
 #define FORCE_SINGLE_BUFFER false           // Use double buffering for smoother display
+#define DISPLAY_FLIP_TIMEOUT_MS 50          // Max wait in displayShow() for the DMA to start scanning the new buffer
+
+// Pattern rendering on both cores (see RowJobs)
+#define ROW_JOBS_ENABLE true                // Render row-parallel patterns with a worker on the second core
+#define ROW_JOBS_BAND_ROWS 4                // Rows handed to a core at a time
+#define PATTERN_UPLOAD_CHECK true           // Log a pattern that calls ShowFrame() itself (ModePattern uploads once per frame)
+#define PATTERN_TRANSITION_MS 800           // Length of the transition between two patterns (0 = cut instantly)
+#define PATTERN_TRANSITION_STYLE TRANSITION_CROSSFADE // TRANSITION_CROSSFADE, TRANSITION_WIPE or TRANSITION_DISSOLVE
+
+// Memory telemetry (see Telemetry)
+#define TELEMETRY_SAMPLE_MS (60 * 1000UL)   // Interval between memory samples kept in the history
+#define TELEMETRY_HISTORY 64                // Samples kept for the SysInfo graphs (one per column)
+#define TELEMETRY_PERF_MS 1000              // Interval between performance samples (one PERF page column each)
+#define TELEMETRY_REPORT_MS (5 * 60 * 1000UL) // Interval between MQTT reports (0 = never publish)
+#define TELEMETRY_TOPIC_SUFFIX "/telemetry" // Reports go to g_mqttTopic + this suffix
 
 // Sandbox simulation settings
 #define INDEPENDENT_SANDBOX_ENABLE false    // Enable independent physics simulation mode
@@ -91,6 +118,15 @@ inline int setPhysicalX(int logicalX) { int physicalX = (logicalX + MATRIX_X_OFF
 #define BUZZER_PIN 10                       // Audio feedback buzzer pin
 #define IR_RECEIVER_PIN 11                  // Infrared signal receiver pin
 
+// Button input timing (interrupt-driven, see InputManager)
+#define BUTTON_DEBOUNCE_MS 30               // Minimum stable time before an edge is accepted
+#define BUTTON_LONG_PRESS_MS 800            // Hold time before a long press is reported
+#define BUTTON_REPEAT_MS 400                // Auto-repeat interval while held after a long press
+#define INPUT_EDGE_QUEUE_SIZE 32            // Raw GPIO edges buffered between loop iterations (power of 2)
+#define INPUT_EVENT_QUEUE_SIZE 16           // Merged input events pending dispatch (power of 2)
+#define INPUT_MQTT_PAYLOAD_SIZE 256         // Bytes kept per queued MQTT payload (PubSubClient packet limit)
+#define INPUT_LOG_LATENCY 0                 // 1 = print every dispatched event's latency (debug, can block on UART)
+
 // Audio feedback settings
 #define DEFAULT_BUZZER_ENABLED true         // Enable audio feedback by default
 
@@ -106,7 +142,8 @@ struct IRCodeMapping {
 };
 
 // IR remote control button code definitions
-const IRCodeMapping IR_CODE_MAP[] = {
+// The index of an entry is its IRKey (below); IRManager compiles this into a 256-entry code -> key table
+constexpr IRCodeMapping IR_CODE_MAP[] = {
     {0x00, "POWER"},                        // Power/standby button
     {0x01, "UP"},                           // Up navigation
     {0x02, "LIGHT"},                        // Light/brightness control
@@ -131,7 +168,23 @@ const IRCodeMapping IR_CODE_MAP[] = {
 };
 
 // Total number of defined IR codes
-const size_t IR_CODE_MAP_SIZE = sizeof(IR_CODE_MAP) / sizeof(IRCodeMapping);
+constexpr size_t IR_CODE_MAP_SIZE = sizeof(IR_CODE_MAP) / sizeof(IRCodeMapping);
+
+/**
+ * @brief Logical remote keys, in IR_CODE_MAP order
+ * 
+ * Input dispatch works on keys rather than raw codes, so a learned code can be
+ * remapped onto a key at runtime (IRManager::remapKey()) without touching the
+ * per-mode action tables.
+ */
+enum IRKey : uint8_t {
+    IR_KEY_POWER, IR_KEY_UP, IR_KEY_LIGHT, IR_KEY_LEFT, IR_KEY_SOUND, IR_KEY_RIGHT,
+    IR_KEY_UNDO, IR_KEY_DOWN, IR_KEY_REDO, IR_KEY_PLUS, IR_KEY_0, IR_KEY_MINUS,
+    IR_KEY_1, IR_KEY_2, IR_KEY_3, IR_KEY_4, IR_KEY_5, IR_KEY_6, IR_KEY_7, IR_KEY_8, IR_KEY_9,
+    IR_KEY_COUNT,
+    IR_KEY_NONE = 0xFF                      // Code not mapped to any key
+};
+static_assert(IR_CODE_MAP_SIZE == IR_KEY_COUNT, "IRKey must list every IR_CODE_MAP entry");
 
 // IR command code definitions for programmatic access
 #define IR_POWER    0x00                    // Power button code
@@ -27,10 +27,12 @@ private:
     
     // Display and utility pointers
     Utils* m_utils;
-    MatrixPanel_I2S_DMA* m_matrix;
+    MatrixDisplay* m_matrix;
 
     // Frame buffer for robust GIF rendering
     uint8_t *pFrameBuffer;
+    int16_t fbWidth;            // Frame buffer size, taken from the display at begin()
+    int16_t fbHeight;
     uint16_t currentPalette[256];
     uint8_t gifBackgroundIndex; // Store the GIF's background color index
     
@@ -80,7 +82,7 @@ public:
     GifPlayer();
     ~GifPlayer();
     
-    bool begin(Utils* utils, MatrixPanel_I2S_DMA* matrix);
+    bool begin(Utils* utils, MatrixDisplay* matrix);
     void end();
     
     // Playback control
@@ -0,0 +1,194 @@
+/**
+ * @file input_manager.h
+ * @brief Unified, timestamped input event stream for buttons, IR and MQTT
+ *
+ * The InputManager replaces loop-polled button handling with GPIO interrupts.
+ * Each button edge is timestamped in the ISR and pushed into a small spinlock-guarded
+ * ring; the debounce / long-press / repeat state machine runs when that ring is
+ * drained from the main loop. Because edges are captured by hardware, presses
+ * are no longer lost while a mode blocks (MQTT message delays, the Yahboom IR
+ * busy-wait, mode previews, ...).
+ *
+ * Decoded IR commands and received MQTT payloads are posted into the same
+ * event queue, so main.cpp consumes a single ordered stream of InputEvent
+ * records. Every event carries the microsecond timestamp of its physical
+ * origin, which allows per-source input latency to be measured at dispatch.
+ */
+
+#ifndef INPUT_MANAGER_H
+#define INPUT_MANAGER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * @brief Origin of an input event
+ */
+enum class InputSource : uint8_t {
+    BUTTON,         // Physical GPIO buttons (UP/DOWN)
+    IR,             // Decoded IR remote command
+    MQTT,           // MQTT JSON payload
+    SOURCE_COUNT
+};
+
+/**
+ * @brief Kind of input event
+ *
+ * Button events go through the debounce state machine and may produce
+ * PRESS, LONG_PRESS, REPEAT and RELEASE. IR and MQTT events are always PRESS.
+ */
+enum class InputEventType : uint8_t {
+    PRESS,          // Debounced press (or a single IR / MQTT message)
+    LONG_PRESS,     // Button held for BUTTON_LONG_PRESS_MS
+    REPEAT,         // Auto-repeat while held after a long press
+    RELEASE         // Debounced release
+};
+
+/**
+ * @brief Logical button identifiers carried in InputEvent::code for BUTTON events
+ */
+enum InputButton : uint8_t {
+    INPUT_BUTTON_UP = 0,
+    INPUT_BUTTON_DOWN,
+    INPUT_BUTTON_COUNT
+};
+
+/**
+ * @brief Single entry of the merged input stream
+ */
+struct InputEvent {
+    InputSource source;     // Where the event came from
+    InputEventType type;    // Press / long press / repeat / release
+    uint32_t code;          // InputButton, IR command byte or MQTT payload slot
+    uint32_t timestamp_us;  // micros() of the physical edge / reception
+};
+
+/**
+ * @brief Latency statistics for one input source (microseconds)
+ */
+struct InputLatencyStats {
+    uint32_t count;         // Number of dispatched events
+    uint32_t last_us;       // Latency of the most recent event
+    uint32_t max_us;        // Worst latency seen since last reset
+    uint64_t total_us;      // Sum of latencies (for the mean)
+    uint32_t dropped;       // Events lost because a queue was full
+};
+
+class InputManager {
+public:
+    InputManager();
+
+    /**
+     * @doc Attaches CHANGE interrupts to the UP/DOWN button pins.
+     *
+     * Pins must already be configured as INPUT_PULLUP (done in Utils::setup()).
+     */
+    void setup();
+
+    /**
+     * @doc Drains the ISR edge ring and advances the button state machines.
+     *
+     * Generates PRESS / LONG_PRESS / REPEAT / RELEASE events into the merged
+     * queue. Cheap enough to call every loop iteration.
+     */
+    void update();
+
+    /**
+     * @doc Posts a decoded IR command into the event stream.
+     *
+     * @param command IR command byte
+     * @param timestamp_us micros() when the command finished decoding
+     */
+    void postIRCommand(uint32_t command, uint32_t timestamp_us);
+
+    /**
+     * @doc Copies an MQTT payload into a slot and posts it into the event stream.
+     * The message is dropped (and counted) when every slot still holds a payload
+     * that is pending or being dispatched.
+     *
+     * @param payload Raw payload bytes (not null-terminated)
+     * @param length Payload length; truncated to INPUT_MQTT_PAYLOAD_SIZE - 1
+     */
+    void postMqttMessage(const uint8_t* payload, unsigned int length);
+
+    /**
+     * @doc Pops the oldest pending event.
+     *
+     * @param event Filled with the event when one is available
+     * @return true if an event was returned
+     */
+    bool poll(InputEvent& event);
+
+    /**
+     * @doc Returns the payload for an MQTT event (valid until the next poll()).
+     */
+    const char* getMqttPayload(const InputEvent& event) const;
+
+    /**
+     * @doc Records dispatch completion for an event and updates latency stats.
+     */
+    void recordLatency(const InputEvent& event);
+
+    const InputLatencyStats& getLatencyStats(InputSource source) const {
+        return latencyStats[(uint8_t)source];
+    }
+    void resetLatencyStats();
+    void printLatencyStats() const;
+
+    bool isButtonHeld(InputButton button) const { return buttons[button].pressed; }
+
+private:
+    // Raw edge captured in ISR context
+    struct Edge {
+        uint8_t button;
+        uint8_t level;          // Raw pin level after the edge (LOW = pressed)
+        uint32_t timestamp_us;
+    };
+
+    // Per-button debounce / long-press / repeat state
+    struct ButtonState {
+        uint8_t pin;
+        bool pressed;               // Debounced state
+        bool candidatePending;      // Edges seen that have not yet been stable for BUTTON_DEBOUNCE_MS
+        bool candidatePressed;      // Level after the most recent pending edge
+        uint32_t burstStart_us;     // First edge of the pending bounce burst (event timestamp)
+        uint32_t lastEdge_us;       // Most recent edge of the burst (stability reference)
+        uint32_t pressTime_us;      // Debounced press start
+        uint32_t nextRepeat_us;     // Next LONG_PRESS / REPEAT deadline while held
+        bool longPressSent;
+    };
+
+    static void onButtonUpEdge();      // ISR (IRAM)
+    static void onButtonDownEdge();    // ISR (IRAM)
+    static void pushEdge(uint8_t button, uint8_t pin);
+
+    void processEdge(const Edge& edge);
+    void commitCandidate(uint8_t button);
+    bool pushEvent(InputSource source, InputEventType type, uint32_t code, uint32_t timestamp_us);
+
+    // ISR -> loop edge ring, guarded by s_edgeMux
+    static InputManager* s_instance;
+    static portMUX_TYPE s_edgeMux;
+    volatile uint16_t edgeHead;
+    volatile uint16_t edgeTail;
+    volatile uint32_t edgesDropped;
+    Edge edges[INPUT_EDGE_QUEUE_SIZE];
+
+    ButtonState buttons[INPUT_BUTTON_COUNT];
+
+    // Merged event queue (loop context only)
+    uint8_t eventHead;
+    uint8_t eventTail;
+    InputEvent events[INPUT_EVENT_QUEUE_SIZE];
+
+    // MQTT payload slots referenced by InputEvent::code, handed out round-robin. Queued
+    // MQTT events hold consecutive slots, plus the one poll() last returned
+    static const uint8_t MQTT_SLOTS = 4;
+    uint8_t nextMqttSlot;
+    uint8_t mqttPending;        // MQTT events queued and not yet polled
+    char mqttPayloads[MQTT_SLOTS][INPUT_MQTT_PAYLOAD_SIZE];
+
+    InputLatencyStats latencyStats[(uint8_t)InputSource::SOURCE_COUNT];
+};
+
+#endif // INPUT_MANAGER_H
@@ -0,0 +1,63 @@
+/**
+ * @file ir_keymap.h
+ * @brief Per-mode IR remote action tables
+ *
+ * handleIRCommand() used to be one switch over raw codes with a nested chain of
+ * currentMode checks for LEFT / RIGHT. Dispatch is now two array lookups:
+ *
+ *   IRManager::keyForCode(code)  256-entry code -> IRKey table, compiled from
+ *                                IR_CODE_MAP and remappable at runtime
+ *   IRKeymap::action(mode, key)  [mode][key] -> action function
+ *
+ * Each mode registers a short list of bindings for the keys it handles itself.
+ * Global bindings (mode selection, POWER, SOUND, ...) are registered first and
+ * fill every key a mode leaves unbound, so no fallback search is needed at
+ * dispatch time.
+ */
+
+#ifndef IR_KEYMAP_H
+#define IR_KEYMAP_H
+
+#include <Arduino.h>
+#include "config.h"
+
+typedef void (*IRAction)();
+
+/**
+ * @brief One key -> action entry of a mode's table
+ */
+struct IRBinding {
+    IRKey key;
+    IRAction action;
+};
+
+class IRKeymap {
+public:
+    IRKeymap();
+
+    /**
+     * @doc Binds keys in every mode. Call before setMode().
+     */
+    void setGlobal(const IRBinding* bindings, size_t count);
+
+    /**
+     * @doc Binds keys for one mode; keys it does not bind keep the global action.
+     */
+    void setMode(DisplayMode mode, const IRBinding* bindings, size_t count);
+
+    template <size_t N>
+    void setGlobal(const IRBinding (&bindings)[N]) { setGlobal(bindings, N); }
+    template <size_t N>
+    void setMode(DisplayMode mode, const IRBinding (&bindings)[N]) { setMode(mode, bindings, N); }
+
+    // Action for a key in a mode, nullptr when the key does nothing there
+    IRAction action(DisplayMode mode, IRKey key) const {
+        return (unsigned)mode < MODE_ENUM_COUNT && key < IR_KEY_COUNT ? m_actions[mode][key] : nullptr;
+    }
+
+private:
+    // Row 0 holds the global bindings (DisplayMode starts at 1)
+    IRAction m_actions[MODE_ENUM_COUNT][IR_KEY_COUNT];
+};
+
+#endif // IR_KEYMAP_H
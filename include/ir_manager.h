@@ -34,6 +34,7 @@ public:
     void updateReadNonBlocking(); // Primarily for NEC_NON_BLOCKING mode
     bool hasNewCommand();
     uint32_t getLastCommand();
+    uint32_t getLastCommandTime() const { return lastCommandTime_us; } // micros() when the last command was decoded
     void clearCommand();
 
     // Mode selection
@@ -51,9 +52,16 @@ public:
     void printCodeMappings() const;
     void resetToDefaults();
 
+    // Code -> key table, one array lookup (IR_KEY_NONE for codes no key uses)
+    IRKey keyForCode(uint32_t code) const { return (IRKey)keyOfCode[code & 0xFF]; }
+    // Moves a key to a new code; the key's old code and any key that had the new code become unmapped
+    void remapKey(IRKey key, uint8_t code);
+    // Key with this IR_CODE_MAP name (case-insensitive), for the learning console; IR_KEY_NONE if none
+    IRKey keyForName(const char* buttonName) const;
+
     // Button checking (primarily for NEC mode or after a raw code is processed)
-    bool isButtonPressed(const char* buttonName);
-    uint32_t getButtonCode(const char* buttonName);
+    bool isButtonPressed(IRKey key) const;
+    uint32_t getButtonCode(IRKey key) const;
 
     // Sound feedback control
     void enableSoundFeedback(bool enable = true);
@@ -64,6 +72,7 @@ private:
 
     uint32_t lastCommand;
     unsigned long lastReceiveTime;
+    uint32_t lastCommandTime_us;
     bool newCommandAvailable;
     bool scanMode;
     bool soundFeedbackEnabled;
@@ -112,10 +121,11 @@ private:
     static const int RAW_DELAY_MICROSECONDS = 30;    // From old Utils::readIRCode
 
     static const int NUM_BUTTONS = IR_CODE_MAP_SIZE;
-    IRCodeMapping buttonMappings[NUM_BUTTONS];
+    IRCodeMapping buttonMappings[NUM_BUTTONS];  // Indexed by IRKey: current code and name of each key
+    uint8_t keyOfCode[256];                     // IRKey for each command byte, IR_DEFAULT_KEYMAP at reset
 
     int findButtonIndex(const char* buttonName) const;
-    int findButtonIndexByCode(uint32_t code);
+    int findButtonIndexByCode(uint32_t code) const;
 };
 
 #endif
\ No newline at end of file
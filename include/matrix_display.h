@@ -0,0 +1,68 @@
+/**
+ * @file matrix_display.h
+ * @brief Display surface for one panel or a wall of chained HUB75 panels
+ *
+ * All modes draw through a MatrixDisplay instead of the HUB75 driver. It is a
+ * VirtualMatrixPanel_T with the chain layout chosen at runtime (panel rows,
+ * columns and cable routing come from config.json), so width() / height()
+ * report the size of the whole wall and every drawing call is remapped onto
+ * the single DMA chain.
+ *
+ * The chain mapping is precomputed by VirtualMatrixPanel_T's remap table (runs of
+ * contiguous electrical pixels per virtual row), and the per-panel column offset
+ * (MATRIX_X_OFFSET, previously applied by hand with setPhysicalX() at each call
+ * site) is precomputed per virtual column here, so neither costs a division per
+ * pixel. Horizontal spans and fillRect() are written as whole DMA lines.
+ */
+
+#ifndef MATRIX_DISPLAY_H
+#define MATRIX_DISPLAY_H
+
+#include <Arduino.h>
+#include <ESP32-HUB75-MatrixPanel-I2S-DMA.h>
+#include <ESP32-HUB75-VirtualMatrixPanel_T.hpp>
+#include "config.h"
+
+class MatrixDisplay : public VirtualMatrixPanel_T<CHAIN_RUNTIME> {
+public:
+    /**
+     * @param driver     Initialised HUB75 driver, chain_length must be panelRows * panelCols
+     * @param panelRows  Number of panel rows in the wall
+     * @param panelCols  Number of panel columns in the wall
+     * @param chainType  How the cable runs through the panels (CHAIN_NONE for a single row of panels)
+     * @param xOffset    Column correction applied within every panel (MATRIX_X_OFFSET)
+     */
+    MatrixDisplay(MatrixPanel_I2S_DMA* driver, uint8_t panelRows, uint8_t panelCols,
+                  PANEL_CHAIN_TYPE chainType, int xOffset = MATRIX_X_OFFSET);
+    ~MatrixDisplay();
+
+    // Drawing: applies the panel column offset, then the chain mapping
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+    void drawPixelRGB888(int16_t x, int16_t y, uint8_t r, uint8_t g, uint8_t b);
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+
+    /**
+     * @brief Shifts the region (x, y, w, h) one column to the left in the back buffer.
+     *        The rightmost column keeps its old content for the caller to draw over.
+     *        Moves colour bits in the DMA frame, so scrolling a graph costs a few
+     *        word copies per pixel instead of a redraw of everything in it.
+     */
+    void scrollLeft(int16_t x, int16_t y, int16_t w, int16_t h);
+
+    // Pass-throughs to the HUB75 driver
+    MatrixPanel_I2S_DMA* driver() const { return m_driver; }
+    void setBrightness8(uint8_t brightness) { m_driver->setBrightness8(brightness); }
+    bool waitForFlip(uint32_t timeoutMs) { return m_driver->waitForFlip(timeoutMs); }
+
+    uint8_t panelRows() const { return m_panelRows; }
+    uint8_t panelCols() const { return m_panelCols; }
+
+private:
+    MatrixPanel_I2S_DMA* m_driver;
+    uint8_t m_panelRows;
+    uint8_t m_panelCols;
+    uint16_t m_columns;      // Virtual width (entries in m_columnLut)
+    uint16_t* m_columnLut;   // Virtual x -> x with the per-panel column offset applied
+};
+
+#endif // MATRIX_DISPLAY_H
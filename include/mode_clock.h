@@ -16,7 +16,7 @@
 
 // Forward declarations to avoid circular dependencies
 class Utils;
-class MatrixPanel_I2S_DMA;
+class MatrixDisplay;
 
 /**
  * @brief Digital clock display mode implementation
@@ -41,7 +41,7 @@ public:
      * @param utils_ptr Pointer to utilities object for display helpers
      * @param matrix_ptr Pointer to LED matrix display driver
      */
-    void setup(Utils* utils_ptr, MatrixPanel_I2S_DMA* matrix_ptr);
+    void setup(Utils* utils_ptr, MatrixDisplay* matrix_ptr);
     
     /**
      * @doc Main execution loop for clock display updates.
@@ -63,7 +63,7 @@ public:
 private:
     // Core member variables
     Utils* m_utils;                         // Utilities object reference  
-    MatrixPanel_I2S_DMA* m_matrix;          // Display driver reference
+    MatrixDisplay* m_matrix;          // Display driver reference
     
     // Timing and synchronization state
     unsigned long lastUpdate;               // Last display update timestamp
@@ -8,11 +8,11 @@
 
 // Forward declarations
 class Utils;
-class MatrixPanel_I2S_DMA;
+class MatrixDisplay;
 
 class ModeCountdown {
 public:
-    void setup(Utils* utils_ptr, MatrixPanel_I2S_DMA* matrix_ptr);
+    void setup(Utils* utils_ptr, MatrixDisplay* matrix_ptr);
     void run();
     void cleanup();
     void drawSandClock();
@@ -27,7 +27,7 @@ public:
 
     private:
     Utils* m_utils;
-    MatrixPanel_I2S_DMA* m_matrix;
+    MatrixDisplay* m_matrix;
     unsigned long lastUpdate;
     unsigned long countdownStart;    // Add this line
     unsigned long countdownDuration; // Add this line
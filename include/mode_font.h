@@ -6,7 +6,7 @@
 
 // Forward declarations
 class Utils;
-class MatrixPanel_I2S_DMA;
+class MatrixDisplay;
 
 // Font sub-mode enumeration (기존 FontType을 활용)
 enum class FontModeType {
@@ -31,7 +31,7 @@ enum class FontModeType {
 
 class ModeFont {
 public:
-    void setup(Utils* utils_ptr, MatrixPanel_I2S_DMA* matrix_ptr);
+    void setup(Utils* utils_ptr, MatrixDisplay* matrix_ptr);
     void run();
     void cleanup();
     void activate(); // Called when the mode becomes active
@@ -41,7 +41,7 @@ public:
     
 private:
     Utils* m_utils;
-    MatrixPanel_I2S_DMA* m_matrix;
+    MatrixDisplay* m_matrix;
 
     const unsigned long INITIAL_DISPLAY_DELAY_MS = 3000; // 3 seconds
 
@@ -23,7 +23,7 @@ enum class GifContentType {
 class ModeGIF {
 private:
     Utils* m_utils;
-    MatrixPanel_I2S_DMA* m_matrix;
+    MatrixDisplay* m_matrix;
     
     bool autoMode;
     unsigned long lastAutoSwitch;
@@ -37,7 +37,7 @@ public:
     ~ModeGIF();
 
     // Basic mode structure functions
-    void setup(Utils* utils_ptr, MatrixPanel_I2S_DMA* matrix_ptr);
+    void setup(Utils* utils_ptr, MatrixDisplay* matrix_ptr);
     void activate();
     void run();
     void cleanup();
@@ -64,7 +64,7 @@ class ModeImage {
 private:
     // Core system references
     Utils* m_utils;                    // Utility functions and display management
-    MatrixPanel_I2S_DMA* m_matrix;     // LED matrix panel interface
+    MatrixDisplay* m_matrix;     // LED matrix panel interface
     PNG png;                           // PNG decoder instance
     
     // Image state management
@@ -77,6 +77,8 @@ private:
 
     // Image processing buffers and dimensions
     uint16_t* imageBuffer;            // RGB565 frame buffer for display
+    int16_t bufferWidth;              // imageBuffer size, taken from the display at setup
+    int16_t bufferHeight;
     uint16_t imageWidth;              // Original image width in pixels
     uint16_t imageHeight;             // Original image height in pixels
     uint16_t displayWidth;            // Scaled display width
@@ -126,7 +128,7 @@ public:
      * @param utils_ptr Pointer to utility functions
      * @param matrix_ptr Pointer to LED matrix interface
      */
-    void setup(Utils* utils_ptr, MatrixPanel_I2S_DMA* matrix_ptr);
+    void setup(Utils* utils_ptr, MatrixDisplay* matrix_ptr);
     
     /**
      * @brief Activate image mode and load initial content
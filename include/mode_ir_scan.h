@@ -3,7 +3,11 @@
 
 #include "utils.h"
 #include "ir_manager.h"
-#include <ESP32-HUB75-MatrixPanel-I2S-DMA.h>
+#include "matrix_display.h"
+
+#define IR_LEARN_MAX_KEYS 50                // Learned key slots
+#define IR_LEARN_TIMEOUT_MS (10 * 1000UL)   // Time to press the remote after a key name is entered
+#define IR_KEYS_FILE "/ir_keys.bin"         // Learned keys on LittleFS (binary table)
 
 /**
  * @brief Enumeration defining the different states of the IR learning process
@@ -40,6 +44,11 @@ struct LearnedKey {
  * This class provides functionality for learning IR remote control codes
  * and mapping them to human-readable key names. It supports both blocking
  * and non-blocking IR reception modes.
+ *
+ * Learning is a state machine advanced by run(): serial lines are read without
+ * blocking and decoded IR codes arrive from the main loop's input queue through
+ * handleIRCode(), so MQTT, WiFi, buttons and the idle timeout keep running while
+ * a key is learned. Learned keys are kept in IR_KEYS_FILE and reloaded on entry.
  */
 class ModeIRScan {
 public:
@@ -54,7 +63,16 @@ public:
      * @param matrix_ptr Pointer to LED matrix display instance
      * @param irManager_ptr Pointer to IR manager instance
      */
-    void setup(Utils* utils_ptr, MatrixPanel_I2S_DMA* matrix_ptr, IRManager* irManager_ptr);
+    void setup(Utils* utils_ptr, MatrixDisplay* matrix_ptr, IRManager* irManager_ptr);
+    
+    /**
+     * @brief Load IR_KEYS_FILE and remap the remote keys it names (UP, 1, ...) in the IR manager
+     * 
+     * Called once at boot, before the mode is first entered, so relearned keys
+     * work in every mode.
+     * @param irManager_ptr Pointer to IR manager instance
+     */
+    void applyLearnedKeys(IRManager* irManager_ptr);
     
     /**
      * @brief Main execution loop for IR scan mode
@@ -66,12 +84,20 @@ public:
      */
     void cleanup();
 
-private:
     /**
-     * @brief Internal loop that handles the learning process
+     * @brief Offer a decoded IR code from the input queue to the learning process
+     * @param code IR command byte
+     * @return true if the code was consumed, false if the main loop should handle it
      */
-    void runInternalLoop();
-    
+    bool handleIRCode(uint32_t code);
+
+    /**
+     * @brief Check if a learning operation (key name, scan, mode or overwrite prompt) is in progress
+     * @return true while the user is in the middle of learning
+     */
+    bool isLearning() const { return learningState != READY && learningState != EXIT_MODE; }
+
+private:
     /**
      * @brief Display usage instructions and available commands
      */
@@ -108,9 +134,19 @@ private:
     void handleDuplicateChoice(const String& input);
     
     /**
-     * @brief Main IR signal scanning and reception handler
+     * @brief Arm the IR receiver for the selected mode and start the scan timeout
+     */
+    void startIRScan();
+    
+    /**
+     * @brief Disarm the IR receiver and restore the receive mode active before the scan
      */
-    void handleIRScan();
+    void stopIRScan();
+    
+    /**
+     * @brief Return to key name input when no IR code arrived in time
+     */
+    void checkScanTimeout();
     
     /**
      * @brief Process received IR code and store or handle duplicates
@@ -168,6 +204,24 @@ private:
      */
     void clearKeys();
     
+    /**
+     * @brief Load learned keys from IR_KEYS_FILE
+     * @return true if the file existed and was valid
+     */
+    bool loadKeys();
+    
+    /**
+     * @brief Write learned keys to IR_KEYS_FILE
+     * @return true if the file was written
+     */
+    bool saveKeys();
+    
+    /**
+     * @brief Point the IR manager's remote key of the same name at a learned code
+     * @param index Learned key slot
+     */
+    void applyKey(int index);
+    
     /**
      * @brief Display appropriate input prompt based on current state
      */
@@ -190,16 +244,19 @@ private:
     
     // Core component references
     Utils* m_utils;                     // Pointer to utility functions instance
-    MatrixPanel_I2S_DMA* m_matrix;      // Pointer to LED matrix display instance
+    MatrixDisplay* m_matrix;      // Pointer to LED matrix display instance
     IRManager* m_irManager;             // Pointer to IR signal manager instance
     
     // Current operational state
     LearningState learningState;        // Current state in the learning process
     IRMode selectedMode;                // Currently selected IR reception mode
+    bool scanArmed;                     // startIRScan() switched the receiver, stopIRScan() not yet called
+    IRManager::IRReceiveMode previousReceiveMode; // Receive mode to restore when the scan ends
     bool isFirstRun;                    // Flag to track first execution of run()
+    LearningState displayedState;       // State currently shown on the matrix
     
     // IR key learning storage
-    LearnedKey keys[50];                // Array to store learned IR key mappings
+    LearnedKey keys[IR_LEARN_MAX_KEYS]; // Array to store learned IR key mappings
     char currentKeyName[32];            // Buffer for currently processing key name
     int totalLearnedKeys;               // Count of successfully learned keys
     uint32_t duplicateIRCode;           // Temporary storage for duplicate code confirmation
@@ -207,26 +264,19 @@ private:
     // Real-time input processing
     char inputBuffer[64];               // Buffer for accumulating user input
     int bufferIndex;                    // Current position in input buffer
+    bool lastWasCR;                     // Previous character was CR (skip the LF of CR+LF)
     
     /**
-     * @brief Handle real-time keyboard input with immediate echo
-     * @return true if complete input was processed, false otherwise
+     * @brief Read the serial characters already received, with immediate echo
+     * 
+     * Never waits for input. Stops after one complete line so a command is
+     * handled per run() call; the rest stays in the serial buffer.
+     * @return true if a complete line was processed, false otherwise
      */
     bool handleRealTimeInput();
     
-    /**
-     * @brief Enumeration for IR scan operation states
-     */
-    enum class ScanState {
-        WAITING_FOR_INPUT,              // Waiting for key name input from user
-        SCANNING_IR,                    // Actively scanning for IR signal
-        PROCESSING_RESULT               // Processing received IR signal result
-    };
-    
-    // IR scan timing and state management
-    ScanState scanState;                // Current state of IR scanning process
+    // IR scan timing
     unsigned long scanStartTime;        // Timestamp when IR scan was initiated
-    bool irScanInitiated;               // Flag indicating if IR scan has been started
 };
 
 #endif // MODE_IR_SCAN_H
\ No newline at end of file
@@ -6,11 +6,11 @@
 
 // Forward declarations
 class Utils;
-class MatrixPanel_I2S_DMA;
+class MatrixDisplay;
 
 class ModeMqtt {
 public:
-    void setup(Utils* utils_ptr, MatrixPanel_I2S_DMA* matrix_ptr);
+    void setup(Utils* utils_ptr, MatrixDisplay* matrix_ptr);
     void run();
     void cleanup();
     void displayMqttMessage(const char* stage_str, const char* code_str, const char* message_str = nullptr);
@@ -23,7 +23,7 @@ public:
 
 private:
     Utils* m_utils;
-    MatrixPanel_I2S_DMA* m_matrix;
+    MatrixDisplay* m_matrix;
     
     void standbyMqtt();
     // Helper method for stage mark
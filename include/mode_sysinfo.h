@@ -7,7 +7,8 @@
 
 // Forward declarations
 class Utils;
-class MatrixPanel_I2S_DMA;
+class MatrixDisplay;
+struct PerfSample;
 
 class ModeSysinfo {
 public:
@@ -15,12 +16,14 @@ public:
         INFO_SYSINFO = 0,
         INFO_NETWORK,
         INFO_MEMORY,
+        INFO_HEAP,
+        INFO_PERF,
         INFO_MODE_COUNT  // 이 값이 자동으로 모드 개수가 됨
     };
     
     static const int MAX_INFO_MODES = INFO_MODE_COUNT; // 자동 계산
     
-    void setup(Utils* utils_ptr, MatrixPanel_I2S_DMA* matrix_ptr);
+    void setup(Utils* utils_ptr, MatrixDisplay* matrix_ptr);
     void run();
     void cleanup();
     
@@ -33,15 +36,21 @@ public:
 
 private:
     Utils* m_utils;
-    MatrixPanel_I2S_DMA* m_matrix;
+    MatrixDisplay* m_matrix;
     
     unsigned long lastUpdate;
-    int currentInfoMode; // 0: SYSINFO, 1: NETWORK, 2: MEMORY
+    int currentInfoMode; // 0: SYSINFO, 1: NETWORK, 2: MEMORY, 3: HEAP, 4: PERF
+    uint32_t lastPerfSeq; // 화면에 그려진 마지막 telemetry perf 샘플
     
     void displayCurrentInfo();
     void displaySysInfo();      // SYSINFO
     void displayWiFiInfo();     // NETWORK  
     void displayMemoryInfo();   // MEMORY
+    void displayHeapGraph();    // HEAP (telemetry history)
+    void displayPerfInfo();     // PERF (전체 그리기)
+    void scrollPerfInfo();      // PERF (새 샘플: 한 열 스크롤)
+    void drawPerfColumn(int x, const PerfSample& s);
+    void drawPerfLabels(const PerfSample& s);
 };
 
 extern ModeSysinfo modeSysinfo;
@@ -0,0 +1,109 @@
+/**
+ * @file row_jobs.h
+ * @brief Fork-join row-band renderer that uses both ESP32-S3 cores
+ *
+ * Per-pixel pattern kernels (Plasma, Julia, the noise fields, ...) compute every
+ * row independently, but they used to run entirely on the Arduino loop core
+ * while the other core mostly idled in the WiFi stack. RowJobs splits a frame
+ * into bands of a few rows and renders them on both cores: one fixed worker task
+ * pinned to the other core, plus the calling task itself. Bands are handed out
+ * by an atomic counter, so an uneven kernel (the Julia set) still balances.
+ *
+ * A frame is one fork-join: the caller publishes the job and wakes the worker,
+ * both drain bands, and the caller waits for the worker's "done" before it
+ * returns. Those two hand-offs are task notifications, not a mutex per band.
+ *
+ * Pattern classes opt in by exposing
+ *     void renderRows(int y0, int y1);   // draw rows [y0, y1) of the frame
+ * and calling rowJobs.render(*this, effects.height) from drawFrame(). Per-frame
+ * state (time, offsets) must be computed before render(), and renderRows() may
+ * only write pixels in its own rows.
+ *
+ * Off target (no ARDUINO) the worker is a std::thread, so the same code can be
+ * built on a PC to benchmark the speed-up and compare output with a serial run.
+ */
+
+#ifndef ROW_JOBS_H
+#define ROW_JOBS_H
+
+#include <stdint.h>
+#include <atomic>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <thread>
+#endif
+
+class RowJobs {
+public:
+    RowJobs();
+    ~RowJobs();
+
+    /**
+     * @brief Start the worker on the core the caller is NOT running on
+     * @param bandRows Rows per band handed out at a time
+     * @return false if the worker could not be created (frames then render serially)
+     */
+    bool begin(uint8_t bandRows = 4);
+    void end();
+    bool isRunning() const { return m_running; }
+
+    /** @brief Render rows [0, rows) of a frame with pattern.renderRows() on both cores */
+    template <typename Pattern>
+    void render(Pattern& pattern, int rows) {
+        run(rows, &callRenderRows<Pattern>, &pattern);
+    }
+
+    /** @brief Same as render() for any callable taking (int y0, int y1) */
+    template <typename Fn>
+    void forEachBand(int rows, Fn& fn) {
+        run(rows, &callFunctor<Fn>, &fn);
+    }
+
+    // Rows rendered by the worker in the last frame (0 when running serially)
+    int workerRows() const { return m_workerRows; }
+
+private:
+    typedef void (*BandFn)(void* ctx, int y0, int y1);
+
+    template <typename Pattern>
+    static void callRenderRows(void* ctx, int y0, int y1) { static_cast<Pattern*>(ctx)->renderRows(y0, y1); }
+
+    template <typename Fn>
+    static void callFunctor(void* ctx, int y0, int y1) { (*static_cast<Fn*>(ctx))(y0, y1); }
+
+    void run(int rows, BandFn fn, void* ctx);
+    int drain();                    // Render bands until none are left, returns rows done
+    void workerLoop();
+
+    // Barrier primitives: worker waits for a frame, caller waits for the worker
+    void signalWorker();
+    void waitForWork();
+    void signalDone();
+    void waitForDone();
+
+    BandFn m_fn;
+    void* m_ctx;
+    int m_rows;
+    uint8_t m_bandRows;
+    std::atomic<int> m_nextRow;
+    int m_workerRows;
+    bool m_running;
+    bool m_stop;
+
+#ifdef ARDUINO
+    static void workerTask(void* arg);
+    TaskHandle_t m_worker;
+    TaskHandle_t m_caller;
+#else
+    std::thread m_worker;
+    std::atomic<uint32_t> m_startSeq;
+    std::atomic<uint32_t> m_doneSeq;
+    uint32_t m_seenSeq;
+#endif
+};
+
+extern RowJobs rowJobs;
+
+#endif // ROW_JOBS_H
@@ -0,0 +1,193 @@
+/**
+ * @file telemetry.h
+ * @brief Heap, PSRAM, task stack and DMA memory telemetry with a short history
+ *
+ * ModeSysinfo used to show ESP.getFreeHeap() and nothing else, which says little
+ * about a device that has been up for weeks: a slow leak only shows in the
+ * minimum-ever free heap, and fragmentation only in the largest free block, which
+ * can shrink below the size of the next allocation while plenty of heap is free.
+ *
+ * Telemetry samples, from the main loop every TELEMETRY_SAMPLE_MS:
+ *   - free / largest free block / minimum-ever free per capability
+ *     (internal, DMA-capable internal, SPIRAM)
+ *   - the stack high-water mark of the tasks the firmware depends on
+ *   - the bytes the HUB75 driver allocated for its frames and descriptors
+ *
+ * The latest sample is kept in full, and a compact point (KB and percent, 8 bytes)
+ * is appended to a TELEMETRY_HISTORY ring that the SysInfo HEAP page draws as a
+ * graph. Every TELEMETRY_REPORT_MS the latest sample is published as one JSON
+ * object to g_mqttTopic + TELEMETRY_TOPIC_SUFFIX, streamed so it does not depend on
+ * PubSubClient's packet buffer.
+ *
+ * Every TELEMETRY_PERF_MS it also closes a PerfSample for the SysInfo PERF page:
+ * the longest and mean time spent in the current mode's run() (reported by the
+ * main loop through recordFrame()), loop iterations per second, the busy share of
+ * each core, MQTT messages dispatched and their latency, and the refresh rate the
+ * DMA actually scanned out. CPU load comes from the idle tasks' run-time counters
+ * when FreeRTOS keeps run-time stats. The stock Arduino build does not keep them, so
+ * an idle hook times each core's waits for an interrupt instead.
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <Arduino.h>
+#include "config.h"
+
+class MatrixPanel_I2S_DMA;
+
+/**
+ * @brief Free / largest block / minimum-ever free for one heap capability (bytes)
+ */
+struct HeapCapsStats {
+    uint32_t total;
+    uint32_t free;
+    uint32_t largest;
+    uint32_t minFree;
+
+    // Share of the free memory that is NOT in the largest block (0 = one contiguous block)
+    uint8_t fragPercent() const { return free ? 100 - (uint8_t)((uint64_t)largest * 100 / free) : 0; }
+};
+
+/**
+ * @brief Stack high-water mark of one watched task
+ */
+struct TaskStackStats {
+    const char* name;
+    uint32_t freeBytes;     // Least stack left since the task started, 0 if the task does not exist
+    bool found;
+};
+
+/**
+ * @brief One history point in KB / percent, so the whole ring is TELEMETRY_HISTORY * 8 bytes
+ */
+struct TelemetryPoint {
+    uint16_t internalFreeKB;
+    uint16_t internalLargestKB;
+    uint16_t psramFreeKB;
+    uint8_t internalFrag;   // HeapCapsStats::fragPercent()
+    uint8_t dmaFrag;
+};
+
+/**
+ * @brief Performance over one TELEMETRY_PERF_MS interval
+ */
+struct PerfSample {
+    uint32_t frameMaxUs;    // Longest mode run() in the interval
+    uint32_t frameAvgUs;    // Mean mode run()
+    uint16_t loopsPerSec;
+    uint16_t refreshHz;     // Frames the DMA scanned out per second
+    uint16_t mqttMessages;  // MQTT messages dispatched in the interval
+    uint16_t mqttLatencyMs; // Mean reception -> handled latency of those, 0 when there were none
+    uint8_t cpuLoad[2];     // Busy percent per core, CPU_LOAD_UNKNOWN when it cannot be measured
+    uint8_t mode;           // DisplayMode running at the end of the interval
+};
+
+class Telemetry {
+public:
+    static const uint8_t TASK_COUNT = 6;
+    static const uint8_t CPU_LOAD_UNKNOWN = 0xFF;
+
+    Telemetry();
+
+    /**
+     * @doc Takes the first sample and remembers the DMA memory of the display driver.
+     *
+     * @param display HUB75 driver after begin(), or nullptr when there is no display
+     */
+    void begin(MatrixPanel_I2S_DMA* display);
+
+    /**
+     * @doc Samples and publishes when their intervals are due. Call every loop iteration.
+     */
+    void update();
+
+    /** @brief Takes a sample now and appends it to the history */
+    void sample();
+
+    /**
+     * @doc Re-reads the heap figures returned by internal(), dma() and psram() without
+     * touching the history or the report cadence. For displays that show the current values.
+     */
+    void refreshHeap();
+
+    /**
+     * @doc Publishes the latest sample over MQTT.
+     *
+     * @return false if MQTT is not connected or the publish failed
+     */
+    bool publish();
+
+    void print() const;
+
+    /**
+     * @doc Accounts one main loop iteration.
+     *
+     * @param modeUs Time spent in the current mode's run() this iteration
+     * @param mode Mode that ran
+     */
+    void recordFrame(uint32_t modeUs, uint8_t mode);
+
+    /** @brief Accounts one dispatched MQTT message and its end-to-end latency */
+    void recordMqttMessage(uint32_t latencyUs);
+
+    const HeapCapsStats& internal() const { return m_internal; }
+    const HeapCapsStats& dma() const { return m_dma; }
+    const HeapCapsStats& psram() const { return m_psram; }
+    const TaskStackStats& task(uint8_t i) const { return m_tasks[i]; }
+    uint32_t dmaDisplayBytes() const { return m_dmaDisplayBytes; }
+
+    // History, oldest first: point(0) .. point(historyCount() - 1)
+    uint16_t historyCount() const { return m_count; }
+    const TelemetryPoint& point(uint16_t i) const {
+        return m_history[(m_head + TELEMETRY_HISTORY - m_count + i) % TELEMETRY_HISTORY];
+    }
+
+    // Performance history, oldest first; perfSeq() counts samples so a reader can tell what is new
+    uint16_t perfCount() const { return m_perfCount; }
+    const PerfSample& perf(uint16_t i) const {
+        return m_perf[(m_perfHead + TELEMETRY_HISTORY - m_perfCount + i) % TELEMETRY_HISTORY];
+    }
+    uint32_t perfSeq() const { return m_perfSeq; }
+
+private:
+    static void readCaps(uint32_t caps, HeapCapsStats& out);
+    size_t formatReport(char* buf, size_t len) const;
+    void samplePerf();
+    bool readIdleTime(uint32_t idle[2], uint32_t& total);
+
+    HeapCapsStats m_internal;
+    HeapCapsStats m_dma;
+    HeapCapsStats m_psram;
+    TaskStackStats m_tasks[TASK_COUNT];
+    uint32_t m_dmaDisplayBytes;
+
+    TelemetryPoint m_history[TELEMETRY_HISTORY];
+    uint16_t m_head;        // Next slot to write
+    uint16_t m_count;
+
+    unsigned long m_lastSample;
+    unsigned long m_lastReport;
+
+    // Performance accumulators for the interval in progress
+    MatrixPanel_I2S_DMA* m_display;
+    uint32_t m_perfStart;       // micros()
+    uint32_t m_loops;
+    uint32_t m_frameTotalUs;
+    uint32_t m_frameMaxUs;
+    uint8_t m_mode;
+    uint32_t m_mqttCount;
+    uint32_t m_mqttLatencyUs;
+    uint32_t m_lastVsync;
+    uint32_t m_lastIdle[2];
+    uint32_t m_lastIdleTotal;
+
+    PerfSample m_perf[TELEMETRY_HISTORY];
+    uint16_t m_perfHead;
+    uint16_t m_perfCount;
+    uint32_t m_perfSeq;
+};
+
+extern Telemetry telemetry;
+
+#endif // TELEMETRY_H
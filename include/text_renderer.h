@@ -3,9 +3,9 @@
 
 #include <Arduino.h>
 #include <Adafruit_GFX.h> // For GFXfont
-#include <ESP32-HUB75-MatrixPanel-I2S-DMA.h>
+#include "matrix_display.h"
 #include "font_manager.h"
-#include "config.h" // For FontType, MATRIX_WIDTH, MATRIX_HEIGHT, SCROLL_CYCLE_END_WAIT_MS etc.
+#include "config.h" // For FontType, SCROLL_CYCLE_END_WAIT_MS etc.
 #include <string>   // For std::string
 
 // Enums previously in utils.h or specific to text rendering
@@ -17,7 +17,7 @@ enum ScrollDirection { SCROLL_HORIZONTAL_LEFT, SCROLL_HORIZONTAL_RIGHT, SCROLL_V
 class TextRenderer {
 public:
     TextRenderer();
-    void setup(MatrixPanel_I2S_DMA* matrixPtr, FontManager* fontManagerPtr);
+    void setup(MatrixDisplay* matrixPtr, FontManager* fontManagerPtr);
 
     FontType getCurrentAppliedFontType() const { return currentAppliedFontType; } // Ensure this is public
 
@@ -48,7 +48,7 @@ public:
     void startHorizontalScroll(const String& text, int16_t yPos, uint16_t color, int speedMillis,
                                FontType fontType = FONT_PRIMARY,
                                ScrollDirection direction = SCROLL_HORIZONTAL_LEFT,
-                               bool loop = true, int16_t scrollWidth = MATRIX_WIDTH);
+                               bool loop = true, int16_t scrollWidth = 0); // 0 = display width
     void updateHorizontalScroll();
     void stopHorizontalScroll();
     bool isHorizontalScrollingActive() const;
@@ -75,7 +75,7 @@ public:
 
 
 private:
-    MatrixPanel_I2S_DMA* matrix; // Renamed from m_matrix
+    MatrixDisplay* matrix; // Renamed from m_matrix
     FontManager* fontManager;    // Renamed from m_fontManager
 
     // --- Helpers for Basic Text Drawing & Metrics ---
@@ -9,7 +9,7 @@
  * Key responsibilities:
  * - Hardware initialization and GPIO management
  * - LED matrix display control and visual effects
- * - Button input processing with debouncing
+ * - Button GPIO configuration and state queries (events come from InputManager)
  * - Audio feedback system with volume control
  * - Text rendering and positioning utilities
  * - Color conversion and management
@@ -27,22 +27,11 @@
 #include <Arduino.h>
 #include <ESP32-HUB75-MatrixPanel-I2S-DMA.h>
 #include "config.h"
+#include "matrix_display.h"
 #include <Wire.h>
 #include "font_manager.h"
 #include "text_renderer.h"
 
-/**
- * @brief Button action enumeration for user input events
- * 
- * Defines the types of button actions that can be triggered by physical
- * GPIO buttons. Used for mode switching and navigation throughout the system.
- */
-enum class ButtonAction { 
-    NONE,           // No button action pending
-    NEXT_MODE,      // Navigate to next display mode  
-    PREV_MODE       // Navigate to previous display mode
-};
-
 /**
  * @brief Core utility class providing system-wide functionality
  * 
@@ -61,13 +50,7 @@ enum class ButtonAction {
 class Utils {
 private:
     // Core system references
-    MatrixPanel_I2S_DMA* m_matrix;         // LED matrix display driver reference
-    
-    // Button input state management
-    unsigned long lastButtonCheck;         // Timestamp of last button state check
-    bool lastButtonUpState;                // Previous state of UP button
-    bool lastButtonDownState;              // Previous state of DOWN button
-    ButtonAction pendingButtonAction;      // Queued button action for processing
+    MatrixDisplay* m_matrix;               // LED matrix display (whole panel wall)
     
     // Audio system state
     bool buzzerEnabled;                    // Global audio feedback enable flag
@@ -76,15 +59,6 @@ private:
     // Integrated helper subsystems
     FontManager fontManagerInstance;       // Font management and selection
     TextRenderer textRendererInstance;     // Advanced text rendering with scrolling
-    
-    // Private hardware initialization methods
-    /**
-     * @doc Initializes LED matrix display hardware with configured parameters.
-     * 
-     * Internal method for setting up the HUB75 interface with proper pin assignments,
-     * timing parameters, and buffer configuration. Called during main setup process.
-     */
-    void setupDisplay();
 
 public:
     // Construction and initialization
@@ -106,7 +80,7 @@ public:
      * 
      * @param matrix_ptr Pointer to initialized LED matrix display driver
      */
-    void setup(MatrixPanel_I2S_DMA* matrix_ptr);
+    void setup(MatrixDisplay* matrix_ptr);
 
     // --- DISPLAY MANAGEMENT AND VISUAL EFFECTS ---
     
@@ -194,26 +168,8 @@ public:
     static uint16_t rgb888to565(uint8_t r, uint8_t g, uint8_t b);
 
     // --- USER INPUT AND BUTTON MANAGEMENT ---
-    
-    /**
-     * @doc Retrieves and clears any pending button action.
-     * 
-     * Returns the next queued button action and clears it from the internal
-     * queue. This implements a non-blocking button event system that prevents
-     * action loss and provides clean event handling.
-     * 
-     * @return ButtonAction enum value (NONE if no action pending)
-     */
-    ButtonAction getButtonAction();
-    
-    /**
-     * @doc Processes button state changes with debouncing logic.
-     * 
-     * Monitors GPIO button states, applies debouncing to prevent false
-     * triggers, and queues appropriate actions for consumption. Should be
-     * called regularly from the main loop for responsive input handling.
-     */
-    void handleButtons();
+    // Press / long-press / repeat events are produced by InputManager from
+    // GPIO interrupts; these accessors only sample the current pin level.
     
     /**
      * @doc Checks current state of UP navigation button.
@@ -331,6 +287,8 @@ public:
      * 
      * Triggers the DMA buffer flip to make all pending drawing operations
      * visible on the physical display. Essential for double-buffered operation.
+     * Returns once the DMA engine has moved onto the new buffer (vsync), so the
+     * back buffer can be drawn into straight away without tearing.
      */
     void displayShow();
     
@@ -0,0 +1,77 @@
+/**
+ * @file ESP32-HUB75-Dither.hpp
+ * @brief Ordered / temporal dither threshold tables for reduced colour depth output.
+ *
+ * With pixel_color_depth_bits < 8 (e.g. 6) the driver keeps only the top bits of the
+ * 16-bit CIE1931 corrected value, so everything below 1 LSB of the kept depth is simply
+ * truncated and dark gradients show visible bands.
+ *
+ * Adding a threshold t in [0, 1 LSB) before truncation turns that into rounding whose
+ * average is the true value. Thresholds come from a 4x4 Bayer matrix (spatial) and, when
+ * 2 or 4 frames are configured, a per-pixel rotation across successive uploaded frames
+ * (temporal). Each pixel visits every coarse threshold once per cycle, while within any
+ * single frame the thresholds stay spread over the panel, so the overall frame brightness
+ * does not flicker.
+ *
+ * Everything is precomputed when the mode is set; the per-pixel cost is one table read
+ * and three saturating adds. Header only and free of ESP-IDF dependencies so the host
+ * test in /testing can evaluate exactly the same tables.
+ */
+
+#ifndef ESP32_HUB75_DITHER_HPP
+#define ESP32_HUB75_DITHER_HPP
+
+#include <stdint.h>
+
+#define DITHER_MAX_FRAMES 4
+
+struct DitherTable
+{
+  uint8_t frames = 0;                          // 0 = off, 1 = ordered (spatial only), 2 or 4 = temporal cycle length
+  uint16_t thr[DITHER_MAX_FRAMES][16] = {};    // [phase][(y & 3) * 4 + (x & 3)], in 16-bit CIE units
+
+  /**
+   * @param mask_offset - number of low bits of the 16-bit value that get truncated (16 - colour depth)
+   * @param _frames     - 0 (off), 1, 2 or 4. Other values are rounded down to the nearest of these.
+   */
+  void build(uint8_t mask_offset, uint8_t _frames)
+  {
+    static const uint8_t bayer4[16] = {
+       0,  8,  2, 10,
+      12,  4, 14,  6,
+       3, 11,  1,  9,
+      15,  7, 13,  5 };
+
+    frames = (_frames >= 4) ? 4 : (_frames >= 2) ? 2 : _frames;
+    if (frames == 0 || mask_offset == 0)
+    {
+      frames = 0;
+      return;
+    }
+
+    // levels = 16 * frames fine steps of one LSB; centred, so the mean added value is exactly LSB/2
+    uint32_t levels2 = 32u * frames;
+    for (uint8_t f = 0; f < frames; f++)
+    {
+      for (uint8_t i = 0; i < 16; i++)
+      {
+        uint32_t coarse = (bayer4[i] + f) % frames; // which temporal slot this pixel is in for this phase
+        uint32_t k = coarse * 16 + bayer4[i];
+        thr[f][i] = (uint16_t)(((2 * k + 1) << mask_offset) / levels2);
+      }
+    }
+  }
+
+  inline uint16_t threshold(uint16_t x, uint16_t y, uint8_t phase) const
+  {
+    return thr[phase & (frames - 1)][((y & 3) << 2) | (x & 3)];
+  }
+
+  static inline uint16_t add_sat(uint16_t v, uint16_t t)
+  {
+    uint32_t s = (uint32_t)v + t;
+    return (s > 0xFFFF) ? 0xFFFF : (uint16_t)s;
+  }
+};
+
+#endif
@@ -6,16 +6,14 @@
 #include "rom/cache.h"
 #endif
 
-/* This replicates same function in rowBitStruct, but due to induced inlining it might be MUCH faster
+/* This replicates same function in frameStruct, but due to induced inlining it might be MUCH faster
  * when used in tight loops while method from struct could be flushed out of instruction cache between
- * loop cycles do NOT forget about buff_id param if using this.
+ * loop cycles. The frame is one contiguous block, so it is plain stride arithmetic.
  */
-// #define getRowDataPtr(row, _dpth, buff_id) &(dma_buff.rowBits[row]->data[_dpth * dma_buff.rowBits[row]->width + buff_id*(dma_buff.rowBits[row]->width * dma_buff.rowBits[row]->colour_depth)])
-
 // BufferID is now ignored, seperate global pointer pointer!
-#define getRowDataPtr(row, _dpth) &(fb->rowBits[row]->data[_dpth * fb->rowBits[row]->width])
+#define getRowDataPtr(row, _dpth) (fb->data + (row) * fb->row_stride + (_dpth) * fb->plane_stride)
 
-/* We need to update the correct uint16_t in the rowBitStruct array, that gets sent out in parallel
+/* We need to update the correct uint16_t in the frameStruct array, that gets sent out in parallel
  * 16 bit parallel mode - Save the calculated value to the bitplane memory in reverse order to account for I2S Tx FIFO mode1 ordering
  * Irrelevant for ESP32-S2 the way the FIFO ordering works is different - refer to page 679 of S2 technical reference manual
  */
@@ -49,24 +47,21 @@ bool MatrixPanel_I2S_DMA::setupDMA(const HUB75_I2S_CFG &_cfg)
 
   for (int fb = 0; fb < (fbs_required); fb++)
   {
-    frame_buffer[fb].rowBits.reserve(ROWS_PER_FRAME);
-
-    for (int malloc_num = 0; malloc_num < ROWS_PER_FRAME; malloc_num++)
+    // One aligned block per frame: all rows, all colour depths
+    if (!frame_buffer[fb].allocate(ROWS_PER_FRAME, PIXELS_PER_ROW, m_cfg.getPixelColorDepthBits()))
     {
-      auto ptr = std::make_shared<rowBitStruct>(PIXELS_PER_ROW, m_cfg.getPixelColorDepthBits());
-
-      if (ptr->data == nullptr) {
-
-        ESP_LOGE("I2S-DMA", "CRITICAL ERROR: Not enough memory for requested colour depth of %d bits! Please reduce pixel_color_depth_bits value.\r\n", m_cfg.getPixelColorDepthBits());
-
-        return false;
-        // TODO: should we release all previous rowBitStructs here???
-      }
-
-      allocated_fb_memory += ptr->getColorDepthSize(false); // byte required to display all colour depths for the two parallel rows
-      frame_buffer[fb].rowBits.emplace_back(ptr); // save new rowBitStruct pointer into rows vector
-      ++frame_buffer[fb].rows;
+      ESP_LOGE("I2S-DMA", "CRITICAL ERROR: Not enough memory for requested colour depth of %d bits! Please reduce pixel_color_depth_bits value.\r\n", m_cfg.getPixelColorDepthBits());
+#if defined(SPIRAM_DMA_BUFFER)
+      ESP_LOGE("I2S-DMA", "Largest free SPIRAM block: %d bytes", heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM));
+#else
+      ESP_LOGE("I2S-DMA", "Largest free DMA block: %d bytes", heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA));
+#endif
+      frame_buffer[0].release();
+      frame_buffer[1].release();
+      return false;
     }
+
+    allocated_fb_memory += frame_buffer[fb].size_bytes;
   }
   ESP_LOGI("I2S-DMA", "Allocating %d bytes memory for DMA BCM framebuffer(s).", allocated_fb_memory);
 
@@ -84,34 +79,12 @@ bool MatrixPanel_I2S_DMA::setupDMA(const HUB75_I2S_CFG &_cfg)
 
   ESP_LOGI("I2S-DMA", "Minimum visual refresh rate (scan rate from panel top to bottom) requested: %d Hz", m_cfg.min_refresh_rate);
 
-  while (1)
-  {
-    int psPerClock = 1000000000000UL / m_cfg.i2sspeed;
-    int nsPerLatch = ((PIXELS_PER_ROW + CLKS_DURING_LATCH) * psPerClock) / 1000; // time per row
-
-    // add time to shift out LSBs + LSB-MSB transition bit - this ignores fractions...
-    int nsPerRow = m_cfg.getPixelColorDepthBits() * nsPerLatch;
-
-    // Now add the time for the remaining bit depths
-    for (int i = lsbMsbTransitionBit + 1; i < m_cfg.getPixelColorDepthBits(); i++) {
-      //nsPerRow += (1 << (i - lsbMsbTransitionBit - 1)) * (m_cfg.getPixelColorDepthBits() - i) * nsPerLatch;
-	  nsPerRow += (1 << (i - lsbMsbTransitionBit - 1)) *  nsPerLatch;
-	}
-
-    int nsPerFrame = nsPerRow * ROWS_PER_FRAME;
-    int actualRefreshRate = 1000000000UL / (nsPerFrame);
-    calculated_refresh_rate = actualRefreshRate;
-
-    ESP_LOGW("I2S-DMA", "lsbMsbTransitionBit of %d gives %d Hz refresh rate.", lsbMsbTransitionBit, actualRefreshRate);
-
-    if (actualRefreshRate > m_cfg.min_refresh_rate)
-      break;
+  // Same model the offline tuner uses, see ESP32-HUB75-TimingModel.hpp
+  uint32_t actualRefreshRate = 0;
+  lsbMsbTransitionBit = hub75_transition_bit(getTimingParams(m_cfg), m_cfg.min_refresh_rate, &actualRefreshRate);
+  calculated_refresh_rate = actualRefreshRate;
 
-    if (lsbMsbTransitionBit < m_cfg.getPixelColorDepthBits() - 1)
-      lsbMsbTransitionBit++;
-    else
-      break;
-  }
+  ESP_LOGW("I2S-DMA", "lsbMsbTransitionBit of %d gives %d Hz refresh rate.", lsbMsbTransitionBit, (int)actualRefreshRate);
 
   if (lsbMsbTransitionBit > 0)
   {
@@ -129,11 +102,11 @@ bool MatrixPanel_I2S_DMA::setupDMA(const HUB75_I2S_CFG &_cfg)
    *          give this library's DMA output memory allocation approach is by the row.
    */
 	
-  int    dma_descs_per_row_1cdepth	 	= (frame_buffer[0].rowBits[0]->getColorDepthSize(true) + DMA_MAX - 1 ) / DMA_MAX;
-  size_t last_dma_desc_bytes_1cdepth    = (frame_buffer[0].rowBits[0]->getColorDepthSize(true) % DMA_MAX);
+  int    dma_descs_per_row_1cdepth	 	= (frame_buffer[0].getColorDepthSize(true) + DMA_MAX - 1 ) / DMA_MAX;
+  size_t last_dma_desc_bytes_1cdepth    = (frame_buffer[0].getColorDepthSize(true) % DMA_MAX);
   
-  int    dma_descs_per_row_all_cdepths	  = (frame_buffer[0].rowBits[0]->getColorDepthSize(false) + DMA_MAX - 1 ) / DMA_MAX;
-  size_t last_dma_desc_bytes_all_cdepths  = (frame_buffer[0].rowBits[0]->getColorDepthSize(false) % DMA_MAX);
+  int    dma_descs_per_row_all_cdepths	  = (frame_buffer[0].getColorDepthSize(false) + DMA_MAX - 1 ) / DMA_MAX;
+  size_t last_dma_desc_bytes_all_cdepths  = (frame_buffer[0].getColorDepthSize(false) % DMA_MAX);
 
   // Logging the calculated values
   ESP_LOGV("I2S-DMA", "dma_descs_per_row_1cdepth: %d", dma_descs_per_row_1cdepth);
@@ -192,9 +165,9 @@ bool MatrixPanel_I2S_DMA::setupDMA(const HUB75_I2S_CFG &_cfg)
 			size_t payload_bytes = (dma_desc_all == (dma_descs_per_row_all_cdepths-1)) ? last_dma_desc_bytes_all_cdepths:DMA_MAX;
 			
 			// Log the current descriptor number and the payload size being used.
-			//ESP_LOGV("I2S-DMA", "Processing dma_desc_all: %d, payload_bytes: %zu, memory location: %p", dma_desc_all, payload_bytes, (frame_buffer[fb].rowBits[row]->getDataPtr(0)+(dma_desc_all*(DMA_MAX/sizeof(ESP32_I2S_DMA_STORAGE_TYPE)))));
+			//ESP_LOGV("I2S-DMA", "Processing dma_desc_all: %d, payload_bytes: %zu, memory location: %p", dma_desc_all, payload_bytes, (frame_buffer[fb].getDataPtr(row, 0)+(dma_desc_all*(DMA_MAX/sizeof(ESP32_I2S_DMA_STORAGE_TYPE)))));
 				
-		    dma_bus.create_dma_desc_link(frame_buffer[fb].rowBits[row]->getDataPtr(0)+(dma_desc_all*(DMA_MAX/sizeof(ESP32_I2S_DMA_STORAGE_TYPE))), payload_bytes, (fb==1));
+		    dma_bus.create_dma_desc_link(frame_buffer[fb].getDataPtr(row, 0)+(dma_desc_all*(DMA_MAX/sizeof(ESP32_I2S_DMA_STORAGE_TYPE))), payload_bytes, (fb==1));
 			_dmadescriptor_count++;
 			
 			// Log the updated descriptor count after each operation.
@@ -216,9 +189,9 @@ bool MatrixPanel_I2S_DMA::setupDMA(const HUB75_I2S_CFG &_cfg)
 				size_t payload_bytes = (dma_desc_1cdepth == (dma_descs_per_row_1cdepth-1)) ? last_dma_desc_bytes_1cdepth:DMA_MAX;
 				
 				// Log the current bit and the corresponding payload size.
-				//ESP_LOGV("I2S-DMA", "Processing dma_desc_1cdepth: %d, payload_bytes: %zu, memory location: %p", dma_desc_1cdepth, payload_bytes, (frame_buffer[fb].rowBits[row]->getDataPtr(i)+(dma_desc_1cdepth*(DMA_MAX/sizeof(ESP32_I2S_DMA_STORAGE_TYPE)))));
+				//ESP_LOGV("I2S-DMA", "Processing dma_desc_1cdepth: %d, payload_bytes: %zu, memory location: %p", dma_desc_1cdepth, payload_bytes, (frame_buffer[fb].getDataPtr(row, i)+(dma_desc_1cdepth*(DMA_MAX/sizeof(ESP32_I2S_DMA_STORAGE_TYPE)))));
 		
-				dma_bus.create_dma_desc_link(frame_buffer[fb].rowBits[row]->getDataPtr(i)+(dma_desc_1cdepth*(DMA_MAX/sizeof(ESP32_I2S_DMA_STORAGE_TYPE))), payload_bytes, (fb==1));
+				dma_bus.create_dma_desc_link(frame_buffer[fb].getDataPtr(row, i)+(dma_desc_1cdepth*(DMA_MAX/sizeof(ESP32_I2S_DMA_STORAGE_TYPE))), payload_bytes, (fb==1));
 				_dmadescriptor_count++;
 				
 				// Log the updated descriptor count after each operation.
@@ -314,7 +287,7 @@ bool MatrixPanel_I2S_DMA::setupDMA(const HUB75_I2S_CFG &_cfg)
  *  Critical dependency: That 'updateMatrixDMABuffer(uint8_t red, uint8_t green, uint8_t blue)' has been run at least once over the
  *                       entire frameBuffer to ensure all the non R,G,B bitmasks are in place (i.e. like OE, Address Lines etc.)
  *
- *  Note: If you change the brightness with setBrightness() you MUST then clearScreen() and repaint / flush the entire framebuffer.
+ *  Note: setBrightness() only rewrites the OE bits (see setBrightnessOE()), colour data is left intact so no repaint is needed.
  */
 
 /** @brief - Update pixel at specific co-ordinate in the DMA buffer
@@ -352,6 +325,15 @@ void IRAM_ATTR MatrixPanel_I2S_DMA::updateMatrixDMABuffer(uint16_t x_coord, uint
   red16 = lumConvTab[red];
   green16 = lumConvTab[green];
   blue16 = lumConvTab[blue];
+
+  // Round instead of truncate below the kept colour depth, using the precomputed threshold for this pixel / phase
+  if (dither.frames)
+  {
+    uint16_t t = dither.threshold(x_coord, y_coord, dither_phase);
+    red16 = DitherTable::add_sat(red16, t);
+    green16 = DitherTable::add_sat(green16, t);
+    blue16 = DitherTable::add_sat(blue16, t);
+  }
 #endif
 
   /* When using the drawPixel, we are obviously only changing the value of one x,y position,
@@ -402,7 +384,7 @@ void IRAM_ATTR MatrixPanel_I2S_DMA::updateMatrixDMABuffer(uint16_t x_coord, uint
     // it would represent a vector pointing to the full row of pixels for the specified colour depth bit at Y coordinate
     ESP32_I2S_DMA_STORAGE_TYPE *p = getRowDataPtr(y_coord, colour_depth_idx);
 
-    // We need to update the correct uint16_t word in the rowBitStruct array pointing to a specific pixel at X - coordinate
+    // We need to update the correct uint16_t word in the frameStruct array pointing to a specific pixel at X - coordinate
     p[x_coord] &= _colourbitclear; // reset RGB bits
     p[x_coord] |= RGB_output_bits; // set new RGB bits
 
@@ -457,7 +439,7 @@ void MatrixPanel_I2S_DMA::updateMatrixDMABuffer(uint8_t red, uint8_t green, uint
     // Serial.printf("Fill with: 0x%#06x\n", RGB_output_bits);
 
     // iterate rows
-    int matrix_frame_parallel_row = fb->rowBits.size();
+    int matrix_frame_parallel_row = fb->rows;
     do
     {
       --matrix_frame_parallel_row;
@@ -466,7 +448,7 @@ void MatrixPanel_I2S_DMA::updateMatrixDMABuffer(uint8_t red, uint8_t green, uint
       ESP32_I2S_DMA_STORAGE_TYPE *p = getRowDataPtr(matrix_frame_parallel_row, colour_depth_idx);
 
       // iterate pixels in a row
-      int x_coord = fb->rowBits[matrix_frame_parallel_row]->width;
+      int x_coord = fb->width;
       do
       {
         --x_coord;
@@ -483,6 +465,60 @@ void MatrixPanel_I2S_DMA::updateMatrixDMABuffer(uint8_t red, uint8_t green, uint
   }                                      // colour depth loop (8)
 } // updateMatrixDMABuffer (full frame paint)
 
+void MatrixPanel_I2S_DMA::copyFrontToBackBuffer()
+{
+  if (!initialized || !m_cfg.double_buff)
+    return;
+
+  const frameStruct &front = frame_buffer[back_buffer_id ^ 1];
+  frameStruct &back = frame_buffer[back_buffer_id];
+
+  memcpy(back.data, front.data, back.size_bytes);
+
+#if defined(SPIRAM_DMA_BUFFER)
+  Cache_WriteBack_Addr((uint32_t)back.data, back.size_bytes);
+#endif
+}
+
+void MatrixPanel_I2S_DMA::movePixelDMA(int16_t src_x, int16_t src_y, int16_t dst_x, int16_t dst_y)
+{
+  if (!initialized)
+    return;
+
+  if ((uint16_t)src_x >= PIXELS_PER_ROW || (uint16_t)src_y >= m_cfg.mx_height ||
+      (uint16_t)dst_x >= PIXELS_PER_ROW || (uint16_t)dst_y >= m_cfg.mx_height)
+    return;
+
+  // The top and bottom halves share a word: RGB1 bits for the top row, RGB2 bits for the bottom one
+  uint8_t src_shift = BITS_RGB1_OFFSET, dst_shift = BITS_RGB1_OFFSET;
+  uint16_t dst_clear = BITMASK_RGB1_CLEAR;
+  if (src_y >= ROWS_PER_FRAME)
+  {
+    src_y -= ROWS_PER_FRAME;
+    src_shift = BITS_RGB2_OFFSET;
+  }
+  if (dst_y >= ROWS_PER_FRAME)
+  {
+    dst_y -= ROWS_PER_FRAME;
+    dst_shift = BITS_RGB2_OFFSET;
+    dst_clear = BITMASK_RGB2_CLEAR;
+  }
+
+  src_x = ESP32_TX_FIFO_POSITION_ADJUST(src_x);
+  dst_x = ESP32_TX_FIFO_POSITION_ADJUST(dst_x);
+
+  for (uint8_t colour_depth_idx = 0; colour_depth_idx < fb->colour_depth; colour_depth_idx++)
+  {
+    uint16_t rgb = (getRowDataPtr(src_y, colour_depth_idx)[src_x] >> src_shift) & 0b111;
+    ESP32_I2S_DMA_STORAGE_TYPE *p = getRowDataPtr(dst_y, colour_depth_idx);
+    p[dst_x] = (p[dst_x] & dst_clear) | (rgb << dst_shift);
+
+#if defined(SPIRAM_DMA_BUFFER)
+    Cache_WriteBack_Addr((uint32_t)&p[dst_x], sizeof(ESP32_I2S_DMA_STORAGE_TYPE));
+#endif
+  }
+}
+
 /**
  * @brief - clears and reinitializes colour/control data in DMA buffs
  * When allocated, DMA buffs might be dirty, so we need to blank it and initialize ABCDE,LAT,OE control bits.
@@ -498,17 +534,20 @@ void MatrixPanel_I2S_DMA::clearFrameBuffer(bool _buff_id)
 
   frameStruct *fb = &frame_buffer[_buff_id];
 
+  // every word is rewritten below, so the OE window has to be laid down again from scratch
+  oe_span_valid[_buff_id] = false;
+
   // we start with iterating all rows in dma_buff structure
-  int row_idx = fb->rowBits.size();
+  int row_idx = fb->rows;
   do
   {
     --row_idx;
 
-    ESP32_I2S_DMA_STORAGE_TYPE *row = fb->rowBits[row_idx]->getDataPtr(0); // set pointer to the HEAD of a buffer holding data for the entire matrix row
+    ESP32_I2S_DMA_STORAGE_TYPE *row = fb->getDataPtr(row_idx, 0); // set pointer to the HEAD of a buffer holding data for the entire matrix row
     ESP32_I2S_DMA_STORAGE_TYPE abcde = (ESP32_I2S_DMA_STORAGE_TYPE)row_idx;
 
     // get last pixel index in a row of all colourdepths
-    int x_pixel = fb->rowBits[row_idx]->width * fb->rowBits[row_idx]->colour_depth;
+    int x_pixel = fb->width * fb->colour_depth;
 
 	abcde <<= BITS_ADDR_OFFSET; // shift row y-coord to match ABCDE bits in vector from 8 to 12
 	do
@@ -529,7 +568,7 @@ void MatrixPanel_I2S_DMA::clearFrameBuffer(bool _buff_id)
 			row[ESP32_TX_FIFO_POSITION_ADJUST(x_pixel)] = abcde;
 		}
 
-	} while (x_pixel != fb->rowBits[row_idx]->width); // spare the first "width's" worth of pixels as they are the LSB pixels/colordepth
+	} while (x_pixel != fb->width); // spare the first "width's" worth of pixels as they are the LSB pixels/colordepth
 
 	// The colour_index[0] (LSB) x_pixels must be "marked" with a previous's row address, because it is used to display
 	// previous row while we pump in MSBs's for the next row.
@@ -567,7 +606,7 @@ void MatrixPanel_I2S_DMA::clearFrameBuffer(bool _buff_id)
     {
       uint16_t serialCount;
       uint16_t latch;
-      x_pixel = fb->rowBits[row_idx]->width - 16; // come back 8*2 pixels to allow for 8 writes
+      x_pixel = fb->width - 16; // come back 8*2 pixels to allow for 8 writes
       serialCount = 8;
       do
       {
@@ -581,7 +620,7 @@ void MatrixPanel_I2S_DMA::clearFrameBuffer(bool _buff_id)
     // row selection for SM5368 shift regs with ABC-only addressing. A is row clk, B is BK and C is row data
     if (m_cfg.driver == HUB75_I2S_CFG::DP3246_SM5368) 
     {
-      x_pixel = fb->rowBits[row_idx]->width - 1;                                                                        // last pixel in first block)
+      x_pixel = fb->width - 1;                                                                        // last pixel in first block)
       uint16_t c = (row_idx == 0) ? BIT_C : 0x0000;                                                                     // set row data (C) when row==0, then push through shift regs for all other rows
       row[ESP32_TX_FIFO_POSITION_ADJUST(x_pixel - 1)] |= c;                                                             // set row data
       row[ESP32_TX_FIFO_POSITION_ADJUST(x_pixel + 0)] |= c | BIT_A | BIT_B;                                             // set row clk and bk, carry row data
@@ -589,22 +628,22 @@ void MatrixPanel_I2S_DMA::clearFrameBuffer(bool _buff_id)
 
     // let's set LAT/OE control bits for specific pixels in each colour_index subrows
     // Need to consider the original ESP32's (WROOM) DMA TX FIFO reordering of bytes...
-    uint8_t colouridx = fb->rowBits[row_idx]->colour_depth;
+    uint8_t colouridx = fb->colour_depth;
     do
     {
       --colouridx;
 
       // switch pointer to a row for a specific colour index
-      row = fb->rowBits[row_idx]->getDataPtr(colouridx);
+      row = fb->getDataPtr(row_idx, colouridx);
 
       // DP3246 needs the latch high for 3 clock cycles, so start 2 cycles earlier
       if (m_cfg.driver == HUB75_I2S_CFG::DP3246_SM5368) 
       {
-        row[ESP32_TX_FIFO_POSITION_ADJUST(fb->rowBits[row_idx]->width - 3)] |= BIT_LAT;   // DP3246 needs 3 clock cycle latch 
-        row[ESP32_TX_FIFO_POSITION_ADJUST(fb->rowBits[row_idx]->width - 2)] |= BIT_LAT;   // DP3246 needs 3 clock cycle latch 
+        row[ESP32_TX_FIFO_POSITION_ADJUST(fb->width - 3)] |= BIT_LAT;   // DP3246 needs 3 clock cycle latch 
+        row[ESP32_TX_FIFO_POSITION_ADJUST(fb->width - 2)] |= BIT_LAT;   // DP3246 needs 3 clock cycle latch 
       } // DP3246_SM5368
       
-      row[ESP32_TX_FIFO_POSITION_ADJUST(fb->rowBits[row_idx]->width - 1)] |= BIT_LAT; // -1 pixel to compensate array index starting at 0
+      row[ESP32_TX_FIFO_POSITION_ADJUST(fb->width - 1)] |= BIT_LAT; // -1 pixel to compensate array index starting at 0
 
       // ESP32_TX_FIFO_POSITION_ADJUST(dma_buff.rowBits[row_idx]->width - 1)
 
@@ -616,20 +655,28 @@ void MatrixPanel_I2S_DMA::clearFrameBuffer(bool _buff_id)
         --_blank;
 
         row[ESP32_TX_FIFO_POSITION_ADJUST(0 + _blank)] |= BIT_OE;                               // disable output
-        row[ESP32_TX_FIFO_POSITION_ADJUST(fb->rowBits[row_idx]->width - 1)] |= BIT_OE;          // disable output
-        row[ESP32_TX_FIFO_POSITION_ADJUST(fb->rowBits[row_idx]->width - _blank - 1)] |= BIT_OE; // (LAT pulse is (width-2) -1 pixel to compensate array index starting at 0
+        row[ESP32_TX_FIFO_POSITION_ADJUST(fb->width - 1)] |= BIT_OE;          // disable output
+        row[ESP32_TX_FIFO_POSITION_ADJUST(fb->width - _blank - 1)] |= BIT_OE; // (LAT pulse is (width-2) -1 pixel to compensate array index starting at 0
 
       } while (_blank);
 
     } while (colouridx);
 
 #if defined(SPIRAM_DMA_BUFFER)
-    Cache_WriteBack_Addr((uint32_t)row, fb->rowBits[row_idx]->getColorDepthSize(false));
+    Cache_WriteBack_Addr((uint32_t)row, fb->getColorDepthSize(false));
 #endif
 
   } while (row_idx);
 }
 
+/* Brightness lives only in the OE control bit of each word, so it is applied without touching colour data.
+ * The OE 'on' window is a centred span per bit plane (identical for every row). We remember the span that
+ * was last written into each buffer and only rewrite the words between the old and the new left edge and
+ * between the old and the new right edge, as plain word loops with no per-pixel branching. A step of one
+ * brightness level therefore touches only the few words each edge moved by per plane-row (none for planes
+ * whose span did not change), which makes per-frame ramps (power limiting, ambient dimming) cheap.
+ * After clearFrameBuffer() the remembered spans are invalid and the whole row width is rewritten once.
+ */
 void MatrixPanel_I2S_DMA::setBrightnessOE(uint8_t brt, const int _buff_id)
 {
 
@@ -639,59 +686,99 @@ void MatrixPanel_I2S_DMA::setBrightnessOE(uint8_t brt, const int _buff_id)
   frameStruct *fb = &frame_buffer[_buff_id];
 
   uint8_t _blank = m_cfg.latch_blanking; // don't want to inadvertantly blast over this
-  uint8_t _depth = fb->rowBits[0]->colour_depth;
-  uint16_t _width = fb->rowBits[0]->width;
+  uint8_t _depth = fb->colour_depth;
+  uint16_t _width = fb->width;
+
+  int16_t *span_min = oe_span_min[_buff_id];
+  int16_t *span_max = oe_span_max[_buff_id];
+
+  // words [left_from, left_to) and [right_from, right_to) of each plane need rewriting
+  int16_t left_from[PIXEL_COLOR_DEPTH_BITS_MAX], left_to[PIXEL_COLOR_DEPTH_BITS_MAX];
+  int16_t right_from[PIXEL_COLOR_DEPTH_BITS_MAX], right_to[PIXEL_COLOR_DEPTH_BITS_MAX];
+  bool dirty = false;
+
+  uint8_t colouridx = _depth;
+  do
+  {
+    --colouridx;
+
+    char bitplane = (2 * _depth - colouridx) % _depth;
+    char bitshift = (_depth - lsbMsbTransitionBit - 1) >> 1;
+
+    char rightshift = std::max(bitplane - bitshift - 2, 0);
+    // calculate the OE disable period by brightness, and also blanking
+    int brightness_in_x_pixels = ((_width - _blank) * brt) >> (7 + rightshift);
+    brightness_in_x_pixels = (brightness_in_x_pixels >> 1) | (brightness_in_x_pixels & 1);
+
+    // define range of Output Enable on the center of the row (the range is already excluding "blanking")
+    int16_t x_coord_max = (_width + brightness_in_x_pixels + 1) >> 1;
+    int16_t x_coord_min = (_width - brightness_in_x_pixels + 0) >> 1;
+
+    if (!oe_span_valid[_buff_id])
+    {
+      left_from[colouridx] = 0; // whole row, once
+      left_to[colouridx] = _width;
+      right_from[colouridx] = right_to[colouridx] = 0;
+    }
+    else
+    {
+      // only the words each edge moved across (empty when the edge did not move)
+      left_from[colouridx] = std::min(x_coord_min, span_min[colouridx]);
+      left_to[colouridx] = std::max(x_coord_min, span_min[colouridx]);
+      right_from[colouridx] = std::min(x_coord_max, span_max[colouridx]);
+      right_to[colouridx] = std::max(x_coord_max, span_max[colouridx]);
+    }
+
+    dirty |= (left_from[colouridx] != left_to[colouridx]) || (right_from[colouridx] != right_to[colouridx]);
+    span_min[colouridx] = x_coord_min;
+    span_max[colouridx] = x_coord_max;
+
+  } while (colouridx);
+
+  oe_span_valid[_buff_id] = true;
+
+  if (!dirty)
+    return;
 
   // start with iterating all rows in dma_buff structure
-  int row_idx = fb->rowBits.size();
+  int row_idx = fb->rows;
   do
   {
     --row_idx;
 
-    // let's set OE control bits for specific pixels in each color_index subrows
-    uint8_t colouridx = _depth;
+    colouridx = _depth;
     do
     {
       --colouridx;
 
-      char bitplane = (2 * _depth - colouridx) % _depth;
-      char bitshift = (_depth - lsbMsbTransitionBit - 1) >> 1;
-
-      char rightshift = std::max(bitplane - bitshift - 2, 0);
-      // calculate the OE disable period by brightness, and also blanking
-      int brightness_in_x_pixels = ((_width - _blank) * brt) >> (7 + rightshift);
-      brightness_in_x_pixels = (brightness_in_x_pixels >> 1) | (brightness_in_x_pixels & 1);
+      if (left_from[colouridx] == left_to[colouridx] && right_from[colouridx] == right_to[colouridx])
+        continue;
 
       // switch pointer to a row for a specific color index
-      ESP32_I2S_DMA_STORAGE_TYPE *row = fb->rowBits[row_idx]->getDataPtr(colouridx);
-
-      // define range of Output Enable on the center of the row
-      int x_coord_max = (_width + brightness_in_x_pixels + 1) >> 1;
-      int x_coord_min = (_width - brightness_in_x_pixels + 0) >> 1;
-      int x_coord = _width;
-      do
-      {
-        --x_coord;
+      ESP32_I2S_DMA_STORAGE_TYPE *row = fb->getDataPtr(row_idx, colouridx);
 
-        // (the check is already including "blanking" )
-        if (x_coord >= x_coord_min && x_coord < x_coord_max)
-        {
-          row[ESP32_TX_FIFO_POSITION_ADJUST(x_coord)] &= BITMASK_OE_CLEAR;
-        }
-        else
-        {
-          row[ESP32_TX_FIFO_POSITION_ADJUST(x_coord)] |= BIT_OE; // Disable output after this point.
-        }
+      const int16_t win_min = span_min[colouridx], win_max = span_max[colouridx];
 
-      } while (x_coord);
+      // Each edge range is split at the new window: disabled left of it, enabled inside, disabled right of it
+      for (int edge = 0; edge < 2; ++edge)
+      {
+        int x_coord = edge ? right_from[colouridx] : left_from[colouridx];
+        const int x_end = edge ? right_to[colouridx] : left_to[colouridx];
+        for (; x_coord < std::min<int>(x_end, win_min); ++x_coord)
+          row[ESP32_TX_FIFO_POSITION_ADJUST(x_coord)] |= BIT_OE;           // output disabled left of the window
+        for (; x_coord < std::min<int>(x_end, win_max); ++x_coord)
+          row[ESP32_TX_FIFO_POSITION_ADJUST(x_coord)] &= BITMASK_OE_CLEAR; // output enabled inside the window
+        for (; x_coord < x_end; ++x_coord)
+          row[ESP32_TX_FIFO_POSITION_ADJUST(x_coord)] |= BIT_OE;           // output disabled right of the window
+      }
 
     } while (colouridx);
 
 #if defined(SPIRAM_DMA_BUFFER)
 	// Force the flush and update of the PSRAM for the memory address range of the 'row data' as
 	// data changes probably aren't being sent out via DMA as they're sitting in a hadrware 'cache' 
-    ESP32_I2S_DMA_STORAGE_TYPE *row_ptr = fb->rowBits[row_idx]->getDataPtr(0);
-    Cache_WriteBack_Addr((uint32_t)row_ptr, fb->rowBits[row_idx]->getColorDepthSize(false));
+    ESP32_I2S_DMA_STORAGE_TYPE *row_ptr = fb->getDataPtr(row_idx, 0);
+    Cache_WriteBack_Addr((uint32_t)row_ptr, fb->getColorDepthSize(false));
 #endif
   } while (row_idx);
 }
@@ -833,7 +920,7 @@ void MatrixPanel_I2S_DMA::hlineDMA(int16_t x_coord, int16_t y_coord, int16_t l,
 
     // Get the contents at this address,
     // it would represent a vector pointing to the full row of pixels for the specified colour depth bit at Y coordinate
-    ESP32_I2S_DMA_STORAGE_TYPE *p = fb->rowBits[y_coord]->getDataPtr(colour_depth_idx);
+    ESP32_I2S_DMA_STORAGE_TYPE *p = fb->getDataPtr(y_coord, colour_depth_idx);
     // inlined version works slower here, dunno why :(
     // ESP32_I2S_DMA_STORAGE_TYPE *p = getRowDataPtr(y_coord, colour_depth_idx, back_buffer_id);
 
@@ -941,7 +1028,7 @@ void MatrixPanel_I2S_DMA::vlineDMA(int16_t x_coord, int16_t y_coord, int16_t l,
       // Get the contents at this address,
       // it would represent a vector pointing to the full row of pixels for the specified colour depth bit at Y coordinate
       // ESP32_I2S_DMA_STORAGE_TYPE *p = getRowDataPtr(_y, colour_depth_idx, back_buffer_id);
-      ESP32_I2S_DMA_STORAGE_TYPE *p = fb->rowBits[_y]->getDataPtr(colour_depth_idx);
+      ESP32_I2S_DMA_STORAGE_TYPE *p = fb->getDataPtr(_y, colour_depth_idx);
 
       p[x_coord] &= _colourbitclear; // reset RGB bits
       p[x_coord] |= RGB_output_bits; // set new RGB bits
@@ -11,6 +11,8 @@
 
 // #include <Arduino.h>
 #include "platforms/platform_detect.hpp"
+#include "ESP32-HUB75-Dither.hpp"
+#include "ESP32-HUB75-TimingModel.hpp"
 
 #ifdef USE_GFX_LITE
   // Slimmed version of Adafruit GFX + FastLED: https://github.com/mrcodetastic/GFX_Lite
@@ -126,90 +128,110 @@
 
 /***************************************************************************************/
 
-/** @brief - Structure holds raw DMA data to drive TWO full rows of pixels spanning through all chained modules
- * Note: sizeof(data) must be multiple of 32 bits, as ESP32 DMA linked list buffer address pointer must be word-aligned
+/* Byte alignment of every row inside a contiguous frame buffer.
+ * GDMA bursts from PSRAM need 64 byte aligned payloads, internal SRAM only needs word alignment.
  */
-struct rowBitStruct
+#ifndef DMA_FRAME_ROW_ALIGN
+  #if defined(SPIRAM_DMA_BUFFER)
+    #define DMA_FRAME_ROW_ALIGN 64
+  #else
+    #define DMA_FRAME_ROW_ALIGN 4
+  #endif
+#endif
+
+/***************************************************************************************/
+
 /**
- * @struct rowBitStruct
- * @brief Structure to hold row data for HUB75 matrix panel DMA operations
- * 
- * @var width
- * Width of the row in pixels
- * 
- * @var colour_depth
- * Number of color depths (i.e. copies of each row for each colur bitmask)
- * 
- * @var data
- * Pointer to DMA storage type array holding pixel data for the row
- * 
+ * @struct frameStruct
+ * @brief Raw DMA data for a full frame, held in ONE aligned, contiguous allocation.
+ *
+ * A 'frame' contains ALL the data for a full refresh (i.e. BOTH halves of the panel are
+ * contained in parallel within the one uint16_t that is sent out to the HUB75).
+ *
+ * Layout, in ESP32_I2S_DMA_STORAGE_TYPE words:
+ *
+ *   data[ row * row_stride + colour_depth_idx * plane_stride + x ]
+ *
+ * - plane_stride == width (pixels in a row across all chained modules)
+ * - row_stride   == width * colour_depth, rounded up so each row starts on a
+ *                   DMA_FRAME_ROW_ALIGN byte boundary
+ *
+ * Strides are fixed when the frame is allocated in setupDMA(), so pixel writes are plain
+ * pointer arithmetic (no per-row heap objects or refcounted pointers to chase) and a whole
+ * frame can be copied or cleared with a single memcpy()/memset().
+ *
  * @note Memory allocation differs based on target platform and configuration:
  * - For ESP32-S3 with SPIRAM: Allocates aligned memory in SPIRAM
  * - For other configurations: Allocates DMA-capable internal memory
  */
+struct frameStruct
 {
-  const size_t width;
-  const uint8_t colour_depth;
-  //const bool double_buff;
-  ESP32_I2S_DMA_STORAGE_TYPE *data;
-
-  /** @brief Returns size (in bytes) of a colour depth row data array
-   * 
-   * @param single_color_depth 
+  uint8_t rows = 0;          // number of (parallel) rows held in the frame, i.e. ROWS_PER_FRAME
+  uint16_t width = 0;        // pixels per row across the chain, i.e. PIXELS_PER_ROW
+  uint8_t colour_depth = 0;  // number of colour depth bit planes per row
+  size_t plane_stride = 0;   // words between consecutive colour depth planes of a row
+  size_t row_stride = 0;     // words between consecutive rows (includes alignment padding)
+  size_t size_bytes = 0;     // total bytes of the allocation
+  ESP32_I2S_DMA_STORAGE_TYPE *data = nullptr;
+
+  frameStruct() = default;
+  frameStruct(const frameStruct &) = delete;
+  frameStruct &operator=(const frameStruct &) = delete;
+  ~frameStruct() { release(); }
+
+  /** @brief Returns size (in bytes) of a row's DMA payload
+   *
+   * @param single_color_depth
    *        - if true, returns size for a single color depth layer
-   *        - if false, returns total size for all color depth layers for a row.
-   * 
-   * @returns size_t - Size in bytes required for DMA buffer allocation
-   * 
+   *        - if false, returns total size for all color depth layers for a row (excluding padding).
    */
-  size_t getColorDepthSize(bool single_color_depth)
+  inline size_t getColorDepthSize(bool single_color_depth) const
   {
-    int _cdepth = (single_color_depth) ? 1:colour_depth;
+    int _cdepth = (single_color_depth) ? 1 : colour_depth;
     return width * _cdepth * sizeof(ESP32_I2S_DMA_STORAGE_TYPE);
-  };
+  }
 
+  /** @brief Returns pointer to pixel[0] of colour depth plane _dpth of a row */
+  inline ESP32_I2S_DMA_STORAGE_TYPE *getDataPtr(const uint8_t _row, const uint8_t _dpth = 0) const
+  {
+    return data + (_row * row_stride) + (_dpth * plane_stride);
+  }
 
-  /** @brief
-   * Returns pointer to the row's data vector beginning at pixel[0] for _dpth colour bit
-   * 
-   * NOTE: this call might be very slow in loops. Due to poor instruction caching in esp32 it might be required a reread from flash
-   * every loop cycle, better use inlined #define instead in such cases
+  /** @brief Allocates the whole frame in one aligned block and computes the strides.
+   *  @returns false if the allocation failed (nothing is left allocated in that case)
    */
-  inline ESP32_I2S_DMA_STORAGE_TYPE *getDataPtr(const uint8_t _dpth = 0) { return &(data[_dpth * width]); };
-
-  // constructor - allocates DMA-capable memory to hold the struct data
-  //rowBitStruct(const size_t _width, const uint8_t _depth, const bool _dbuff) : width(_width), colour_depth(_depth), double_buff(_dbuff)
-  rowBitStruct(const size_t _width, const uint8_t _depth) : width(_width), colour_depth(_depth)
+  bool allocate(const uint8_t _rows, const uint16_t _width, const uint8_t _depth)
   {
+    release();
 
-    // #if defined(SPIRAM_FRAMEBUFFER) && defined (CONFIG_IDF_TARGET_ESP32S3)
-#if defined(SPIRAM_DMA_BUFFER)
+    size_t row_bytes = (size_t)_width * _depth * sizeof(ESP32_I2S_DMA_STORAGE_TYPE);
+    row_bytes = (row_bytes + DMA_FRAME_ROW_ALIGN - 1) & ~((size_t)DMA_FRAME_ROW_ALIGN - 1);
 
-    // data = (ESP32_I2S_DMA_STORAGE_TYPE *)heap_caps_aligned_alloc(64, size()+size()*double_buff, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
-    // No longer have double buffer in the same struct - have a different struct
-    data = (ESP32_I2S_DMA_STORAGE_TYPE *)heap_caps_aligned_alloc(64, getColorDepthSize(false), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+#if defined(SPIRAM_DMA_BUFFER)
+    data = (ESP32_I2S_DMA_STORAGE_TYPE *)heap_caps_aligned_alloc(DMA_FRAME_ROW_ALIGN, row_bytes * _rows, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
 #else
-    // data = (ESP32_I2S_DMA_STORAGE_TYPE *)heap_caps_malloc( size()+size()*double_buff, MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
-
-    // No longer have double buffer in the same struct - have a different struct
-    data = (ESP32_I2S_DMA_STORAGE_TYPE *)heap_caps_malloc(getColorDepthSize(false), MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
-
+    data = (ESP32_I2S_DMA_STORAGE_TYPE *)heap_caps_aligned_alloc(DMA_FRAME_ROW_ALIGN, row_bytes * _rows, MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
 #endif
+    if (data == nullptr)
+      return false;
+
+    rows = _rows;
+    width = _width;
+    colour_depth = _depth;
+    plane_stride = _width;
+    row_stride = row_bytes / sizeof(ESP32_I2S_DMA_STORAGE_TYPE);
+    size_bytes = row_bytes * _rows;
+    return true;
   }
-  ~rowBitStruct() { delete data; }
-};
 
-/* frameStruct
- * Note: A 'frameStruct' contains ALL the data for a full-frame (i.e. BOTH 2x16-row frames are
- *       are contained in parallel within the one uint16_t that is sent in parallel to the HUB75).
- *
- *       This structure isn't actually allocated in one memory block anymore, as the library now allocates
- *       memory per row (per rowBits) instead.
- */
-struct frameStruct
-{
-  uint8_t rows = 0; // number of rows held in current frame, not used actually, just to keep the idea of struct
-  std::vector<std::shared_ptr<rowBitStruct>> rowBits;
+  void release()
+  {
+    if (data)
+      heap_caps_free(data);
+    data = nullptr;
+    rows = 0;
+    size_bytes = 0;
+  }
 };
 
 /***************************************************************************************/
@@ -624,6 +646,8 @@ public:
 
   inline void flipDMABuffer()
   {
+    ++dither_phase; // next uploaded frame uses the next temporal dither phase
+
     if (!m_cfg.double_buff)
     {
       return;
@@ -639,8 +663,68 @@ public:
 	
   }
 
+  /**
+   * @brief Waits until the buffer shown before the last flipDMABuffer() is no longer being scanned out,
+   *        so the new back buffer can be drawn into without tearing. Replaces guessed delay() calls.
+   * @param timeout_ms - maximum time to block
+   * @returns true when the flip has completed (or nothing is pending / not double buffered), false on timeout
+   */
+  bool waitForFlip(uint32_t timeout_ms = 100)
+  {
+    if (!initialized || !m_cfg.double_buff)
+      return true;
+
+    return dma_bus.wait_flip_complete(timeout_ms);
+  }
+
+  /**
+   * @brief Registers a callback raised from the DMA end-of-frame interrupt after every full refresh.
+   *        The callback runs in ISR context: it must be IRAM_ATTR and only use ISR-safe calls.
+   *        Pass nullptr to remove it. Only the ESP32-S3 GDMA backend raises vsync events.
+   */
+  void onVsync(hub75_vsync_cb_t cb, void *arg = nullptr) { dma_bus.set_vsync_callback(cb, arg); }
+
+  /** @brief Number of completed frame scans since begin() */
+  uint32_t getVsyncCount() const { return dma_bus.get_vsync_count(); }
+
+  /** @brief Number of flips requested before the previous flip had been scanned out (i.e. likely tearing) */
+  uint32_t getMissedVsyncCount() const { return dma_bus.get_missed_vsync_count(); }
+
+  /** @brief Bytes allocated by begin() for the frame buffer(s) and their DMA descriptors */
+  size_t getDmaMemoryBytes() const
+  {
+    return frame_buffer[0].size_bytes + frame_buffer[1].size_bytes + dma_bus.get_dma_desc_bytes();
+  }
+
+  /**
+   * @brief Copies the frame currently being displayed into the back buffer (double buffering only).
+   *        Useful for incremental drawing on top of the last shown frame after flipDMABuffer().
+   *        Both frames are single contiguous blocks, so this is one memcpy.
+   */
+  void copyFrontToBackBuffer();
+
+  /**
+   * @brief Moves the colour of pixel (src_x, src_y) to (dst_x, dst_y) in the back buffer, all bit planes.
+   *        The bits are copied as they are (no gamma / dither pass) and the control bits stay in place,
+   *        so a region can be scrolled in the frame buffer without redrawing it. Coordinates are electrical.
+   */
+  void movePixelDMA(int16_t src_x, int16_t src_y, int16_t dst_x, int16_t dst_y);
+
+  /**
+   * @brief Enables ordered / temporal dithering of per-pixel writes (drawPixel*, and everything built on it)
+   *        to hide banding when running with fewer colour depth bits than 8.
+   * @param frames - 0 disables, 1 is a static 4x4 ordered dither, 2 or 4 rotate the thresholds over that
+   *        many frames (advanced on every flipDMABuffer(), so content must be redrawn each frame for the
+   *        temporal part to work).
+   * Solid fills (fillScreen, fast h/v lines) are not dithered. Has no effect when built with NO_CIE1931.
+   */
+  void setDither(uint8_t frames) { dither.build(16 - m_cfg.getPixelColorDepthBits(), frames); }
+  uint8_t getDither() const { return dither.frames; }
+
   /**
    * @param uint8_t b - 8-bit brightness value
+   * Only the OE bits that differ from the previous brightness are rewritten; colour data is untouched,
+   * so no repaint is needed and it is cheap enough to call every frame.
    */
   void setBrightness(const uint8_t b)
   {
@@ -819,6 +903,11 @@ private:
    */
   void setBrightnessOE(uint8_t brt, const int _buff_id = 0);
 
+  // OE 'on' window [min, max) last written into each bit plane of each frame buffer, see setBrightnessOE()
+  int16_t oe_span_min[2][PIXEL_COLOR_DEPTH_BITS_MAX] = {};
+  int16_t oe_span_max[2][PIXEL_COLOR_DEPTH_BITS_MAX] = {};
+  bool oe_span_valid[2] = {false, false};
+
   /**
    * @brief - transforms coordinates according to orientation
    * @param x - x position origin
@@ -863,6 +952,28 @@ public:
    */
   int calculated_refresh_rate = 0;
 
+  /** @brief Transition bit chosen by setupDMA() for min_refresh_rate (0 = full BCM weighting for every plane) */
+  int getLsbMsbTransitionBit() const { return lsbMsbTransitionBit; }
+
+  /**
+   * @brief Timing model inputs for a configuration on this platform (transition bit 0).
+   *        Use with hub75_timing_model() / hub75_tune() to predict refresh rate and DMA memory before begin().
+   */
+  static HUB75TimingParams getTimingParams(const HUB75_I2S_CFG &cfg)
+  {
+    HUB75TimingParams p;
+    p.pixels_per_row = cfg.mx_width * cfg.chain_length;
+    p.rows_per_frame = cfg.mx_height / MATRIX_ROWS_IN_PARALLEL;
+    p.clk_hz = cfg.i2sspeed;
+    p.color_depth = cfg.getPixelColorDepthBits();
+    p.double_buff = cfg.double_buff;
+    p.clks_during_latch = CLKS_DURING_LATCH;
+    p.dma_max_bytes = DMA_MAX;
+    p.row_align_bytes = DMA_FRAME_ROW_ALIGN;
+    p.desc_bytes = sizeof(HUB75_DMA_DESCRIPTOR_T);
+    return p;
+  }
+
 protected:
   Bus_Parallel16 dma_bus;
 
@@ -873,10 +984,9 @@ private:
 
   /* Pixel data is organized from LSB to MSB sequentially by row, from row 0 to row matrixHeight/matrixRowsInParallel
    * (two rows of pixels are refreshed in parallel)
-   * Memory is allocated (malloc'd) by the row, and not in one massive chunk, for flexibility.
-   * The whole DMA framebuffer is just a vector of pointers to structs with ESP32_I2S_DMA_STORAGE_TYPE arrays
+   * Each frame is allocated as one contiguous block in setupDMA() and addressed by strides.
    * Since it's dimensions is unknown prior to class initialization, we just declare it here as empty struct and will do all allocations later.
-   * Refer to rowBitStruct to get the idea of it's internal structure
+   * Refer to frameStruct to get the idea of it's internal structure
    */
   frameStruct frame_buffer[2];
   frameStruct *fb; // What framebuffer we are writing pixel changes to? (pointer to either frame_buffer[0] or frame_buffer[1] basically ) used within updateMatrixDMABuffer(...)
@@ -894,6 +1004,9 @@ private:
   uint8_t ROWS_PER_FRAME = m_cfg.mx_height / MATRIX_ROWS_IN_PARALLEL; // RPF - rows per frame, either 16 or 32 depending on matrix module
   uint8_t MASK_OFFSET = 16 - m_cfg.getPixelColorDepthBits();
 
+  DitherTable dither;          // disabled until setDither()
+  uint8_t dither_phase = 0;    // advanced by flipDMABuffer()
+
   // Other private variables
   bool initialized = false;
   bool config_set = false;
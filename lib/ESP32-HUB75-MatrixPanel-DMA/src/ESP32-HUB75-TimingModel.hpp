@@ -0,0 +1,196 @@
+/**
+ * @file ESP32-HUB75-TimingModel.hpp
+ * @brief DMA / BCM timing model and refresh-rate tuner for the HUB75 driver.
+ *
+ * This is the model setupDMA() uses to pick lsbMsbTransitionBit for the requested
+ * min_refresh_rate, pulled out so the same arithmetic can be used to:
+ *  - predict the refresh rate, descriptor count and DMA memory of a configuration
+ *    before allocating anything;
+ *  - sweep clock speed and colour depth (and the resulting transition bit) to find
+ *    the best combination for a target refresh rate (hub75_tune());
+ *  - plan bigger chains offline on a PC (see /testing/timing.cpp).
+ *
+ * Header only and free of ESP-IDF dependencies.
+ *
+ * Model: every row sends all colour depth planes once (bits 0..transition_bit each get
+ * one pass), and every bit above the transition bit is repeated 2^(i - transition_bit - 1)
+ * more times to give it its BCM weight. Each pass shifts out one row of pixels.
+ */
+
+#ifndef ESP32_HUB75_TIMING_MODEL_HPP
+#define ESP32_HUB75_TIMING_MODEL_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+
+struct HUB75TimingParams
+{
+  uint16_t pixels_per_row = 64;     // panel width * chain length
+  uint8_t rows_per_frame = 32;      // panel height / 2 (rows driven in parallel)
+  uint32_t clk_hz = 8000000;        // output clock as configured (HUB75_I2S_CFG::i2sspeed)
+  uint8_t color_depth = 8;          // bit planes stored per row
+  uint8_t transition_bit = 0;       // lsbMsbTransitionBit
+  bool double_buff = false;
+  uint16_t clks_during_latch = 0;   // extra clocks per pass (CLKS_DURING_LATCH)
+  uint16_t dma_max_bytes = 4092;    // largest payload of one DMA descriptor (DMA_MAX)
+  uint8_t row_align_bytes = 4;      // DMA_FRAME_ROW_ALIGN
+  uint8_t desc_bytes = 12;          // sizeof(HUB75_DMA_DESCRIPTOR_T)
+};
+
+struct HUB75TimingResult
+{
+  uint32_t refresh_hz = 0;          // full panel refreshes per second
+  uint32_t descriptors = 0;         // DMA descriptors per frame buffer
+  size_t fb_bytes = 0;              // pixel data, all frame buffers
+  size_t desc_bytes = 0;            // descriptor memory, all frame buffers
+  size_t total_bytes = 0;
+};
+
+/** @brief Refresh rate predicted for one configuration (same arithmetic as setupDMA() Step 1) */
+inline uint32_t hub75_refresh_rate(const HUB75TimingParams &p)
+{
+  uint64_t psPerClock = 1000000000000ULL / p.clk_hz;
+  uint64_t nsPerLatch = ((uint64_t)(p.pixels_per_row + p.clks_during_latch) * psPerClock) / 1000; // time per pass
+
+  // time to shift out LSBs + LSB-MSB transition bit - this ignores fractions...
+  uint64_t nsPerRow = p.color_depth * nsPerLatch;
+
+  // Now add the time for the remaining bit depths
+  for (int i = p.transition_bit + 1; i < p.color_depth; i++)
+    nsPerRow += (1ULL << (i - p.transition_bit - 1)) * nsPerLatch;
+
+  uint64_t nsPerFrame = nsPerRow * p.rows_per_frame;
+  return nsPerFrame ? (uint32_t)(1000000000ULL / nsPerFrame) : 0;
+}
+
+/**
+ * @brief The smallest transition bit whose refresh rate is above min_refresh_hz, as chosen by setupDMA().
+ * @param achieved_hz - optional, receives the refresh rate at the returned bit
+ */
+inline uint8_t hub75_transition_bit(HUB75TimingParams p, uint32_t min_refresh_hz, uint32_t *achieved_hz = nullptr)
+{
+  uint32_t rate;
+  while (1)
+  {
+    rate = hub75_refresh_rate(p);
+
+    if (rate > min_refresh_hz)
+      break;
+
+    if (p.transition_bit < p.color_depth - 1)
+      p.transition_bit++;
+    else
+      break;
+  }
+
+  if (achieved_hz)
+    *achieved_hz = rate;
+  return p.transition_bit;
+}
+
+/** @brief Refresh rate, descriptor count and DMA memory of one configuration */
+inline HUB75TimingResult hub75_timing_model(const HUB75TimingParams &p)
+{
+  HUB75TimingResult r;
+  r.refresh_hz = hub75_refresh_rate(p);
+
+  size_t plane_bytes = (size_t)p.pixels_per_row * 2; // ESP32_I2S_DMA_STORAGE_TYPE is uint16_t
+  size_t row_bytes = plane_bytes * p.color_depth;
+
+  uint32_t descs_1cdepth = (plane_bytes + p.dma_max_bytes - 1) / p.dma_max_bytes;
+  uint32_t descs_per_row = (row_bytes + p.dma_max_bytes - 1) / p.dma_max_bytes;
+  for (int i = p.transition_bit + 1; i < p.color_depth; i++)
+    descs_per_row += (1UL << (i - p.transition_bit - 1)) * descs_1cdepth;
+
+  int buffers = p.double_buff ? 2 : 1;
+  size_t row_stride = (row_bytes + p.row_align_bytes - 1) / p.row_align_bytes * p.row_align_bytes;
+
+  r.descriptors = descs_per_row * p.rows_per_frame;
+  r.fb_bytes = row_stride * p.rows_per_frame * buffers;
+  r.desc_bytes = (size_t)r.descriptors * p.desc_bytes * buffers;
+  r.total_bytes = r.fb_bytes + r.desc_bytes;
+  return r;
+}
+
+/***************************************************************************************/
+
+struct HUB75TunerLimits
+{
+  uint32_t target_refresh_hz = 120;
+  uint8_t min_depth = 4;
+  uint8_t max_depth = 8;
+  const uint32_t *clocks = nullptr;  // candidate output clocks, in order of preference (e.g. most robust first)
+  uint8_t num_clocks = 0;
+  size_t max_memory_bytes = 0;       // 0 = no limit
+};
+
+struct HUB75TunerCandidate
+{
+  uint32_t clk_hz = 0;
+  uint8_t color_depth = 0;
+  uint8_t transition_bit = 0;
+  HUB75TimingResult result;
+  bool feasible = false;
+
+  // Colour depth actually resolved by BCM: planes at or below the transition bit all get the same weight
+  uint8_t effectiveDepth() const { return color_depth - transition_bit; }
+};
+
+/**
+ * @brief Sweeps clock x colour depth; the transition bit for each pair is the one setupDMA() would pick
+ *        for min_refresh_rate = target. Best = feasible, then highest effective depth, then the earliest
+ *        clock in limits.clocks, then the least memory.
+ * @param base        - geometry / platform fields (pixels_per_row, rows_per_frame, double_buff, ...)
+ * @param on_candidate - called for every candidate, e.g. to print the sweep (use the overload below to skip)
+ * @returns true if at least one candidate meets the target refresh rate and memory limit
+ */
+template <typename Callback>
+inline bool hub75_tune(const HUB75TimingParams &base, const HUB75TunerLimits &limits, HUB75TunerCandidate &best, Callback on_candidate)
+{
+  bool found = false;
+  best = HUB75TunerCandidate();
+
+  for (uint8_t c = 0; c < limits.num_clocks; c++)
+  {
+    for (uint8_t depth = limits.max_depth; depth >= limits.min_depth && depth >= 2; depth--)
+    {
+      HUB75TimingParams p = base;
+      p.clk_hz = limits.clocks[c];
+      p.color_depth = depth;
+      p.transition_bit = hub75_transition_bit(p, limits.target_refresh_hz);
+
+      HUB75TunerCandidate cand;
+      cand.clk_hz = p.clk_hz;
+      cand.color_depth = depth;
+      cand.transition_bit = p.transition_bit;
+      cand.result = hub75_timing_model(p);
+      cand.feasible = cand.result.refresh_hz > limits.target_refresh_hz &&
+                      (limits.max_memory_bytes == 0 || cand.result.total_bytes <= limits.max_memory_bytes);
+
+      on_candidate(cand);
+
+      if (!cand.feasible)
+        continue;
+
+      // clocks are walked in order of preference, so an equal depth at a later clock never wins
+      bool better = !found ||
+                    cand.effectiveDepth() > best.effectiveDepth() ||
+                    (cand.effectiveDepth() == best.effectiveDepth() && cand.clk_hz == best.clk_hz &&
+                     cand.result.total_bytes < best.result.total_bytes);
+      if (better)
+      {
+        best = cand;
+        found = true;
+      }
+    }
+  }
+
+  return found;
+}
+
+inline bool hub75_tune(const HUB75TimingParams &base, const HUB75TunerLimits &limits, HUB75TunerCandidate &best)
+{
+  return hub75_tune(base, limits, best, [](const HUB75TunerCandidate &) {});
+}
+
+#endif
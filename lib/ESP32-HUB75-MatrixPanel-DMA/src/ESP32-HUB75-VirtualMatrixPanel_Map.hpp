@@ -0,0 +1,383 @@
+/**
+ * @file ESP32-HUB75-VirtualMatrixPanel_Map.hpp
+ * @brief Chain layout arithmetic shared by VirtualMatrixPanel_T and the host tests.
+ *
+ * Maps a virtual (x,y) on a grid of panels to the (x,y) of the single long chain the
+ * DMA engine drives, for every PANEL_CHAIN_TYPE. VirtualMatrixPanel_T calls it with a
+ * compile-time chain type (so the switch folds away), and with CHAIN_RUNTIME it is used
+ * once per virtual row to build a VirtualRowMap table instead.
+ *
+ * Within one virtual row the chain mapping is always linear in x: every panel of the row
+ * sits in the same stretch of the chain, either right way up (x increasing) or upside down
+ * (x decreasing, y mirrored). So a row is fully described by its electrical y, the
+ * electrical x of virtual x = 0 and a direction of +1 / -1.
+ *
+ * The scan type remapping (ScanTypeMapping), the runtime rotation and the run table used by
+ * VirtualMatrixPanel_T::setRemapTable() live here too.
+ *
+ * Header only and free of ESP-IDF dependencies, see /testing/chain.cpp and /testing/virtual.cpp.
+ */
+
+#ifndef VIRTUAL_MATRIX_PANEL_MAP_H
+#define VIRTUAL_MATRIX_PANEL_MAP_H
+
+#include <stdint.h>
+
+/**
+ * @brief Structure holding virtual/physical coordinate mapping.
+ */
+struct VirtualCoords {
+	int16_t x;
+	int16_t y;
+	int16_t virt_row; // chain of panels row (optional)
+	int16_t virt_col; // chain of panels col (optional)
+	VirtualCoords() : x(0), y(0), virt_row(0), virt_col(0) {}
+};
+
+/**
+ * @brief Panel scan types.
+ *
+ * Defines the different scanning modes.
+ */
+enum PANEL_SCAN_TYPE {
+	STANDARD_TWO_SCAN,
+	FOUR_SCAN_16PX_HIGH,			///< Four-scan mode, 16-pixel high panels.
+	FOUR_SCAN_32PX_HIGH,			///< Four-scan mode, 32-pixel high panels.
+	FOUR_SCAN_40PX_HIGH,			///< Four-scan mode, 40-pixel high panels.
+	FOUR_SCAN_40_80PX_HFARCAN,		///< Four-scan mode, 40-pixel high, 80px wide panel. Weird mapping: https://github.com/mrcodetastic/ESP32-HUB75-MatrixPanel-DMA/issues/759
+	FOUR_SCAN_64PX_HIGH,			///< Four-scan mode, 64-pixel high panels.
+};
+
+/**
+ * @brief Panel chain types.
+ *
+ * Defines the physical chain configuration for multiple panels.
+ */
+enum PANEL_CHAIN_TYPE {
+	CHAIN_NONE,					///< No chaining.
+	CHAIN_TOP_LEFT_DOWN,		///< Chain starting top-left, going down.
+	CHAIN_TOP_RIGHT_DOWN,		///< Chain starting top-right, going down.
+	CHAIN_BOTTOM_LEFT_UP,		///< Chain starting bottom-left, going up.
+	CHAIN_BOTTOM_RIGHT_UP,		///< Chain starting bottom-right, going up.
+	CHAIN_TOP_LEFT_DOWN_ZZ,		///< Zigzag chain starting top-left.
+	CHAIN_TOP_RIGHT_DOWN_ZZ,	///< Zigzag chain starting top-right.
+	CHAIN_BOTTOM_RIGHT_UP_ZZ,	///< Zigzag chain starting bottom-right.
+	CHAIN_BOTTOM_LEFT_UP_ZZ,	///< Zigzag chain starting bottom-left.
+	CHAIN_RUNTIME				///< VirtualMatrixPanel_T only: one of the above, chosen with setChainType().
+};
+
+/**
+ * @brief Chain geometry, as derived by the VirtualMatrixPanel_T constructor.
+ */
+struct VirtualChainGeometry {
+	uint8_t  vmodule_rows;	// virtual module rows
+	uint8_t  vmodule_cols;	// virtual module columns
+	uint8_t  panel_res_x;	// physical panel resolution X
+	uint8_t  panel_res_y;	// physical panel resolution Y
+
+	uint16_t virtualResX() const { return vmodule_cols * panel_res_x; }
+	uint16_t virtualResY() const { return vmodule_rows * panel_res_y; }
+	uint16_t dmaResX() const { return panel_res_x * vmodule_rows * vmodule_cols - 1; } // last x of the chain
+};
+
+/**
+ * @brief Chain mapping of one (already rotated) virtual coordinate. No bounds checks, no scan type remapping.
+ */
+inline VirtualCoords hub75_chain_coords(PANEL_CHAIN_TYPE chain, const VirtualChainGeometry &g, int16_t virt_x, int16_t virt_y)
+{
+	VirtualCoords coords;
+	const int virtual_res_x = g.virtualResX();
+	const int dma_res_x = g.dmaResX();
+
+	int row = virt_y / g.panel_res_y; // 0-indexed row in the virtual module
+	switch (chain) {
+		case CHAIN_TOP_RIGHT_DOWN:
+			if ((row & 1) == 1) {
+				coords.x = dma_res_x - virt_x - (row * virtual_res_x);
+				coords.y = g.panel_res_y - 1 - (virt_y % g.panel_res_y);
+			} else {
+				coords.x = ((g.vmodule_rows - (row + 1)) * virtual_res_x) + virt_x;
+				coords.y = (virt_y % g.panel_res_y);
+			}
+			break;
+
+		case CHAIN_TOP_LEFT_DOWN:
+			if ((row & 1) == 0) {
+				coords.x = dma_res_x - virt_x - (row * virtual_res_x);
+				coords.y = g.panel_res_y - 1 - (virt_y % g.panel_res_y);
+			} else {
+				coords.x = ((g.vmodule_rows - (row + 1)) * virtual_res_x) + virt_x;
+				coords.y = (virt_y % g.panel_res_y);
+			}
+			break;
+
+		case CHAIN_TOP_RIGHT_DOWN_ZZ:
+		case CHAIN_TOP_LEFT_DOWN_ZZ:
+			coords.x = ((g.vmodule_rows - (row + 1)) * virtual_res_x) + virt_x;
+			coords.y = (virt_y % g.panel_res_y);
+			break;
+
+		case CHAIN_BOTTOM_LEFT_UP:
+			row = g.vmodule_rows - row - 1;
+			if ((row & 1) == 1) {
+				coords.x = ((g.vmodule_rows - (row + 1)) * virtual_res_x) + virt_x;
+				coords.y = (virt_y % g.panel_res_y);
+			} else {
+				coords.x = dma_res_x - (row * virtual_res_x) - virt_x;
+				coords.y = g.panel_res_y - 1 - (virt_y % g.panel_res_y);
+			}
+			break;
+
+		case CHAIN_BOTTOM_RIGHT_UP:
+			row = g.vmodule_rows - row - 1;
+			if ((row & 1) == 0) {
+				coords.x = ((g.vmodule_rows - (row + 1)) * virtual_res_x) + virt_x;
+				coords.y = (virt_y % g.panel_res_y);
+			} else {
+				coords.x = dma_res_x - (row * virtual_res_x) - virt_x;
+				coords.y = g.panel_res_y - 1 - (virt_y % g.panel_res_y);
+			}
+			break;
+
+		case CHAIN_BOTTOM_LEFT_UP_ZZ:
+		case CHAIN_BOTTOM_RIGHT_UP_ZZ:
+			row = g.vmodule_rows - row - 1;
+			coords.x = ((g.vmodule_rows - (row + 1)) * virtual_res_x) + virt_x;
+			coords.y = (virt_y % g.panel_res_y);
+			break;
+
+		default: // CHAIN_NONE
+			coords.x = virt_x;
+			coords.y = virt_y;
+			break;
+	}
+
+	return coords;
+}
+
+// ----------------------------------------------------------------------
+// Default Scan Rate Policy
+/**
+ * @brief Default policy for scan type mapping.
+ *
+ * This templated policy implements the static function apply() to remap
+ * coordinates according to the panel scan type. It uses the panel's pixel base
+ * to calculate offsets.
+ *
+ * @tparam Type The compile-time scan type (of type PANEL_SCAN_TYPE).
+ */
+template <PANEL_SCAN_TYPE ScanType>
+struct ScanTypeMapping {
+	static constexpr VirtualCoords apply(VirtualCoords coords, int panel_pixel_base) 
+	{
+		//log_v("ScanTypeMapping: coords.x: %d, coords.y: %d, virt_y: %d, pixel_base: %d", coords.x, coords.y, virt_y, panel_pixel_base);
+
+		// FOUR_SCAN_16PX_HIGH
+		if constexpr (ScanType == FOUR_SCAN_16PX_HIGH) 
+		{
+			if ((coords.y & 4) == 0) {
+				coords.x += (((coords.x / panel_pixel_base) + 1) * panel_pixel_base);
+			} else {
+				coords.x += ((coords.x / panel_pixel_base) * panel_pixel_base);
+			}
+			
+			coords.y = (coords.y >> 3) * 4 + (coords.y & 0b00000011);
+		}
+		// FOUR_SCAN_40PX_HIGH
+		else if constexpr (ScanType == FOUR_SCAN_40PX_HIGH) 
+		{
+			
+			if (((coords.y) / 10) % 2 == 0) {				
+				coords.x += (((coords.x / panel_pixel_base) + 1) * panel_pixel_base);
+			} else {
+				coords.x += ((coords.x / panel_pixel_base) * panel_pixel_base);
+			}
+			coords.y = (coords.y / 20) * 10 + (coords.y % 10);
+		}
+		else if constexpr (ScanType == FOUR_SCAN_40_80PX_HFARCAN) 
+		{
+			//  Weird mapping: https://github.com/mrcodetastic/ESP32-HUB75-MatrixPanel-DMA/issues/759
+			panel_pixel_base = 16;
+
+            // Mapping logic
+            int panel_local_x = coords.x % 80; // Compensate for chain of panels
+
+            if ((((coords.y) / 10) % 2) ^ ((panel_local_x / panel_pixel_base) % 2)) {
+                coords.x += ((coords.x / panel_pixel_base) * panel_pixel_base);
+            } else {
+                coords.x += (((coords.x / panel_pixel_base) + 1) * panel_pixel_base);
+            }
+
+            coords.y = (coords.y % 10) + 10 * ((coords.y / 20) % 2);
+			
+		}		
+		//	FOUR_SCAN_64PX_HIGH || FOUR_SCAN_32PX_HIGH
+		else if constexpr (ScanType == FOUR_SCAN_64PX_HIGH || ScanType == FOUR_SCAN_32PX_HIGH) 
+		{
+			if constexpr (ScanType == FOUR_SCAN_64PX_HIGH) {
+				// As in the original code (with extra remapping for 64px high panels)
+				if ((coords.y & 8) != ((coords.y & 16) >> 1)) {
+					coords.y = (((coords.y & 0b11000) ^ 0b11000) + (coords.y & 0b11100111));
+				}
+			}
+
+			if ((coords.y & 8) == 0) {
+				coords.x += (((coords.x / panel_pixel_base) + 1) * panel_pixel_base);
+			} else {
+				coords.x += ((coords.x / panel_pixel_base) * panel_pixel_base);
+			}
+			
+			coords.y = (coords.y >> 4) * 8 + (coords.y & 0b00000111);
+		}
+
+		// For STANDARD_TWO_SCAN / NORMAL_ONE_SIXTEEN no remapping is done.
+		return coords;
+	}
+};
+
+/**
+ * @brief Runtime rotation (0..3) of a coordinate on the rotated (width x height as drawn) canvas
+ *        back to the unrotated virtual_res_x x virtual_res_y canvas.
+ */
+inline void hub75_rotate(uint8_t rotate, uint16_t virtual_res_x, uint16_t virtual_res_y, int16_t &virt_x, int16_t &virt_y)
+{
+	switch (rotate) {
+		case 1: {
+			int16_t temp = virt_x;
+			virt_x = virt_y;
+			virt_y = virtual_res_y - 1 - temp;
+			break;
+		}
+		case 2: {
+			virt_x = virtual_res_x - 1 - virt_x;
+			virt_y = virtual_res_y - 1 - virt_y;
+			break;
+		}
+		case 3: {
+			int16_t temp = virt_x;
+			virt_x = virtual_res_x - 1 - virt_y;
+			virt_y = temp;
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+/**
+ * @brief Chain mapping of one virtual row: electrical x = x0 + dir * virt_x, electrical y = y.
+ */
+struct VirtualRowMap {
+	int16_t x0;
+	int16_t y;
+	int8_t  dir;
+};
+
+/**
+ * @brief Fills rows[0 .. virtualResY - 1] with the row descriptors of a chain type.
+ */
+inline void hub75_build_row_map(PANEL_CHAIN_TYPE chain, const VirtualChainGeometry &g, VirtualRowMap *rows)
+{
+	for (int y = 0; y < g.virtualResY(); y++)
+	{
+		VirtualCoords c0 = hub75_chain_coords(chain, g, 0, y);
+		VirtualCoords c1 = hub75_chain_coords(chain, g, 1, y);
+
+		rows[y].x0 = c0.x;
+		rows[y].y = c0.y;
+		rows[y].dir = (c1.x < c0.x) ? -1 : 1;
+	}
+}
+
+/***************************************************************************************/
+
+/**
+ * @brief One contiguous electrical run of a virtual row: virtual x = vx .. vx + len - 1 lands on
+ *        electrical (x + i * dx, y + i * dy), with exactly one of dx / dy being +1 or -1.
+ *
+ * Used by VirtualMatrixPanel_T::setRemapTable(). With rotation, chain and scan type folded in,
+ * a virtual row is a handful of such runs (one per panel for a plain chain, one per pixel_base
+ * block for four-scan panels), so the whole table is a few hundred bytes, and a horizontal span
+ * becomes one hlineDMA / vlineDMA per run.
+ */
+struct VirtualRun {
+	int16_t vx;		// first virtual x of the run
+	int16_t len;	// pixels
+	int16_t x;		// electrical x of vx
+	int16_t y;		// electrical y of vx
+	int8_t  dx;		// electrical step per virtual x
+	int8_t  dy;
+};
+
+/**
+ * @brief Splits every virtual row into the fewest contiguous electrical runs.
+ * @param map		- (virt_x, virt_y) -> electrical VirtualCoords, i.e. the full arithmetic path
+ * @param runs		- nullptr to only count, else receives the runs, row by row
+ * @param row_first	- nullptr to only count, else height + 1 entries: runs of row y are
+ *					  [row_first[y], row_first[y + 1])
+ * @returns number of runs
+ *
+ * Greedy extension is minimal here: any part of a unit-step run is itself a unit-step run.
+ */
+template <typename MapFn>
+inline uint32_t hub75_build_runs(uint16_t width, uint16_t height, MapFn map, VirtualRun *runs, uint16_t *row_first)
+{
+	uint32_t n = 0;
+	for (int y = 0; y < height; y++)
+	{
+		if (row_first)
+			row_first[y] = n;
+
+		int x = 0;
+		while (x < width)
+		{
+			VirtualCoords c0 = map(x, y);
+			VirtualRun r = {(int16_t)x, 1, c0.x, c0.y, 1, 0};
+
+			if (x + 1 < width)
+			{
+				VirtualCoords c1 = map(x + 1, y);
+				int ddx = c1.x - c0.x, ddy = c1.y - c0.y;
+				if ((ddy == 0 && (ddx == 1 || ddx == -1)) || (ddx == 0 && (ddy == 1 || ddy == -1)))
+				{
+					r.dx = ddx;
+					r.dy = ddy;
+					while (x + r.len < width)
+					{
+						VirtualCoords c = map(x + r.len, y);
+						if (c.x != r.x + r.len * r.dx || c.y != r.y + r.len * r.dy)
+							break;
+						r.len++;
+					}
+				}
+			}
+
+			if (runs)
+				runs[n] = r;
+			n++;
+			x += r.len;
+		}
+	}
+	if (row_first)
+		row_first[height] = n;
+	return n;
+}
+
+/**
+ * @brief The run of row y holding virtual x (binary search, rows rarely have more than a few runs).
+ */
+inline const VirtualRun &hub75_find_run(const VirtualRun *runs, const uint16_t *row_first, int16_t x, int16_t y)
+{
+	uint16_t lo = row_first[y], hi = row_first[y + 1] - 1;
+	while (lo < hi)
+	{
+		uint16_t mid = (lo + hi + 1) >> 1;
+		if (runs[mid].vx <= x)
+			lo = mid;
+		else
+			hi = mid - 1;
+	}
+	return runs[lo];
+}
+
+#endif	// VIRTUAL_MATRIX_PANEL_MAP_H
@@ -8,6 +8,14 @@
  *	 - Scan type mapping (via a class, default is STANDARD_TWO_SCAN)
  *	 - A compile‐time scale factor (each virtual pixel is drawn as a block)
  *
+ * With ChainType = CHAIN_RUNTIME the chain layout is instead picked at runtime with
+ * setChainType(), and is mapped through a per-row table (VirtualRowMap) built at that point.
+ *
+ * Optionally (setRemapTable(true)) rotation, chain and scan type are all folded into a table of
+ * contiguous electrical runs per virtual row (VirtualRun), rebuilt by setDisplay(), setRotation(),
+ * setChainType() and setPixelBase(). drawPixel() is then a table lookup, and drawFastHLine() /
+ * fillRect() write each run with one hlineDMA / vlineDMA of the underlying driver.
+ *
  * Runtime rotation is supported via setRotation(). Depending on the build options,
  * the class conditionally inherits from Adafruit_GFX, GFX_Lite, or stands alone.
  * 
@@ -35,7 +43,9 @@
 #define VIRTUAL_MATRIX_PANEL_TEMPLATE_H
 
 //#include <cstdint>
+#include <new>
 #include "ESP32-HUB75-MatrixPanel-I2S-DMA.h"
+#include "ESP32-HUB75-VirtualMatrixPanel_Map.hpp"
 
 #ifdef USE_GFX_LITE
   #include "GFX_Lite.h"
@@ -43,131 +53,6 @@
   #include "Adafruit_GFX.h"
 #endif
 
-// ----------------------------------------------------------------------
-// Data structures and enums
-
-/**
- * @brief Structure holding virtual/physical coordinate mapping.
- */
-struct VirtualCoords {
-	int16_t x;
-	int16_t y;
-	int16_t virt_row; // chain of panels row (optional)
-	int16_t virt_col; // chain of panels col (optional)
-	VirtualCoords() : x(0), y(0), virt_row(0), virt_col(0) {}
-};
-
-/**
- * @brief Panel scan types.
- *
- * Defines the different scanning modes.
- */
-enum PANEL_SCAN_TYPE {
-	STANDARD_TWO_SCAN,
-	FOUR_SCAN_16PX_HIGH,			///< Four-scan mode, 16-pixel high panels.
-	FOUR_SCAN_32PX_HIGH,			///< Four-scan mode, 32-pixel high panels.
-	FOUR_SCAN_40PX_HIGH,			///< Four-scan mode, 40-pixel high panels.	
-	FOUR_SCAN_40_80PX_HFARCAN,		///< Four-scan mode, 40-pixel high, 80px wide panel. Weird mapping: https://github.com/mrcodetastic/ESP32-HUB75-MatrixPanel-DMA/issues/759
-	FOUR_SCAN_64PX_HIGH,			///< Four-scan mode, 64-pixel high panels.
-};
-
-/**
- * @brief Panel chain types.
- *
- * Defines the physical chain configuration for multiple panels.
- */
-enum PANEL_CHAIN_TYPE {
-	CHAIN_NONE,					///< No chaining.
-	CHAIN_TOP_LEFT_DOWN,		///< Chain starting top-left, going down.
-	CHAIN_TOP_RIGHT_DOWN,		///< Chain starting top-right, going down.
-	CHAIN_BOTTOM_LEFT_UP,		///< Chain starting bottom-left, going up.
-	CHAIN_BOTTOM_RIGHT_UP,		///< Chain starting bottom-right, going up.
-	CHAIN_TOP_LEFT_DOWN_ZZ,		///< Zigzag chain starting top-left.
-	CHAIN_TOP_RIGHT_DOWN_ZZ,	///< Zigzag chain starting top-right.
-	CHAIN_BOTTOM_RIGHT_UP_ZZ,	///< Zigzag chain starting bottom-right.
-	CHAIN_BOTTOM_LEFT_UP_ZZ		///< Zigzag chain starting bottom-left.
-};
-
-// ----------------------------------------------------------------------
-// Default Scan Rate Policy
-/**
- * @brief Default policy for scan type mapping.
- *
- * This templated policy implements the static function apply() to remap
- * coordinates according to the panel scan type. It uses the panel's pixel base
- * to calculate offsets.
- *
- * @tparam Type The compile-time scan type (of type PANEL_SCAN_TYPE).
- */
-template <PANEL_SCAN_TYPE ScanType>
-struct ScanTypeMapping {
-	static constexpr VirtualCoords apply(VirtualCoords coords, int panel_pixel_base) 
-	{
-		//log_v("ScanTypeMapping: coords.x: %d, coords.y: %d, virt_y: %d, pixel_base: %d", coords.x, coords.y, virt_y, panel_pixel_base);
-
-		// FOUR_SCAN_16PX_HIGH
-		if constexpr (ScanType == FOUR_SCAN_16PX_HIGH) 
-		{
-			if ((coords.y & 4) == 0) {
-				coords.x += (((coords.x / panel_pixel_base) + 1) * panel_pixel_base);
-			} else {
-				coords.x += ((coords.x / panel_pixel_base) * panel_pixel_base);
-			}
-			
-			coords.y = (coords.y >> 3) * 4 + (coords.y & 0b00000011);
-		}
-		// FOUR_SCAN_40PX_HIGH
-		else if constexpr (ScanType == FOUR_SCAN_40PX_HIGH) 
-		{
-			
-			if (((coords.y) / 10) % 2 == 0) {				
-				coords.x += (((coords.x / panel_pixel_base) + 1) * panel_pixel_base);
-			} else {
-				coords.x += ((coords.x / panel_pixel_base) * panel_pixel_base);
-			}
-			coords.y = (coords.y / 20) * 10 + (coords.y % 10);
-		}
-		else if constexpr (ScanType == FOUR_SCAN_40_80PX_HFARCAN) 
-		{
-			//  Weird mapping: https://github.com/mrcodetastic/ESP32-HUB75-MatrixPanel-DMA/issues/759
-			panel_pixel_base = 16;
-
-            // Mapping logic
-            int panel_local_x = coords.x % 80; // Compensate for chain of panels
-
-            if ((((coords.y) / 10) % 2) ^ ((panel_local_x / panel_pixel_base) % 2)) {
-                coords.x += ((coords.x / panel_pixel_base) * panel_pixel_base);
-            } else {
-                coords.x += (((coords.x / panel_pixel_base) + 1) * panel_pixel_base);
-            }
-
-            coords.y = (coords.y % 10) + 10 * ((coords.y / 20) % 2);
-			
-		}		
-		//	FOUR_SCAN_64PX_HIGH || FOUR_SCAN_32PX_HIGH
-		else if constexpr (ScanType == FOUR_SCAN_64PX_HIGH || ScanType == FOUR_SCAN_32PX_HIGH) 
-		{
-			if constexpr (ScanType == FOUR_SCAN_64PX_HIGH) {
-				// As in the original code (with extra remapping for 64px high panels)
-				if ((coords.y & 8) != ((coords.y & 16) >> 1)) {
-					coords.y = (((coords.y & 0b11000) ^ 0b11000) + (coords.y & 0b11100111));
-				}
-			}
-
-			if ((coords.y & 8) == 0) {
-				coords.x += (((coords.x / panel_pixel_base) + 1) * panel_pixel_base);
-			} else {
-				coords.x += ((coords.x / panel_pixel_base) * panel_pixel_base);
-			}
-			
-			coords.y = (coords.y >> 4) * 8 + (coords.y & 0b00000111);
-		}
-
-		// For STANDARD_TWO_SCAN / NORMAL_ONE_SIXTEEN no remapping is done.
-		return coords;
-	}
-};
-
 // ----------------------------------------------------------------------
 // VirtualMatrixPanel_T Declaration
 //
@@ -222,6 +107,39 @@ public:
 	{
 		// Initialize with an invalid coordinate.
 		coords.x = coords.y = -1;
+
+		if constexpr (ChainScanType == CHAIN_RUNTIME) {
+			row_map = new VirtualRowMap[virtual_res_y];
+			setChainType(CHAIN_NONE);
+		}
+	}
+
+	~VirtualMatrixPanel_T() {
+		delete[] row_map;
+		freeRemapTable();
+	}
+
+	VirtualMatrixPanel_T(const VirtualMatrixPanel_T &) = delete;
+	VirtualMatrixPanel_T &operator=(const VirtualMatrixPanel_T &) = delete;
+
+	// ------------------------------------------------------------------
+	// Chain layout (CHAIN_RUNTIME only). Rebuilds the per-row map; any other
+	// chain type is fixed by the template parameter and this is ignored.
+	inline void setChainType(PANEL_CHAIN_TYPE chain_type) {
+		if constexpr (ChainScanType == CHAIN_RUNTIME) {
+			if (chain_type == CHAIN_RUNTIME)
+				chain_type = CHAIN_NONE;
+			runtime_chain_type = chain_type;
+			hub75_build_row_map(chain_type, geometry(), row_map);
+			buildRemapTable();
+		}
+	}
+
+	inline PANEL_CHAIN_TYPE getChainType() const {
+		if constexpr (ChainScanType == CHAIN_RUNTIME)
+			return runtime_chain_type;
+		else
+			return ChainScanType;
 	}
 
 	// ------------------------------------------------------------------
@@ -249,6 +167,28 @@ public:
 		log_v("x: %d, y: %d -> coords.x: %d, coords.y: %d", x, y, coords.x, coords.y);
 	}
 
+	// Horizontal span: with the remap table, one driver line per electrical run, else per pixel
+	void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+		if (!remap_runs || ScaleFactor > 1) {
+			// qualified: a derived drawPixel() may remap x again
+			for (int16_t i = 0; i < w; i++)
+				VirtualMatrixPanel_T::drawPixel(x + i, y, color);
+			return;
+		}
+
+		forEachRun(x, y, w, [&](const VirtualRun &r) {
+			if (r.dy == 0)
+				display->drawFastHLine(r.dx > 0 ? r.x : r.x - r.len + 1, r.y, r.len, color);
+			else
+				display->drawFastVLine(r.x, r.dy > 0 ? r.y : r.y - r.len + 1, r.len, color);
+		});
+	}
+
+	void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+		for (int16_t row = y; row < y + h; row++)
+			drawFastHLine(x, row, w, color);
+	}
+
 	inline void fillScreen(uint16_t color) {
 		display->fillScreen(color);
 	}
@@ -336,33 +276,76 @@ public:
 	inline void setRotation(uint8_t rotate) {
 		if (rotate < 4)
 			_rotate = rotate;
-#ifdef NO_GFX
-		// When NO_GFX is defined, update _virtual_res_x/_virtual_res_y as needed.
-#else
+
 		uint8_t rotation = (rotate & 3);
 		switch (rotation) {
 			case 0:
 			case 2:
 				_virtual_res_x = virtual_res_x;
 				_virtual_res_y = virtual_res_y;
-				_width = virtual_res_x;
-				_height = virtual_res_y;
 				break;
 			case 1:
 			case 3:
 				_virtual_res_x = virtual_res_y;
 				_virtual_res_y = virtual_res_x;
-				_width = virtual_res_y;
-				_height = virtual_res_x;
 				break;
 		}
+#ifndef NO_GFX
+		_width = _virtual_res_x;
+		_height = _virtual_res_y;
 #endif
+		buildRemapTable();
 	}
 
 	// ------------------------------------------------------------------
 	// Panel scan–type configuration (runtime adjustment of pixel base)
 	inline void setPixelBase(uint8_t pixel_base) {
 		panel_pixel_base = pixel_base;
+		buildRemapTable();
+	}
+
+	// ------------------------------------------------------------------
+	// Remap table (opt-in): virtual row -> contiguous electrical runs, see VirtualRun.
+	// Costs sizeof(VirtualRun) per run plus 2 bytes per row; returns false if it could not be allocated
+	// (drawing then keeps using the arithmetic path).
+	inline bool setRemapTable(bool enable) {
+		remap_enabled = enable;
+		if (!enable) {
+			freeRemapTable();
+			return true;
+		}
+		buildRemapTable();
+		return remap_runs != nullptr;
+	}
+
+	inline bool hasRemapTable() const { return remap_runs != nullptr; }
+	inline size_t remapTableBytes() const {
+		return remap_runs ? remap_run_count * sizeof(VirtualRun) + (_virtual_res_y + 1) * sizeof(uint16_t) : 0;
+	}
+
+	// Calls fn(const VirtualRun &) for the electrical runs covering virtual x .. x + w - 1 of row y,
+	// clipped to the display and to the span. Requires the remap table (does nothing without it).
+	template <typename Fn>
+	void forEachRun(int16_t x, int16_t y, int16_t w, Fn fn) const {
+		if (!remap_runs || y < 0 || y >= _virtual_res_y)
+			return;
+		if (x < 0) { w += x; x = 0; }
+		if (x + w > _virtual_res_x) w = _virtual_res_x - x;
+		if (w <= 0)
+			return;
+
+		const int16_t end = x + w;
+		const VirtualRun *r = &hub75_find_run(remap_runs, remap_row_first, x, y);
+		const VirtualRun *last = remap_runs + remap_row_first[y + 1];
+		for (; r < last && r->vx < end; r++) {
+			int16_t from = r->vx > x ? r->vx : x;
+			int16_t to = r->vx + r->len < end ? r->vx + r->len : end;
+			int16_t skip = from - r->vx;
+
+			VirtualRun piece = {from, (int16_t)(to - from),
+								(int16_t)(r->x + skip * r->dx), (int16_t)(r->y + skip * r->dy), r->dx, r->dy};
+			fn(piece);
+		}
 	}
 
 	// ------------------------------------------------------------------
@@ -380,99 +363,39 @@ public:
 			//return coords;
 		}
 
+		if (remap_runs) {
+			const VirtualRun &r = hub75_find_run(remap_runs, remap_row_first, virt_x, virt_y);
+			int16_t i = virt_x - r.vx;
+			coords.x = r.x + i * r.dx;
+			coords.y = r.y + i * r.dy;
+			return;
+		}
+
+		coords = mapCoords(virt_x, virt_y);
+	}
+
+	// Arithmetic path: rotation, chain mapping and scan type. No bounds checks.
+	VirtualCoords mapCoords(int16_t virt_x, int16_t virt_y) const {
+		VirtualCoords coords;
+
 		//log_d("calcCoords pre-chain: virt_x: %d, virt_y: %d", virt_x, virt_y);
 
 		// --- Runtime rotation ---
-		switch (_rotate) {
-			case 1: {
-				int16_t temp = virt_x;
-				virt_x = virt_y;
-				virt_y = virtual_res_y - 1 - temp;
-				break;
-			}
-			case 2: {
-				virt_x = virtual_res_x - 1 - virt_x;
-				virt_y = virtual_res_y - 1 - virt_y;
-				break;
-			}
-			case 3: {
-				int16_t temp = virt_x;
-				virt_x = virtual_res_x - 1 - virt_y;
-				virt_y = temp;
-				break;
-			}
-			default:
-				break;
-		}
+		hub75_rotate(_rotate, virtual_res_x, virtual_res_y, virt_x, virt_y);
 
 		// --- Chain mapping ---
-		int row = virt_y / panel_res_y; // 0-indexed row in the virtual module
-		if constexpr (ChainScanType == CHAIN_TOP_RIGHT_DOWN) {
-			if ((row & 1) == 1) {
-				coords.x = dma_res_x - virt_x - (row * virtual_res_x);
-				coords.y = panel_res_y - 1 - (virt_y % panel_res_y);
-			} else {
-				coords.x = ((vmodule_rows - (row + 1)) * virtual_res_x) + virt_x;
-				coords.y = (virt_y % panel_res_y);
-			}
-		}
-		else if constexpr (ChainScanType == CHAIN_TOP_RIGHT_DOWN_ZZ) {
-			coords.x = ((vmodule_rows - (row + 1)) * virtual_res_x) + virt_x;
-			coords.y = (virt_y % panel_res_y);
-		}
-		else if constexpr (ChainScanType == CHAIN_TOP_LEFT_DOWN) {
-			if ((row & 1) == 0) {
-				coords.x = dma_res_x - virt_x - (row * virtual_res_x);
-				coords.y = panel_res_y - 1 - (virt_y % panel_res_y);
-			} else {
-				coords.x = ((vmodule_rows - (row + 1)) * virtual_res_x) + virt_x;
-				coords.y = (virt_y % panel_res_y);
-			}
-		}
-		else if constexpr (ChainScanType == CHAIN_TOP_LEFT_DOWN_ZZ) {
-			coords.x = ((vmodule_rows - (row + 1)) * virtual_res_x) + virt_x;
-			coords.y = (virt_y % panel_res_y);
-		}
-		else if constexpr (ChainScanType == CHAIN_BOTTOM_LEFT_UP) {
-			row = vmodule_rows - row - 1;
-			if ((row & 1) == 1) {
-				coords.x = ((vmodule_rows - (row + 1)) * virtual_res_x) + virt_x;
-				coords.y = (virt_y % panel_res_y);
-			} else {
-				coords.x = dma_res_x - (row * virtual_res_x) - virt_x;
-				coords.y = panel_res_y - 1 - (virt_y % panel_res_y);
-			}
-		}
-		else if constexpr (ChainScanType == CHAIN_BOTTOM_LEFT_UP_ZZ) {
-			row = vmodule_rows - row - 1;
-			coords.x = ((vmodule_rows - (row + 1)) * virtual_res_x) + virt_x;
-			coords.y = (virt_y % panel_res_y);
-		}
-		else if constexpr (ChainScanType == CHAIN_BOTTOM_RIGHT_UP) {
-			row = vmodule_rows - row - 1;
-			if ((row & 1) == 0) {
-				coords.x = ((vmodule_rows - (row + 1)) * virtual_res_x) + virt_x;
-				coords.y = (virt_y % panel_res_y);
-			} else {
-				coords.x = dma_res_x - (row * virtual_res_x) - virt_x;
-				coords.y = panel_res_y - 1 - (virt_y % panel_res_y);
-			}
-		}
-		else if constexpr (ChainScanType == CHAIN_BOTTOM_RIGHT_UP_ZZ) {
-			row = vmodule_rows - row - 1;
-			coords.x = ((vmodule_rows - (row + 1)) * virtual_res_x) + virt_x;
-			coords.y = (virt_y % panel_res_y);
-		}
-		else { // CHAIN_NONE (default)
-			coords.x = virt_x;
-			coords.y = virt_y;
+		if constexpr (ChainScanType == CHAIN_RUNTIME) {
+			const VirtualRowMap &r = row_map[virt_y];
+			coords.x = r.x0 + r.dir * virt_x;
+			coords.y = r.y;
+		} else {
+			coords = hub75_chain_coords(ChainScanType, geometry(), virt_x, virt_y);
 		}
 
 		//log_d("calcCoords post-chain: virt_x: %d, virt_y: %d", virt_x, virt_y);  
 
 		// --- Apply physical LED panel scan–type mapping / fix ---
-		coords = ScanTypeMapping::apply(coords, panel_pixel_base);
-
+		return ScanTypeMapping::apply(coords, panel_pixel_base);
 	}
 
 #ifdef NO_GFX
@@ -490,9 +413,39 @@ public:
 
 	inline void setDisplay(MatrixPanel_I2S_DMA &disp) {
 		display = &disp;
+		buildRemapTable();
 	}
 
 private:
+	void buildRemapTable() {
+		freeRemapTable();
+		if (!remap_enabled)
+			return;
+
+		auto map = [this](int16_t x, int16_t y) { return mapCoords(x, y); };
+		uint32_t n = hub75_build_runs(_virtual_res_x, _virtual_res_y, map, nullptr, nullptr);
+
+		remap_runs = new (std::nothrow) VirtualRun[n];
+		remap_row_first = new (std::nothrow) uint16_t[_virtual_res_y + 1];
+		if (!remap_runs || !remap_row_first) {
+			freeRemapTable();
+			return;
+		}
+		remap_run_count = hub75_build_runs(_virtual_res_x, _virtual_res_y, map, remap_runs, remap_row_first);
+	}
+
+	void freeRemapTable() {
+		delete[] remap_runs;
+		delete[] remap_row_first;
+		remap_runs = nullptr;
+		remap_row_first = nullptr;
+		remap_run_count = 0;
+	}
+
+	inline VirtualChainGeometry geometry() const {
+		return VirtualChainGeometry{vmodule_rows, vmodule_cols, panel_res_x, panel_res_y};
+	}
+
 	MatrixPanel_I2S_DMA *display;
 	// Note: panel_chain_type is now fixed via the compile–time template parameter 'ChainScanType'.
 	uint16_t virtual_res_x;	   // virtual display width (combination of panels)
@@ -504,6 +457,14 @@ private:
 	uint16_t dma_res_x;		   // width as seen by the DMA engine
 
 	int _rotate;			 // runtime rotation (0 to 3)
+
+	PANEL_CHAIN_TYPE runtime_chain_type = CHAIN_NONE; // CHAIN_RUNTIME only
+	VirtualRowMap *row_map = nullptr;	 // CHAIN_RUNTIME only: chain mapping per (rotated) virtual row
+
+	bool remap_enabled = false;			 // setRemapTable()
+	VirtualRun *remap_runs = nullptr;	 // runs of all virtual rows, as drawn (after rotation)
+	uint16_t *remap_row_first = nullptr; // _virtual_res_y + 1 entries, index of each row's first run
+	uint32_t remap_run_count = 0;
 };
 
 #endif	// VIRTUAL_MATRIX_PANEL_TEMPLATE_H
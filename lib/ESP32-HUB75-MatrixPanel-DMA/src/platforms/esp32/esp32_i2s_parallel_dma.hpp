@@ -52,6 +52,9 @@ Contributors:
 // The type used for this SoC
 #define HUB75_DMA_DESCRIPTOR_T lldesc_t
 
+// Called once per completed frame scan on backends that support it. Must be IRAM_ATTR and ISR-safe.
+typedef void (*hub75_vsync_cb_t)(void *arg);
+
 
 #if defined (CONFIG_IDF_TARGET_ESP32S2)   
 #define ESP32_I2S_DEVICE I2S_NUM_0	
@@ -123,6 +126,15 @@ i2s_dev_t* getDev();
     void dma_transfer_stop();
 
     void flip_dma_output_buffer(int buffer_id);
+
+    // No EOF interrupt is wired up on the I2S backend (see the disabled i2s_isr), so flips are
+    // reported as complete immediately and no vsync callbacks are raised.
+    bool wait_flip_complete(uint32_t timeout_ms) { return true; }
+    void set_vsync_callback(hub75_vsync_cb_t cb, void *arg) { }
+    uint32_t get_vsync_count() const { return 0; }
+    uint32_t get_missed_vsync_count() const { return 0; }
+
+    size_t get_dma_desc_bytes() const { return sizeof(HUB75_DMA_DESCRIPTOR_T) * _dmadesc_count * (_dmadesc_b ? 2 : 1); }
   
   private:
 
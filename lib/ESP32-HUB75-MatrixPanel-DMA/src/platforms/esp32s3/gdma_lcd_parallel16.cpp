@@ -28,31 +28,28 @@
   #include "esp_attr.h"
   #include "esp_idf_version.h"
 
-/*
-  DRAM_ATTR volatile bool previousBufferFree = true;
- 
-  // End-of-DMA-transfer callback
-  IRAM_ATTR bool gdma_on_trans_eof_callback(gdma_channel_handle_t dma_chan,
+  // End-of-frame callback. The last descriptor of each chain has suc_eof set, so this fires once
+  // for every complete scan of the frame. The chain has already followed the 'next' pointer that
+  // flip_dma_output_buffer() relinked, so a pending flip is now done and the old buffer is free.
+  IRAM_ATTR bool Bus_Parallel16::on_trans_eof(gdma_channel_handle_t dma_chan,
                                     gdma_event_data_t *event_data, void *user_data) {
-                                        
-  // This DMA callback seems to trigger a moment before the last data has
-  // issued (buffering between DMA & LCD peripheral?), so pause a moment
-  // before stopping LCD data out. The ideal delay may depend on the LCD
-  // clock rate...this one was determined empirically by monitoring on a
-  // logic analyzer. YMMV.
-    esp_rom_delay_us(100);        
-  // The LCD peripheral stops transmitting at the end of the DMA xfer, but
-  // clear the lcd_start flag anyway -- we poll it in loop() to decide when
-  // the transfer has finished, and the same flag is set later to trigger
-  // the next transfer.
-
-    //LCD_CAM.lcd_user.lcd_start = 0;
-    
-    previousBufferFree = true;
-    
-    return true;
-  }  
-*/  
+
+    Bus_Parallel16 *bus = (Bus_Parallel16 *)user_data;
+    BaseType_t need_yield = pdFALSE;
+
+    bus->_vsync_count = bus->_vsync_count + 1;
+
+    if (bus->_flip_pending)
+    {
+      bus->_flip_pending = false;
+      xSemaphoreGiveFromISR(bus->_flip_done_sem, &need_yield);
+    }
+
+    hub75_vsync_cb_t cb = bus->_vsync_cb;
+    if (cb) cb(bus->_vsync_cb_arg);
+
+    return (need_yield == pdTRUE);
+  }
 
   lcd_cam_dev_t* getDev()
   {
@@ -250,14 +247,15 @@
     gdma_set_transfer_ability(dma_chan, &ability);
 #endif
 
-/*
-    // Enable DMA transfer callback
+    // Enable DMA transfer callback, used for flip / vsync notification
+    if (_flip_done_sem == nullptr) {
+      _flip_done_sem = xSemaphoreCreateBinary();
+    }
     static gdma_tx_event_callbacks_t tx_cbs = {
        // .on_trans_eof is literally the only gdma tx event type available
-      .on_trans_eof = gdma_on_trans_eof_callback 
+      .on_trans_eof = on_trans_eof
     };
-    gdma_register_tx_event_callbacks(dma_chan, &tx_cbs, NULL);
-*/
+    gdma_register_tx_event_callbacks(dma_chan, &tx_cbs, this);
 
     // This uses a busy loop to wait for each DMA transfer to complete...
     // but the whole point of DMA is that one's code can do other work in
@@ -280,6 +278,12 @@
 
   void Bus_Parallel16::release(void)
   {
+    _vsync_cb = nullptr;
+    if (_flip_done_sem)
+    {
+      vSemaphoreDelete(_flip_done_sem);
+      _flip_done_sem = nullptr;
+    }
     if (_i80_bus)
     {
       esp_lcd_del_i80_bus(_i80_bus);
@@ -415,6 +419,10 @@
 
   void Bus_Parallel16::flip_dma_output_buffer(int back_buffer_id)
   {
+    // Previous flip not scanned out yet: the caller drew into a buffer that was still on screen
+    if (_flip_pending) {
+      _missed_vsync_count = _missed_vsync_count + 1;
+    }
 	  
     if ( back_buffer_id == 1) // change across to everything 'b''
     {
@@ -426,12 +434,25 @@
        _dmadesc_a[_dmadesc_count-1].next =  (dma_descriptor_t *) &_dmadesc_a[0];  // setup loop    
        _dmadesc_b[_dmadesc_count-1].next =  (dma_descriptor_t *) &_dmadesc_a[0];  // flip across         
     }
-/*   
-    previousBufferFree = false;  
-    while (!previousBufferFree);
-*/
-    
+
+    // Arm only after relinking: an EOF from the old chain must not complete this flip.
+    // (An EOF landing between the relink and here just costs the waiter one extra frame.)
+    if (_flip_done_sem) xSemaphoreTake(_flip_done_sem, 0); // drop a stale completion
+    _flip_pending = true;
   } // end flip
 
+  bool Bus_Parallel16::wait_flip_complete(uint32_t timeout_ms)
+  {
+    if (!_flip_pending || _flip_done_sem == nullptr) {
+      return true;
+    }
+
+    if (xSemaphoreTake(_flip_done_sem, pdMS_TO_TICKS(timeout_ms)) == pdTRUE) {
+      return true;
+    }
+
+    return !_flip_pending; // completed between the timeout and this check
+  }
+
 
 #endif
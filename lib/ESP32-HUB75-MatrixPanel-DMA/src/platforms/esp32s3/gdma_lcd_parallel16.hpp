@@ -70,6 +70,9 @@
 #include <esp_heap_caps.h>
 #include <esp_heap_caps_init.h>
 
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
 
 #if __has_include (<esp_private/periph_ctrl.h>)
  #include <esp_private/periph_ctrl.h>
@@ -86,6 +89,9 @@
 // The type used for this SoC
 #define HUB75_DMA_DESCRIPTOR_T dma_descriptor_t
 
+// Called from the GDMA EOF interrupt once per completed frame scan. Must be IRAM_ATTR and ISR-safe.
+typedef void (*hub75_vsync_cb_t)(void *arg);
+
 
 //----------------------------------------------------------------------------
 
@@ -150,8 +156,21 @@
 
      void flip_dma_output_buffer(int back_buffer_id);
 
+    // Blocks until the DMA engine has wrapped onto the buffer selected by the last flip,
+    // i.e. the previous front buffer is no longer being scanned. Returns false on timeout.
+    bool wait_flip_complete(uint32_t timeout_ms);
+
+    void set_vsync_callback(hub75_vsync_cb_t cb, void *arg) { _vsync_cb_arg = arg; _vsync_cb = cb; }
+
+    uint32_t get_vsync_count() const { return _vsync_count; }
+    uint32_t get_missed_vsync_count() const { return _missed_vsync_count; }
+
+    size_t get_dma_desc_bytes() const { return sizeof(HUB75_DMA_DESCRIPTOR_T) * _dmadesc_count * (_dmadesc_b ? 2 : 1); }
+
   private:
 
+    static bool on_trans_eof(gdma_channel_handle_t dma_chan, gdma_event_data_t *event_data, void *user_data);
+
     config_t _cfg;
 
     volatile lcd_cam_dev_t* _dev;   
@@ -169,6 +188,15 @@
 
     esp_lcd_i80_bus_handle_t _i80_bus = nullptr;
 
+    // Frame completion (EOF of the last descriptor in the active chain)
+    SemaphoreHandle_t _flip_done_sem = nullptr;
+    volatile bool     _flip_pending  = false;
+    volatile uint32_t _vsync_count   = 0;
+    volatile uint32_t _missed_vsync_count = 0;   // flips requested before the previous one was scanned out
+
+    volatile hub75_vsync_cb_t _vsync_cb = nullptr;
+    void * volatile   _vsync_cb_arg     = nullptr;
+
 
   };
 
@@ -0,0 +1,163 @@
+// Host side check and benchmark of EffectsLayer::blur() / blurDim() (src/Aurora/EffectsLayer.hpp)
+//
+// Reference: FastLED's fl::blur2d(), i.e. blurRows() then blurColumns() from colorutils.cpp,
+// transcribed below with the fl::XYMap lookup per access (a plain row-major map). FastLED takes
+// 8-bit sizes, so a 256 px wide canvas skipped the blur there; the transcription uses int sizes
+// so it can be compared at every size.
+//  - blurDim(amount, dim) must equal nscale8(dim) of every pixel followed by the reference blur,
+//    bit for bit, for every amount and dims 255 (blur()), 250, 128 and 0, on random frames;
+//  - times blur(64) and blurDim(64, 250) against the reference (and DimAll() + reference).
+//
+//   g++ -std=c++17 -O2 -Iaurora_host -I../../../include -o aurora_blur.exe aurora_blur.cpp ../../../src/row_jobs.cpp -lpthread && ./aurora_blur.exe
+
+#include <cstdio>
+#include <cstring>
+#include "aurora_host/aurora_host.hpp"
+
+EffectsLayer effects(64, 64);
+static MatrixDisplay display;
+
+// fl::XYMap::mapToIndex() of a rectangular, non-serpentine map: not inlined, as in the library
+struct XYMap
+{
+  int width;
+  __attribute__((noinline)) int mapToIndex(int x, int y) const { return y * width + x; }
+};
+
+// DO NOT CHANGE: FastLED blurRows() / blurColumns()
+static void blurRows(CRGB *leds, int width, int height, fract8 blur_amount, const XYMap &xymap)
+{
+  uint8_t keep = 255 - blur_amount;
+  uint8_t seep = blur_amount >> 1;
+  for (int row = 0; row < height; row++)
+  {
+    CRGB carryover = CRGB::Black;
+    for (int i = 0; i < width; i++)
+    {
+      CRGB cur = leds[xymap.mapToIndex(i, row)];
+      CRGB part = cur;
+      part.nscale8(seep);
+      cur.nscale8(keep);
+      cur += carryover;
+      if (i)
+        leds[xymap.mapToIndex(i - 1, row)] += part;
+      leds[xymap.mapToIndex(i, row)] = cur;
+      carryover = part;
+    }
+  }
+}
+
+static void blurColumns(CRGB *leds, int width, int height, fract8 blur_amount, const XYMap &xymap)
+{
+  uint8_t keep = 255 - blur_amount;
+  uint8_t seep = blur_amount >> 1;
+  for (int col = 0; col < width; ++col)
+  {
+    CRGB carryover = CRGB::Black;
+    for (int i = 0; i < height; ++i)
+    {
+      CRGB cur = leds[xymap.mapToIndex(col, i)];
+      CRGB part = cur;
+      part.nscale8(seep);
+      cur.nscale8(keep);
+      cur += carryover;
+      if (i)
+        leds[xymap.mapToIndex(col, i - 1)] += part;
+      leds[xymap.mapToIndex(col, i)] = cur;
+      carryover = part;
+    }
+  }
+}
+
+static void blur2d(CRGB *leds, int width, int height, fract8 blur_amount, const XYMap &xymap)
+{
+  blurRows(leds, width, height, blur_amount, xymap);
+  blurColumns(leds, width, height, blur_amount, xymap);
+}
+
+// Random frame with black pixels and saturated channels, where the lane arithmetic could overflow
+static void random_frame(std::vector<CRGB> &frame)
+{
+  for (CRGB &c : frame)
+  {
+    c = CRGB(rand(), rand(), rand() % 4 ? rand() : 255);
+    if (rand() % 5 == 0)
+      c = CRGB::Black;
+  }
+}
+
+static bool check(int w, int h)
+{
+  aurora_resize(display, w, h);
+  XYMap map{w};
+  std::vector<CRGB> frame(w * h), ref(w * h);
+
+  int cases = 0, fails = 0;
+  for (int amount = 0; amount < 256; amount++)
+    for (int dim : {255, 250, 128, 0})
+    {
+      random_frame(frame);
+      ref = frame;
+      memcpy(effects.leds, frame.data(), w * h * sizeof(CRGB));
+
+      if (dim != 255)
+        nscale8(ref.data(), w * h, dim);
+      blur2d(ref.data(), w, h, amount, map);
+      if (dim == 255)
+        effects.blur(amount);
+      else
+        effects.blurDim(amount, dim);
+
+      cases++;
+      if (memcmp(ref.data(), effects.leds, w * h * sizeof(CRGB)))
+      {
+        if (fails++ < 3)
+          printf("    amount %d dim %d differs\n", amount, dim);
+      }
+    }
+
+  printf("  %3dx%-3d %4d frames  %s\n", w, h, cases, fails ? "FAIL" : "bit-exact");
+  return fails == 0;
+}
+
+static void bench(int w, int h)
+{
+  aurora_resize(display, w, h);
+  XYMap map{w};
+  std::vector<CRGB> ref(w * h);
+  random_frame(ref);
+  memcpy(effects.leds, ref.data(), w * h * sizeof(CRGB));
+
+  const int N = 2000;
+  double t_ref = aurora_time_us([&](int) { blur2d(ref.data(), w, h, 64, map); }, N);
+  double t_blur = aurora_time_us([&](int) { effects.blur(64); }, N);
+  double t_ref_dim = aurora_time_us([&](int) {
+    nscale8(ref.data(), w * h, 250);
+    blur2d(ref.data(), w, h, 64, map);
+  }, N);
+  double t_dim = aurora_time_us([&](int) { effects.DimAll(250); effects.blur(64); }, N);
+  double t_blur_dim = aurora_time_us([&](int) { effects.blurDim(64, 250); }, N);
+
+  printf("  %3dx%-3d blur: fl::blur2d %7.1f us  blur() %7.1f us (%.2fx)   dim+blur: fl %7.1f us  DimAll()+blur() %7.1f us  blurDim() %7.1f us (%.2fx)\n",
+         w, h, t_ref, t_blur, t_ref / t_blur, t_ref_dim, t_dim, t_blur_dim, t_ref_dim / t_blur_dim);
+}
+
+int main()
+{
+  const int sizes[][2] = {{64, 64}, {128, 128}, {256, 64}, {64, 32}, {7, 5}, {1, 1}};
+
+  srand(3);
+  bool ok = true;
+  printf("blurDim() against fl::blur2d(), every amount, dims 255 / 250 / 128 / 0:\n");
+  for (auto &sz : sizes)
+    ok &= check(sz[0], sz[1]);
+
+  printf("\nPer frame:\n");
+  bench(64, 32);
+  bench(64, 64);
+  bench(128, 128);
+  bench(256, 64);
+
+  printf(ok ? "\nSUCCESS: blur() / blurDim() match fl::blur2d().\n" : "\nERROR: blur mismatch.\n");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,235 @@
+// Host side check and benchmark of the fire / smoke engine in src/Aurora/FireSim.hpp
+//
+//  - FireKoz's and Smoke's heat -> colour tables must be their colours unchanged: the panel
+//    driver applies its CIE 1931 table to every channel, so no gamma is added on top (this
+//    program builds without NO_CIE1931, like the firmware);
+//  - flame height, i.e. how far up the mean heat of a row stays above 16, on 64 px wide
+//    canvases 32 to 512 px high: the cooling rate is scaled to the height in 1/256 steps, so
+//    FireKoz's flames and Smoke's plume reach the same fraction of the canvas at every height;
+//  - time per frame at 64x32, 128x64 and 256x128 of FireKoz as it was before FireSim
+//    (namespace baseline: the float fireBuffer[VPANEL_W][VPANEL_H][2] class, with the panel
+//    size as template parameters so it runs at every size), FireKoz and Smoke on FireSim,
+//    on one core.
+//
+//   g++ -std=c++17 -O2 -Iaurora_host -I../../../include -o aurora_fire.exe aurora_fire.cpp ../../../src/row_jobs.cpp -lpthread && ./aurora_fire.exe
+
+#include <cstdio>
+#include <cstring>
+#include "aurora_host/aurora_host.hpp"
+
+EffectsLayer effects(64, 64);
+static MatrixDisplay display;
+
+// The checks read the FireSim of each pattern
+#define private public
+#include "../../../src/Aurora/PatternFireKoz.hpp"
+#include "../../../src/Aurora/PatternSmoke.hpp"
+
+// DO NOT CHANGE: PatternFireKoz before FireSim, VPANEL_W / VPANEL_H made W / H
+namespace baseline
+{
+
+template <int W, int H>
+class PatternFireKoz : public Drawable
+{
+private:
+  const int FIRE_HEIGHT = 800;
+
+  int Bit = 0, NBit = 1;
+  float fire_c;
+  uint8_t fireBuffer[W][H][2];
+
+public:
+  PatternFireKoz() { name = (char *)"FireKoz"; }
+
+  void start()
+  {
+    memset(fireBuffer, 0, sizeof(fireBuffer));
+    effects.ClearFrame();
+  }
+
+  unsigned int drawFrame()
+  {
+    for (int x = 1; x < W - 1; x++)
+    {
+      fireBuffer[x][H - 2][Bit] = random(0, FIRE_HEIGHT);
+      if (random(0, 100) > 80)
+      {
+        fireBuffer[x][H - 2][Bit] = 0;
+        fireBuffer[x][H - 3][Bit] = 0;
+      }
+    }
+    for (int y = 1; y < H - 1; y++)
+    {
+      for (int x = 1; x < W - 1; x++)
+      {
+        fire_c = (fireBuffer[x - 1][y][Bit] +
+                  fireBuffer[x + 1][y][Bit] +
+                  fireBuffer[x][y - 1][Bit] +
+                  fireBuffer[x][y + 1][Bit] +
+                  fireBuffer[x][y][Bit]) /
+                 5.0;
+
+        fire_c = (fireBuffer[x - 1][y][Bit] +
+                  fireBuffer[x + 1][y][Bit] +
+                  fireBuffer[x][y - 1][Bit] +
+                  fireBuffer[x][y + 1][Bit] +
+                  fireBuffer[x][y][Bit]) /
+                 5.0;
+
+        if (fire_c > (FIRE_HEIGHT / 2) && fire_c < FIRE_HEIGHT)
+          fire_c -= 0.2;
+        else if (fire_c > (FIRE_HEIGHT / 4) && fire_c < (FIRE_HEIGHT / 2))
+          fire_c -= 0.4;
+        else if (fire_c <= (FIRE_HEIGHT / 8))
+          fire_c -= 0.7;
+        else
+          fire_c -= 1;
+        if (fire_c < 0)
+          fire_c = 0;
+        if (fire_c >= FIRE_HEIGHT + 1)
+          fire_c = FIRE_HEIGHT - 1;
+        fireBuffer[x][y - 1][NBit] = fire_c;
+        int index = (int)fire_c * 3;
+        if (fire_c == 0)
+          effects.setPixel(x, y, CRGB(0, 0, 0));
+        else
+          effects.setPixel(x, y, CRGB(palette_fire[index], palette_fire[index + 1], palette_fire[index + 2]));
+      }
+    }
+
+    NBit = Bit;
+    Bit = 1 - Bit;
+
+    return 30;
+  }
+};
+
+} // namespace baseline
+
+static bool check_palettes()
+{
+  PatternFireKoz koz;
+  PatternSmoke smoke;
+  koz.start();
+  smoke.start();
+
+  int wrong = 0;
+  for (int h = 0; h < 256; h++)
+  {
+    CRGB flame(palette_fire[h * 3], palette_fire[h * 3 + 1], palette_fire[h * 3 + 2]);
+    uint8_t v = h < 85 ? h * 3 : 255;
+    CRGB plume(scale8(v, 200), scale8(v, 210), v);
+    wrong += koz.fire.lut[h] != flame;
+    wrong += smoke.smoke.lut[h] != plume;
+  }
+  koz.stop();
+  smoke.stop();
+
+  printf("  FireKoz / Smoke tables, 256 heats each: %s\n", wrong ? "FAIL: gamma applied" : "the colours as given");
+  return wrong == 0;
+}
+
+// Fraction of the canvas, from the bottom, over which the mean heat of a row stays above 16
+static double flame_height(FireSim &sim, int frames)
+{
+  const int w = effects.width, h = effects.height;
+  std::vector<double> mean(h);
+  for (int f = 0; f < frames; f++)
+  {
+    sim.step(effects);
+    if (f < frames / 2)
+      continue;
+    for (int y = 0; y < h; y++)
+    {
+      long sum = 0;
+      for (int x = 0; x < w; x++)
+        sum += sim.field()[y * w + x];
+      mean[y] += (double)sum / w / (frames - frames / 2);
+    }
+  }
+
+  int y = h - 1;
+  while (y >= 0 && mean[y] > 16)
+    y--;
+  return (double)(h - 1 - y) / h;
+}
+
+static bool check_heights()
+{
+  bool ok = true;
+  double lo[2] = {1, 1}, hi[2] = {0, 0};
+  for (int h : {32, 64, 128, 256, 512})
+  {
+    aurora_resize(display, 64, h);
+    PatternFireKoz koz;
+    PatternSmoke smoke;
+    koz.start();
+    smoke.start();
+    double fk = flame_height(koz.fire, 4 * h + 200);
+    double sm = flame_height(smoke.smoke, 4 * h + 200);
+    printf("  64x%-3d  FireKoz cooling %5.2f: flames %3.0f%% of the height   Smoke cooling %5.2f: plume %3.0f%%\n", h,
+           koz.fire.cooling / 256.0, fk * 100, smoke.smoke.cooling / 256.0, sm * 100);
+    lo[0] = std::min(lo[0], fk);
+    hi[0] = std::max(hi[0], fk);
+    lo[1] = std::min(lo[1], sm);
+    hi[1] = std::max(hi[1], sm);
+    ok &= fk > 0.3 && fk < 1 && sm > 0.3;
+    koz.stop();
+    smoke.stop();
+  }
+  ok &= hi[0] - lo[0] < 0.25 && hi[1] - lo[1] < 0.25;
+  printf("  %s\n", ok ? "flames die out below the top at every height, within 25% of the height of each other"
+                      : "FAIL: flame height depends on the canvas height");
+  return ok;
+}
+
+template <int W, int H>
+static void bench()
+{
+  aurora_resize(display, W, H);
+  aurora_reset(1);
+
+  const int N = 2000;
+  static baseline::PatternFireKoz<W, H> before;
+  PatternFireKoz koz;
+  PatternSmoke smoke;
+  before.start();
+  koz.start();
+  smoke.start();
+  for (int i = 0; i < 100; i++)
+  {
+    before.drawFrame();
+    koz.drawFrame();
+    smoke.drawFrame();
+  }
+
+  double tb = aurora_time_us([&](int) { before.drawFrame(); }, N);
+  double tk = aurora_time_us([&](int) { koz.drawFrame(); }, N);
+  double ts = aurora_time_us([&](int) { smoke.drawFrame(); }, N);
+  printf("  %3dx%-3d  old FireKoz %7.1f us   FireKoz %6.1f us (%4.1fx, %4.0f Mcell/s)   Smoke %6.1f us\n", W, H, tb, tk, tb / tk,
+         W * H / tk, ts);
+  koz.stop();
+  smoke.stop();
+}
+
+int main()
+{
+  aurora_resize(display, 64, 64);
+  aurora_reset(1);
+
+  bool ok = true;
+  printf("Heat -> colour tables (built without NO_CIE1931):\n");
+  ok &= check_palettes();
+
+  printf("\nFlame height against canvas height:\n");
+  ok &= check_heights();
+
+  printf("\nPer frame, one core (host):\n");
+  bench<64, 32>();
+  bench<128, 64>();
+  bench<256, 128>();
+
+  printf(ok ? "\nSUCCESS: FireSim tables and cooling as intended.\n" : "\nERROR: FireSim check failed.\n");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,617 @@
+// Host side check and benchmark of the fixed-point geometry in src/Aurora/FixedMath.hpp and
+// EffectsLayer::drawLine(FixVec2, FixVec2, CRGB)
+//
+//  - fixSin() / fixCos() against sin() / cos() for all 65536 binary angles (error below 3e-5);
+//  - drawLine() on random sub-pixel segments, partly off the canvas, must light exactly the
+//    pixels of the exact line (per column of the major axis, the one the line crosses at the
+//    column's centre); how far its pixels and those of the float path (end points floored, GFX
+//    drawLine()) stray from the segment;
+//  - PatternCube, PatternSpin and PatternInfinity next to the float / GFX versions they replaced
+//    (namespace baseline, transcribed from the tree before FixedMath.hpp): Cube poses against
+//    the exact projection (pixel to edge distance, largest gap along an edge), Spin and
+//    Infinity frame by frame, and the time per frame of both.
+//
+//   g++ -std=c++17 -O2 -Iaurora_host -I../../../include -o aurora_fixedmath.exe aurora_fixedmath.cpp ../../../src/row_jobs.cpp -lpthread && ./aurora_fixedmath.exe
+
+#include <cstdio>
+#include <cstring>
+#include "aurora_host/aurora_host.hpp"
+
+EffectsLayer effects(64, 64);
+static MatrixDisplay display;
+
+// The checks drive rotate() and read the projected vertices of both Cubes
+#define private public
+#include "../../../src/Aurora/PatternCube.hpp"
+#include "../../../src/Aurora/PatternSpin.hpp"
+#include "../../../src/Aurora/PatternInfinity.hpp"
+
+// DO NOT CHANGE: the patterns as they were before FixedMath.hpp
+namespace baseline
+{
+
+class PatternCube : public Drawable
+{
+private:
+  float focal = 30;
+  int cubeWidth = 28;
+  float Angx = 20.0, AngxSpeed = 0.05;
+  float Angy = 10.0, AngySpeed = 0.05;
+  float Ox = effects.width / 2, Oy = effects.height / 2;
+  int zCamera = 110;
+
+  Vertex local[8];
+  Vertex aligned[8];
+  Point screen[8];
+  squareFace face[6];
+  EdgePoint edge[12];
+  int nbEdges;
+  float m00, m01, m02, m10, m11, m12, m20, m21, m22;
+  byte hue = 0;
+  int step = 0;
+
+  void make(int w)
+  {
+    nbEdges = 0;
+
+    local[0].set(-w, w, w);
+    local[1].set(w, w, w);
+    local[2].set(w, -w, w);
+    local[3].set(-w, -w, w);
+    local[4].set(-w, w, -w);
+    local[5].set(w, w, -w);
+    local[6].set(w, -w, -w);
+    local[7].set(-w, -w, -w);
+
+    face[0].set(1, 0, 3, 2);
+    face[1].set(0, 4, 7, 3);
+    face[2].set(4, 0, 1, 5);
+    face[3].set(4, 5, 6, 7);
+    face[4].set(1, 2, 6, 5);
+    face[5].set(2, 3, 7, 6);
+
+    for (int f = 0; f < 6; f++)
+      for (int i = 0; i < face[f].length; i++)
+        face[f].ed[i] = findEdge(face[f].sommets[i], face[f].sommets[i ? i - 1 : face[f].length - 1]);
+  }
+
+  int findEdge(int a, int b)
+  {
+    int i;
+    for (i = 0; i < nbEdges; i++)
+      if ((edge[i].x == a && edge[i].y == b) || (edge[i].x == b && edge[i].y == a))
+        return i;
+    edge[nbEdges++].set(a, b);
+    return i;
+  }
+
+  void rotate(float angx, float angy)
+  {
+    int i;
+    float cx = cos(angx);
+    float sx = sin(angx);
+    float cy = cos(angy);
+    float sy = sin(angy);
+
+    m00 = cy;
+    m01 = 0;
+    m02 = -sy;
+    m10 = sx * sy;
+    m11 = cx;
+    m12 = sx * cy;
+    m20 = cx * sy;
+    m21 = -sx;
+    m22 = cx * cy;
+
+    for (i = 0; i < 8; i++)
+    {
+      aligned[i].x = m00 * local[i].x + m01 * local[i].y + m02 * local[i].z;
+      aligned[i].y = m10 * local[i].x + m11 * local[i].y + m12 * local[i].z;
+      aligned[i].z = m20 * local[i].x + m21 * local[i].y + m22 * local[i].z + zCamera;
+
+      screen[i].x = floor((Ox + focal * aligned[i].x / aligned[i].z));
+      screen[i].y = floor((Oy - focal * aligned[i].y / aligned[i].z));
+    }
+
+    for (i = 0; i < 12; i++)
+      edge[i].visible = false;
+
+    Point *pa, *pb, *pc;
+    for (i = 0; i < 6; i++)
+    {
+      pa = screen + face[i].sommets[0];
+      pb = screen + face[i].sommets[1];
+      pc = screen + face[i].sommets[2];
+
+      boolean back = ((pb->x - pa->x) * (pc->y - pa->y) - (pb->y - pa->y) * (pc->x - pa->x)) < 0;
+      if (!back)
+        for (int j = 0; j < 4; j++)
+          edge[face[i].ed[j]].visible = true;
+    }
+  }
+
+public:
+  PatternCube()
+  {
+    name = (char *)"Cube";
+    make(effects.width);
+  }
+
+  unsigned int drawFrame()
+  {
+    uint8_t blurAmount = beatsin8(2, 10, 128);
+    effects.blur(blurAmount);
+
+    zCamera = beatsin8(2, 100, 140);
+    AngxSpeed = beatsin8(3, 1, 6) / 100.0f;
+    AngySpeed = effects.beatcos8(5, 1, 6) / 100.0f;
+
+    Angx += AngxSpeed;
+    Angy += AngySpeed;
+    if (Angx >= TWO_PI)
+      Angx -= TWO_PI;
+    if (Angy >= TWO_PI)
+      Angy -= TWO_PI;
+
+    rotate(Angx, Angy);
+
+    CRGB color = effects.ColorFromCurrentPalette(hue, 128);
+
+    EdgePoint *e;
+    for (int i = 0; i < 12; i++)
+    {
+      e = edge + i;
+      if (!e->visible)
+      {
+        uint16_t lineColor = effects.virtualDisp->color565(color.r, color.g, color.b);
+        effects.drawLine(screen[e->x].x, screen[e->x].y, screen[e->y].x, screen[e->y].y, lineColor);
+      }
+    }
+
+    uint16_t frontColor = effects.ColorFromCurrentPalette565(hue);
+
+    for (int i = 0; i < 12; i++)
+    {
+      e = edge + i;
+      if (e->visible)
+        effects.drawLine(screen[e->x].x, screen[e->x].y, screen[e->y].x, screen[e->y].y, frontColor);
+    }
+
+    step++;
+    if (step == 8)
+    {
+      step = 0;
+      hue++;
+    }
+
+    return 20;
+  }
+};
+
+class PatternSpin : public Drawable
+{
+public:
+  PatternSpin() { name = (char *)"Spin"; }
+
+  float degrees = 0;
+  float radius = 16;
+
+  float speedStart = 1;
+  float velocityStart = 0.6;
+
+  float maxSpeed = 30;
+
+  float speed = speedStart;
+  float velocity = velocityStart;
+
+  void start()
+  {
+    speed = speedStart;
+    velocity = velocityStart;
+    degrees = 0;
+  }
+
+  unsigned int drawFrame()
+  {
+    CRGB color = effects.ColorFromCurrentPalette(speed * 8);
+
+    int x;
+    int y;
+
+    float targetDegrees = degrees + speed;
+    float targetRadians = radians(targetDegrees);
+    int targetX = (int)(effects.getCenterX() + radius * cos(targetRadians));
+    int targetY = (int)(effects.getCenterY() - radius * sin(targetRadians));
+    (void)targetX;
+    (void)targetY;
+
+    float tempDegrees = degrees;
+
+    for (int i = 0; i < 16; i++)
+    {
+      float radians = radians(tempDegrees);
+      x = (int)(effects.getCenterX() + radius * cos(radians));
+      y = (int)(effects.getCenterY() - radius * sin(radians));
+
+      effects.setPixel(x, y, color);
+      effects.setPixel(y, x, color);
+
+      tempDegrees += 1;
+      if (tempDegrees >= 360)
+        tempDegrees = 0;
+    }
+
+    degrees += speed;
+
+    if (degrees >= 360)
+    {
+      degrees = 0;
+      speed += velocity;
+      if (speed <= speedStart)
+      {
+        speed = speedStart;
+        velocity *= -1;
+      }
+      else if (speed > maxSpeed)
+      {
+        speed = maxSpeed - velocity;
+        velocity *= -1;
+      }
+    }
+
+    return 0;
+  }
+};
+
+class PatternInfinity : public Drawable
+{
+public:
+  PatternInfinity() { name = (char *)"Infinity"; }
+
+  unsigned int drawFrame()
+  {
+    effects.MoveOscillators();
+
+    int x = (VPANEL_W - 4) - effects.p[1];
+    int y = map8(sin8(effects.osci[3]), 8, VPANEL_H - 8);
+    byte hue = sin8(effects.osci[5]);
+
+    CRGB color = effects.ColorFromCurrentPalette(hue);
+    effects.drawTriangle(x, y, x + 1, y + 1, x + 2, y + 2, effects.virtualDisp->color565(color.r, color.g, color.b));
+
+    return 30;
+  }
+};
+
+} // namespace baseline
+
+static std::vector<uint8_t> lit_mask()
+{
+  std::vector<uint8_t> m(effects.num_leds);
+  for (int i = 0; i < effects.num_leds; i++)
+    m[i] = effects.pixelFormat == PIXEL_RGB565 ? effects.frame565()[i] != 0
+                                               : (effects.leds[i].r | effects.leds[i].g | effects.leds[i].b) != 0;
+  return m;
+}
+
+// Largest Chebyshev distance from a lit pixel of a to the nearest lit pixel of b
+static int mask_distance(const std::vector<uint8_t> &a, const std::vector<uint8_t> &b)
+{
+  const int w = effects.width, h = effects.height;
+  int worst = 0;
+  for (int i = 0; i < w * h; i++)
+  {
+    if (!a[i])
+      continue;
+    int best = 1 << 20;
+    for (int j = 0; j < w * h; j++)
+      if (b[j])
+        best = std::min(best, std::max(abs(j % w - i % w), abs(j / w - i / w)));
+    worst = std::max(worst, best);
+  }
+  return worst;
+}
+
+struct Segment
+{
+  double x0, y0, x1, y1;
+};
+
+static double segment_distance(double px, double py, const Segment &s)
+{
+  double dx = s.x1 - s.x0, dy = s.y1 - s.y0;
+  double t = ((px - s.x0) * dx + (py - s.y0) * dy) / (dx * dx + dy * dy + 1e-12);
+  t = std::max(0.0, std::min(1.0, t));
+  return hypot(s.x0 + t * dx - px, s.y0 + t * dy - py);
+}
+
+// Lit pixels against the exact segments: mean / max distance of a pixel centre to the nearest
+// segment, and the largest distance from a point of a segment to a lit pixel. Gaps are only
+// sampled 1 px or more inside the canvas: a line that grazes a corner may miss it altogether
+struct LineError
+{
+  double sum = 0, worst = 0, gap = 0;
+  long pixels = 0;
+
+  void add(const std::vector<uint8_t> &lit, const Segment *segs, int n)
+  {
+    const int w = effects.width, h = effects.height;
+    for (int i = 0; i < w * h; i++)
+    {
+      if (!lit[i])
+        continue;
+      double best = 1e9;
+      for (int s = 0; s < n; s++)
+        best = std::min(best, segment_distance(i % w + 0.5, i / w + 0.5, segs[s]));
+      sum += best;
+      worst = std::max(worst, best);
+      pixels++;
+    }
+
+    for (int s = 0; s < n; s++)
+    {
+      const Segment &g = segs[s];
+      int steps = std::max(1, (int)(hypot(g.x1 - g.x0, g.y1 - g.y0) * 4));
+      for (int k = 0; k <= steps; k++)
+      {
+        double x = g.x0 + (g.x1 - g.x0) * k / steps, y = g.y0 + (g.y1 - g.y0) * k / steps;
+        if (x < 1 || y < 1 || x > w - 1 || y > h - 1)
+          continue;
+        int cx = (int)x, cy = (int)y;
+        double best = 9;
+        for (int yy = std::max(0, cy - 3); yy <= std::min(h - 1, cy + 3); yy++)
+          for (int xx = std::max(0, cx - 3); xx <= std::min(w - 1, cx + 3); xx++)
+            if (lit[yy * w + xx])
+              best = std::min(best, std::max(fabs(xx + 0.5 - x), fabs(yy + 0.5 - y)));
+        gap = std::max(gap, best);
+      }
+    }
+  }
+
+  void print(const char *name) const
+  {
+    printf("    %-6s pixel to line: mean %.2f px, max %.2f px   largest gap along a line: %.2f px\n", name, sum / pixels, worst,
+           gap);
+  }
+};
+
+static bool check_trig()
+{
+  double worst_sin = 0, worst_cos = 0;
+  for (int a = 0; a < 65536; a++)
+  {
+    double r = a * (2 * PI / 65536);
+    worst_sin = std::max(worst_sin, fabs(fixToFloat(fixSin(a)) - sin(r)));
+    worst_cos = std::max(worst_cos, fabs(fixToFloat(fixCos(a)) - cos(r)));
+  }
+  bool ok = worst_sin < 3e-5 && worst_cos < 3e-5;
+  printf("  fixSin() max error %.2e, fixCos() max error %.2e   %s\n", worst_sin, worst_cos, ok ? "below 3e-5" : "FAIL");
+  return ok;
+}
+
+// The pixels drawLine() must light: the 24.8 end points it works with, one pixel per column
+// of the major axis, on the row the line crosses at the column's centre
+static std::vector<uint8_t> exact_line(const FixVec2 &a, const FixVec2 &b, int *ties)
+{
+  const int w = effects.width, h = effects.height;
+  std::vector<uint8_t> m(w * h);
+  double x0 = (a.x >> 8) / 256.0, y0 = (a.y >> 8) / 256.0, x1 = (b.x >> 8) / 256.0, y1 = (b.y >> 8) / 256.0;
+  bool steep = fabs(y1 - y0) > fabs(x1 - x0);
+  if (steep)
+  {
+    std::swap(x0, y0);
+    std::swap(x1, y1);
+  }
+  if (x0 > x1)
+  {
+    std::swap(x0, x1);
+    std::swap(y0, y1);
+  }
+  const int major = steep ? h : w, minor = steep ? w : h;
+  for (int c = std::max(0, (int)floor(x0)); c <= std::min(major - 1, (int)floor(x1)); c++)
+  {
+    double y = x1 == x0 ? y0 : y0 + (c + 0.5 - x0) * (y1 - y0) / (x1 - x0);
+    int row = (int)floor(y);
+    if (fabs(y - round(y)) < 1e-9)
+      (*ties)++;
+    if (row >= 0 && row < minor)
+      m[steep ? c * w + row : row * w + c] = 1;
+  }
+  return m;
+}
+
+static bool check_lines()
+{
+  const int N = 20000;
+  int wrong = 0, ties = 0;
+  LineError fixed, floored;
+  for (int i = 0; i < N; i++)
+  {
+    // end points anywhere from 16 px off the canvas to 16 px past it, 1/65536 px steps
+    Segment s;
+    double *v[] = {&s.x0, &s.y0, &s.x1, &s.y1};
+    for (int k = 0; k < 4; k++)
+      *v[k] = (rand() % (96 * 65536)) / 65536.0 - 16;
+    FixVec2 a(fixFromFloat(s.x0), fixFromFloat(s.y0)), b(fixFromFloat(s.x1), fixFromFloat(s.y1));
+
+    effects.ClearFrame();
+    effects.drawLine(a, b, CRGB::White);
+    std::vector<uint8_t> lit = lit_mask();
+    int t = 0;
+    std::vector<uint8_t> ref = exact_line(a, b, &t);
+    ties += t;
+    if (!t && lit != ref && wrong++ < 3)
+      printf("    (%.3f, %.3f) - (%.3f, %.3f) differs\n", s.x0, s.y0, s.x1, s.y1);
+    fixed.add(lit, &s, 1);
+
+    effects.ClearFrame();
+    effects.drawLine((int16_t)floor(s.x0), (int16_t)floor(s.y0), (int16_t)floor(s.x1), (int16_t)floor(s.y1), 0xffff);
+    floored.add(lit_mask(), &s, 1);
+  }
+  printf("  drawLine(FixVec2): %d random segments, %d pixels wrong (%d column centres exactly on a row edge not compared)   %s\n", N,
+         wrong, ties, wrong ? "FAIL" : "exact");
+  floored.print("float");
+  fixed.print("fixed");
+  return wrong == 0;
+}
+
+// Cube: poses of both versions against the exact projection of the pose. Poses with a corner
+// closer than z = 1 are skipped: the float path divides by ~0 there
+static bool check_cube()
+{
+  baseline::PatternCube before;
+  PatternCube after;
+  LineError e_before, e_after;
+  int poses = 0;
+
+  for (int k = 0; k < 3000; k++)
+  {
+    float ax = fmodf(k * 0.0137f + 0.3f, TWO_PI), ay = fmodf(k * 0.0091f, TWO_PI);
+    int z = 100 + k % 41;
+
+    before.zCamera = z;
+    before.rotate(ax, ay);
+    bool behind = false;
+    for (int i = 0; i < 8; i++)
+      behind |= before.aligned[i].z < 1;
+    if (behind)
+      continue;
+
+    Segment segs[12];
+    for (int i = 0; i < 12; i++)
+    {
+      const Vertex &a = before.aligned[before.edge[i].x], &b = before.aligned[before.edge[i].y];
+      segs[i] = {before.Ox + before.focal * a.x / a.z, before.Oy - before.focal * a.y / a.z,
+                 before.Ox + before.focal * b.x / b.z, before.Oy - before.focal * b.y / b.z};
+    }
+
+    effects.ClearFrame();
+    for (int i = 0; i < 12; i++)
+    {
+      const EdgePoint &e = before.edge[i];
+      effects.drawLine(before.screen[e.x].x, before.screen[e.x].y, before.screen[e.y].x, before.screen[e.y].y, 0xffff);
+    }
+    e_before.add(lit_mask(), segs, 12);
+
+    after.zCamera = z;
+    after.rotate(fixAngleFromRadians(ax), fixAngleFromRadians(ay));
+    effects.ClearFrame();
+    for (int i = 0; i < 12; i++)
+      effects.drawLine(after.screen[after.edge[i].x], after.screen[after.edge[i].y], CRGB::White);
+    e_after.add(lit_mask(), segs, 12);
+    poses++;
+  }
+
+  printf("  Cube, %d poses against the exact projection:\n", poses);
+  e_before.print("float");
+  e_after.print("fixed");
+  bool ok = e_after.gap < 1 && e_after.worst < 1.1;
+  printf("    %s\n", ok ? "fixed: no gaps, every pixel within 1.1 px of an edge" : "FAIL");
+  return ok;
+}
+
+static bool check_spin_infinity()
+{
+  baseline::PatternSpin spin_before;
+  PatternSpin spin_after;
+  baseline::PatternInfinity inf_before;
+  PatternInfinity inf_after;
+  spin_before.start();
+  spin_after.start();
+
+  const int N = 3000;
+  int spin_same = 0, spin_worst = 0, inf_same = 0;
+  for (int f = 0; f < N; f++)
+  {
+    // Spin draws on an RGB565 canvas, the float version on CRGB; setPixelFormat() also clears
+    effects.setPixelFormat(PIXEL_CRGB);
+    spin_before.drawFrame();
+    std::vector<uint8_t> a = lit_mask();
+    effects.setPixelFormat(PIXEL_RGB565);
+    spin_after.drawFrame();
+    std::vector<uint8_t> b = lit_mask();
+    spin_same += a == b;
+    spin_worst = std::max({spin_worst, mask_distance(a, b), mask_distance(b, a)});
+
+    // both move the shared oscillators: the second one starts from the same state
+    byte osci[6], p[6];
+    memcpy(osci, effects.osci, 6);
+    memcpy(p, effects.p, 6);
+    effects.setPixelFormat(PIXEL_CRGB);
+    inf_before.drawFrame();
+    a = lit_mask();
+    memcpy(effects.osci, osci, 6);
+    memcpy(effects.p, p, 6);
+    effects.ClearFrame();
+    inf_after.drawFrame();
+    inf_same += a == lit_mask();
+  }
+
+  bool ok = spin_worst <= 1 && inf_same == N;
+  printf("  Spin, %d frames: %.1f%% identical, all others within %d px\n", N, 100.0 * spin_same / N, spin_worst);
+  printf("  Infinity, %d frames: %d identical\n", N, inf_same);
+  printf("    %s\n", ok ? "as drawn before" : "FAIL");
+  return ok;
+}
+
+static void bench()
+{
+  const int N = 200000;
+  baseline::PatternCube cube_before;
+  PatternCube cube_after;
+  baseline::PatternSpin spin_before;
+  PatternSpin spin_after;
+  baseline::PatternInfinity inf_before;
+  PatternInfinity inf_after;
+  spin_before.start();
+  spin_after.start();
+  effects.setPixelFormat(PIXEL_CRGB);
+
+  double tb = aurora_time_us([&](int k) {
+    cube_before.rotate(k * 0.0137f, k * 0.0091f);
+    for (int i = 0; i < 12; i++)
+    {
+      const EdgePoint &e = cube_before.edge[i];
+      effects.drawLine(cube_before.screen[e.x].x, cube_before.screen[e.x].y, cube_before.screen[e.y].x, cube_before.screen[e.y].y, 0xffff);
+    }
+  }, N);
+  double ta = aurora_time_us([&](int k) {
+    cube_after.rotate(fixAngleFromRadians(k * 0.0137f), fixAngleFromRadians(k * 0.0091f));
+    for (int i = 0; i < 12; i++)
+      effects.drawLine(cube_after.screen[cube_after.edge[i].x], cube_after.screen[cube_after.edge[i].y], CRGB::White);
+  }, N);
+  printf("  Cube rotate + 12 edges  float %6.0f ns   fixed %6.0f ns   %5.2fx\n", tb * 1000, ta * 1000, tb / ta);
+
+  tb = aurora_time_us([&](int) { spin_before.drawFrame(); }, N);
+  effects.setPixelFormat(PIXEL_RGB565);
+  ta = aurora_time_us([&](int) { spin_after.drawFrame(); }, N);
+  effects.setPixelFormat(PIXEL_CRGB);
+  printf("  Spin drawFrame()        float %6.0f ns   fixed %6.0f ns   %5.2fx\n", tb * 1000, ta * 1000, tb / ta);
+
+  tb = aurora_time_us([&](int) { inf_before.drawFrame(); }, N);
+  ta = aurora_time_us([&](int) { inf_after.drawFrame(); }, N);
+  printf("  Infinity drawFrame()    GFX   %6.0f ns   fixed %6.0f ns   %5.2fx\n", tb * 1000, ta * 1000, tb / ta);
+}
+
+int main()
+{
+  aurora_resize(display, 64, 64);
+  aurora_reset(7);
+
+  bool ok = true;
+  printf("Fixed-point sine and cosine against sin() / cos():\n");
+  ok &= check_trig();
+
+  printf("\nSub-pixel lines, 64x64:\n");
+  ok &= check_lines();
+
+  printf("\nPatterns, 64x64, fixed point against the float / GFX versions:\n");
+  ok &= check_cube();
+  ok &= check_spin_infinity();
+
+  printf("\nPer frame (host):\n");
+  bench();
+
+  printf(ok ? "\nSUCCESS: fixed-point geometry matches the exact lines and the float patterns.\n" : "\nERROR: fixed-point mismatch.\n");
+  return ok ? 0 : 1;
+}
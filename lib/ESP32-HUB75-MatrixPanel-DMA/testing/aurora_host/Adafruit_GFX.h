@@ -0,0 +1,91 @@
+// Host stand-in for the Adafruit_GFX base class of EffectsLayer: the canvas size and the
+// line / triangle / rectangle primitives (transcribed from Adafruit_GFX.cpp), drawn through drawPixel().
+
+#ifndef AURORA_HOST_ADAFRUIT_GFX_H
+#define AURORA_HOST_ADAFRUIT_GFX_H
+
+#include "Arduino.h"
+
+class Adafruit_GFX
+{
+public:
+  Adafruit_GFX(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h), _width(w), _height(h) {}
+  virtual ~Adafruit_GFX() {}
+
+  virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+
+  virtual void writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color)
+  {
+    int16_t steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep) {
+      std::swap(x0, y0);
+      std::swap(x1, y1);
+    }
+    if (x0 > x1) {
+      std::swap(x0, x1);
+      std::swap(y0, y1);
+    }
+    int16_t dx = x1 - x0;
+    int16_t dy = abs(y1 - y0);
+    int16_t err = dx / 2;
+    int16_t ystep = y0 < y1 ? 1 : -1;
+    for (; x0 <= x1; x0++) {
+      if (steep)
+        drawPixel(y0, x0, color);
+      else
+        drawPixel(x0, y0, color);
+      err -= dy;
+      if (err < 0) {
+        y0 += ystep;
+        err += dx;
+      }
+    }
+  }
+
+  virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) { writeLine(x, y, x, y + h - 1, color); }
+  virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) { writeLine(x, y, x + w - 1, y, color); }
+
+  virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+  {
+    for (int16_t i = x; i < x + w; i++)
+      drawFastVLine(i, y, h, color);
+  }
+
+  virtual void fillScreen(uint16_t color) { fillRect(0, 0, _width, _height, color); }
+
+  virtual void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color)
+  {
+    if (x0 == x1) {
+      if (y0 > y1)
+        std::swap(y0, y1);
+      drawFastVLine(x0, y0, y1 - y0 + 1, color);
+    } else if (y0 == y1) {
+      if (x0 > x1)
+        std::swap(x0, x1);
+      drawFastHLine(x0, y0, x1 - x0 + 1, color);
+    } else {
+      writeLine(x0, y0, x1, y1, color);
+    }
+  }
+
+  void drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color)
+  {
+    drawLine(x0, y0, x1, y1, color);
+    drawLine(x1, y1, x2, y2, color);
+    drawLine(x2, y2, x0, y0, color);
+  }
+
+  virtual void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+  {
+    drawFastHLine(x, y, w, color);
+    drawFastHLine(x, y + h - 1, w, color);
+    drawFastVLine(x, y, h, color);
+    drawFastVLine(x + w - 1, y, h, color);
+  }
+
+protected:
+  int16_t WIDTH, HEIGHT;
+  int16_t _width, _height;
+};
+
+#endif
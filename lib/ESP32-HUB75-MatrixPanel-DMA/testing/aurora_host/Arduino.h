@@ -0,0 +1,79 @@
+// Host stand-in for the parts of the Arduino core the Aurora headers use.
+//
+// Time does not run by itself: millis() / micros() return host_micros, which a test
+// advances between frames, so two runs of a pattern see the same clock.
+
+#ifndef AURORA_HOST_ARDUINO_H
+#define AURORA_HOST_ARDUINO_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+#include <string>
+#include <algorithm>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#define HALF_PI 1.5707963267948966192313216916398
+#define TWO_PI 6.283185307179586476925286766559
+#endif
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+#define radians(deg) ((deg) * DEG_TO_RAD)
+#define degrees(rad) ((rad) * RAD_TO_DEG)
+
+#define PROGMEM
+#define F(s) (s)
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+
+using std::min;
+using std::max;
+using std::abs;
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+inline uint32_t host_micros = 0;
+
+inline uint32_t micros() { return host_micros; }
+inline uint32_t millis() { return host_micros / 1000; }
+
+inline long random(long howbig) { return howbig > 0 ? rand() % howbig : 0; }
+inline long random(long howsmall, long howbig) { return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall); }
+inline void randomSeed(unsigned long seed) { srand(seed); }
+
+inline long map(long x, long in_min, long in_max, long out_min, long out_max)
+{
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+class String : public std::string
+{
+public:
+  String() {}
+  String(const char *s) : std::string(s) {}
+  String(const std::string &s) : std::string(s) {}
+  String(int v) : std::string(std::to_string(v)) {}
+  const char *c_str() const { return std::string::c_str(); }
+};
+
+// Output goes nowhere: tests print their own results
+struct HostSerial
+{
+  template <typename T> void print(const T &) {}
+  template <typename T> void println(const T &) {}
+  void println() {}
+  template <typename... A> void printf(const char *, A...) {}
+};
+inline HostSerial Serial;
+
+inline bool psramFound() { return false; }
+inline void *ps_malloc(size_t n) { return malloc(n); }
+
+#endif
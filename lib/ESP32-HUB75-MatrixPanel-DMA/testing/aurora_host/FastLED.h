@@ -0,0 +1,611 @@
+// Host stand-in for the parts of FastLED the Aurora headers use.
+//
+// The integer helpers are transcriptions of FastLED 3.x's portable C paths with
+// FASTLED_SCALE8_FIXED / FASTLED_BLEND_FIXED (the ESP32 build uses the same paths),
+// so pixel values match the target. Functions that are only declared here (noise)
+// are not used by the host tests and fail at link time if one starts to.
+
+#ifndef AURORA_HOST_FASTLED_H
+#define AURORA_HOST_FASTLED_H
+
+#include "Arduino.h"
+
+#define FASTLED_SCALE8_FIXED 1
+#define FASTLED_BLEND_FIXED 1
+
+typedef uint8_t fract8;
+typedef uint16_t fract16;
+typedef uint16_t accum88;
+typedef int16_t saccum87;
+
+// ---------------------------------------------------------------- lib8tion
+
+inline uint8_t scale8(uint8_t i, fract8 scale) { return ((uint16_t)i * (1 + (uint16_t)scale)) >> 8; }
+inline uint8_t scale8_video(uint8_t i, fract8 scale) { return (((int)i * (int)scale) >> 8) + ((i && scale) ? 1 : 0); }
+inline uint16_t scale16(uint16_t i, fract16 scale) { return ((uint32_t)i * (1 + (uint32_t)scale)) >> 16; }
+inline uint16_t scale16by8(uint16_t i, fract8 scale) { return (i * (1 + ((uint16_t)scale))) >> 8; }
+
+inline uint8_t qadd8(uint8_t i, uint8_t j) { unsigned t = i + j; return t > 255 ? 255 : t; }
+inline uint8_t qsub8(uint8_t i, uint8_t j) { int t = i - j; return t < 0 ? 0 : t; }
+inline uint8_t qmul8(uint8_t i, uint8_t j) { unsigned p = (unsigned)i * j; return p > 255 ? 255 : p; }
+inline uint8_t add8(uint8_t i, uint8_t j) { return i + j; }
+inline uint8_t sub8(uint8_t i, uint8_t j) { return i - j; }
+inline uint8_t mul8(uint8_t i, uint8_t j) { return ((unsigned)i * j) & 0xFF; }
+inline uint8_t avg8(uint8_t i, uint8_t j) { return (i + j) >> 1; }
+inline uint8_t abs8(int8_t i) { return i < 0 ? -i : i; }
+
+inline uint8_t dim8_raw(uint8_t x) { return scale8(x, x); }
+inline uint8_t dim8_video(uint8_t x) { return scale8_video(x, x); }
+inline uint8_t brighten8_raw(uint8_t x) { uint8_t ix = 255 - x; return 255 - scale8(ix, ix); }
+
+inline uint8_t map8(uint8_t in, uint8_t rangeStart, uint8_t rangeEnd)
+{
+  uint8_t rangeWidth = rangeEnd - rangeStart;
+  uint8_t out = scale8(in, rangeWidth);
+  out += rangeStart;
+  return out;
+}
+
+inline uint8_t lerp8by8(uint8_t a, uint8_t b, fract8 frac)
+{
+  if (b > a)
+    return a + scale8(b - a, frac);
+  return a - scale8(a - b, frac);
+}
+
+inline uint8_t blend8(uint8_t a, uint8_t b, uint8_t amountOfB)
+{
+  uint16_t partial = (a << 8) | b;
+  partial += (b * amountOfB);
+  partial -= (a * amountOfB);
+  return partial >> 8;
+}
+
+inline uint16_t sqrt16(uint16_t x) { return (uint16_t)sqrtf((float)x); }
+
+inline uint8_t sin8(uint8_t theta)
+{
+  static const uint8_t b_m16_interleave[] = {0, 49, 49, 41, 90, 27, 117, 10};
+  uint8_t offset = theta;
+  if (theta & 0x40)
+    offset = (uint8_t)255 - offset;
+  offset &= 0x3F;
+  uint8_t secoffset = offset & 0x0F;
+  if (theta & 0x40)
+    ++secoffset;
+  uint8_t section = offset >> 4;
+  const uint8_t *p = b_m16_interleave + section * 2;
+  uint8_t b = p[0];
+  uint8_t m16 = p[1];
+  uint8_t mx = (m16 * secoffset) >> 4;
+  int8_t y = mx + b;
+  if (theta & 0x80)
+    y = -y;
+  y += 128;
+  return y;
+}
+
+inline uint8_t cos8(uint8_t theta) { return sin8(theta + 64); }
+
+inline int16_t sin16(uint16_t theta)
+{
+  static const uint16_t base[] = {0, 6393, 12539, 18204, 23170, 27245, 30273, 32137};
+  static const uint8_t slope[] = {49, 48, 44, 38, 31, 23, 14, 4};
+  uint16_t offset = (theta & 0x3FFF) >> 3;
+  if (theta & 0x4000)
+    offset = 2047 - offset;
+  uint8_t section = offset / 256;
+  uint16_t b = base[section];
+  uint8_t m = slope[section];
+  uint8_t secoffset8 = (uint8_t)(offset) / 2;
+  uint16_t mx = m * secoffset8;
+  int16_t y = mx + b;
+  if (theta & 0x8000)
+    y = -y;
+  return y;
+}
+
+inline int16_t cos16(uint16_t theta) { return sin16(theta + 16384); }
+
+inline uint8_t triwave8(uint8_t in)
+{
+  if (in & 0x80)
+    in = 255 - in;
+  return in << 1;
+}
+
+inline uint8_t ease8InOutQuad(uint8_t i)
+{
+  uint8_t j = i;
+  if (j & 0x80)
+    j = 255 - j;
+  uint8_t jj = scale8(j, j);
+  uint8_t jj2 = jj << 1;
+  if (i & 0x80)
+    jj2 = 255 - jj2;
+  return jj2;
+}
+
+inline uint8_t ease8InOutCubic(fract8 i)
+{
+  uint8_t ii = scale8(i, i);
+  uint8_t iii = scale8(ii, i);
+  uint16_t r1 = (3 * (uint16_t)(ii)) - (2 * (uint16_t)(iii));
+  uint8_t result = r1;
+  if (r1 & 0x100)
+    result = 255;
+  return result;
+}
+
+inline uint8_t quadwave8(uint8_t in) { return ease8InOutQuad(triwave8(in)); }
+inline uint8_t cubicwave8(uint8_t in) { return ease8InOutCubic(triwave8(in)); }
+
+// ---------------------------------------------------------------- random
+
+inline uint16_t rand16seed = 1337;
+
+inline uint8_t random8()
+{
+  rand16seed = (rand16seed * 2053) + 13849;
+  return (uint8_t)(((uint8_t)(rand16seed & 0xFF)) + ((uint8_t)(rand16seed >> 8)));
+}
+inline uint16_t random16()
+{
+  rand16seed = (rand16seed * 2053) + 13849;
+  return rand16seed;
+}
+inline uint8_t random8(uint8_t lim) { return (random8() * lim) >> 8; }
+inline uint8_t random8(uint8_t min, uint8_t lim) { return min + random8(lim - min); }
+inline uint16_t random16(uint16_t lim) { return ((uint32_t)random16() * lim) >> 16; }
+inline uint16_t random16(uint16_t min, uint16_t lim) { return min + random16(lim - min); }
+inline void random16_set_seed(uint16_t seed) { rand16seed = seed; }
+inline uint16_t random16_get_seed() { return rand16seed; }
+inline void random16_add_entropy(uint16_t entropy) { rand16seed += entropy; }
+
+// ---------------------------------------------------------------- beats
+
+inline uint16_t beat88(accum88 beats_per_minute_88, uint32_t timebase = 0)
+{
+  return (((millis()) - timebase) * beats_per_minute_88 * 280) >> 16;
+}
+inline uint16_t beat16(accum88 beats_per_minute, uint32_t timebase = 0)
+{
+  if (beats_per_minute < 256)
+    beats_per_minute <<= 8;
+  return beat88(beats_per_minute, timebase);
+}
+inline uint8_t beat8(accum88 beats_per_minute, uint32_t timebase = 0) { return beat16(beats_per_minute, timebase) >> 8; }
+
+inline uint8_t beatsin8(accum88 beats_per_minute, uint8_t lowest = 0, uint8_t highest = 255,
+                        uint32_t timebase = 0, uint8_t phase_offset = 0)
+{
+  uint8_t beat = beat8(beats_per_minute, timebase);
+  uint8_t beatsin = sin8(beat + phase_offset);
+  uint8_t rangewidth = highest - lowest;
+  return lowest + scale8(beatsin, rangewidth);
+}
+
+inline uint16_t beatsin16(accum88 beats_per_minute, uint16_t lowest = 0, uint16_t highest = 65535,
+                          uint32_t timebase = 0, uint16_t phase_offset = 0)
+{
+  uint16_t beat = beat16(beats_per_minute, timebase);
+  uint16_t beatsin = (sin16(beat + phase_offset) + 32768);
+  uint16_t rangewidth = highest - lowest;
+  return lowest + scale16(beatsin, rangewidth);
+}
+
+inline uint16_t beatsin88(accum88 beats_per_minute_88, uint16_t lowest = 0, uint16_t highest = 65535,
+                          uint32_t timebase = 0, uint16_t phase_offset = 0)
+{
+  uint16_t beat = beat88(beats_per_minute_88, timebase);
+  uint16_t beatsin = (sin16(beat + phase_offset) + 32768);
+  uint16_t rangewidth = highest - lowest;
+  return lowest + scale16(beatsin, rangewidth);
+}
+
+// ---------------------------------------------------------------- noise (not used on the host)
+
+uint16_t inoise16(uint32_t x, uint32_t y, uint32_t z);
+uint16_t inoise16(uint32_t x, uint32_t y);
+uint8_t inoise8(uint16_t x, uint16_t y, uint16_t z);
+uint8_t inoise8(uint16_t x, uint16_t y);
+
+// ---------------------------------------------------------------- colours
+
+struct CRGB;
+
+struct CHSV
+{
+  union {
+    struct { union { uint8_t hue; uint8_t h; }; union { uint8_t saturation; uint8_t sat; uint8_t s; }; union { uint8_t value; uint8_t val; uint8_t v; }; };
+    uint8_t raw[3];
+  };
+  CHSV() = default;
+  CHSV(uint8_t ih, uint8_t is, uint8_t iv) : hue(ih), sat(is), val(iv) {}
+};
+
+void hsv2rgb_rainbow(const CHSV &hsv, CRGB &rgb);
+void hsv2rgb_spectrum(const CHSV &hsv, CRGB &rgb);
+void hsv2rgb_raw(const CHSV &hsv, CRGB &rgb);
+
+struct CRGB
+{
+  union {
+    struct { union { uint8_t r; uint8_t red; }; union { uint8_t g; uint8_t green; }; union { uint8_t b; uint8_t blue; }; };
+    uint8_t raw[3];
+  };
+
+  typedef enum {
+    Aqua = 0x00FFFF, Aquamarine = 0x7FFFD4, Black = 0x000000, Blue = 0x0000FF, CadetBlue = 0x5F9EA0,
+    CornflowerBlue = 0x6495ED, DarkBlue = 0x00008B, DarkCyan = 0x008B8B, DarkGreen = 0x006400,
+    DarkOliveGreen = 0x556B2F, DarkRed = 0x8B0000, ForestGreen = 0x228B22, Green = 0x008000,
+    Indigo = 0x4B0082, LawnGreen = 0x7CFC00, LightBlue = 0xADD8E6, LightGreen = 0x90EE90,
+    LightSkyBlue = 0x87CEFA, LimeGreen = 0x32CD32, Maroon = 0x800000, MediumAquamarine = 0x66CDAA,
+    MediumBlue = 0x0000CD, MidnightBlue = 0x191970, Navy = 0x000080, OliveDrab = 0x6B8E23,
+    Orange = 0xFFA500, Red = 0xFF0000, SeaGreen = 0x2E8B57, SkyBlue = 0x87CEEB, Teal = 0x008080,
+    Violet = 0xEE82EE, White = 0xFFFFFF, Yellow = 0xFFFF00, YellowGreen = 0x9ACD32,
+  } HTMLColorCode;
+
+  uint8_t &operator[](uint8_t x) { return raw[x]; }
+  const uint8_t &operator[](uint8_t x) const { return raw[x]; }
+
+  CRGB() = default;
+  constexpr CRGB(uint8_t ir, uint8_t ig, uint8_t ib) : r(ir), g(ig), b(ib) {}
+  constexpr CRGB(uint32_t colorcode) : r((colorcode >> 16) & 0xFF), g((colorcode >> 8) & 0xFF), b((colorcode >> 0) & 0xFF) {}
+  constexpr CRGB(HTMLColorCode colorcode) : r((colorcode >> 16) & 0xFF), g((colorcode >> 8) & 0xFF), b((colorcode >> 0) & 0xFF) {}
+  CRGB(const CHSV &rhs) { hsv2rgb_rainbow(rhs, *this); }
+
+  CRGB &operator=(const CHSV &rhs) { hsv2rgb_rainbow(rhs, *this); return *this; }
+  CRGB &operator=(uint32_t colorcode) { r = (colorcode >> 16) & 0xFF; g = (colorcode >> 8) & 0xFF; b = colorcode & 0xFF; return *this; }
+  CRGB &setRGB(uint8_t nr, uint8_t ng, uint8_t nb) { r = nr; g = ng; b = nb; return *this; }
+  CRGB &setHSV(uint8_t hue, uint8_t sat, uint8_t val) { hsv2rgb_rainbow(CHSV(hue, sat, val), *this); return *this; }
+  CRGB &setHue(uint8_t hue) { hsv2rgb_rainbow(CHSV(hue, 255, 255), *this); return *this; }
+
+  CRGB &operator+=(const CRGB &rhs) { r = qadd8(r, rhs.r); g = qadd8(g, rhs.g); b = qadd8(b, rhs.b); return *this; }
+  CRGB &operator-=(const CRGB &rhs) { r = qsub8(r, rhs.r); g = qsub8(g, rhs.g); b = qsub8(b, rhs.b); return *this; }
+  CRGB &addToRGB(uint8_t d) { r = qadd8(r, d); g = qadd8(g, d); b = qadd8(b, d); return *this; }
+  CRGB &subtractFromRGB(uint8_t d) { r = qsub8(r, d); g = qsub8(g, d); b = qsub8(b, d); return *this; }
+  CRGB &operator*=(uint8_t d) { r = qmul8(r, d); g = qmul8(g, d); b = qmul8(b, d); return *this; }
+  CRGB &operator/=(uint8_t d) { r /= d; g /= d; b /= d; return *this; }
+  CRGB &operator>>=(uint8_t d) { r >>= d; g >>= d; b >>= d; return *this; }
+  CRGB &operator|=(const CRGB &rhs) { if (rhs.r > r) r = rhs.r; if (rhs.g > g) g = rhs.g; if (rhs.b > b) b = rhs.b; return *this; }
+  CRGB &operator&=(const CRGB &rhs) { if (rhs.r < r) r = rhs.r; if (rhs.g < g) g = rhs.g; if (rhs.b < b) b = rhs.b; return *this; }
+
+  CRGB &nscale8(uint8_t scaledown)
+  {
+    uint16_t scale_fixed = scaledown + 1;
+    r = (((uint16_t)r) * scale_fixed) >> 8;
+    g = (((uint16_t)g) * scale_fixed) >> 8;
+    b = (((uint16_t)b) * scale_fixed) >> 8;
+    return *this;
+  }
+  CRGB &nscale8_video(uint8_t scaledown)
+  {
+    r = scale8_video(r, scaledown);
+    g = scale8_video(g, scaledown);
+    b = scale8_video(b, scaledown);
+    return *this;
+  }
+  CRGB &operator%=(uint8_t scaledown) { return nscale8_video(scaledown); }
+  CRGB &fadeToBlackBy(uint8_t fadefactor) { return nscale8(255 - fadefactor); }
+  CRGB &fadeLightBy(uint8_t fadefactor) { return nscale8_video(255 - fadefactor); }
+  CRGB scale8(uint8_t scaledown) const { CRGB out = *this; return out.nscale8(scaledown); }
+
+  explicit operator bool() const { return r || g || b; }
+  CRGB operator-() const { return CRGB(255 - r, 255 - g, 255 - b); }
+
+  uint8_t getLuminance() const
+  {
+    return ::scale8(r, 54) + ::scale8(g, 183) + ::scale8(b, 18);
+  }
+  uint8_t getAverageLight() const
+  {
+    return ::scale8(r, 85) + ::scale8(g, 85) + ::scale8(b, 85);
+  }
+};
+
+inline bool operator==(const CRGB &lhs, const CRGB &rhs) { return lhs.r == rhs.r && lhs.g == rhs.g && lhs.b == rhs.b; }
+inline bool operator!=(const CRGB &lhs, const CRGB &rhs) { return !(lhs == rhs); }
+inline CRGB operator+(const CRGB &p1, const CRGB &p2) { return CRGB(qadd8(p1.r, p2.r), qadd8(p1.g, p2.g), qadd8(p1.b, p2.b)); }
+inline CRGB operator-(const CRGB &p1, const CRGB &p2) { return CRGB(qsub8(p1.r, p2.r), qsub8(p1.g, p2.g), qsub8(p1.b, p2.b)); }
+inline CRGB operator*(const CRGB &p1, uint8_t d) { return CRGB(qmul8(p1.r, d), qmul8(p1.g, d), qmul8(p1.b, d)); }
+inline CRGB operator/(const CRGB &p1, uint8_t d) { return CRGB(p1.r / d, p1.g / d, p1.b / d); }
+inline CRGB operator%(const CRGB &p1, uint8_t d) { CRGB r = p1; r.nscale8_video(d); return r; }
+
+inline void hsv2rgb_raw(const CHSV &hsv, CRGB &rgb)
+{
+  uint8_t value = hsv.val;
+  uint8_t saturation = hsv.sat;
+  uint8_t invsat = 255 - saturation;
+  uint8_t brightness_floor = (value * invsat) / 256;
+  uint8_t color_amplitude = value - brightness_floor;
+  uint8_t section = hsv.hue / 0x40;
+  uint8_t offset = hsv.hue % 0x40;
+  uint8_t rampup = offset;
+  uint8_t rampdown = (0x40 - 1) - offset;
+  uint8_t rampup_amp_adj = (rampup * color_amplitude) / (256 / 4);
+  uint8_t rampdown_amp_adj = (rampdown * color_amplitude) / (256 / 4);
+  uint8_t rampup_adj_with_floor = rampup_amp_adj + brightness_floor;
+  uint8_t rampdown_adj_with_floor = rampdown_amp_adj + brightness_floor;
+  if (section) {
+    if (section == 1)
+      rgb = CRGB(brightness_floor, rampdown_adj_with_floor, rampup_adj_with_floor);
+    else
+      rgb = CRGB(rampup_adj_with_floor, brightness_floor, rampdown_adj_with_floor);
+  } else {
+    rgb = CRGB(rampdown_adj_with_floor, rampup_adj_with_floor, brightness_floor);
+  }
+}
+
+inline void hsv2rgb_spectrum(const CHSV &hsv, CRGB &rgb)
+{
+  CHSV hsv2(hsv);
+  hsv2.hue = scale8(hsv2.hue, 191);
+  hsv2rgb_raw(hsv2, rgb);
+}
+
+inline void hsv2rgb_rainbow(const CHSV &hsv, CRGB &rgb)
+{
+  const uint8_t K255 = 255, K171 = 171, K170 = 170, K85 = 85;
+  uint8_t hue = hsv.hue, sat = hsv.sat, val = hsv.val;
+  uint8_t offset8 = (hue & 0x1F) << 3;
+  uint8_t third = scale8(offset8, (256 / 3));
+  uint8_t r, g, b;
+  if (!(hue & 0x80)) {
+    if (!(hue & 0x40)) {
+      if (!(hue & 0x20)) { r = K255 - third; g = third; b = 0; }
+      else { r = K171; g = K85 + third; b = 0; }
+    } else {
+      if (!(hue & 0x20)) { uint8_t twothirds = scale8(offset8, ((256 * 2) / 3)); r = K171 - twothirds; g = K170 + third; b = 0; }
+      else { r = 0; g = K255 - third; b = third; }
+    }
+  } else {
+    if (!(hue & 0x40)) {
+      if (!(hue & 0x20)) { r = 0; uint8_t twothirds = scale8(offset8, ((256 * 2) / 3)); g = K171 - twothirds; b = K85 + twothirds; }
+      else { r = third; g = 0; b = K255 - third; }
+    } else {
+      if (!(hue & 0x20)) { r = K85 + third; g = 0; b = K171 - third; }
+      else { r = K170 + third; g = 0; b = K85 - third; }
+    }
+  }
+  if (sat != 255) {
+    if (sat == 0) {
+      r = 255; b = 255; g = 255;
+    } else {
+      uint8_t desat = 255 - sat;
+      desat = scale8_video(desat, desat);
+      uint8_t satscale = 255 - desat;
+      r = scale8(r, satscale) + desat;
+      g = scale8(g, satscale) + desat;
+      b = scale8(b, satscale) + desat;
+    }
+  }
+  if (val != 255) {
+    val = scale8_video(val, val);
+    if (val == 0) {
+      r = 0; g = 0; b = 0;
+    } else {
+      r = scale8(r, val);
+      g = scale8(g, val);
+      b = scale8(b, val);
+    }
+  }
+  rgb = CRGB(r, g, b);
+}
+
+inline CRGB blend(const CRGB &p1, const CRGB &p2, fract8 amountOfP2)
+{
+  return CRGB(blend8(p1.r, p2.r, amountOfP2), blend8(p1.g, p2.g, amountOfP2), blend8(p1.b, p2.b, amountOfP2));
+}
+
+inline CRGB &nblend(CRGB &existing, const CRGB &overlay, fract8 amountOfOverlay)
+{
+  if (amountOfOverlay == 0)
+    return existing;
+  if (amountOfOverlay == 255) {
+    existing = overlay;
+    return existing;
+  }
+  existing = blend(existing, overlay, amountOfOverlay);
+  return existing;
+}
+
+inline void nscale8(CRGB *leds, uint16_t num_leds, uint8_t scale)
+{
+  for (uint16_t i = 0; i < num_leds; ++i)
+    leds[i].nscale8(scale);
+}
+inline void fadeToBlackBy(CRGB *leds, uint16_t num_leds, uint8_t fadeBy) { nscale8(leds, num_leds, 255 - fadeBy); }
+inline void fill_solid(CRGB *leds, int numToFill, const CRGB &color)
+{
+  for (int i = 0; i < numToFill; ++i)
+    leds[i] = color;
+}
+
+inline void fill_gradient_RGB(CRGB *leds, uint16_t startpos, CRGB startcolor, uint16_t endpos, CRGB endcolor)
+{
+  if (endpos < startpos) {
+    std::swap(endpos, startpos);
+    std::swap(endcolor, startcolor);
+  }
+  saccum87 rdistance87 = (endcolor.r - startcolor.r) << 7;
+  saccum87 gdistance87 = (endcolor.g - startcolor.g) << 7;
+  saccum87 bdistance87 = (endcolor.b - startcolor.b) << 7;
+  uint16_t pixeldistance = endpos - startpos;
+  int16_t divisor = pixeldistance ? pixeldistance : 1;
+  saccum87 rdelta87 = rdistance87 / divisor;
+  saccum87 gdelta87 = gdistance87 / divisor;
+  saccum87 bdelta87 = bdistance87 / divisor;
+  rdelta87 *= 2;
+  gdelta87 *= 2;
+  bdelta87 *= 2;
+  accum88 r88 = startcolor.r << 8;
+  accum88 g88 = startcolor.g << 8;
+  accum88 b88 = startcolor.b << 8;
+  for (uint16_t i = startpos; i <= endpos; ++i) {
+    leds[i] = CRGB(r88 >> 8, g88 >> 8, b88 >> 8);
+    r88 += rdelta87;
+    g88 += gdelta87;
+    b88 += bdelta87;
+  }
+}
+
+// ---------------------------------------------------------------- palettes
+
+typedef uint32_t TProgmemRGBPalette16[16];
+
+enum TBlendType { NOBLEND = 0, LINEARBLEND = 1, LINEARBLEND_NOWRAP = 2 };
+
+class CRGBPalette16
+{
+public:
+  CRGB entries[16];
+
+  CRGBPalette16() { memset(entries, 0, sizeof(entries)); }
+  CRGBPalette16(const TProgmemRGBPalette16 &rhs)
+  {
+    for (int i = 0; i < 16; ++i)
+      entries[i] = rhs[i];
+  }
+  CRGBPalette16(const CRGB &c1)
+  {
+    fill_solid(entries, 16, c1);
+  }
+  CRGBPalette16(const CRGB &c1, const CRGB &c2)
+  {
+    fill_gradient_RGB(entries, 0, c1, 15, c2);
+  }
+  CRGBPalette16(const CRGB &c1, const CRGB &c2, const CRGB &c3)
+  {
+    fill_gradient_RGB(entries, 0, c1, 7, c2);
+    fill_gradient_RGB(entries, 7, c2, 15, c3);
+  }
+  CRGBPalette16(const CRGB &c1, const CRGB &c2, const CRGB &c3, const CRGB &c4)
+  {
+    fill_gradient_RGB(entries, 0, c1, 5, c2);
+    fill_gradient_RGB(entries, 5, c2, 10, c3);
+    fill_gradient_RGB(entries, 10, c3, 15, c4);
+  }
+  CRGBPalette16(const CRGB &c00, const CRGB &c01, const CRGB &c02, const CRGB &c03,
+                const CRGB &c04, const CRGB &c05, const CRGB &c06, const CRGB &c07,
+                const CRGB &c08, const CRGB &c09, const CRGB &c10, const CRGB &c11,
+                const CRGB &c12, const CRGB &c13, const CRGB &c14, const CRGB &c15)
+  {
+    const CRGB c[16] = {c00, c01, c02, c03, c04, c05, c06, c07, c08, c09, c10, c11, c12, c13, c14, c15};
+    memcpy(entries, c, sizeof(entries));
+  }
+
+  CRGBPalette16 &operator=(const TProgmemRGBPalette16 &rhs)
+  {
+    for (int i = 0; i < 16; ++i)
+      entries[i] = rhs[i];
+    return *this;
+  }
+
+  bool operator==(const CRGBPalette16 &rhs) const { return memcmp(entries, rhs.entries, sizeof(entries)) == 0; }
+  bool operator!=(const CRGBPalette16 &rhs) const { return !(*this == rhs); }
+
+  CRGB &operator[](uint8_t x) { return entries[x]; }
+  const CRGB &operator[](uint8_t x) const { return entries[x]; }
+};
+
+inline CRGB ColorFromPalette(const CRGBPalette16 &pal, uint8_t index, uint8_t brightness = 255, TBlendType blendType = LINEARBLEND)
+{
+  uint8_t hi4 = index >> 4;
+  uint8_t lo4 = index & 0x0F;
+  const CRGB *entry = &(pal[0]) + hi4;
+  uint8_t red1 = entry->r;
+  uint8_t green1 = entry->g;
+  uint8_t blue1 = entry->b;
+  uint8_t blend = lo4 && (blendType != NOBLEND);
+  if (blendType == LINEARBLEND_NOWRAP && hi4 == 15)
+    blend = 0;
+  if (blend) {
+    if (hi4 == 15)
+      entry = &(pal[0]);
+    else
+      ++entry;
+    uint8_t f2 = lo4 << 4;
+    uint8_t f1 = 255 - f2;
+    red1 = scale8(red1, f1) + scale8(entry->r, f2);
+    green1 = scale8(green1, f1) + scale8(entry->g, f2);
+    blue1 = scale8(blue1, f1) + scale8(entry->b, f2);
+  }
+  if (brightness != 255) {
+    if (brightness) {
+      ++brightness;
+      red1 = scale8(red1, brightness);
+      green1 = scale8(green1, brightness);
+      blue1 = scale8(blue1, brightness);
+    } else {
+      red1 = green1 = blue1 = 0;
+    }
+  }
+  return CRGB(red1, green1, blue1);
+}
+
+inline void nblendPaletteTowardPalette(CRGBPalette16 &current, CRGBPalette16 &target, uint8_t maxChanges)
+{
+  uint8_t *p1 = (uint8_t *)current.entries;
+  uint8_t *p2 = (uint8_t *)target.entries;
+  const uint8_t totalChannels = sizeof(CRGBPalette16);
+  uint8_t changes = 0;
+  for (uint8_t i = 0; i < totalChannels; ++i) {
+    if (p1[i] == p2[i])
+      continue;
+    if (p1[i] < p2[i]) {
+      ++p1[i];
+      ++changes;
+    }
+    if (p1[i] > p2[i]) {
+      --p1[i];
+      ++changes;
+      if (p1[i] > p2[i])
+        --p1[i];
+    }
+    if (changes >= maxChanges)
+      break;
+  }
+}
+
+inline const TProgmemRGBPalette16 CloudColors_p = {
+  CRGB::Blue, CRGB::DarkBlue, CRGB::DarkBlue, CRGB::DarkBlue,
+  CRGB::DarkBlue, CRGB::DarkBlue, CRGB::DarkBlue, CRGB::DarkBlue,
+  CRGB::Blue, CRGB::DarkBlue, CRGB::SkyBlue, CRGB::SkyBlue,
+  CRGB::LightBlue, CRGB::White, CRGB::LightBlue, CRGB::SkyBlue};
+
+inline const TProgmemRGBPalette16 LavaColors_p = {
+  CRGB::Black, CRGB::Maroon, CRGB::Black, CRGB::Maroon,
+  CRGB::DarkRed, CRGB::DarkRed, CRGB::Maroon, CRGB::DarkRed,
+  CRGB::DarkRed, CRGB::DarkRed, CRGB::Red, CRGB::Orange,
+  CRGB::White, CRGB::Orange, CRGB::Red, CRGB::DarkRed};
+
+inline const TProgmemRGBPalette16 OceanColors_p = {
+  CRGB::MidnightBlue, CRGB::DarkBlue, CRGB::MidnightBlue, CRGB::Navy,
+  CRGB::DarkBlue, CRGB::MediumBlue, CRGB::SeaGreen, CRGB::Teal,
+  CRGB::CadetBlue, CRGB::Blue, CRGB::DarkCyan, CRGB::CornflowerBlue,
+  CRGB::Aquamarine, CRGB::SeaGreen, CRGB::Aqua, CRGB::LightSkyBlue};
+
+inline const TProgmemRGBPalette16 ForestColors_p = {
+  CRGB::DarkGreen, CRGB::DarkGreen, CRGB::DarkOliveGreen, CRGB::DarkGreen,
+  CRGB::Green, CRGB::ForestGreen, CRGB::OliveDrab, CRGB::Green,
+  CRGB::SeaGreen, CRGB::MediumAquamarine, CRGB::LimeGreen, CRGB::YellowGreen,
+  CRGB::LightGreen, CRGB::LawnGreen, CRGB::MediumAquamarine, CRGB::ForestGreen};
+
+inline const TProgmemRGBPalette16 RainbowColors_p = {
+  0xFF0000, 0xD52A00, 0xAB5500, 0xAB7F00, 0xABAB00, 0x56D500, 0x00FF00, 0x00D52A,
+  0x00AB55, 0x0056AA, 0x0000FF, 0x2A00D5, 0x5500AB, 0x7F0081, 0xAB0055, 0xD5002B};
+
+inline const TProgmemRGBPalette16 RainbowStripeColors_p = {
+  0xFF0000, 0x000000, 0xAB5500, 0x000000, 0xABAB00, 0x000000, 0x00FF00, 0x000000,
+  0x00AB55, 0x000000, 0x0000FF, 0x000000, 0x5500AB, 0x000000, 0xAB0055, 0x000000};
+
+inline const TProgmemRGBPalette16 PartyColors_p = {
+  0x5500AB, 0x84007C, 0xB5004B, 0xE5001B, 0xE81700, 0xB84700, 0xAB7700, 0xABAB00,
+  0xAB5500, 0xDD2200, 0xF2000E, 0xC2003E, 0x8F0071, 0x5F00A1, 0x2F00D0, 0x0007F9};
+
+inline const TProgmemRGBPalette16 HeatColors_p = {
+  0x000000, 0x330000, 0x660000, 0x990000, 0xCC0000, 0xFF0000, 0xFF3300, 0xFF6600,
+  0xFF9900, 0xFFCC00, 0xFFFF00, 0xFFFF33, 0xFFFF66, 0xFFFF99, 0xFFFFCC, 0xFFFFFF};
+
+#endif
@@ -0,0 +1,58 @@
+// Shared set-up for the host programs that run the Aurora patterns (src/Aurora) off target.
+//
+// The program defines the global EffectsLayer 'effects' the patterns draw into; this file
+// gives it a MatrixDisplay to upload to and puts every input a pattern reads (clock, both
+// random generators, palette, canvas) into a known state, so two runs can be compared frame
+// by frame.
+
+#ifndef AURORA_HOST_HPP
+#define AURORA_HOST_HPP
+
+#include <chrono>
+#include <vector>
+#include "../../../../src/Aurora/EffectsLayer.hpp"
+
+// Start of a run: time 0, seeded random(), FastLED's random8/16 at their power-on seed, the
+// Rainbow palette fully blended in and an empty CRGB canvas
+inline void aurora_reset(unsigned seed)
+{
+  host_micros = 0;
+  srand(seed);
+  random16_set_seed(1337);
+  effects.setPixelFormat(PIXEL_CRGB);
+  effects.loadPalette(0);
+  effects.currentPalette = effects.targetPalette;
+  effects.paletteChanged();
+  effects.ClearFrame();
+}
+
+// Canvas size for the next patterns; construct patterns after this, some size themselves from it
+inline void aurora_resize(MatrixDisplay &display, int w, int h)
+{
+  effects.resize(w, h);
+  display = MatrixDisplay(w, h);
+  effects.virtualDisp = &display;
+}
+
+// FNV-1a of a byte buffer (an uploaded frame, a canvas)
+inline uint64_t aurora_hash(const void *data, size_t n, uint64_t h = 1469598103934665603ull)
+{
+  const uint8_t *p = (const uint8_t *)data;
+  for (size_t i = 0; i < n; i++)
+  {
+    h ^= p[i];
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
+template <typename F>
+inline double aurora_time_us(F f, int n)
+{
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < n; i++)
+    f(i);
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / n;
+}
+
+#endif
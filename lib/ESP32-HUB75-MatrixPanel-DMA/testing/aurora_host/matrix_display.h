@@ -0,0 +1,35 @@
+// Host stand-in for MatrixDisplay (include/matrix_display.h): ShowFrame() uploads into a plain
+// RGB888 frame instead of the DMA buffer.
+
+#ifndef AURORA_HOST_MATRIX_DISPLAY_H
+#define AURORA_HOST_MATRIX_DISPLAY_H
+
+#include "Arduino.h"
+#include "config.h"
+#include <vector>
+
+class MatrixDisplay
+{
+public:
+  MatrixDisplay(int w = 0, int h = 0) : width(w), height(h), frame(w * h * 3) {}
+
+  void drawPixelRGB888(int16_t x, int16_t y, uint8_t r, uint8_t g, uint8_t b)
+  {
+    if (x < 0 || x >= width || y < 0 || y >= height)
+      return;
+    uint8_t *px = &frame[(y * width + x) * 3];
+    px[0] = r;
+    px[1] = g;
+    px[2] = b;
+  }
+
+  static uint16_t color565(uint8_t r, uint8_t g, uint8_t b)
+  {
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+  }
+
+  int width, height;
+  std::vector<uint8_t> frame;
+};
+
+#endif
@@ -0,0 +1,164 @@
+// Host side golden-frame check of src/Aurora/PatternMaze.hpp
+//
+// PatternMaze with a fixed seed, four mazes per canvas (newest-cell and random-cell growing
+// tree, each solved by BFS and by A*), at 64x32, 64x64, 128x64 and 256x128:
+//  - every generated maze is perfect: cells - 1 passages and every cell reachable;
+//  - the solver's path length is the shortest one (a BFS of the carved maze; on a maze with
+//    loops A* could stop at a longer one), and the traced path is that many white cells and
+//    passages;
+//  - a second run with the same seed draws the same frames, every one of them;
+//  - the hash of all frames matches the golden value recorded below. It changes whenever the
+//    pattern draws differently or draws its random numbers differently; record the new value
+//    only for a change that is meant to do that.
+//
+//   g++ -std=c++17 -O2 -Iaurora_host -I../../../include -o aurora_maze.exe aurora_maze.cpp ../../../src/row_jobs.cpp -lpthread && ./aurora_maze.exe
+
+#include <cstdio>
+#include <queue>
+#include "aurora_host/aurora_host.hpp"
+
+EffectsLayer effects(64, 64);
+static MatrixDisplay display;
+
+// The checks read the maze and the solver state
+#define private public
+#include "../../../src/Aurora/PatternMaze.hpp"
+
+static const uint32_t SEED = 12345;
+static const int MAZES = 4;
+
+// Cells - 1 passages and all cells reachable from the start; returns the BFS distance to the goal
+static int check_perfect(const PatternMaze &m, bool *ok)
+{
+  const int n = m.cellCount;
+  int passages = 0;
+  for (int c = 0; c < n; c++)
+    for (int d = PatternMaze::Right; d <= PatternMaze::Down; d++)
+      passages += m.neighbour(c, d) >= 0 && m.isOpen(c, d);
+
+  std::vector<int> dist(n, -1);
+  std::queue<int> q;
+  dist[0] = 0;
+  q.push(0);
+  while (!q.empty())
+  {
+    int c = q.front();
+    q.pop();
+    for (int d = 0; d < 4; d++)
+    {
+      int nb = m.neighbour(c, d);
+      if (nb >= 0 && m.isOpen(c, d) && dist[nb] < 0)
+      {
+        dist[nb] = dist[c] + 1;
+        q.push(nb);
+      }
+    }
+  }
+
+  int reached = 0;
+  for (int v : dist)
+    reached += v >= 0;
+  if (passages != n - 1 || reached != n)
+  {
+    printf("    not a perfect maze: %d passages, %d of %d cells reached\n", passages, reached, n);
+    *ok = false;
+  }
+  return dist[n - 1];
+}
+
+static int white_pixels()
+{
+  int n = 0;
+  for (int i = 0; i < effects.num_leds; i++)
+    n += effects.leds[i] == CRGB(CRGB::White);
+  return n;
+}
+
+struct Run
+{
+  uint64_t hash = 1469598103934665603ull;
+  std::vector<uint64_t> frames; // hash of each frame
+  bool ok = true;
+};
+
+// MAZES mazes with SEED from a reset canvas, checking each maze as it is generated and solved
+static Run run()
+{
+  aurora_reset(1);
+  PatternMaze m;
+  m.seed = SEED;
+  m.start();
+
+  Run r;
+  int mazes = 0, shortest = -1;
+  const char *algorithm[2] = {"newest", "random"};
+  while (mazes < MAZES)
+  {
+    PatternMaze::Phase before = m.phase;
+    m.drawFrame();
+
+    uint64_t h = aurora_hash(effects.leds, effects.num_leds * sizeof(CRGB));
+    r.frames.push_back(h);
+    r.hash = aurora_hash(&h, sizeof(h), r.hash);
+
+    if (before == PatternMaze::GENERATE && m.phase == PatternMaze::SOLVE)
+      shortest = check_perfect(m, &r.ok);
+    if (before == PatternMaze::SOLVE && m.phase != PatternMaze::SOLVE && m.cost[m.cellCount - 1] != shortest)
+    {
+      printf("    %s cell / %s: path of %d steps, the shortest is %d\n", algorithm[m.algorithm], m.useAStar ? "A*" : "BFS",
+             m.cost[m.cellCount - 1], shortest);
+      r.ok = false;
+    }
+    if (before == PatternMaze::TRACE && m.phase == PatternMaze::HOLD && white_pixels() != 2 * shortest + 1)
+    {
+      printf("    traced path: %d white pixels, expected %d\n", white_pixels(), 2 * shortest + 1);
+      r.ok = false;
+    }
+    if (before == PatternMaze::HOLD && m.phase == PatternMaze::GENERATE)
+      mazes++;
+  }
+  m.stop();
+  return r;
+}
+
+static bool check(int w, int h, uint64_t golden)
+{
+  aurora_resize(display, w, h);
+  Run first = run();
+  Run replay = run();
+
+  size_t differ = 0;
+  while (differ < first.frames.size() && first.frames[differ] == replay.frames[differ])
+    differ++;
+  bool same = differ == first.frames.size() && replay.frames.size() == first.frames.size();
+  bool match = first.hash == golden;
+
+  printf("  %3dx%-3d %5zu frames  mazes / paths %s  replay %s  hash %016llx %s\n", w, h, first.frames.size(),
+         first.ok ? "OK" : "FAIL", same ? "identical" : "FAIL", (unsigned long long)first.hash,
+         match ? "= golden" : "FAIL: golden differs");
+  if (!same)
+    printf("    first different frame: %zu\n", differ);
+  return first.ok && same && match;
+}
+
+int main()
+{
+  const struct
+  {
+    int w, h;
+    uint64_t golden;
+  } cases[] = {
+      {64, 32, 0x6effd1dc90d6f7e7ull},
+      {64, 64, 0xb5656b5e9293165dull},
+      {128, 64, 0x41c99c98a0bc319dull},
+      {256, 128, 0x04994aff81d021b7ull},
+  };
+
+  bool ok = true;
+  printf("PatternMaze, seed %u, %d mazes per canvas:\n", SEED, MAZES);
+  for (auto &c : cases)
+    ok &= check(c.w, c.h, c.golden);
+
+  printf(ok ? "\nSUCCESS: perfect mazes, shortest paths, frames as recorded.\n" : "\nERROR: maze check failed.\n");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,179 @@
+// Host side benchmark of the structure-of-arrays particle engine (src/Aurora/ParticleSystem.hpp)
+//
+// Stardust Burst's particle work, with the pool kept full so every frame respawns what died:
+//  - before : the array of StardustParticle structs (float position / velocity, active flag,
+//             random() / cosf / sinf per spawn, round() per draw), transcribed from the pattern
+//             before ParticlePool;
+//  - after  : ParticlePool<N>::emit() + update() + draw() with Stardust's draw flags.
+// Both run spawn + update + draw on a 128x64 canvas for 256, 1024 and 4096 slots. Reported per
+// frame: live particles, time, ns per live particle, and how many particles that is in one
+// 60 fps frame (16.7 ms) on this machine.
+//
+//   g++ -std=c++17 -O2 -Iaurora_host -I../../../include -o aurora_particles.exe aurora_particles.cpp ../../../src/row_jobs.cpp -lpthread && ./aurora_particles.exe
+
+#include <cstdio>
+#include "aurora_host/aurora_host.hpp"
+
+EffectsLayer effects(128, 64);
+static MatrixDisplay display;
+
+#include "../../../src/Aurora/ParticleSystem.hpp"
+
+static const int WARMUP = 200;
+static const int FRAMES = 3000;
+
+// DO NOT CHANGE: Stardust Burst's particles before ParticlePool, spawnBurst() filling every
+// free slot instead of 6
+namespace baseline
+{
+
+struct StardustParticle
+{
+  float x, y;
+  float vx, vy;
+  CRGB color;
+  int age;
+  int maxAge;
+  bool active;
+
+  StardustParticle() : x(0), y(0), vx(0), vy(0), color(CRGB::Black), age(0), maxAge(0), active(false) {}
+};
+
+template <int N>
+struct Stardust
+{
+  StardustParticle particles[N];
+
+  void spawnBurst()
+  {
+    float burstOriginX = random(0, effects.width);
+    float burstOriginY = random(0, effects.height);
+    CRGB burstBaseColor = effects.ColorFromCurrentPalette(random8(), 255);
+
+    for (int i = 0; i < N; ++i)
+    {
+      if (!particles[i].active)
+      {
+        particles[i].active = true;
+        particles[i].x = burstOriginX;
+        particles[i].y = burstOriginY;
+
+        float angle = random(0, 360) * (PI / 180.0f);
+        float speed = random(10, (int)(0.9f * 100)) / 100.0f;
+
+        particles[i].vx = cos(angle) * speed;
+        particles[i].vy = sin(angle) * speed;
+        particles[i].color = burstBaseColor;
+        particles[i].age = 0;
+        particles[i].maxAge = random(25, 60);
+      }
+    }
+  }
+
+  int frame()
+  {
+    spawnBurst();
+
+    int alive = 0;
+    for (int i = 0; i < N; ++i)
+    {
+      if (particles[i].active)
+      {
+        particles[i].x += particles[i].vx;
+        particles[i].y += particles[i].vy;
+        particles[i].age++;
+
+        if (particles[i].age > particles[i].maxAge ||
+            particles[i].x < 0 || particles[i].x >= effects.width ||
+            particles[i].y < 0 || particles[i].y >= effects.height)
+        {
+          particles[i].active = false;
+          continue;
+        }
+
+        uint8_t brightness = 255;
+        if (particles[i].maxAge > 0)
+          brightness = ease8InOutQuad((float)(particles[i].maxAge - particles[i].age) * 255.0f / particles[i].maxAge);
+
+        CRGB displayColor = particles[i].color;
+        displayColor.nscale8(brightness);
+
+        int drawX = round(particles[i].x);
+        int drawY = round(particles[i].y);
+        if (drawX >= 0 && drawX < effects.width && drawY >= 0 && drawY < effects.height)
+          effects.leds[effects.XY16(drawX, drawY)] += displayColor;
+        alive++;
+      }
+    }
+    return alive;
+  }
+};
+
+} // namespace baseline
+
+// Stardust Burst on ParticlePool, emitting into every free slot
+template <int N>
+struct PoolStardust
+{
+  ParticlePool<N> pool;
+
+  PoolStardust() { pool.drawFlags = PARTICLE_DRAW_FADE | PARTICLE_DRAW_EASED | PARTICLE_DRAW_ADD; }
+
+  int frame()
+  {
+    ParticleEmitter burst;
+    burst.x = toPfix(random16(effects.width)) + PFIX_ONE / 2;
+    burst.y = toPfix(random16(effects.height)) + PFIX_ONE / 2;
+    burst.speedMin = 26;
+    burst.speedMax = 230;
+    burst.lifeMin = 25;
+    burst.lifeMax = 60;
+    burst.color = effects.ColorFromCurrentPalette(random8(), 255);
+    pool.emit(burst, N);
+
+    pool.update(effects);
+    pool.draw(effects);
+    return pool.count();
+  }
+};
+
+struct Result
+{
+  double us, alive;
+  double ns_per_particle() const { return us * 1000 / alive; }
+  double per_60fps_frame() const { return 16667.0 / us * alive; }
+};
+
+template <class S>
+static Result run(S &s)
+{
+  aurora_reset(1);
+  for (int i = 0; i < WARMUP; i++)
+    s.frame();
+
+  long alive = 0;
+  double us = aurora_time_us([&](int) { alive += s.frame(); }, FRAMES);
+  return Result{us, (double)alive / FRAMES};
+}
+
+template <int N>
+static void bench()
+{
+  static baseline::Stardust<N> before;
+  static PoolStardust<N> after;
+  Result b = run(before), a = run(after);
+
+  printf("  %5d slots  before: %6.0f live %8.1f us %6.1f ns/particle %8.0f per 60 fps frame\n", N, b.alive, b.us, b.ns_per_particle(), b.per_60fps_frame());
+  printf("               after:  %6.0f live %8.1f us %6.1f ns/particle %8.0f per 60 fps frame   %.2fx per particle\n",
+         a.alive, a.us, a.ns_per_particle(), a.per_60fps_frame(), b.ns_per_particle() / a.ns_per_particle());
+}
+
+int main()
+{
+  aurora_resize(display, 128, 64);
+  printf("Stardust spawn + update + draw, pool kept full, 128x64 (host):\n");
+  bench<256>();
+  bench<1024>();
+  bench<4096>();
+  return 0;
+}
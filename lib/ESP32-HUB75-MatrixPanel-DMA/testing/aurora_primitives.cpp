@@ -0,0 +1,138 @@
+// Host side check and microbenchmark of the frame-wide primitives of EffectsLayer
+// (src/Aurora/EffectsLayer.hpp): scaleAll(), fadeAll(), mapXY() and fillPalette()
+//
+// Each one against the per-pixel loop it replaced (column-major through XY16(), as in
+// Starfield, Munch and the palette fills):
+//  - scaleAll(s) must equal CRGB::nscale8(s) of every pixel for every s, and fadeAll(a)
+//    fadeToBlackBy(a) for every a, including canvases whose byte count is not a multiple of 4;
+//  - mapXY() and fillPalette() must write the same frame as the loops;
+//  - times both at 64x32, 64x64 and 128x128.
+//
+//   g++ -std=c++17 -O2 -Iaurora_host -I../../../include -o aurora_primitives.exe aurora_primitives.cpp ../../../src/row_jobs.cpp -lpthread && ./aurora_primitives.exe
+
+#include <cstdio>
+#include <cstring>
+#include "aurora_host/aurora_host.hpp"
+
+EffectsLayer effects(64, 64);
+static MatrixDisplay display;
+
+static const int N = 5000;
+
+static void random_frame(std::vector<CRGB> &frame)
+{
+  for (CRGB &c : frame)
+    c = CRGB(rand(), rand(), rand());
+}
+
+static bool same(const std::vector<CRGB> &ref)
+{
+  return memcmp(ref.data(), effects.leds, ref.size() * sizeof(CRGB)) == 0;
+}
+
+// scaleAll() / fadeAll() against nscale8() / fadeToBlackBy() per pixel, every scale
+static bool check_scale(int w, int h)
+{
+  aurora_resize(display, w, h);
+  std::vector<CRGB> frame(w * h), ref(w * h);
+
+  int fails = 0;
+  for (int s = 0; s < 256; s++)
+  {
+    random_frame(frame);
+    ref = frame;
+    for (CRGB &c : ref)
+      c.nscale8(s);
+    memcpy(effects.leds, frame.data(), w * h * sizeof(CRGB));
+    effects.scaleAll(s);
+    if (!same(ref) && fails++ < 3)
+      printf("    scaleAll(%d) differs\n", s);
+
+    ref = frame;
+    for (CRGB &c : ref)
+      c.fadeToBlackBy(s);
+    memcpy(effects.leds, frame.data(), w * h * sizeof(CRGB));
+    effects.fadeAll(s);
+    if (!same(ref) && fails++ < 3)
+      printf("    fadeAll(%d) differs\n", s);
+  }
+
+  printf("  %3dx%-3d scaleAll / fadeAll, 256 values each: %s\n", w, h, fails ? "FAIL" : "bit-exact");
+  return fails == 0;
+}
+
+static bool bench(int w, int h)
+{
+  aurora_resize(display, w, h);
+  std::vector<CRGB> frame(w * h);
+  random_frame(frame);
+  memcpy(effects.leds, frame.data(), w * h * sizeof(CRGB));
+  bool ok = true;
+
+  // scaleAll: the dim loop of Starfield / Rain
+  double t_loop = aurora_time_us([&](int) {
+    for (int16_t i = 0; i < effects.width; i++)
+      for (int16_t j = 0; j < effects.height; j++)
+        effects.leds[effects.XY16(i, j)].nscale8(250);
+  }, N);
+  double t_new = aurora_time_us([&](int) { effects.scaleAll(250); }, N);
+  printf("  %3dx%-3d scaleAll     loop %8.2f us   primitive %8.2f us   %5.2fx\n", w, h, t_loop, t_new, t_loop / t_new);
+
+  t_loop = aurora_time_us([&](int) {
+    for (int16_t i = 0; i < effects.width; i++)
+      for (int16_t j = 0; j < effects.height; j++)
+        effects.leds[effects.XY16(i, j)].fadeToBlackBy(20);
+  }, N);
+  t_new = aurora_time_us([&](int) { effects.fadeAll(20); }, N);
+  printf("  %3dx%-3d fadeAll      loop %8.2f us   primitive %8.2f us   %5.2fx\n", w, h, t_loop, t_new, t_loop / t_new);
+
+  // mapXY: the Munch kernel
+  uint8_t flip = 0, count = 40;
+  auto munch = [&](int x, int y, uint8_t generation) {
+    return (x ^ y ^ flip) < count ? effects.ColorFromCurrentPalette(((x ^ y) << 2) + generation) : CRGB(CRGB::Black);
+  };
+  t_loop = aurora_time_us([&](int g) {
+    for (uint16_t x = 0; x < effects.width; x++)
+      for (uint16_t y = 0; y < effects.height; y++)
+        effects.leds[effects.XY16(x, y)] = munch(x, y, g);
+  }, N);
+  std::vector<CRGB> ref(effects.leds, effects.leds + w * h);
+  t_new = aurora_time_us([&](int g) { effects.mapXY([&](int x, int y) { return munch(x, y, g); }); }, N);
+  ok &= same(ref);
+  printf("  %3dx%-3d mapXY        loop %8.2f us   primitive %8.2f us   %5.2fx   %s\n", w, h, t_loop, t_new, t_loop / t_new,
+         same(ref) ? "identical" : "FAIL");
+
+  // fillPalette: a palette index per pixel
+  t_loop = aurora_time_us([&](int g) {
+    for (uint16_t x = 0; x < effects.width; x++)
+      for (uint16_t y = 0; y < effects.height; y++)
+        effects.setPixelFromPaletteIndex(x, y, x * 2 + y + g);
+  }, N);
+  ref.assign(effects.leds, effects.leds + w * h);
+  t_new = aurora_time_us([&](int g) { effects.fillPalette([&](int x, int y) { return x * 2 + y + g; }); }, N);
+  ok &= same(ref);
+  printf("  %3dx%-3d fillPalette  loop %8.2f us   primitive %8.2f us   %5.2fx   %s\n", w, h, t_loop, t_new, t_loop / t_new,
+         same(ref) ? "identical" : "FAIL");
+
+  return ok;
+}
+
+int main()
+{
+  srand(5);
+  aurora_reset(5);
+
+  bool ok = true;
+  printf("Against nscale8() / fadeToBlackBy() per pixel:\n");
+  ok &= check_scale(64, 64);
+  ok &= check_scale(7, 5); // 105 bytes: the byte-wise tail
+  ok &= check_scale(1, 1);
+
+  printf("\nPer frame, old loop against the primitive:\n");
+  ok &= bench(64, 32);
+  ok &= bench(64, 64);
+  ok &= bench(128, 128);
+
+  printf(ok ? "\nSUCCESS: primitives match the per-pixel loops.\n" : "\nERROR: primitive mismatch.\n");
+  return ok ? 0 : 1;
+}
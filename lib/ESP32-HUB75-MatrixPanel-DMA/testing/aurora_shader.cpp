@@ -0,0 +1,349 @@
+// Host side check and benchmark of the per-pixel shader framework in src/Aurora/Shader.hpp
+//
+// Runs PatternPlasma, PatternJuliaSet (shaders) and PatternWave (every rotation / wave count;
+// its trail fade is now DimAll() ahead of the wave) next to the hand-written loops they
+// replaced (namespace baseline, transcribed from the tree before Shader.hpp) and, frame by
+// frame:
+//  - compares the uploaded frames, which must be identical;
+//  - times drawFrame() without the upload, on one core.
+// The patterns are built against the host stand-ins in aurora_host/ (FastLED, Adafruit_GFX,
+// MatrixDisplay).
+//
+//   g++ -std=c++17 -O2 -Iaurora_host -I../../../include -o aurora_shader.exe aurora_shader.cpp ../../../src/row_jobs.cpp -lpthread && ./aurora_shader.exe
+
+#include <cstdio>
+#include <cstring>
+#include "aurora_host/aurora_host.hpp"
+
+EffectsLayer effects(64, 64);
+
+#include "../../../src/Aurora/PatternPlasma.hpp"
+#include "../../../src/Aurora/PatternJuliaSetFractal.hpp"
+#include "../../../src/Aurora/PatternWave.hpp"
+
+// DO NOT CHANGE: the patterns as they were before Shader.hpp. Each uploads its own frame, and
+// Julia's fl::blur2d() is effects.blur(), which gives the same result (aurora_blur.cpp)
+namespace baseline
+{
+
+class PatternPlasma : public Drawable
+{
+private:
+  int time = 0;
+  int cycles = 0;
+
+public:
+  PatternPlasma() { name = (char *)"Plasma"; }
+
+  void renderRows(int y0, int y1)
+  {
+    uint8_t wibble = sin8(time);
+    uint8_t cosTime = cos8(-time);
+    for (int y = y0; y < y1; y++)
+    {
+      for (int x = 0; x < effects.width; x++)
+      {
+        int16_t v = 0;
+        v += sin16(x * wibble * 6 + time);
+        v += cos16(y * (128 - wibble) * 6 + time);
+        v += sin16(y * x * cosTime / 8);
+
+        effects.setPixelFromPaletteIndex(x, y, (v >> 8) + 127);
+      }
+    }
+  }
+
+  unsigned int drawFrame()
+  {
+    rowJobs.render(*this, effects.height);
+
+    time += 1;
+    cycles++;
+
+    if (cycles >= 2048)
+    {
+      time = 0;
+      cycles = 0;
+    }
+
+    effects.ShowFrame();
+
+    return 30;
+  }
+};
+
+class PatternJuliaSet : public Drawable
+{
+private:
+  float sint[256];
+
+  double t;
+  float xoff, yoff;
+
+public:
+  PatternJuliaSet() { name = (char *)"Julia Set"; }
+
+  void start()
+  {
+    for (int i = 0; i < 256; i++)
+      sint[i] = sinf(i / 256.f * 2.f * PI);
+  }
+
+  void drawPixelPalette(int x, int y, uint32_t m)
+  {
+    float r = 0.f, g = 0.f, b = 0.f;
+    if (m)
+    {
+      char n = m >> 4;
+      float l = abs(sint[m >> 2 & 255]) * 255.f;
+      float s = (sint[m & 255] + 1.f) * 0.5f;
+      r = (max(min(sint[n & 255] + 0.5f, 1.f), 0.f) * s + (1 - s)) * l;
+      g = (max(min(sint[(n + 85) & 255] + 0.5f, 1.f), 0.f) * s + (1 - s)) * l;
+      b = (max(min(sint[(n + 170) & 255] + 0.5f, 1.f), 0.f) * s + (1 - s)) * l;
+    }
+    effects.leds[effects.XY16(x, y)] = CRGB(r, g, b);
+  }
+
+  void renderRows(int y0, int y1)
+  {
+    for (uint16_t y = y0; y < y1; y++)
+    {
+      for (uint16_t x = 0; x < effects.width; x++)
+      {
+        uint32_t itcount = iteratefloat(xoff, yoff, ((x - 64) + 1) / 64.f, (y) / 64.f, 64);
+        uint32_t itcolor = itcount ? floatsqrt(itcount) * 4 + t * 1024 : 0;
+        drawPixelPalette(x, y, itcolor);
+      }
+    }
+  }
+
+  unsigned int drawFrame()
+  {
+    uint32_t lastMicros = micros();
+    t = (double)lastMicros / 8000000;
+    double k = sin(t * 3.212 / 2) * sin(t * 3.212 / 2) / 16 + 1;
+    float cosk = (k - cos(t)) / 2;
+    xoff = (cos(t) * cosk + k / 2 - 0.25);
+    yoff = (sin(t) * cosk);
+    rowJobs.render(*this, effects.height);
+
+    effects.blur(64);
+
+    effects.ShowFrame();
+    return 0;
+  }
+};
+
+class PatternWave : public Drawable
+{
+private:
+  byte thetaUpdate = 0;
+  byte thetaUpdateFrequency = 0;
+  byte theta = 0;
+
+  byte hueUpdate = 0;
+  byte hueUpdateFrequency = 0;
+  byte hue = 0;
+
+  byte rotation = 0;
+
+  uint8_t scaleX = 256 / effects.width;
+  uint8_t scaleY = 256 / effects.height;
+
+  uint16_t maxX = effects.width - 1;
+  uint16_t maxY = effects.height - 1;
+
+  uint8_t waveCount = 1;
+
+public:
+  PatternWave() { name = (char *)"Wave"; }
+
+  void start()
+  {
+    rotation = random(0, 4);
+    waveCount = random(1, 3);
+  }
+
+  unsigned int drawFrame()
+  {
+    int n = 0;
+
+    switch (rotation)
+    {
+    case 0:
+      for (int x = 0; x < effects.width; x++)
+      {
+        n = quadwave8(x * 2 + theta) / scaleY;
+        effects.leds[effects.XY16(x, n)] = effects.ColorFromCurrentPalette(x + hue);
+        if (waveCount == 2)
+          effects.leds[effects.XY16(x, maxY - n)] = effects.ColorFromCurrentPalette(x + hue);
+      }
+      break;
+
+    case 1:
+      for (int y = 0; y < effects.height; y++)
+      {
+        n = quadwave8(y * 2 + theta) / scaleX;
+        effects.leds[effects.XY16(n, y)] = effects.ColorFromCurrentPalette(y + hue);
+        if (waveCount == 2)
+          effects.leds[effects.XY16(maxX - n, y)] = effects.ColorFromCurrentPalette(y + hue);
+      }
+      break;
+
+    case 2:
+      for (int x = 0; x < effects.width; x++)
+      {
+        n = quadwave8(x * 2 - theta) / scaleY;
+        effects.leds[effects.XY16(x, n)] = effects.ColorFromCurrentPalette(x + hue);
+        if (waveCount == 2)
+          effects.leds[effects.XY16(x, maxY - n)] = effects.ColorFromCurrentPalette(x + hue);
+      }
+      break;
+
+    case 3:
+      for (int y = 0; y < effects.height; y++)
+      {
+        n = quadwave8(y * 2 - theta) / scaleX;
+        effects.leds[effects.XY16(n, y)] = effects.ColorFromCurrentPalette(y + hue);
+        if (waveCount == 2)
+          effects.leds[effects.XY16(maxX - n, y)] = effects.ColorFromCurrentPalette(y + hue);
+      }
+      break;
+    }
+
+    effects.DimAll(220);
+
+    if (thetaUpdate >= thetaUpdateFrequency)
+    {
+      thetaUpdate = 0;
+      theta++;
+    }
+    else
+    {
+      thetaUpdate++;
+    }
+
+    if (hueUpdate >= hueUpdateFrequency)
+    {
+      hueUpdate = 0;
+      hue++;
+    }
+    else
+    {
+      hueUpdate++;
+    }
+
+    effects.ShowFrame();
+
+    return 0;
+  }
+};
+
+} // namespace baseline
+
+static MatrixDisplay display;
+
+// Upload and canvas of one pattern between frames, so the two patterns can take turns
+struct Run
+{
+  PixelFormat format;
+  std::vector<uint8_t> canvas;
+  std::vector<uint8_t> frame;
+  double us = 0;
+
+  template <class P>
+  void start(P &p, unsigned seed)
+  {
+    aurora_reset(seed);
+    p.start();
+    save();
+  }
+
+  void save()
+  {
+    format = effects.pixelFormat;
+    const uint8_t *bytes = (const uint8_t *)effects.leds;
+    canvas.assign(bytes, bytes + effects.canvasBytes());
+    frame = display.frame;
+  }
+
+  void restore()
+  {
+    effects.setPixelFormat(format);
+    memcpy(effects.leds, canvas.data(), canvas.size());
+  }
+};
+
+// 'frames' frames of the baseline pattern B and the shader pattern S from the same start,
+// 40 ms apart. B uploads inside drawFrame(), so it runs without a display while it is timed
+// (ShowFrame() then returns before the upload) and uploads again after; S is uploaded the way
+// ModePattern does it
+template <class B, class S>
+static bool compare(const char *name, int frames, unsigned seed = 1)
+{
+  B b;
+  S s;
+  Run rb, rs;
+  rb.start(b, seed);
+  rs.start(s, seed);
+
+  int first_bad = -1;
+  for (int f = 0; f < frames; f++)
+  {
+    host_micros = f * 40000;
+
+    rb.restore();
+    effects.virtualDisp = nullptr;
+    rb.us += aurora_time_us([&](int) { b.drawFrame(); }, 1);
+    effects.virtualDisp = &display;
+    effects.ShowFrame();
+    rb.save();
+
+    rs.restore();
+    rs.us += aurora_time_us([&](int) { s.drawFrame(); }, 1);
+    effects.ShowFrame();
+    rs.save();
+
+    if (first_bad < 0 && rb.frame != rs.frame)
+      first_bad = f;
+  }
+
+  printf("  %-14s before %8.1f us   after %8.1f us   %5.2fx   ", name, rb.us / frames, rs.us / frames, rb.us / rs.us);
+  if (first_bad < 0)
+    printf("frames identical\n");
+  else
+    printf("FAIL: frame %d differs\n", first_bad);
+  return first_bad < 0;
+}
+
+int main()
+{
+  const int sizes[][2] = {{64, 64}, {128, 64}, {128, 128}};
+
+  bool ok = true;
+  for (auto &sz : sizes)
+  {
+    aurora_resize(display, sz[0], sz[1]);
+    printf("%dx%d, drawFrame() on one core:\n", sz[0], sz[1]);
+
+    ok &= compare<baseline::PatternPlasma, PatternPlasma>("Plasma", 300);
+    ok &= compare<baseline::PatternJuliaSet, PatternJuliaSet>("Julia", 100);
+    // start() draws the rotation and wave count from random(): one seed per combination
+    bool seen[4][2] = {};
+    for (unsigned seed = 0; seed < 1000; seed++)
+    {
+      srand(seed);
+      int rotation = random(0, 4), waves = random(1, 3);
+      if (seen[rotation][waves - 1])
+        continue;
+      seen[rotation][waves - 1] = true;
+      char name[32];
+      snprintf(name, sizeof(name), "Wave r%d x%d", rotation, waves);
+      ok &= compare<baseline::PatternWave, PatternWave>(name, 300, seed);
+    }
+    printf("\n");
+  }
+
+  printf(ok ? "SUCCESS: shader patterns upload the same frames as the loops they replaced.\n" : "ERROR: frame mismatch.\n");
+  return ok ? 0 : 1;
+}
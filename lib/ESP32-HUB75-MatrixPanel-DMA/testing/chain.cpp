@@ -0,0 +1,145 @@
+// Host side check and benchmark of the chain mapping in ESP32-HUB75-VirtualMatrixPanel_Map.hpp
+//
+// For 1x1, 2x2 (128x128) and 4x1 (256x64) walls of 64x64 panels and every chain type:
+//  - verifies the per-row table used by VirtualMatrixPanel_T<CHAIN_RUNTIME> against the arithmetic
+//    path for every pixel;
+//  - times one full frame written through each path into a fake DMA buffer:
+//      compile-time : arithmetic with the chain type as a template parameter (VirtualMatrixPanel_T<CHAIN_x>)
+//      runtime      : arithmetic with the chain type as a variable (a plain switch per pixel)
+//      row table    : VirtualMatrixPanel_T<CHAIN_RUNTIME>
+//
+//   g++ -O2 -o chain.exe chain.cpp && ./chain.exe
+
+#include <cstdio>
+#include <cstdint>
+#include <chrono>
+#include <vector>
+#include "../src/ESP32-HUB75-VirtualMatrixPanel_Map.hpp"
+
+static const int PANEL_RES = 64;
+static const int FRAMES = 200;
+
+static const char *chain_name(PANEL_CHAIN_TYPE c)
+{
+  static const char *names[] = {
+    "CHAIN_NONE", "CHAIN_TOP_LEFT_DOWN", "CHAIN_TOP_RIGHT_DOWN", "CHAIN_BOTTOM_LEFT_UP",
+    "CHAIN_BOTTOM_RIGHT_UP", "CHAIN_TOP_LEFT_DOWN_ZZ", "CHAIN_TOP_RIGHT_DOWN_ZZ",
+    "CHAIN_BOTTOM_RIGHT_UP_ZZ", "CHAIN_BOTTOM_LEFT_UP_ZZ" };
+  return names[c];
+}
+
+// Stand-in for the DMA buffer: one 16-bit word per electrical pixel
+struct FakeChain
+{
+  int width, height;
+  std::vector<uint16_t> px;
+
+  FakeChain(int w, int h) : width(w), height(h), px((size_t)w * h) {}
+  inline void drawPixel(int16_t x, int16_t y, uint16_t c)
+  {
+    if (x < 0 || x >= width || y < 0 || y >= height) return;
+    px[(size_t)y * width + x] = c;
+  }
+};
+
+template <PANEL_CHAIN_TYPE Chain>
+static void frame_compile_time(const VirtualChainGeometry &g, FakeChain &out, uint16_t c)
+{
+  for (int y = 0; y < g.virtualResY(); y++)
+    for (int x = 0; x < g.virtualResX(); x++)
+    {
+      VirtualCoords v = hub75_chain_coords(Chain, g, x, y);
+      out.drawPixel(v.x, v.y, c + x);
+    }
+}
+
+static void frame_runtime(PANEL_CHAIN_TYPE chain, const VirtualChainGeometry &g, FakeChain &out, uint16_t c)
+{
+  for (int y = 0; y < g.virtualResY(); y++)
+    for (int x = 0; x < g.virtualResX(); x++)
+    {
+      VirtualCoords v = hub75_chain_coords(chain, g, x, y);
+      out.drawPixel(v.x, v.y, c + x);
+    }
+}
+
+static void frame_row_map(const VirtualRowMap *rows, const VirtualChainGeometry &g, FakeChain &out, uint16_t c)
+{
+  for (int y = 0; y < g.virtualResY(); y++)
+  {
+    const VirtualRowMap &r = rows[y];
+    for (int x = 0; x < g.virtualResX(); x++)
+      out.drawPixel(r.x0 + r.dir * x, r.y, c + x);
+  }
+}
+
+template <typename F>
+static double time_frames(F f)
+{
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < FRAMES; i++)
+    f((uint16_t)i);
+  auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::micro>(t1 - t0).count() / FRAMES;
+}
+
+template <PANEL_CHAIN_TYPE Chain>
+static bool run(const VirtualChainGeometry &g)
+{
+  const int vw = g.virtualResX(), vh = g.virtualResY();
+  std::vector<VirtualRowMap> rows(vh);
+  hub75_build_row_map(Chain, g, rows.data());
+
+  int fails = 0;
+  for (int y = 0; y < vh; y++)
+    for (int x = 0; x < vw; x++)
+    {
+      VirtualCoords v = hub75_chain_coords(Chain, g, x, y);
+      int lx = rows[y].x0 + rows[y].dir * x;
+      if (v.x != lx || v.y != rows[y].y)
+      {
+        if (fails++ < 5)
+          printf("    (%d,%d): arithmetic (%d,%d), row table (%d,%d)\n", x, y, v.x, v.y, lx, rows[y].y);
+      }
+    }
+
+  FakeChain out(g.dmaResX() + 1, g.panel_res_y);
+  double t_ct = time_frames([&](uint16_t c) { frame_compile_time<Chain>(g, out, c); });
+  volatile PANEL_CHAIN_TYPE rt = Chain; // keep the compiler from folding the switch
+  double t_rt = time_frames([&](uint16_t c) { frame_runtime(rt, g, out, c); });
+  double t_lut = time_frames([&](uint16_t c) { frame_row_map(rows.data(), g, out, c); });
+
+  printf("  %-26s %s   compile-time %8.1f us   runtime %8.1f us   row table %8.1f us\n",
+         chain_name(Chain), fails ? "FAIL" : "ok  ", t_ct, t_rt, t_lut);
+  return fails == 0;
+}
+
+static bool run_layout(int rows, int cols)
+{
+  VirtualChainGeometry g{(uint8_t)rows, (uint8_t)cols, PANEL_RES, PANEL_RES};
+  printf("%d x %d panels (%dx%d virtual, %d px chain), per frame:\n", rows, cols, g.virtualResX(), g.virtualResY(), g.dmaResX() + 1);
+
+  bool ok = true;
+  ok &= run<CHAIN_NONE>(g);
+  ok &= run<CHAIN_TOP_LEFT_DOWN>(g);
+  ok &= run<CHAIN_TOP_RIGHT_DOWN>(g);
+  ok &= run<CHAIN_BOTTOM_LEFT_UP>(g);
+  ok &= run<CHAIN_BOTTOM_RIGHT_UP>(g);
+  ok &= run<CHAIN_TOP_LEFT_DOWN_ZZ>(g);
+  ok &= run<CHAIN_TOP_RIGHT_DOWN_ZZ>(g);
+  ok &= run<CHAIN_BOTTOM_RIGHT_UP_ZZ>(g);
+  ok &= run<CHAIN_BOTTOM_LEFT_UP_ZZ>(g);
+  printf("\n");
+  return ok;
+}
+
+int main()
+{
+  bool ok = true;
+  ok &= run_layout(1, 1); // single 64x64 panel
+  ok &= run_layout(2, 2); // 128x128
+  ok &= run_layout(1, 4); // 256x64
+
+  printf(ok ? "SUCCESS: row tables match the arithmetic mapping.\n" : "ERROR: row table mismatch.\n");
+  return ok ? 0 : 1;
+}
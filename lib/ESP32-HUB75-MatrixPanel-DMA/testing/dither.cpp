@@ -0,0 +1,104 @@
+// Host side evaluation of the dither tables in ESP32-HUB75-Dither.hpp
+//
+// Quantises a dark horizontal gradient the same way updateMatrixDMABuffer() does
+// (CIE1931 16-bit value, keep the top 'depth' bits) and reports, per dither mode:
+//  - rmse_px   : per pixel error of the time averaged output (what a camera with a long exposure sees)
+//  - rmse_4x4  : error after a 4x4 box blur (what the eye sees at viewing distance)
+//  - max_step  : largest jump between neighbouring pixels along the gradient after the 4x4 blur (visible band edge)
+// Errors are in units of one 8-bit-depth LSB (65536 / 256) of linear light.
+//
+//   g++ -O2 -o dither.exe dither.cpp && ./dither.exe
+
+#include <cstdio>
+#include <cstdint>
+#include <cmath>
+#include "../src/ESP32-HUB75-Dither.hpp"
+
+static const int W = 128; // gradient length
+static const int H = 16;
+
+// Same curve the driver's lumConvTab was generated from
+static uint16_t cie1931(uint8_t v)
+{
+  double L = v * 100.0 / 255.0;
+  double Y = (L <= 8.0) ? (L / 902.3) : pow((L + 16.0) / 116.0, 3.0);
+  return (uint16_t)lround(Y * 65535.0);
+}
+
+static void evaluate(uint8_t depth, uint8_t frames, uint8_t v_max)
+{
+  const uint8_t mask_offset = 16 - depth;
+  const uint16_t keep_mask = (uint16_t)(0xFFFF << mask_offset);
+
+  DitherTable dt;
+  dt.build(mask_offset, frames);
+  const int cycle = dt.frames ? dt.frames : 1;
+
+  static double target[H][W], shown[H][W];
+
+  for (int y = 0; y < H; y++)
+    for (int x = 0; x < W; x++)
+    {
+      uint8_t v = (uint8_t)(x * v_max / (W - 1));
+      uint16_t v16 = cie1931(v);
+      target[y][x] = v16;
+
+      double acc = 0;
+      for (int phase = 0; phase < cycle; phase++)
+      {
+        uint16_t d = dt.frames ? DitherTable::add_sat(v16, dt.threshold(x, y, phase)) : v16;
+        acc += (d & keep_mask);
+      }
+      shown[y][x] = acc / cycle;
+    }
+
+  const double lsb8 = 65536.0 / 256.0;
+  double se_px = 0, se_blur = 0;
+  double max_step = 0;
+  double prev = 0;
+
+  for (int y = 0; y < H - 3; y++)
+    for (int x = 0; x < W - 3; x++)
+    {
+      double t = 0, s = 0;
+      for (int j = 0; j < 4; j++)
+        for (int i = 0; i < 4; i++)
+        {
+          t += target[y + j][x + i];
+          s += shown[y + j][x + i];
+        }
+      t /= 16; s /= 16;
+      se_blur += (s - t) * (s - t);
+
+      if (y == 0)
+      {
+        if (x > 0 && fabs(s - prev) > max_step) max_step = fabs(s - prev);
+        prev = s;
+      }
+    }
+
+  for (int y = 0; y < H; y++)
+    for (int x = 0; x < W; x++)
+      se_px += (shown[y][x] - target[y][x]) * (shown[y][x] - target[y][x]);
+
+  printf("depth %2d  frames %d   rmse_px %7.3f   rmse_4x4 %7.3f   max_step %7.3f\n",
+         depth, frames,
+         sqrt(se_px / (W * H)) / lsb8,
+         sqrt(se_blur / ((W - 3) * (H - 3))) / lsb8,
+         max_step / lsb8);
+}
+
+int main()
+{
+  const uint8_t v_max = 64; // dark end of the range, where banding is worst
+
+  for (uint8_t depth = 4; depth <= 8; depth += 2)
+  {
+    static const uint8_t modes[] = {0, 1, 2, 4};
+    for (uint8_t frames : modes)
+      evaluate(depth, frames, v_max);
+    printf("\n");
+  }
+
+  return 0;
+}
@@ -0,0 +1,61 @@
+// Offline planner for refresh rate / colour depth / DMA memory, using the driver's own
+// timing model (ESP32-HUB75-TimingModel.hpp). Handy for sizing bigger chains before
+// building anything.
+//
+//   g++ -O2 -o timing.exe timing.cpp
+//   ./timing.exe [panel_width] [panel_height] [chain_length] [target_hz] [max_dma_kb] [double_buff]
+//   ./timing.exe 64 64 4 120 160 1
+
+#include <cstdio>
+#include <cstdlib>
+#include "../src/ESP32-HUB75-TimingModel.hpp"
+
+int main(int argc, char **argv)
+{
+  int width = (argc > 1) ? atoi(argv[1]) : 64;
+  int height = (argc > 2) ? atoi(argv[2]) : 64;
+  int chain = (argc > 3) ? atoi(argv[3]) : 1;
+  int target = (argc > 4) ? atoi(argv[4]) : 120;
+  int max_kb = (argc > 5) ? atoi(argv[5]) : 0;
+  bool dbuff = (argc > 6) ? atoi(argv[6]) != 0 : true;
+
+  // HUB75_I2S_CFG::clk_speed values, most robust first
+  static const uint32_t clocks[] = {8000000, 16000000, 20000000};
+
+  HUB75TimingParams base;
+  base.pixels_per_row = width * chain;
+  base.rows_per_frame = height / 2;
+  base.double_buff = dbuff;
+
+  HUB75TunerLimits limits;
+  limits.target_refresh_hz = target;
+  limits.min_depth = 2;
+  limits.max_depth = 12;
+  limits.clocks = clocks;
+  limits.num_clocks = sizeof(clocks) / sizeof(clocks[0]);
+  limits.max_memory_bytes = (size_t)max_kb * 1024;
+
+  printf("%dx%d panel, chain %d (%d px per row), target > %d Hz, %s buffer, memory limit %d KB (0 = none)\n\n",
+         width, height, chain, base.pixels_per_row, target, dbuff ? "double" : "single", max_kb);
+
+  printf("  clock MHz  depth  tbit  eff.depth  refresh Hz  descriptors  DMA KB  ok\n");
+
+  HUB75TunerCandidate best;
+  bool found = hub75_tune(base, limits, best, [](const HUB75TunerCandidate &c) {
+    printf("  %9.1f  %5d  %4d  %9d  %10u  %11u  %6.1f  %s\n",
+           c.clk_hz / 1e6, c.color_depth, c.transition_bit, c.effectiveDepth(),
+           (unsigned)c.result.refresh_hz, (unsigned)c.result.descriptors,
+           c.result.total_bytes / 1024.0, c.feasible ? "yes" : "-");
+  });
+
+  if (!found)
+  {
+    printf("\nNo configuration reaches the target within the limits.\n");
+    return 1;
+  }
+
+  printf("\nBest: clock %.1f MHz, colour depth %d, min_refresh_rate %d -> transition bit %d, %u Hz, %.1f KB DMA memory\n",
+         best.clk_hz / 1e6, best.color_depth, target, best.transition_bit,
+         (unsigned)best.result.refresh_hz, best.result.total_bytes / 1024.0);
+  return 0;
+}
@@ -1,6 +1,9 @@
 #include <iostream>
 #include <string>
 #include <list>
+#include <vector>
+#include <cstdio>
+#include <stdint.h>
 
 
 struct VirtualCoords
@@ -130,6 +133,21 @@ private:
 
 #include "baseline.hpp"
 
+// The library's own mapping (chain, rotation, scan type and the VirtualRun remap table), in its own
+// namespace as this file predates it and has its own VirtualCoords / PANEL_CHAIN_TYPE.
+namespace lib {
+#include "../src/ESP32-HUB75-VirtualMatrixPanel_Map.hpp"
+}
+
+static const char *lib_chain_name(int c)
+{
+	static const char *names[] = {
+		"CHAIN_NONE", "CHAIN_TOP_LEFT_DOWN", "CHAIN_TOP_RIGHT_DOWN", "CHAIN_BOTTOM_LEFT_UP",
+		"CHAIN_BOTTOM_RIGHT_UP", "CHAIN_TOP_LEFT_DOWN_ZZ", "CHAIN_TOP_RIGHT_DOWN_ZZ",
+		"CHAIN_BOTTOM_RIGHT_UP_ZZ", "CHAIN_BOTTOM_LEFT_UP_ZZ" };
+	return names[c];
+}
+
 /**
  * Development version for testing.
  */
@@ -339,6 +357,70 @@ inline VirtualCoords VirtualMatrixPanelTest::getCoords_Dev(int16_t virt_x, int16
   return coords;
 }
 
+/**
+ * Remap table of VirtualMatrixPanel_T::setRemapTable() against the arithmetic path
+ * (VirtualMatrixPanel_T::mapCoords(): rotation, chain mapping, scan type), for every chain type,
+ * rotation and a few scan types. Also checks every run is contiguous and can't be merged with the next.
+ */
+template <lib::PANEL_SCAN_TYPE Scan>
+static int test_remap_table(int rows, int cols, int res_x, int res_y, int pixel_base, const char *scan_name)
+{
+	int fails = 0;
+	lib::VirtualChainGeometry g{(uint8_t)rows, (uint8_t)cols, (uint8_t)res_x, (uint8_t)res_y};
+
+	for (int chain = lib::CHAIN_NONE; chain < lib::CHAIN_RUNTIME; chain++)
+	{
+		if (chain == lib::CHAIN_NONE && rows > 1) continue; // CHAIN_NONE is a single row of panels
+
+		for (uint8_t rot = 0; rot < 4; rot++)
+		{
+			const uint16_t w = (rot & 1) ? g.virtualResY() : g.virtualResX();
+			const uint16_t h = (rot & 1) ? g.virtualResX() : g.virtualResY();
+
+			auto map = [&](int16_t x, int16_t y) {
+				lib::hub75_rotate(rot, g.virtualResX(), g.virtualResY(), x, y);
+				lib::VirtualCoords c = lib::hub75_chain_coords((lib::PANEL_CHAIN_TYPE)chain, g, x, y);
+				return lib::ScanTypeMapping<Scan>::apply(c, pixel_base);
+			};
+
+			uint32_t n = lib::hub75_build_runs(w, h, map, nullptr, nullptr);
+			std::vector<lib::VirtualRun> runs(n);
+			std::vector<uint16_t> row_first(h + 1);
+			lib::hub75_build_runs(w, h, map, runs.data(), row_first.data());
+
+			int bad = 0;
+			for (int16_t y = 0; y < h; y++)
+			{
+				for (int16_t x = 0; x < w; x++)
+				{
+					const lib::VirtualRun &r = lib::hub75_find_run(runs.data(), row_first.data(), x, y);
+					lib::VirtualCoords a = map(x, y);
+					int16_t i = x - r.vx;
+					if (i < 0 || i >= r.len || a.x != r.x + i * r.dx || a.y != r.y + i * r.dy)
+					{
+						if (bad++ < 3)
+							std::printf("  (%d,%d): arithmetic (%d,%d), table (%d,%d)\n", x, y, a.x, a.y, r.x + i * r.dx, r.y + i * r.dy);
+					}
+				}
+
+				for (uint16_t k = row_first[y]; k < row_first[y + 1]; k++)
+				{
+					const lib::VirtualRun &r = runs[k];
+					if ((r.dx != 0) == (r.dy != 0) || r.dx < -1 || r.dx > 1 || r.dy < -1 || r.dy > 1)
+						bad++;
+					if (k + 1 < row_first[y + 1] && runs[k + 1].x == r.x + r.len * r.dx && runs[k + 1].y == r.y + r.len * r.dy)
+						bad++; // mergeable, so not minimal
+				}
+			}
+
+			std::printf("%-9s %dx%d %-24s rot %d: %4u runs (%5zu bytes) %s\n", scan_name, rows, cols,
+						lib_chain_name(chain), rot, n, n * sizeof(lib::VirtualRun) + (h + 1) * sizeof(uint16_t), bad ? "*** FAIL ***" : "ok");
+			fails += bad;
+		}
+	}
+	return fails;
+}
+
 bool check(VirtualCoords expected, VirtualCoords result, int x = -1, int y = -1)
 {
 
@@ -455,5 +537,20 @@ main(int argc, char* argv[])
 	
 	std::cout << "\n\n";
 
+	std::cout << "Remap table (VirtualMatrixPanel_T::setRemapTable) vs arithmetic path\n";
+	int remap_fails = 0;
+	remap_fails += test_remap_table<lib::STANDARD_TWO_SCAN>(3, 3, 64, 64, 64, "two-scan");
+	remap_fails += test_remap_table<lib::STANDARD_TWO_SCAN>(2, 2, 64, 64, 64, "two-scan");
+	remap_fails += test_remap_table<lib::STANDARD_TWO_SCAN>(1, 4, 64, 64, 64, "two-scan");
+	remap_fails += test_remap_table<lib::FOUR_SCAN_32PX_HIGH>(2, 2, 32, 32, 16, "4s-32px");
+	remap_fails += test_remap_table<lib::FOUR_SCAN_64PX_HIGH>(2, 1, 64, 64, 32, "4s-64px");
+	remap_fails += test_remap_table<lib::FOUR_SCAN_16PX_HIGH>(1, 2, 32, 16, 16, "4s-16px");
+
+	if (remap_fails > 0) {
+		std::printf("ERROR: %d remap table checks failed.\n", remap_fails);
+		return 1;
+	}
+	std::printf("SUCCESS: remap tables match the arithmetic path.\n");
+
     return 0;
 }
\ No newline at end of file
@@ -34,6 +34,8 @@
 #ifndef Boid_H
 #define Boid_H
 
+#include "EffectsLayer.hpp" // Wraps / bounces against the canvas size (effects.width, effects.height)
+
 class Boid {
   public:
 
@@ -253,19 +255,19 @@ class Boid {
     }
 
     void wrapAroundBorders() {
-      if (location.x < 0) location.x = MATRIX_WIDTH - 1;
-      if (location.y < 0) location.y = MATRIX_HEIGHT - 1;
-      if (location.x >= MATRIX_WIDTH) location.x = 0;
-      if (location.y >= MATRIX_HEIGHT) location.y = 0;
+      if (location.x < 0) location.x = effects.width - 1;
+      if (location.y < 0) location.y = effects.height - 1;
+      if (location.x >= effects.width) location.x = 0;
+      if (location.y >= effects.height) location.y = 0;
     }
 
     void avoidBorders() {
       PVector desired = velocity;
 
       if (location.x < 8) desired = PVector(maxspeed, velocity.y);
-      if (location.x >= MATRIX_WIDTH - 8) desired = PVector(-maxspeed, velocity.y);
+      if (location.x >= effects.width - 8) desired = PVector(-maxspeed, velocity.y);
       if (location.y < 8) desired = PVector(velocity.x, maxspeed);
-      if (location.y >= MATRIX_HEIGHT - 8) desired = PVector(velocity.x, -maxspeed);
+      if (location.y >= effects.height - 8) desired = PVector(velocity.x, -maxspeed);
 
       if (desired != velocity) {
         PVector steer = desired - velocity;
@@ -275,15 +277,15 @@ class Boid {
 
       if (location.x < 0) location.x = 0;
       if (location.y < 0) location.y = 0;
-      if (location.x >= MATRIX_WIDTH) location.x = MATRIX_WIDTH - 1;
-      if (location.y >= MATRIX_HEIGHT) location.y = MATRIX_HEIGHT - 1;
+      if (location.x >= effects.width) location.x = effects.width - 1;
+      if (location.y >= effects.height) location.y = effects.height - 1;
     }
 
     bool bounceOffBorders(float bounce) {
       bool bounced = false;
 
-      if (location.x >= MATRIX_WIDTH) {
-        location.x = MATRIX_WIDTH - 1;
+      if (location.x >= effects.width) {
+        location.x = effects.width - 1;
         velocity.x *= -bounce;
         bounced = true;
       }
@@ -293,8 +295,8 @@ class Boid {
         bounced = true;
       }
 
-      if (location.y >= MATRIX_HEIGHT) {
-        location.y = MATRIX_HEIGHT - 1;
+      if (location.y >= effects.height) {
+        location.y = effects.height - 1;
         velocity.y *= -bounce;
         bounced = true;
       }
@@ -325,7 +327,7 @@ class Boid {
     }
 };
 
-static const uint8_t AVAILABLE_BOID_COUNT = MATRIX_WIDTH;
+static const uint8_t AVAILABLE_BOID_COUNT = MATRIX_WIDTH; // Pool size only, independent of the canvas size
 extern Boid boids[AVAILABLE_BOID_COUNT];
 
 #endif // Boid_H
\ No newline at end of file
@@ -18,6 +18,8 @@ public:
         isStarted = false;
     }
 
+    // Draw the next frame into effects.leds and return the frame delay in ms.
+    // Do not call effects.ShowFrame(): ModePattern uploads the frame once after drawFrame()
     virtual unsigned int drawFrame() = 0; // 순수 가상 함수
 };
 
@@ -32,12 +32,71 @@
 
 // Adafruit GFX 라이브러리 (GFX 기본 클래스)
 #include <Adafruit_GFX.h>
-// MatrixPanel 라이브러리 (실제 매트릭스 드라이버)
-#include <ESP32-HUB75-MatrixPanel-I2S-DMA.h>
+// 매트릭스 디스플레이 (패널 체인 전체, MatrixDisplay)
+#include "matrix_display.h"
 // FastLED는 GFX보다 나중에 포함될 수 있음 (의존성 순서 고려)
 #include <FastLED.h>
 // Aurora 패턴의 기본 클래스
 #include "Drawable.h" // Drawable.h가 EffectsLayer.hpp와 같은 src/Aurora 폴더에 있다고 가정
+// 행 단위 병렬 렌더링 (renderRows()를 가진 패턴)
+#include "row_jobs.h"
+// Q16.16 고정소수점 벡터/행렬 (drawLine(FixVec2, FixVec2, CRGB))
+#include "FixedMath.hpp"
+#include <utility>
+
+// How ShowFrame() mixes the outgoing pattern's canvas into the upload during a pattern transition
+enum TransitionStyle : uint8_t {
+  TRANSITION_CROSSFADE,  // alpha blend of the two frames
+  TRANSITION_WIPE,       // the incoming frame sweeps in from the left
+  TRANSITION_DISSOLVE,   // pixels switch over one by one in a fixed random order
+};
+
+// What a pattern's canvas (leds) holds. Each canvas is allocated at the size of its format, so
+// setPixelFormat() reallocates leds; the smaller formats are reached through frameIndexed() /
+// frame565() and expanded to RGB888 in the upload pass. Every other EffectsLayer helper
+// (DimAll, blur, setPixel, the GFX calls...) works on PIXEL_CRGB only
+enum PixelFormat : uint8_t {
+  PIXEL_CRGB,     // 3 bytes per pixel
+  PIXEL_INDEXED,  // 1 byte per pixel, an index into the current palette: a palette change recolours the frame
+  PIXEL_RGB565,   // 2 bytes per pixel
+};
+
+// Storage type and expansion of each format, so the upload loop is instantiated per format
+template <PixelFormat F> struct PixelTraits;
+
+template <> struct PixelTraits<PIXEL_CRGB> {
+  typedef CRGB pixel_t;
+  static const size_t bytes = sizeof(pixel_t);
+  static CRGB toRGB(const pixel_t &p, const CRGB *) { return p; }
+};
+
+template <> struct PixelTraits<PIXEL_INDEXED> {
+  typedef uint8_t pixel_t;
+  static const size_t bytes = sizeof(pixel_t);
+  static CRGB toRGB(pixel_t p, const CRGB *palette) { return palette[p]; }
+};
+
+template <> struct PixelTraits<PIXEL_RGB565> {
+  typedef uint16_t pixel_t;
+  static const size_t bytes = sizeof(pixel_t);
+  static CRGB toRGB(pixel_t p, const CRGB *) {
+    uint8_t r = p >> 11, g = (p >> 5) & 0x3F, b = p & 0x1F;
+    return CRGB((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2));
+  }
+};
+
+// Marsaglia's xorshift32: one shift-xor round per 32 random bits. For engines that want their own
+// cheap stream (FireSim) or a reproducible one from a seed (PatternMaze); state must not be 0
+struct XorShift32 {
+  uint32_t state = 2463534242u;
+
+  uint32_t next() {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+  }
+};
 
 class EffectsLayer; // extern 선언을 위한 전방 선언
 extern EffectsLayer effects; // 전역 effects 객체 (mode_animation.cpp에 정의됨)
@@ -52,15 +111,21 @@ public:
   uint32_t noise_scale_x;
   uint32_t noise_scale_y;
 
-  uint8_t **noise = nullptr;  // we will allocate mem later
+  uint8_t *noise = nullptr;  // width * height, row-major like leds: noise[XY16(x, y)]
   uint8_t noisesmoothing;
 
 
   CRGB *leds;
-  int width;
+  CRGB *leds2 = nullptr;  // the outgoing pattern's canvas during a transition (ModePattern), see allocateTransitionBuffer()
+  PixelFormat pixelFormat = PIXEL_CRGB;   // format of leds, chosen by the pattern in start()
+  PixelFormat pixelFormat2 = PIXEL_CRGB;  // format of leds2
+  size_t ledsBytes = 0;   // allocated size of leds, canvasBytes(pixelFormat) unless a shrink failed
+  size_t leds2Bytes = 0;  // same for leds2
+  int width;   // canvas size, set by the constructor / resize()
   int height;
-  MatrixPanel_I2S_DMA *virtualDisp = nullptr; // m_matrix를 가리킬 포인터 멤버 추가
+  MatrixDisplay *virtualDisp = nullptr; // m_matrix를 가리킬 포인터 멤버 추가
   int num_leds = 0;
+  uint32_t frameUploads = 0; // ShowFrame() calls so far, ModePattern checks it moves by one per frame
 
   // 멤버 함수로 변경, 인스턴스의 width, height 사용
   uint16_t XY16(uint16_t x_coord, uint16_t y_coord) const {
@@ -74,19 +139,11 @@ public:
 
   EffectsLayer(int w, int h) : Adafruit_GFX(w, h), width(w), height(h) {
 
-    // we do dynamic allocation for leds buffer, otherwise esp32 toolchain can't link static arrays of such a big size for 256+ matrices
-    leds = (CRGB *)malloc((width * height + 1) * sizeof(CRGB));
-    num_leds = width * height;
-
-    // allocate mem for noise effect
-    // (there should be some guards for malloc errors eventually)
-    noise = (uint8_t **)malloc(width * sizeof(uint8_t *));
-    for (int i = 0; i < width; ++i) {
-      noise[i] = (uint8_t *)malloc(height * sizeof(uint8_t));
-    }
+    allocateBuffers();
 
     // Set starting palette
     currentPalette = RainbowColors_p;
+    paletteChanged();
     loadPalette(0);
     NoiseVariablesSetup();    
 
@@ -94,11 +151,21 @@ public:
   }
 
   ~EffectsLayer(){
-    free(leds);
-    for (int i = 0; i < width; ++i) {
-      free(noise[i]);
-    }
-    free(noise);
+    freeBuffers();
+  }
+
+  // 캔버스 크기를 디스플레이(패널 체인 전체) 크기에 맞춤 - 패턴 객체 생성 전에 호출
+  void resize(int w, int h) {
+    if (w == width && h == height) return;
+
+    freeBuffers();
+    width = w;
+    height = h;
+    WIDTH = _width = w;   // Adafruit_GFX 크기도 갱신
+    HEIGHT = _height = h;
+    allocateBuffers();
+
+    ClearFrame();
   }
 
   /* The only 'framebuffer' we have is what is contained in the leds and leds2 variables.
@@ -117,23 +184,119 @@ public:
   void setPixelFromPaletteIndex(int x, int y, uint8_t colorIndex) {
     if (x >= 0 && x < width && y >= 0 && y < height) leds[XY16(x, y)] = ColorFromCurrentPalette(colorIndex);
   }
+
+  // setPixel() for a PIXEL_RGB565 canvas
+  void setPixel565(int16_t x, int16_t y, uint16_t color) {
+    if (x >= 0 && x < width && y >= 0 && y < height) frame565()[XY16(x, y)] = color;
+  }
   
  void PrepareFrame() { }
 
+  // Upload leds to the display. ModePattern calls this exactly once per frame, after drawFrame();
+  // patterns only draw into leds and never call it themselves
   void ShowFrame() { // send to display
-    currentPalette = targetPalette;
+    ShowFrame(256, TRANSITION_CROSSFADE);
+  }
+
+  // Same, mixing in leds2 (the outgoing pattern's canvas) during a transition: amount runs from
+  // 0 (all leds2) to 256 (all leds). The mix happens in the upload loop itself, so a transition
+  // adds no pass over the frame
+  void ShowFrame(uint16_t amount, TransitionStyle style) {
+    frameUploads++;
+
+    // Blend toward a newly loaded palette over a few frames; the LUT is only rebuilt while it moves
+    if (currentPalette != targetPalette) {
+      nblendPaletteTowardPalette(currentPalette, targetPalette, PALETTE_BLEND_STEP);
+      paletteChanged();
+    }
   
     if (!virtualDisp) return; // virtualDisp 포인터 유효성 검사
 
+    if (amount >= 256 || !leds2) {
+      switch (pixelFormat) {
+        case PIXEL_INDEXED: uploadFrame<PIXEL_INDEXED>(); break;
+        case PIXEL_RGB565:  uploadFrame<PIXEL_RGB565>(); break;
+        default:            uploadFrame<PIXEL_CRGB>(); break;
+      }
+      return;
+    }
+
     for (int y=0; y<height; ++y){
+          const CRGB *row = canvasRow(leds, pixelFormat, y, uploadLine);
+          const CRGB *fromRow = canvasRow(leds2, pixelFormat2, y, uploadLine + width);
           for (int x=0; x<width; ++x) { // Iterate through logical coordinates
-          uint16_t _pixel = XY16(x,y);
-          // Apply MATRIX_X_OFFSET when drawing to the physical display, and wrap around
-          virtualDisp->drawPixelRGB888( (x + 1) % width, y, leds[_pixel].r, leds[_pixel].g, leds[_pixel].b);
+          CRGB c = transitionPixel(fromRow[x], row[x], x, y, amount, style);
+          // MatrixDisplay applies the per-panel column offset and the chain mapping
+          virtualDisp->drawPixelRGB888(x, y, c.r, c.g, c.b);
         } // end loop to copy fast led to the dma matrix
     }
   }
 
+  // Switch the canvas format, reallocating leds at its size; call from the pattern's start().
+  // Clears the frame. Returns false, format unchanged, when a larger canvas does not fit
+  bool setPixelFormat(PixelFormat format) {
+    const size_t bytes = canvasBytes(format);
+    if (bytes != ledsBytes) {
+      CRGB *canvas = (CRGB *)malloc(bytes);
+      if (canvas) {
+        free(leds);
+        leds = canvas;
+        ledsBytes = bytes;
+      } else if (bytes > ledsBytes) {
+        return false;
+      }
+    }
+    pixelFormat = format;
+    ClearFrame();
+    return true;
+  }
+
+  // Bytes per pixel of a format, PixelTraits<F>::bytes at run time
+  static size_t pixelBytes(PixelFormat format) {
+    switch (format) {
+      case PIXEL_INDEXED: return PixelTraits<PIXEL_INDEXED>::bytes;
+      case PIXEL_RGB565:  return PixelTraits<PIXEL_RGB565>::bytes;
+      default:            return PixelTraits<PIXEL_CRGB>::bytes;
+    }
+  }
+
+  // Size of a canvas in a format, with one spare pixel
+  size_t canvasBytes(PixelFormat format) const { return (num_leds + 1) * pixelBytes(format); }
+  size_t canvasBytes() const { return canvasBytes(pixelFormat); }
+
+  // leds seen as PIXEL_INDEXED / PIXEL_RGB565 pixels, row-major like leds
+  uint8_t *frameIndexed() { return (uint8_t *)leds; }
+  uint16_t *frame565() { return (uint16_t *)leds; }
+
+  // Exchange leds and leds2 with their formats and sizes; ModePattern draws the outgoing pattern
+  // this way. Each canvas keeps the size of its own format, so nothing is reallocated here
+  void swapCanvas() {
+    std::swap(leds, leds2);
+    std::swap(pixelFormat, pixelFormat2);
+    std::swap(ledsBytes, leds2Bytes);
+  }
+
+  // Second canvas for pattern transitions, in PSRAM when the board has it. Allocated by the first
+  // transition, so modes that never change patterns don't pay for it; the incoming pattern's
+  // setPixelFormat() then sizes it for its own format
+  bool allocateTransitionBuffer() {
+    if (leds2) return true;
+    size_t bytes = canvasBytes(pixelFormat2);
+#ifdef ESP32
+    if (psramFound()) leds2 = (CRGB *)ps_malloc(bytes);
+#endif
+    if (!leds2) leds2 = (CRGB *)malloc(bytes);
+    leds2Bytes = leds2 ? bytes : 0;
+    return leds2 != nullptr;
+  }
+
+  void freeTransitionBuffer() {
+    free(leds2);
+    leds2 = nullptr;
+    leds2Bytes = 0;
+    pixelFormat2 = PIXEL_CRGB;
+  }
+
   uint16_t getCenterX() {
     return width / 2;
   }
@@ -145,14 +308,112 @@ public:
 
   // scale the brightness of the screenbuffer down
   void DimAll(byte value)  {
-      for (int i = 0; i < num_leds; i++)
-        leds[i].nscale8(value);
+      scaleAll(value);
   }  
 
   void ClearFrame() {
-      for (int i = 0; i < num_leds; i++)
-        leds[i]= CRGB(0,0,0);
+      memset(leds, 0, num_leds * pixelBytes(pixelFormat));
+  }
+
+  // Frame-wide primitives: walk leds[] linearly instead of per (x, y) through XY16()
+
+  // nscale8() of every channel in the frame, four channels per 32-bit word
+  void scaleAll(uint8_t scale) {
+    const uint32_t mul = scaleMul(scale);
+    uint8_t *bytes = (uint8_t *)leds;
+    const size_t count = (size_t)num_leds * sizeof(CRGB);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+      uint32_t v;
+      memcpy(&v, bytes + i, 4);
+      v = scaleLanes(v & 0x00FF00FF, mul) | (scaleLanes((v >> 8) & 0x00FF00FF, mul) << 8);
+      memcpy(bytes + i, &v, 4);
+    }
+    for (; i < count; i++)
+      bytes[i] = (bytes[i] * mul) >> 8;
+  }
+
+  // fadeToBlackBy() of the whole frame
+  void fadeAll(uint8_t amount) {
+    scaleAll(255 - amount);
+  }
+
+  // leds = fn(x, y) for every pixel, row by row
+  template <typename Fn>
+  void mapXY(Fn fn) {
+    CRGB *px = leds;
+    for (int y = 0; y < height; y++)
+      for (int x = 0; x < width; x++)
+        *px++ = fn(x, y);
+  }
+
+  // leds = current palette at index(x, y) for every pixel, row by row
+  template <typename Fn>
+  void fillPalette(Fn index) {
+    CRGB *px = leds;
+    for (int y = 0; y < height; y++)
+      for (int x = 0; x < width; x++)
+        *px++ = paletteLut[(uint8_t)index(x, y)];
+  }
+
+  // 2D blur of the whole frame, same result as fl::blur2d() (blurRows() then blurColumns())
+  // without the XYMap, and for any canvas size
+  void blur(uint8_t amount) {
+    blurDim(amount, 255);
+  }
+
+  // DimAll(dim) followed by blur(amount), in a single sweep over the rows
+  //
+  // Each row is blurred horizontally, then takes its vertical step, which only touches that
+  // row and the one above it; blurLine carries the vertical seep from one row to the next.
+  // A pixel travels as two words, R|B and G in 16-bit lanes, so one multiply scales R and B.
+  void blurDim(uint8_t amount, uint8_t dim) {
+    const uint32_t keep = scaleMul(255 - amount);
+    const uint32_t seep = scaleMul(amount >> 1);
+    const uint32_t dimMul = scaleMul(dim);
+    uint32_t *carryRB = blurLine;
+    uint32_t *carryG = blurLine + width;
+
+    for (int y = 0; y < height; y++) {
+      CRGB *row = leds + y * width;
+
+      // horizontal
+      uint32_t prevRB = 0, prevG = 0, partRB = 0, partG = 0;
+      for (int x = 0; x < width; x++) {
+        uint32_t rb = ((uint32_t)row[x].r << 16) | row[x].b;
+        uint32_t g = row[x].g;
+        if (dim != 255) {
+          rb = scaleLanes(rb, dimMul);
+          g = scaleLanes(g, dimMul);
+        }
+        uint32_t curRB = addLanes(scaleLanes(rb, keep), partRB);
+        uint32_t curG = addLanes(scaleLanes(g, keep), partG);
+        partRB = scaleLanes(rb, seep);
+        partG = scaleLanes(g, seep);
+        if (x) storeLanes(row[x - 1], addLanes(prevRB, partRB), addLanes(prevG, partG));
+        prevRB = curRB;
+        prevG = curG;
+      }
+      if (width) storeLanes(row[width - 1], prevRB, prevG);
 
+      // vertical
+      for (int x = 0; x < width; x++) {
+        uint32_t rb = ((uint32_t)row[x].r << 16) | row[x].b;
+        uint32_t g = row[x].g;
+        uint32_t pRB = scaleLanes(rb, seep);
+        uint32_t pG = scaleLanes(g, seep);
+        uint32_t cRB = y ? carryRB[x] : 0;
+        uint32_t cG = y ? carryG[x] : 0;
+        storeLanes(row[x], addLanes(scaleLanes(rb, keep), cRB), addLanes(scaleLanes(g, keep), cG));
+        if (y) {
+          CRGB &above = row[x - width];
+          uint32_t aRB = ((uint32_t)above.r << 16) | above.b;
+          storeLanes(above, addLanes(aRB, pRB), addLanes(above.g, pG));
+        }
+        carryRB[x] = pRB;
+        carryG[x] = pG;
+      }
+    }
   }
   
 
@@ -192,6 +453,22 @@ public:
   CRGBPalette16 targetPalette;
   char* currentPaletteName;
 
+  // currentPalette expanded to all 256 indices (currentBlendType applied), and the same as RGB565
+  static const uint8_t PALETTE_BLEND_STEP = 48; // max channel change per frame while blending to targetPalette
+  CRGB paletteLut[256];
+  uint16_t paletteLut565[256];
+  uint32_t paletteVersion = 0;
+
+  // call after writing currentPalette / currentBlendType directly
+  void paletteChanged() {
+    paletteVersion++;
+    for (int i = 0; i < 256; i++) {
+      CRGB c = ColorFromPalette(currentPalette, (uint8_t)i, 255, currentBlendType);
+      paletteLut[i] = c;
+      paletteLut565[i] = ((c.r & 0xF8) << 8) | ((c.g & 0xFC) << 3) | (c.b >> 3);
+    }
+  }
+
   static const int HeatColorsPaletteIndex = 6;
   static const int RandomPaletteIndex = 9;
 
@@ -727,9 +1004,72 @@ public:
     }
   }
 
+  // Line between sub-pixel end points (Q16.16), e.g. projected vertices, replacing the pixels.
+  // One pixel per column (per row when steep): the one the exact line crosses at the column's
+  // centre. Start row and error term come from the fractional end points, the loop only adds.
+  using Adafruit_GFX::drawLine; // keep GFX's integer / RGB565 overload visible next to this one
+  void drawLine(const FixVec2 &a, const FixVec2 &b, CRGB color)
+  {
+    // 24.8 is plenty of sub-pixel precision and keeps the loop in 32 bits
+    int32_t x0 = a.x >> 8, y0 = a.y >> 8, x1 = b.x >> 8, y1 = b.y >> 8;
+    bool steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep) { std::swap(x0, y0); std::swap(x1, y1); }
+    if (x0 > x1) { std::swap(x0, x1); std::swap(y0, y1); }
+
+    const int major = steep ? height : width;
+    const int minor = steep ? width : height;
+    const int step = steep ? width : 1;         // leds[] stride along the major axis
+    const int minorStep = steep ? 1 : width;
+
+    int c0 = x0 < 0 ? 0 : x0 >> 8;
+    int c1 = (x1 >> 8) < major ? x1 >> 8 : major - 1;
+    if (c0 > c1) return;
+
+    int32_t dx = x1 - x0, dy = y1 - y0;         // dx >= |dy|
+    if (dx == 0) {
+      int row = y0 >> 8;
+      if ((unsigned)row < (unsigned)minor) leds[c0 * step + row * minorStep] = color;
+      return;
+    }
+
+    // Minor coordinate at the centre of column c0: row + rem / den
+    const int32_t den = dx * 256;
+    int64_t num = (int64_t)y0 * dx + (int64_t)(c0 * 256 + 128 - x0) * dy;
+    int32_t row = num / den;
+    if (num < 0 && num % den) row--;
+    int32_t rem = num - (int64_t)row * den;
+    const int32_t inc = dy * 256;
+
+    for (int c = c0; c <= c1; c++) {
+      if ((unsigned)row < (unsigned)minor) leds[c * step + row * minorStep] = color;
+      rem += inc;
+      if (rem >= den) { rem -= den; row++; }
+      else if (rem < 0) { rem += den; row--; }
+    }
+  }
+
 
   CRGB ColorFromCurrentPalette(uint8_t index = 0, uint8_t brightness = 255, TBlendType blendType = LINEARBLEND) {
-    return ColorFromPalette(currentPalette, index, brightness, currentBlendType);
+    CRGB c = paletteLut[index];
+    if (brightness == 255) return c;
+    if (brightness == 0) return CRGB(0, 0, 0);
+
+    // same brightness step as ColorFromPalette()
+    ++brightness;
+#if !(FASTLED_SCALE8_FIXED == 1)
+    if (c.r) c.r = scale8(c.r, brightness) + 1;
+    if (c.g) c.g = scale8(c.g, brightness) + 1;
+    if (c.b) c.b = scale8(c.b, brightness) + 1;
+#else
+    c.r = scale8(c.r, brightness);
+    c.g = scale8(c.g, brightness);
+    c.b = scale8(c.b, brightness);
+#endif
+    return c;
+  }
+
+  uint16_t ColorFromCurrentPalette565(uint8_t index) const {
+    return paletteLut565[index];
   }
 
   CRGB HsvToRgb(uint8_t h, uint8_t s, uint8_t v) {
@@ -750,19 +1090,26 @@ public:
   }
 
   void FillNoise() {
-    for (uint16_t i = 0; i < width; i++) {
-      uint32_t ioffset = noise_scale_x * (i - width / 2);
+    auto band = [this](int y0, int y1) { FillNoiseRows(y0, y1); };
+    rowJobs.forEachBand(height, band);
+  }
 
-      for (uint16_t j = 0; j < height; j++) {
-        uint32_t joffset = noise_scale_y * (j - height / 2);
+  // rows [y0, y1) of FillNoise(), every cell is independent
+  void FillNoiseRows(int y0, int y1) {
+    for (int j = y0; j < y1; j++) {
+      uint32_t joffset = noise_scale_y * (j - height / 2);
+      uint8_t *row = noise + j * width;
+
+      for (int i = 0; i < width; i++) {
+        uint32_t ioffset = noise_scale_x * (i - width / 2);
 
         byte data = inoise16(noise_x + ioffset, noise_y + joffset, noise_z) >> 8;
 
-        uint8_t olddata = noise[i][j];
+        uint8_t olddata = row[i];
         uint8_t newdata = scale8(olddata, noisesmoothing) + scale8(data, 256 - noisesmoothing);
         data = newdata;
 
-        noise[i][j] = data;
+        row[i] = data;
       }
     }
   }
@@ -832,6 +1179,108 @@ public:
     }
   }
 
+private:
+  uint32_t *blurLine = nullptr; // blurDim() vertical carry, 2 words per column
+  CRGB *uploadLine = nullptr;   // ShowFrame() transitions: 2 rows of non-CRGB canvases expanded
+
+  // CRGB::nscale8() multiplier: (c * mul) >> 8
+  static uint32_t scaleMul(uint8_t scale) {
+#if (FASTLED_SCALE8_FIXED == 1)
+    return (uint32_t)scale + 1;
+#else
+    return scale;
+#endif
+  }
+
+  // nscale8() of the 8-bit values in the low byte of each 16-bit lane (mul <= 256, so lanes never overflow)
+  static inline uint32_t scaleLanes(uint32_t v, uint32_t mul) {
+    return ((v * mul) >> 8) & 0x00FF00FF;
+  }
+
+  // qadd8() per lane, as CRGB::operator+=
+  static inline uint32_t addLanes(uint32_t a, uint32_t b) {
+    uint32_t sum = a + b;
+    uint32_t over = sum & 0x01000100;
+    return (sum | (over - (over >> 8))) & 0x00FF00FF;
+  }
+
+  static inline void storeLanes(CRGB &px, uint32_t rb, uint32_t g) {
+    px.r = rb >> 16;
+    px.g = g;
+    px.b = rb;
+  }
+
+  // Upload leds, expanded from format F
+  template <PixelFormat F>
+  void uploadFrame() {
+    typedef PixelTraits<F> Traits;
+    const typename Traits::pixel_t *px = (const typename Traits::pixel_t *)leds;
+    for (int y = 0; y < height; ++y) {
+      for (int x = 0; x < width; ++x) {
+        CRGB c = Traits::toRGB(*px++, paletteLut);
+        // MatrixDisplay applies the per-panel column offset and the chain mapping
+        virtualDisp->drawPixelRGB888(x, y, c.r, c.g, c.b);
+      }
+    }
+  }
+
+  // Row y of a canvas as CRGB: PIXEL_CRGB rows are used in place, the others are expanded into line
+  const CRGB *canvasRow(const CRGB *canvas, PixelFormat format, int y, CRGB *line) const {
+    switch (format) {
+      case PIXEL_INDEXED: expandRow<PIXEL_INDEXED>(canvas, y, line); return line;
+      case PIXEL_RGB565:  expandRow<PIXEL_RGB565>(canvas, y, line); return line;
+      default:            return canvas + y * width;
+    }
+  }
+
+  template <PixelFormat F>
+  void expandRow(const CRGB *canvas, int y, CRGB *line) const {
+    typedef PixelTraits<F> Traits;
+    const typename Traits::pixel_t *px = (const typename Traits::pixel_t *)canvas + y * width;
+    for (int x = 0; x < width; ++x)
+      line[x] = Traits::toRGB(px[x], paletteLut);
+  }
+
+  // One pixel of a transition, amount 0..255 of the way from a to b
+  inline CRGB transitionPixel(const CRGB &a, const CRGB &b, int x, int y, uint16_t amount, TransitionStyle style) const {
+    switch (style) {
+      case TRANSITION_WIPE:
+        return (uint32_t)x * 256 < (uint32_t)amount * width ? b : a;
+      case TRANSITION_DISSOLVE: {
+        // Fixed per-pixel threshold from an integer hash of (x, y)
+        uint32_t h = (uint32_t)x * 0x9E3779B1u ^ (uint32_t)y * 0x85EBCA77u;
+        h ^= h >> 15;
+        return (h >> 24) < amount ? b : a;
+      }
+      default:
+        return CRGB(a.r + (((b.r - a.r) * (int)amount) >> 8),
+                    a.g + (((b.g - a.g) * (int)amount) >> 8),
+                    a.b + (((b.b - a.b) * (int)amount) >> 8));
+    }
+  }
+
+  void allocateBuffers() {
+    // we do dynamic allocation for leds buffer, otherwise esp32 toolchain can't link static arrays of such a big size for 256+ matrices
+    num_leds = width * height;
+    ledsBytes = canvasBytes(pixelFormat);
+    leds = (CRGB *)malloc(ledsBytes);
+
+    // allocate mem for noise effect
+    // (there should be some guards for malloc errors eventually)
+    noise = (uint8_t *)malloc(width * height);
+
+    blurLine = (uint32_t *)malloc(2 * width * sizeof(uint32_t));
+    uploadLine = (CRGB *)malloc(2 * width * sizeof(CRGB));
+  }
+
+  void freeBuffers() {
+    freeTransitionBuffer();
+    free(leds);
+    free(blurLine);
+    free(uploadLine);
+    free(noise);
+  }
+
 };
 
 #endif
@@ -0,0 +1,172 @@
+/*
+ * Fire / smoke cellular automaton for EffectsLayer
+ *
+ * PatternFireKoz used to keep fireBuffer[x][y][2] column-first at the compile-time panel
+ * size, average five neighbours in float, and call random(0, 100) per column per frame.
+ * FireSim is the engine behind it and PatternSmoke:
+ *
+ *  - the heat field is one byte per cell, row-major like effects.leds, sized to the
+ *    canvas, with FIRE_FUEL_ROWS hidden rows under the bottom edge that feed the flames
+ *  - two copies of it, ping-ponged: a step reads one and writes the other, so every row
+ *    is independent and the step runs in bands on both cores (rowJobs)
+ *  - a cell moves one row up each step as the average of the three cells below it and
+ *    the one below those, minus a cooling value taken from a small random map that
+ *    scrolls up with the flames (Hugo Elias' fire). The map is dithered from a cooling
+ *    rate in 1/256 steps, so a rate scaled to the canvas height never rounds to 0. The
+ *    inner loop has no branch and no random call, so GCC vectorises it where the target
+ *    has SIMD
+ *  - the fuel rows are refilled with xorshift32, two cells per 32-bit draw
+ *  - heat becomes colour through a 256-entry table, written straight into effects.leds
+ *    in the same band pass. The panel driver maps every channel through its CIE 1931
+ *    table on the way out, so the table gets no gamma of its own unless the driver is
+ *    built with NO_CIE1931
+ *
+ * Typical use:
+ *
+ *   void start()          { fire.setPalette(colorOf); fire.begin(effects.width, effects.height); }
+ *   unsigned drawFrame()  { fire.step(effects); return 16; }
+ */
+
+#ifndef FireSim_H
+#define FireSim_H
+
+#include "EffectsLayer.hpp"
+
+#define FIRE_FUEL_ROWS 2    // hidden rows under the canvas that the fuel is poured into
+#define FIRE_COOL_ROWS 32   // rows of the cooling map, the cooling pattern repeats after that
+#ifdef NO_CIE1931
+#define FIRE_GAMMA 2.2f     // no CIE 1931 table in the driver: the heat colours were picked on a gamma-encoded screen
+#else
+#define FIRE_GAMMA 1.0f     // the driver's lumConvTab already turns the colours into PWM duty
+#endif
+
+class FireSim {
+public:
+  uint16_t cooling = 8 << 8; // most heat a cell loses per row it rises (cooling / 2 on average) in 1/256 steps, set before begin()
+  uint8_t fuelMin = 0;      // fuel cells get fuelMin..fuelMax heat
+  uint8_t fuelMax = 255;
+  uint8_t gapChance = 51;   // chance (of 256) of a cold fuel cell, which splits the flames into tongues
+  CRGB lut[256];            // heat -> colour (setPalette())
+
+  ~FireSim() {
+    end();
+  }
+
+  // Allocate the heat field for a w x h canvas; false (and nothing drawn) when out of memory
+  bool begin(int w, int h) {
+    end();
+    width = w;
+    height = h;
+
+    size_t cells = (size_t)w * (h + FIRE_FUEL_ROWS);
+    heat[0] = (uint8_t *)calloc(cells, 1);
+    heat[1] = (uint8_t *)calloc(cells, 1);
+    coolMap = (uint8_t *)malloc((size_t)w * FIRE_COOL_ROWS);
+    if (!heat[0] || !heat[1] || !coolMap) {
+      end();
+      return false;
+    }
+
+    // 0..cooling / 256 per cell, the fraction rounded up with its own probability
+    for (int i = 0; i < w * FIRE_COOL_ROWS; i++) {
+      uint32_t r = rng.next();
+      uint16_t c = (r & 0xffff) % (cooling + 1);
+      coolMap[i] = (c >> 8) + ((c & 255) > (r >> 24));
+    }
+    current = 0;
+    coolScroll = 0;
+    return true;
+  }
+
+  void end() {
+    free(heat[0]);
+    free(heat[1]);
+    free(coolMap);
+    heat[0] = heat[1] = coolMap = nullptr;
+  }
+
+  // lut[h] = colorOf(h) with the gamma curve applied to each channel (none at gamma 1)
+  template <typename Fn>
+  void setPalette(Fn colorOf, float gamma = FIRE_GAMMA) {
+    uint8_t curve[256];
+    for (int i = 0; i < 256; i++)
+      curve[i] = gamma == 1.0f ? i : (uint8_t)(powf(i / 255.0f, gamma) * 255.0f + 0.5f);
+    for (int h = 0; h < 256; h++) {
+      CRGB c = colorOf((uint8_t)h);
+      lut[h] = CRGB(curve[c.r], curve[c.g], curve[c.b]);
+    }
+  }
+
+  // One step: pour fuel, rise and cool every cell, colour the canvas
+  void step(EffectsLayer &fx) {
+    if (!heat[0]) return;
+
+    pourFuel(heat[current]);
+    coolScroll = coolScroll == FIRE_COOL_ROWS - 1 ? 0 : coolScroll + 1;
+
+    auto band = [this, &fx](int y0, int y1) {
+      for (int y = y0; y < y1; y++) {
+        stepRow(y);
+        renderRow(fx, y);
+      }
+    };
+    rowJobs.forEachBand(height, band);
+
+    current ^= 1;
+  }
+
+  // The field as last drawn, row-major width x height (the fuel rows follow)
+  const uint8_t *field() const {
+    return heat[current];
+  }
+
+private:
+  int width = 0;
+  int height = 0;
+  uint8_t *heat[2] = { nullptr, nullptr };
+  uint8_t *coolMap = nullptr;   // width x FIRE_COOL_ROWS
+  uint8_t current = 0;          // heat[current] is read by the next step, the other one written
+  uint8_t coolScroll = 0;
+  XorShift32 rng;
+
+  // The mean is rounded: a plain >> 2 loses 3/8 heat per row on average, which on tall
+  // canvases outweighs the cooling and pulls the flames down
+  static inline uint8_t rise(uint8_t left, uint8_t centre, uint8_t right, uint8_t below, uint8_t cool) {
+    uint8_t h = (left + centre + right + below + 1) >> 2;
+    return h > cool ? h - cool : 0;
+  }
+
+  void pourFuel(uint8_t *field) {
+    uint8_t *fuel = field + width * height;
+    const int cells = width * FIRE_FUEL_ROWS;
+    const uint8_t range = fuelMax - fuelMin;
+    for (int i = 0; i < cells; i += 2) {
+      uint32_t r = rng.next();
+      fuel[i] = (uint8_t)r < gapChance ? 0 : fuelMin + scale8((uint8_t)(r >> 8), range);
+      if (i + 1 < cells)
+        fuel[i + 1] = (uint8_t)(r >> 16) < gapChance ? 0 : fuelMin + scale8((uint8_t)(r >> 24), range);
+    }
+  }
+
+  void stepRow(int y) {
+    const uint8_t *__restrict below = heat[current] + (y + 1) * width;
+    const uint8_t *__restrict below2 = below + width;
+    const uint8_t *__restrict cool = coolMap + ((y + coolScroll) % FIRE_COOL_ROWS) * width;
+    uint8_t *__restrict out = heat[current ^ 1] + y * width;
+    const int last = width - 1;
+
+    out[0] = rise(below[0], below[0], below[1], below2[0], cool[0]);
+    for (int x = 1; x < last; x++)
+      out[x] = rise(below[x - 1], below[x], below[x + 1], below2[x], cool[x]);
+    out[last] = rise(below[last - 1], below[last], below[last], below2[last], cool[last]);
+  }
+
+  void renderRow(EffectsLayer &fx, int y) {
+    const uint8_t *h = heat[current ^ 1] + y * width;
+    CRGB *px = fx.leds + y * fx.width;
+    for (int x = 0; x < width; x++)
+      px[x] = lut[h[x]];
+  }
+};
+
+#endif
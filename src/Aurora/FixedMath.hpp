@@ -0,0 +1,218 @@
+/*
+ * Fixed-point vector math for the geometric patterns
+ *
+ * Cube, Spin and friends used float vectors and matrices with cos() / sin() /
+ * radians() every frame. Here everything is Q16.16 in an int32_t (fix16_t):
+ *
+ *  - fixMul() / fixDiv() go through 64 bits, so products of canvas-sized values
+ *    (a few hundred pixels) never overflow
+ *  - angles are 16-bit binary angles (fixangle_t, 65536 per turn), so they wrap
+ *    for free; fixSin() / fixCos() read a quarter-wave table with 1024 steps per
+ *    turn and interpolate linearly in between (error below 3e-5)
+ *  - FixVec2 / FixVec3 / FixMat3 / FixMat4 cover rotate, translate and project
+ *
+ * EffectsLayer::drawLine(FixVec2, FixVec2, CRGB) rasterises a line between two
+ * projected, sub-pixel end points with an integer Bresenham loop.
+ */
+
+#ifndef FixedMath_H
+#define FixedMath_H
+
+#include <stdint.h>
+
+typedef int32_t fix16_t;     // Q16.16
+typedef uint16_t fixangle_t; // 65536 per turn
+
+#define FIX16_SHIFT 16
+#define FIX16_ONE 65536
+#define FIX16_HALF 32768
+
+constexpr fix16_t fixFromInt(int value) { return value * FIX16_ONE; }
+constexpr fix16_t fixFromFloat(float value) { return (fix16_t)(value * 65536.0f + (value >= 0 ? 0.5f : -0.5f)); }
+inline float fixToFloat(fix16_t value) { return value / 65536.0f; }
+inline int fixFloor(fix16_t value) { return value >> FIX16_SHIFT; }
+inline int fixRound(fix16_t value) { return (value + FIX16_HALF) >> FIX16_SHIFT; }
+
+inline fix16_t fixMul(fix16_t a, fix16_t b) { return (fix16_t)(((int64_t)a * b) >> FIX16_SHIFT); }
+inline fix16_t fixDiv(fix16_t a, fix16_t b) { return (fix16_t)((int64_t)a * FIX16_ONE / b); }
+
+// The casts wrap, so any angle maps onto the turn
+constexpr fixangle_t fixAngleFromRadians(float radians) { return (fixangle_t)(int32_t)(radians * 10430.378f); }
+constexpr fixangle_t fixAngleFromDegrees(float degrees) { return (fixangle_t)(int32_t)(degrees * 182.04444f); }
+
+// sin(i * 90 / 256 degrees) in Q16.16, i = 0..256
+static const int32_t fixSinQuarter[257] = {
+  0, 402, 804, 1206, 1608, 2010, 2412, 2814,
+  3216, 3617, 4019, 4420, 4821, 5222, 5623, 6023,
+  6424, 6824, 7224, 7623, 8022, 8421, 8820, 9218,
+  9616, 10014, 10411, 10808, 11204, 11600, 11996, 12391,
+  12785, 13180, 13573, 13966, 14359, 14751, 15143, 15534,
+  15924, 16314, 16703, 17091, 17479, 17867, 18253, 18639,
+  19024, 19409, 19792, 20175, 20557, 20939, 21320, 21699,
+  22078, 22457, 22834, 23210, 23586, 23961, 24335, 24708,
+  25080, 25451, 25821, 26190, 26558, 26925, 27291, 27656,
+  28020, 28383, 28745, 29106, 29466, 29824, 30182, 30538,
+  30893, 31248, 31600, 31952, 32303, 32652, 33000, 33347,
+  33692, 34037, 34380, 34721, 35062, 35401, 35738, 36075,
+  36410, 36744, 37076, 37407, 37736, 38064, 38391, 38716,
+  39040, 39362, 39683, 40002, 40320, 40636, 40951, 41264,
+  41576, 41886, 42194, 42501, 42806, 43110, 43412, 43713,
+  44011, 44308, 44604, 44898, 45190, 45480, 45769, 46056,
+  46341, 46624, 46906, 47186, 47464, 47741, 48015, 48288,
+  48559, 48828, 49095, 49361, 49624, 49886, 50146, 50404,
+  50660, 50914, 51166, 51417, 51665, 51911, 52156, 52398,
+  52639, 52878, 53114, 53349, 53581, 53812, 54040, 54267,
+  54491, 54714, 54934, 55152, 55368, 55582, 55794, 56004,
+  56212, 56418, 56621, 56823, 57022, 57219, 57414, 57607,
+  57798, 57986, 58172, 58356, 58538, 58718, 58896, 59071,
+  59244, 59415, 59583, 59750, 59914, 60075, 60235, 60392,
+  60547, 60700, 60851, 60999, 61145, 61288, 61429, 61568,
+  61705, 61839, 61971, 62101, 62228, 62353, 62476, 62596,
+  62714, 62830, 62943, 63054, 63162, 63268, 63372, 63473,
+  63572, 63668, 63763, 63854, 63944, 64031, 64115, 64197,
+  64277, 64354, 64429, 64501, 64571, 64639, 64704, 64766,
+  64827, 64884, 64940, 64993, 65043, 65091, 65137, 65180,
+  65220, 65259, 65294, 65328, 65358, 65387, 65413, 65436,
+  65457, 65476, 65492, 65505, 65516, 65525, 65531, 65535,
+  65536
+};
+
+// sin(angle) in Q16.16
+inline fix16_t fixSin(fixangle_t angle) {
+  uint16_t step = angle >> 6;   // 1024 steps per turn
+  uint8_t i = step & 255;       // step within the quarter
+  int32_t a, b;
+  if (step & 256) {             // second and fourth quarter run backwards
+    a = fixSinQuarter[256 - i];
+    b = fixSinQuarter[255 - i];
+  } else {
+    a = fixSinQuarter[i];
+    b = fixSinQuarter[i + 1];
+  }
+  fix16_t value = a + (((b - a) * (int32_t)(angle & 63)) >> 6);
+  return (step & 512) ? -value : value;
+}
+
+inline fix16_t fixCos(fixangle_t angle) { return fixSin(angle + 16384); }
+
+struct FixVec2 {
+  fix16_t x, y;
+
+  FixVec2() : x(0), y(0) {}
+  FixVec2(fix16_t x, fix16_t y) : x(x), y(y) {}
+
+  FixVec2 operator+(const FixVec2 &v) const { return FixVec2(x + v.x, y + v.y); }
+  FixVec2 operator-(const FixVec2 &v) const { return FixVec2(x - v.x, y - v.y); }
+  FixVec2 operator*(fix16_t s) const { return FixVec2(fixMul(x, s), fixMul(y, s)); }
+  fix16_t dot(const FixVec2 &v) const { return fixMul(x, v.x) + fixMul(y, v.y); }
+  // z of the 3D cross product, > 0 when v is counter-clockwise from this (y up)
+  fix16_t cross(const FixVec2 &v) const { return (fix16_t)(((int64_t)x * v.y - (int64_t)y * v.x) >> FIX16_SHIFT); }
+};
+
+struct FixVec3 {
+  fix16_t x, y, z;
+
+  FixVec3() : x(0), y(0), z(0) {}
+  FixVec3(fix16_t x, fix16_t y, fix16_t z) : x(x), y(y), z(z) {}
+
+  FixVec3 operator+(const FixVec3 &v) const { return FixVec3(x + v.x, y + v.y, z + v.z); }
+  FixVec3 operator-(const FixVec3 &v) const { return FixVec3(x - v.x, y - v.y, z - v.z); }
+  FixVec3 operator*(fix16_t s) const { return FixVec3(fixMul(x, s), fixMul(y, s), fixMul(z, s)); }
+  fix16_t dot(const FixVec3 &v) const { return fixMul(x, v.x) + fixMul(y, v.y) + fixMul(z, v.z); }
+  FixVec3 cross(const FixVec3 &v) const {
+    return FixVec3(fixMul(y, v.z) - fixMul(z, v.y), fixMul(z, v.x) - fixMul(x, v.z), fixMul(x, v.y) - fixMul(y, v.x));
+  }
+};
+
+// Perspective projection onto the z = focal plane (x, y scaled by focal / z). Points closer
+// than z = 1 (or behind the camera) are projected as if at z = 1 instead of dividing by ~0.
+inline FixVec2 fixProject(const FixVec3 &v, fix16_t focal) {
+  fix16_t z = v.z < FIX16_ONE ? FIX16_ONE : v.z;
+  return FixVec2(fixDiv(fixMul(focal, v.x), z), fixDiv(fixMul(focal, v.y), z));
+}
+
+struct FixMat3 {
+  fix16_t m[3][3];
+
+  static FixMat3 identity() {
+    FixMat3 r = {{{FIX16_ONE, 0, 0}, {0, FIX16_ONE, 0}, {0, 0, FIX16_ONE}}};
+    return r;
+  }
+
+  // Right-handed rotations by angle about each axis
+  static FixMat3 rotationX(fixangle_t angle) {
+    fix16_t c = fixCos(angle), s = fixSin(angle);
+    FixMat3 r = {{{FIX16_ONE, 0, 0}, {0, c, -s}, {0, s, c}}};
+    return r;
+  }
+
+  static FixMat3 rotationY(fixangle_t angle) {
+    fix16_t c = fixCos(angle), s = fixSin(angle);
+    FixMat3 r = {{{c, 0, s}, {0, FIX16_ONE, 0}, {-s, 0, c}}};
+    return r;
+  }
+
+  static FixMat3 rotationZ(fixangle_t angle) {
+    fix16_t c = fixCos(angle), s = fixSin(angle);
+    FixMat3 r = {{{c, -s, 0}, {s, c, 0}, {0, 0, FIX16_ONE}}};
+    return r;
+  }
+
+  FixMat3 operator*(const FixMat3 &b) const {
+    FixMat3 r;
+    for (int i = 0; i < 3; i++)
+      for (int j = 0; j < 3; j++)
+        r.m[i][j] = fixMul(m[i][0], b.m[0][j]) + fixMul(m[i][1], b.m[1][j]) + fixMul(m[i][2], b.m[2][j]);
+    return r;
+  }
+
+  FixVec3 operator*(const FixVec3 &v) const {
+    return FixVec3(fixMul(m[0][0], v.x) + fixMul(m[0][1], v.y) + fixMul(m[0][2], v.z),
+                   fixMul(m[1][0], v.x) + fixMul(m[1][1], v.y) + fixMul(m[1][2], v.z),
+                   fixMul(m[2][0], v.x) + fixMul(m[2][1], v.y) + fixMul(m[2][2], v.z));
+  }
+};
+
+// Affine transform: a 3x3 linear part and a translation, last row (0, 0, 0, 1)
+struct FixMat4 {
+  fix16_t m[4][4];
+
+  static FixMat4 identity() { return FixMat4(FixMat3::identity()); }
+
+  static FixMat4 translation(fix16_t x, fix16_t y, fix16_t z) {
+    FixMat4 r = identity();
+    r.m[0][3] = x;
+    r.m[1][3] = y;
+    r.m[2][3] = z;
+    return r;
+  }
+
+  FixMat4() {}
+
+  explicit FixMat4(const FixMat3 &linear) {
+    for (int i = 0; i < 3; i++) {
+      for (int j = 0; j < 3; j++) m[i][j] = linear.m[i][j];
+      m[i][3] = 0;
+      m[3][i] = 0;
+    }
+    m[3][3] = FIX16_ONE;
+  }
+
+  FixMat4 operator*(const FixMat4 &b) const {
+    FixMat4 r;
+    for (int i = 0; i < 4; i++)
+      for (int j = 0; j < 4; j++)
+        r.m[i][j] = fixMul(m[i][0], b.m[0][j]) + fixMul(m[i][1], b.m[1][j]) +
+                    fixMul(m[i][2], b.m[2][j]) + fixMul(m[i][3], b.m[3][j]);
+    return r;
+  }
+
+  // Transform a point (w = 1)
+  FixVec3 operator*(const FixVec3 &v) const {
+    return FixVec3(fixMul(m[0][0], v.x) + fixMul(m[0][1], v.y) + fixMul(m[0][2], v.z) + m[0][3],
+                   fixMul(m[1][0], v.x) + fixMul(m[1][1], v.y) + fixMul(m[1][2], v.z) + m[1][3],
+                   fixMul(m[2][0], v.x) + fixMul(m[2][1], v.y) + fixMul(m[2][2], v.z) + m[2][3]);
+  }
+};
+
+#endif
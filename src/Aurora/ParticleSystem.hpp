@@ -0,0 +1,263 @@
+/*
+ * Particle engine for EffectsLayer
+ *
+ * Particle patterns (Fireworks, Stardust Burst, Starfield, Rain, Bounce, Attract) used
+ * to keep their own arrays of particle structs with an "active" flag, float positions
+ * and a random() call per particle, and Attract / Bounce copied a whole Boid by value
+ * for every particle every frame. ParticlePool replaces those with one engine:
+ *
+ *  - structure-of-arrays storage (x[], y[], vx[], ...), so the update and draw passes
+ *    stream through a few small arrays instead of striding over fat structs
+ *  - a fixed capacity chosen per pattern, with an O(1) free list of slot indices; a
+ *    slot keeps its index while alive, so patterns may keep their own per-particle
+ *    arrays next to the pool and index them the same way
+ *  - fixed-point kinematics: positions are 24.8 pixels, velocities and gravity 8.8
+ *    pixels per frame
+ *  - batched emitters (emit()) that spawn a whole burst in one call with FastLED's
+ *    random8() / random16() and the sin8 / cos8 tables
+ *  - one draw pass that writes the live particles straight into effects.leds
+ *
+ * Typical frame:
+ *
+ *   effects.DimAll(235);            // trails
+ *   particles.emit(emitter, 6);     // spawn
+ *   particles.update(effects);      // move, age, kill
+ *   particles.draw(effects);        // render
+ *
+ * Extra forces are applied by the pattern between emit() and update() by looping over
+ * forEachAlive() and adding to vx[] / vy[].
+ */
+
+#ifndef ParticleSystem_H
+#define ParticleSystem_H
+
+#include "EffectsLayer.hpp"
+
+// 24.8 fixed-point pixel coordinate
+typedef int32_t pfix_t;
+#define PFIX_SHIFT 8
+#define PFIX_ONE (1 << PFIX_SHIFT)
+
+inline pfix_t toPfix(int pixels) { return (pfix_t)pixels * PFIX_ONE; }
+inline int fromPfix(pfix_t value) { return value >> PFIX_SHIFT; }
+
+// Integer square root, for speed limits and distances in fixed point
+inline uint16_t isqrt32(uint32_t value) {
+  uint32_t root = 0, bit = 1UL << 30;
+  while (bit > value) bit >>= 2;
+  while (bit) {
+    if (value >= root + bit) {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return root;
+}
+
+// What happens to a particle that leaves the canvas
+enum ParticleEdge : uint8_t {
+  PARTICLE_EDGE_NONE,    // keeps flying (it is simply not drawn)
+  PARTICLE_EDGE_KILL,    // dies
+  PARTICLE_EDGE_BOUNCE,  // is reflected back in
+};
+
+// Draw flags
+enum ParticleDrawFlags : uint8_t {
+  PARTICLE_DRAW_FADE = 1,     // brightness falls linearly from 255 to 0 over the particle's life
+  PARTICLE_DRAW_EASED = 2,    // with FADE: ease8InOutQuad() on the fade
+  PARTICLE_DRAW_FADE_IN = 4,  // brightness rises from 0 to 255 over the particle's life
+  PARTICLE_DRAW_ADD = 8,      // add to the pixel (saturating) instead of replacing it
+  PARTICLE_DRAW_PALETTE = 16, // colour is ColorFromCurrentPalette(hue[i]) instead of color[i]
+};
+
+/**
+ * Burst description for ParticlePool::emit(). Every particle gets the origin plus a
+ * random offset, the base velocity plus a random box spread and a random radial
+ * speed, and a random life.
+ */
+struct ParticleEmitter {
+  pfix_t x = 0, y = 0;               // origin (24.8)
+  int16_t spreadX = 0, spreadY = 0;  // origin offset, +- pixels
+  int16_t vx = 0, vy = 0;            // base velocity (8.8)
+  int16_t spreadVX = 0, spreadVY = 0;// uniform velocity spread, +- (8.8)
+  int16_t speedMin = 0, speedMax = 0;// radial speed in a random direction (8.8), 0 for none
+  uint8_t lifeMin = 255, lifeMax = 255; // frames
+  CRGB color = CRGB::White;
+  uint8_t hue = 0;                   // palette index, for PARTICLE_DRAW_PALETTE
+};
+
+template <uint16_t CAPACITY>
+class ParticlePool {
+public:
+  // Particle state, slot i is in use while life[i] != 0
+  pfix_t x[CAPACITY], y[CAPACITY];     // position (24.8)
+  int16_t vx[CAPACITY], vy[CAPACITY];  // velocity (8.8 pixels per frame)
+  uint8_t age[CAPACITY];               // frames lived
+  uint8_t life[CAPACITY];              // frames to live, 0 = free slot, 255 = until killed
+  CRGB color[CAPACITY];
+  uint8_t hue[CAPACITY];
+
+  // Simulation parameters
+  int16_t gravityX = 0, gravityY = 0;  // added to the velocity every frame (8.8)
+  uint16_t maxSpeed = 0;               // velocity magnitude limit (8.8), 0 for none
+  ParticleEdge edge = PARTICLE_EDGE_KILL;
+  uint8_t drawFlags = 0;
+
+  ParticlePool() { clear(); }
+
+  static uint16_t capacity() { return CAPACITY; }
+  uint16_t count() const { return CAPACITY - freeCount; }
+  bool full() const { return freeCount == 0; }
+
+  void clear() {
+    memset(life, 0, sizeof(life));
+    // Hand out low slots first, so the passes only walk up to the high-water mark
+    for (uint16_t i = 0; i < CAPACITY; i++)
+      freeList[i] = CAPACITY - 1 - i;
+    freeCount = CAPACITY;
+    highWater = 0;
+  }
+
+  // Spawn one particle, returns its slot or -1 if the pool is full
+  int spawn(pfix_t px, pfix_t py, int16_t pvx, int16_t pvy, uint8_t plife, CRGB pcolor, uint8_t phue = 0) {
+    if (!freeCount) return -1;
+    uint16_t i = freeList[--freeCount];
+    if (i >= highWater) highWater = i + 1;
+    x[i] = px;
+    y[i] = py;
+    vx[i] = pvx;
+    vy[i] = pvy;
+    age[i] = 0;
+    life[i] = plife ? plife : 1;
+    color[i] = pcolor;
+    hue[i] = phue;
+    return i;
+  }
+
+  void kill(uint16_t i) {
+    if (!life[i]) return;
+    life[i] = 0;
+    freeList[freeCount++] = i;
+  }
+
+  // Spawn up to count particles from one emitter, returns how many were spawned
+  int emit(const ParticleEmitter &e, int count) {
+    int spawned = 0;
+    uint8_t lifeRange = e.lifeMax - e.lifeMin;
+    int16_t speedRange = e.speedMax - e.speedMin;
+    for (; spawned < count && freeCount; spawned++) {
+      pfix_t px = e.x, py = e.y;
+      if (e.spreadX) px += toPfix(randomSpread(e.spreadX));
+      if (e.spreadY) py += toPfix(randomSpread(e.spreadY));
+
+      int16_t pvx = e.vx, pvy = e.vy;
+      if (e.spreadVX) pvx += randomSpread(e.spreadVX);
+      if (e.spreadVY) pvy += randomSpread(e.spreadVY);
+      if (e.speedMax) {
+        uint8_t angle = random8();
+        int16_t speed = e.speedMin + (speedRange > 0 ? (int16_t)((uint32_t)random16() * (speedRange + 1) >> 16) : 0);
+        pvx += ((int16_t)cos8(angle) - 128) * speed >> 7;
+        pvy += ((int16_t)sin8(angle) - 128) * speed >> 7;
+      }
+
+      uint8_t plife = e.lifeMin + (lifeRange ? random8(lifeRange + 1) : 0);
+      spawn(px, py, pvx, pvy, plife, e.color, e.hue);
+    }
+    return spawned;
+  }
+
+  // Call fn(i) for every live particle
+  template <class Fn>
+  void forEachAlive(Fn fn) {
+    for (uint16_t i = 0; i < highWater; i++)
+      if (life[i]) fn(i);
+  }
+
+  // Advance one frame: gravity, speed limit, move, age, edges
+  void update(const EffectsLayer &fx) {
+    const pfix_t maxX = toPfix(fx.width) - 1, maxY = toPfix(fx.height) - 1;
+    const uint32_t maxSpeed2 = (uint32_t)maxSpeed * maxSpeed;
+
+    for (uint16_t i = 0; i < highWater; i++) {
+      if (!life[i]) continue;
+
+      int16_t pvx = vx[i] + gravityX;
+      int16_t pvy = vy[i] + gravityY;
+      if (maxSpeed) {
+        uint32_t speed2 = (int32_t)pvx * pvx + (int32_t)pvy * pvy;
+        if (speed2 > maxSpeed2) {
+          uint16_t speed = isqrt32(speed2);
+          pvx = (int32_t)pvx * maxSpeed / speed;
+          pvy = (int32_t)pvy * maxSpeed / speed;
+        }
+      }
+      pfix_t px = x[i] + pvx;
+      pfix_t py = y[i] + pvy;
+
+      if (life[i] != 255 && ++age[i] >= life[i]) {
+        kill(i);
+        continue;
+      }
+
+      if (px < 0 || px > maxX || py < 0 || py > maxY) {
+        if (edge == PARTICLE_EDGE_KILL) {
+          kill(i);
+          continue;
+        }
+        if (edge == PARTICLE_EDGE_BOUNCE) {
+          if (px < 0) { px = -px; pvx = -pvx; }
+          else if (px > maxX) { px = 2 * maxX - px; pvx = -pvx; }
+          if (py < 0) { py = -py; pvy = -pvy; }
+          else if (py > maxY) { py = 2 * maxY - py; pvy = -pvy; }
+        }
+      }
+
+      x[i] = px;
+      y[i] = py;
+      vx[i] = pvx;
+      vy[i] = pvy;
+    }
+  }
+
+  // Render every live particle on the canvas into fx.leds
+  void draw(EffectsLayer &fx) const {
+    const int width = fx.width, height = fx.height;
+    CRGB *leds = fx.leds;
+
+    for (uint16_t i = 0; i < highWater; i++) {
+      if (!life[i]) continue;
+
+      int px = fromPfix(x[i]), py = fromPfix(y[i]);
+      if ((unsigned)px >= (unsigned)width || (unsigned)py >= (unsigned)height) continue;
+
+      CRGB c = (drawFlags & PARTICLE_DRAW_PALETTE) ? fx.ColorFromCurrentPalette(hue[i]) : color[i];
+      if ((drawFlags & (PARTICLE_DRAW_FADE | PARTICLE_DRAW_FADE_IN)) && life[i] != 255) {
+        uint8_t level = (uint16_t)age[i] * 255 / life[i];
+        if (drawFlags & PARTICLE_DRAW_FADE) {
+          level = 255 - level;
+          if (drawFlags & PARTICLE_DRAW_EASED) level = ease8InOutQuad(level);
+        }
+        c.nscale8(level);
+      }
+
+      CRGB &pixel = leds[py * width + px];
+      if (drawFlags & PARTICLE_DRAW_ADD) pixel += c;
+      else pixel = c;
+    }
+  }
+
+private:
+  uint16_t freeList[CAPACITY];  // Free slots, popped from the end
+  uint16_t freeCount;
+  uint16_t highWater;           // Slots at or above this index have never been used since clear()
+
+  // Uniform in [-range, range]
+  static int16_t randomSpread(int16_t range) {
+    return (int16_t)((uint32_t)random16() * (2 * range + 1) >> 16) - range;
+  }
+};
+
+#endif
@@ -24,16 +24,23 @@
 #define PatternAttract_H // Ensure header guard is present and correct
 
 #include "EffectsLayer.hpp" // Ensure EffectsLayer is included for Drawable and effects object
-#include "Attractor.hpp"    // Include Attractor class definition
+#include "ParticleSystem.hpp"
 
+// Particles orbiting an attractor in the centre of the screen. This is the force
+// of Attractor.hpp (G * mass / d^2 towards the centre, d limited to 5..32 px) in
+// fixed point, applied to the particle velocities before the pool moves them.
 class PatternAttract : public Drawable {
 private:
-    const int count = AVAILABLE_BOID_COUNT-1;
-    Attractor attractor;
+    static const int count = MATRIX_WIDTH-1;
+    ParticlePool<count> particles;
 
 public:
     PatternAttract() {
         name = (char *)"Attract";
+
+        particles.maxSpeed = 384;                // 1.5 px/frame (8.8), the Boid default
+        particles.edge = PARTICLE_EDGE_NONE;
+        particles.drawFlags = PARTICLE_DRAW_PALETTE;
     }
 
     void start() {
@@ -41,15 +48,11 @@ public:
         if (direction == 0)
             direction = -1;
 
+        particles.clear();
         for (int i = 0; i < count; i++) {
-            Boid boid = Boid(VPANEL_W/2, VPANEL_H - i);
-            boid.mass = 1; // random(0.1, 2);
-            boid.velocity.x = ((float) random(40, 50)) / 100.0;
-            boid.velocity.x *= direction;
-            boid.velocity.y = 0;
-            boid.colorIndex = i * 32;
-            boids[i] = boid;
-            //dim = random(170, 250);
+            // 0.40..0.50 px/frame sideways
+            int16_t vx = direction * (int16_t)(random(40, 50) * PFIX_ONE / 100);
+            particles.spawn(toPfix(effects.width / 2), toPfix(effects.height - i), vx, 0, 255, CRGB::Black, i * 32);
         }
     }
 
@@ -58,19 +61,25 @@ public:
         uint8_t dim = beatsin8(2, 170, 250);
         effects.DimAll(dim);
 
-        for (int i = 0; i < count; i++) {
-            Boid boid = boids[i];
-
-            PVector force = attractor.attract(boid);
-            boid.applyForce(force);
+        // Distances in 1/16 px, so the squares below stay in 32 bits
+        const int32_t centerX = toPfix(effects.getCenterX()) >> 4;
+        const int32_t centerY = toPfix(effects.getCenterY()) >> 4;
+        particles.forEachAlive([&](uint16_t i) {
+            int32_t dx = centerX - (particles.x[i] >> 4);
+            int32_t dy = centerY - (particles.y[i] >> 4);
+            int32_t d = isqrt32(dx * dx + dy * dy);
+            if (!d) return;
+            int32_t dc = constrain(d, 5 * 16, 32 * 16);
 
-            boid.update();
-            effects.setPixel(boid.location.x, boid.location.y, effects.ColorFromCurrentPalette(boid.colorIndex));
+            // strength = G * mass / d^2 = 5 / d^2 px/frame^2, times 256 for 8.8 and the unit vector dx / d
+            int64_t denominator = (int64_t)d * dc * dc;
+            particles.vx[i] += (int16_t)((int64_t)327680 * dx / denominator);
+            particles.vy[i] += (int16_t)((int64_t)327680 * dy / denominator);
+        });
 
-            boids[i] = boid;
-        }
+        particles.update(effects);
+        particles.draw(effects);
 
-        effects.ShowFrame();
         return 0;
     }
 };
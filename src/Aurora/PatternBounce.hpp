@@ -21,50 +21,50 @@
  */
 
 #ifndef PatternBounce_H
+#define PatternBounce_H
+
+#include "EffectsLayer.hpp"
+#include "ParticleSystem.hpp"
 
 class PatternBounce : public Drawable {
 private:
     static const int count = VPANEL_W-1;
-    PVector gravity = PVector(0, 0.0125);
+    ParticlePool<count> balls;
 
 public:
     PatternBounce() {
         name = (char *)"Bounce";
+
+        balls.gravityY = 3;                 // 0.0125 px/frame^2 (8.8)
+        balls.edge = PARTICLE_EDGE_NONE;    // Balls fly off the top and fall back in
+        balls.drawFlags = PARTICLE_DRAW_PALETTE;
     }
 
     void start() {
         unsigned int colorWidth = 256 / count;
+        balls.clear();
         for (int i = 0; i < count; i++) {
-            Boid boid = Boid(i, 0);
-            boid.velocity.x = 0;
-            boid.velocity.y = i * -0.01;
-            boid.colorIndex = colorWidth * i;
-            boid.maxforce = 10;
-            boid.maxspeed = 10;
-            boids[i] = boid;
+            // Each column starts a little faster than the one to its left: -0.01 px/frame per column
+            balls.spawn(toPfix(i), 0, 0, -(i * PFIX_ONE) / 100, 255, CRGB::Black, colorWidth * i);
         }
     }
 
     unsigned int drawFrame() {
         // dim all pixels on the display
-        effects.DimAll(170); effects.ShowFrame();
-
-        for (int i = 0; i < count; i++) {
-            Boid boid = boids[i];
+        effects.DimAll(170);
 
-            boid.applyForce(gravity);
+        balls.update(effects);
 
-            boid.update();
-
-            effects.setPixel(boid.location.x, boid.location.y, effects.ColorFromCurrentPalette(boid.colorIndex));
-
-            if (boid.location.y >= VPANEL_H - 1) {
-                boid.location.y = VPANEL_H - 1;
-                boid.velocity.y *= -1.0;
+        // Bounce off the floor only
+        const pfix_t floor = toPfix(effects.height - 1);
+        balls.forEachAlive([&](uint16_t i) {
+            if (balls.y[i] >= floor) {
+                balls.y[i] = floor;
+                balls.vy[i] = -balls.vy[i];
             }
+        });
 
-            boids[i] = boid;
-        }
+        balls.draw(effects);
 
         return 15;
     }
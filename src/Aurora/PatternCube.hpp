@@ -30,45 +30,43 @@
 #define PatternCube_H
 
 #include "EffectsLayer.hpp"
-#include "Geometry.hpp" // Vertex, Point 등의 정의가 포함된 파일
-#include <FastLED.h>    // For RectangularXYMap and blur2d
+#include "Geometry.hpp" // squareFace, EdgePoint
+#include "FixedMath.hpp"
+#include <FastLED.h>    // For beatsin8
 
+// Rotation, projection and line drawing are all Q16.16 (FixedMath.hpp)
 class PatternCube : public Drawable {
   private:
-    float focal = 30; // Focal of the camera
-    int cubeWidth = 28; // Cube size
-    float Angx = 20.0, AngxSpeed = 0.05; // rotation (angle+speed) around X-axis
-    float Angy = 10.0, AngySpeed = 0.05; // rotation (angle+speed) around Y-axis
-    float Ox = MATRIX_WIDTH/2, Oy = MATRIX_HEIGHT/2; // position (x,y) of the frame center
+    fix16_t focal = fixFromInt(30); // Focal of the camera
+    fixangle_t Angx = fixAngleFromRadians(20.0), AngxSpeed; // rotation (angle+speed) around X-axis
+    fixangle_t Angy = fixAngleFromRadians(10.0), AngySpeed; // rotation (angle+speed) around Y-axis
+    fix16_t Ox = fixFromInt(effects.width/2), Oy = fixFromInt(effects.height/2); // position (x,y) of the frame center
     int zCamera = 110; // distance from cube to the eye of the camera
 
     // Local vertices
-    Vertex  local[8];
-    // Camera aligned vertices
-    Vertex  aligned[8];
-    // On-screen projected vertices
-    Point   screen[8];
+    FixVec3 local[8];
+    // On-screen projected vertices (sub-pixel)
+    FixVec2 screen[8];
     // Faces
     squareFace face[6];
     // Edges
     EdgePoint edge[12];
     int nbEdges;
-    // ModelView matrix
-    float m00, m01, m02, m10, m11, m12, m20, m21, m22;
 
     // constructs the cube
     void make(int w)
     {
       nbEdges = 0;
 
-      local[0].set(-w, w, w);
-      local[1].set(w, w, w);
-      local[2].set(w, -w, w);
-      local[3].set(-w, -w, w);
-      local[4].set(-w, w, -w);
-      local[5].set(w, w, -w);
-      local[6].set(w, -w, -w);
-      local[7].set(-w, -w, -w);
+      fix16_t p = fixFromInt(w), n = -p;
+      local[0] = FixVec3(n, p, p);
+      local[1] = FixVec3(p, p, p);
+      local[2] = FixVec3(p, n, p);
+      local[3] = FixVec3(n, n, p);
+      local[4] = FixVec3(n, p, n);
+      local[5] = FixVec3(p, p, n);
+      local[6] = FixVec3(p, n, n);
+      local[7] = FixVec3(n, n, n);
 
       face[0].set(1, 0, 3, 2);
       face[1].set(0, 4, 7, 3);
@@ -99,45 +97,30 @@ class PatternCube : public Drawable {
     }
 
     // rotates according to angle x&y
-    void rotate(float angx, float angy)
+    void rotate(fixangle_t angx, fixangle_t angy)
     {
       int i;
-      float cx = cos(angx);
-      float sx = sin(angx);
-      float cy = cos(angy);
-      float sy = sin(angy);
-
-      m00 = cy;
-      m01 = 0;
-      m02 = -sy;
-      m10 = sx * sy;
-      m11 = cx;
-      m12 = sx * cy;
-      m20 = cx * sy;
-      m21 = -sx;
-      m22 = cx * cy;
+
+      // ModelView: rotate about y, then about x (both clockwise), then push away from the camera
+      FixMat4 modelView = FixMat4::translation(0, 0, fixFromInt(zCamera)) *
+                          FixMat4(FixMat3::rotationX(-angx) * FixMat3::rotationY(-angy));
 
       for (i = 0; i < 8; i++)
       {
-        aligned[i].x = m00 * local[i].x + m01 * local[i].y + m02 * local[i].z;
-        aligned[i].y = m10 * local[i].x + m11 * local[i].y + m12 * local[i].z;
-        aligned[i].z = m20 * local[i].x + m21 * local[i].y + m22 * local[i].z + zCamera;
-
-        screen[i].x = floor((Ox + focal * aligned[i].x / aligned[i].z));
-        screen[i].y = floor((Oy - focal * aligned[i].y / aligned[i].z));
+        FixVec2 p = fixProject(modelView * local[i], focal);
+        screen[i] = FixVec2(Ox + p.x, Oy - p.y);
       }
 
       for (i = 0; i < 12; i++)
         edge[i].visible = false;
 
-      Point *pa, *pb, *pc;
       for (i = 0; i < 6; i++)
       {
-        pa = screen + face[i].sommets[0];
-        pb = screen + face[i].sommets[1];
-        pc = screen + face[i].sommets[2];
+        const FixVec2 &pa = screen[face[i].sommets[0]];
+        const FixVec2 &pb = screen[face[i].sommets[1]];
+        const FixVec2 &pc = screen[face[i].sommets[2]];
 
-        boolean back = ((pb->x - pa->x) * (pc->y - pa->y) - (pb->y - pa->y) * (pc->x - pa->x)) < 0;
+        boolean back = (pb - pa).cross(pc - pa) < 0;
         if (!back)
         {
           int j;
@@ -155,7 +138,7 @@ class PatternCube : public Drawable {
   public:
     PatternCube() {
       name = (char *)"Cube";
-      make(MATRIX_WIDTH);
+      make(effects.width);
     }
 
     void start() override {
@@ -167,26 +150,16 @@ class PatternCube : public Drawable {
       uint8_t blurAmount = beatsin8(2, 10, 128);
       // uint8_t blurAmount = 224; // For a more pronounced fade/trail effect within the cube pattern itself
 
-#if FASTLED_VERSION >= 3009020
-      // blur2d(effects.leds, MATRIX_WIDTH, MATRIX_HEIGHT, blurAmount);
-      fl::XYMap matrix_map(MATRIX_WIDTH, MATRIX_HEIGHT, false); // Use XYMap, non-serpentine
-      fl::blur2d(effects.leds, (uint8_t)MATRIX_WIDTH, (uint8_t)MATRIX_HEIGHT, blurAmount, matrix_map);
-#else
-      // If this path is taken, ensure no premature ShowFrame()
-      effects.DimAll(blurAmount); 
-#endif
+      effects.blur(blurAmount);
 
+      // Speeds of 0.01 .. 0.06 rad per frame
       zCamera = beatsin8(2, 100, 140);
-      AngxSpeed = beatsin8(3, 1, 6) / 100.0f;
-      AngySpeed = effects.beatcos8(5, 1, 6) / 100.0f;
+      AngxSpeed = beatsin8(3, 1, 6) * fixAngleFromRadians(0.01);
+      AngySpeed = effects.beatcos8(5, 1, 6) * fixAngleFromRadians(0.01);
 
-      // Update values
+      // Update values (binary angles wrap at a full turn)
       Angx += AngxSpeed;
       Angy += AngySpeed;
-      if (Angx >= TWO_PI)
-        Angx -= TWO_PI;
-      if (Angy >= TWO_PI)
-        Angy -= TWO_PI;
 
       rotate(Angx, Angy);
 
@@ -200,25 +173,18 @@ class PatternCube : public Drawable {
       for (i = 0; i < 12; i++)
       {
         e = edge + i;
-        if (!e->visible) {
-          // Convert CRGB to uint16_t for Adafruit_GFX::drawLine
-          uint16_t lineColor = effects.virtualDisp->color565(color.r, color.g, color.b); // 또는 Adafruit_GFX::color565
-          effects.drawLine(screen[e->x].x, screen[e->x].y, screen[e->y].x, screen[e->y].y, lineColor);
-        }
+        if (!e->visible)
+          effects.drawLine(screen[e->x], screen[e->y], color);
       }
 
-      color = effects.ColorFromCurrentPalette(hue, 255);
+      CRGB frontColor = effects.ColorFromCurrentPalette(hue);
 
       // Frontface
       for (i = 0; i < 12; i++)
       {
         e = edge + i;
         if (e->visible)
-        {
-          // Convert CRGB to uint16_t for Adafruit_GFX::drawLine
-          uint16_t lineColor = effects.virtualDisp->color565(color.r, color.g, color.b); // 또는 Adafruit_GFX::color565
-          effects.drawLine(screen[e->x].x, screen[e->x].y, screen[e->y].x, screen[e->y].y, lineColor);
-        }
+          effects.drawLine(screen[e->x], screen[e->y], frontColor);
       }
 
       step++;
@@ -227,8 +193,6 @@ class PatternCube : public Drawable {
         hue++;
       }
 
-      effects.ShowFrame();
-
       return 20;
     }
 };
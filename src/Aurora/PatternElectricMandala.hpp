@@ -96,17 +96,15 @@ class PatternElectricMandala : public Drawable {
       effects.Caleidoscope3();
       effects.Caleidoscope1();
 
-      effects.ShowFrame();
-
       return 30;
     }
 
     // show just one layer
     void ShowNoiseLayer(byte layer, byte colorrepeat, byte colorshift) {
-      for (uint16_t i = 0; i < VPANEL_W; i++) {
-        for (uint16_t j = 0; j < VPANEL_H; j++) {
+      for (uint16_t j = 0; j < effects.height; j++) {
+        for (uint16_t i = 0; i < effects.width; i++) {
 
-          uint8_t color = effects.noise[i][j];
+          uint8_t color = effects.noise[effects.XY16(i, j)];
 
           uint8_t bri = color;
 
@@ -2,152 +2,24 @@
 #define FireWork_H
 
 #include "EffectsLayer.hpp" // Ensure EffectsLayer is included
+#include "ParticleSystem.hpp"
 
 /****************************************************************
- * Fireworks Class
+ * Fireworks
  ****************************************************************/
 // Ripped from: https://github.com/lmirel/MorphingClockRemix
+//
+// Every firework is one rocket particle that rises until gravity turns it around,
+// then bursts into FIREWORK_PARTICLES sparks. Rockets and sparks share one pool.
 
-const int FIREWORKS = 4;           // Number of fireworks
+const int FIREWORKS = 4;            // Number of fireworks
 const int FIREWORK_PARTICLES = 32;  // Number of particles per firework
+const uint8_t FIREWORK_SPARK_LIFE = 50; // Frames a burst lasts before the firework is relaunched
 
-const float GRAVITY = 0.03f;
-const float baselineSpeed = -1.2f;
-const float maxSpeed = -2.0f;
-
-class Firework
-{
-  public:
-    float x[FIREWORK_PARTICLES];
-    float y[FIREWORK_PARTICLES];
-    char lx[FIREWORK_PARTICLES], ly[FIREWORK_PARTICLES];
-    float xSpeed[FIREWORK_PARTICLES];
-    float ySpeed[FIREWORK_PARTICLES];
-
-    char red;
-    char blue;
-    char green;
-    char alpha;
-
-    int framesUntilLaunch;
-
-    char particleSize;
-    bool hasExploded;
-
-    Firework() { // Constructor implementation moved inside
-      initialise();
-      for (int loop = 0; loop < FIREWORK_PARTICLES; loop++)
-      {
-        lx[loop] = 0;
-        ly[loop] = VPANEL_H + 1; // Push the particle location down off the bottom of the screen
-      }
-    }
-
-    void initialise() { // Moved inside
-        // Pick an initial x location and  random x/y speeds
-        float xLoc = (rand() % VPANEL_W);
-        float xSpeedVal = baselineSpeed + (rand() % (int)maxSpeed);
-        float ySpeedVal = baselineSpeed + (rand() % (int)maxSpeed);
-
-        // Set initial x/y location and speeds
-        for (int loop = 0; loop < FIREWORK_PARTICLES; loop++)
-        {
-            x[loop] = xLoc;
-            y[loop] = VPANEL_H + 1; // Push the particle location down off the bottom of the screen
-            xSpeed[loop] = xSpeedVal;
-            ySpeed[loop] = ySpeedVal;
-            //don't reset these otherwise particles won't be removed
-            //lx[loop] = 0;
-            //ly[loop] = LAYER_HEIGHT + 1; // Push the particle location down off the bottom of the screen
-        }
-
-        // Assign a random colour and full alpha (i.e. particle is completely opaque)
-        red   = (rand() % 255);/// (float)RAND_MAX);
-        green = (rand() % 255); /// (float)RAND_MAX);
-        blue  = (rand() % 255); /// (float)RAND_MAX);
-        alpha = 50;//max particle frames
-
-        // Firework will launch after a random amount of frames between 0 and 400
-        framesUntilLaunch = ((int)rand() % (VPANEL_H));
-
-        // Size of the particle (as thrown to glPointSize) - range is 1.0f to 4.0f
-        particleSize = 1.0f + ((float)rand() / (float)RAND_MAX) * 3.0f;
-
-        // Flag to keep trackof whether the firework has exploded or not
-        hasExploded = false;
-
-        //cout << "Initialised a firework." << endl;
-    }
-
-    void move() { // Moved inside
-        for (int loop = 0; loop < FIREWORK_PARTICLES; loop++)
-        {
-            // Once the firework is ready to launch start moving the particles
-            if (framesUntilLaunch <= 0)
-            {
-                //draw black on last known position
-                //tl->drawPixel (x[loop], y[loop], cc_blk);
-                lx[loop] = x[loop];
-                ly[loop] = y[loop];
-                //
-                x[loop] += xSpeed[loop];
-
-                y[loop] += ySpeed[loop];
-
-                ySpeed[loop] += GRAVITY;
-            }
-        }
-        framesUntilLaunch--;
-
-        // Once a fireworks speed turns positive (i.e. at top of arc) - blow it up!
-        if (ySpeed[0] > 0.0f)
-        {
-            for (int loop2 = 0; loop2 < FIREWORK_PARTICLES; loop2++)
-            {
-                // Set a random x and y speed beteen -4 and + 4
-                xSpeed[loop2] = -2 + (rand() / (float)RAND_MAX) * 4;
-                ySpeed[loop2] = -2 + (rand() / (float)RAND_MAX) * 4;
-            }
-
-            //cout << "Boom!" << endl;
-            hasExploded = true;
-        }
-    }
-
-    void explode() { // Moved inside
-        for (int loop = 0; loop < FIREWORK_PARTICLES; loop++)
-        {
-            // Dampen the horizontal speed by 1% per frame
-            xSpeed[loop] *= 0.99;
-
-            //draw black on last known position (NO LONGER USED tl->dim used instead)
-            //tl->drawPixel (x[loop], y[loop], cc_blk);
-            lx[loop] = x[loop];
-            ly[loop] = y[loop];
-            //
-            // Move the particle
-            x[loop] += xSpeed[loop];
-            y[loop] += ySpeed[loop];
-
-            // Apply gravity to the particle's speed
-            ySpeed[loop] += GRAVITY;
-        }
-
-        // Fade out the particles (alpha is stored per firework, not per particle)
-        if (alpha > 0)
-        {
-            alpha -= 1;
-        }
-        else // Once the alpha hits zero reset the firework
-        {
-            initialise();
-        }
-    }
-};
-
-/*********************** */
-
-
+const int16_t FIREWORK_GRAVITY = 8;        // 0.03 px/frame^2 (8.8)
+const int16_t FIREWORK_SPEED_FAST = -307;  // -1.2 px/frame (8.8)
+const int16_t FIREWORK_SPEED_SLOW = -51;   // -0.2 px/frame (8.8)
+const int16_t FIREWORK_SPARK_SPEED = 512;  // Sparks fly at up to +-2 px/frame (8.8)
 
 class PatternFirework : public Drawable {
 
@@ -155,65 +27,91 @@ class PatternFirework : public Drawable {
     PatternFirework() {
         name = (char *)"PatternFirework";
 
+        particles.gravityY = FIREWORK_GRAVITY;
+        particles.edge = PARTICLE_EDGE_NONE; // Rockets launch from below the screen
     }
 
-    void start() { } // Moved inside
+    void start() {
+        particles.clear();
+        for (int f = 0; f < FIREWORKS; f++)
+            initialise(f);
+    }
 
-    void stop()  { } // Moved inside
+    void stop()  { }
 
-    unsigned int drawFrame() { // Moved inside
+    unsigned int drawFrame() {
 
         effects.DimAll(250);
 
-        CRGB cc_frw;
-        //display.fillScreen (0);
-        // Draw fireworks
-        //cout << "Firework count is: " << Firework::fireworkCount << endl;
-        for (int loop = 0; loop < FIREWORKS; loop++)
-        {
-            for (int particleLoop = 0; particleLoop < FIREWORK_PARTICLES; particleLoop++)
-            {
-
-                // Set colour to yellow on way up, then whatever colour firework should be when exploded
-                if (fw[loop].hasExploded == false)
-                {
-                    //glColor4f(1.0f, 1.0f, 0.0f, 1.0f);
-                    cc_frw = CRGB (255, 255, 0);
+        for (int f = 0; f < FIREWORKS; f++) {
+            Firework &fw = fireworks[f];
+
+            if (fw.rocket < 0 && !fw.exploded) {
+                // Waiting on the ground
+                if (fw.framesUntilLaunch-- <= 0) {
+                    int16_t speedX = random8(2) ? FIREWORK_SPEED_FAST : FIREWORK_SPEED_SLOW;
+                    int16_t speedY = random8(2) ? FIREWORK_SPEED_FAST : FIREWORK_SPEED_SLOW;
+                    fw.rocket = particles.spawn(toPfix(fw.launchX), toPfix(effects.height + 1),
+                                                speedX, speedY, 255, CRGB(255, 255, 0));
                 }
-                else
-                {
-                    //glColor4f(fw[loop].red, fw[loop].green, fw[loop].blue, fw[loop].alpha);
-                    //glVertex2f(fw[loop].x[particleLoop], fw[loop].y[particleLoop]);
-                    cc_frw = CRGB (fw[loop].red, fw[loop].green, fw[loop].blue);
+            } else if (fw.rocket >= 0) {
+                // Once the rocket's speed turns positive (i.e. at top of arc) - blow it up!
+                if (particles.vy[fw.rocket] > 0) {
+                    ParticleEmitter burst;
+                    burst.x = particles.x[fw.rocket];
+                    burst.y = particles.y[fw.rocket];
+                    burst.spreadVX = FIREWORK_SPARK_SPEED;
+                    burst.spreadVY = FIREWORK_SPARK_SPEED;
+                    burst.lifeMin = burst.lifeMax = FIREWORK_SPARK_LIFE;
+                    burst.color = fw.color;
+
+                    particles.kill(fw.rocket);
+                    particles.emit(burst, FIREWORK_PARTICLES);
+                    fw.rocket = -1;
+                    fw.exploded = true;
+                    fw.framesLeft = FIREWORK_SPARK_LIFE;
                 }
-
-                // Draw the point
-                //glVertex2f(fw[loop].x[particleLoop], fw[loop].y[particleLoop]);
-                effects.leds[effects.XY16(fw[loop].x[particleLoop], fw[loop].y[particleLoop])] = cc_frw; // Use effects object
-               // effects.setPixel (fw[loop].lx[particleLoop], fw[loop].ly[particleLoop], 0);
-            }
-            // Move the firework appropriately depending on its explosion state
-            if (fw[loop].hasExploded == false)
-            {
-                fw[loop].move();
-            }
-            else
-            {
-                fw[loop].explode();
+            } else if (--fw.framesLeft <= 0) {
+                // Burst burnt out
+                initialise(f);
             }
-            //
-            //delay (10);
-        } // end loop
+        }
+
+        // Dampen the horizontal speed of the sparks by about 1% per frame
+        particles.forEachAlive([this](uint16_t i) {
+            if (particles.life[i] != 255)
+                particles.vx[i] -= particles.vx[i] / 128;
+        });
 
-          effects.ShowFrame();
+        particles.update(effects);
+        particles.draw(effects);
 
-          return 20;    
+        return 20;
     }
 
     private:
-        // Create our array of fireworks
-        Firework fw[FIREWORKS];
-
+        struct Firework {
+            int rocket;            // Pool slot of the rising rocket, -1 when on the ground or exploded
+            bool exploded;
+            int framesUntilLaunch;
+            int framesLeft;        // Frames until the sparks burn out
+            int launchX;
+            CRGB color;
+        };
+
+        Firework fireworks[FIREWORKS];
+        ParticlePool<FIREWORKS * (FIREWORK_PARTICLES + 1)> particles;
+
+        void initialise(int f) {
+            Firework &fw = fireworks[f];
+            fw.rocket = -1;
+            fw.exploded = false;
+            // Firework will launch after a random amount of frames
+            fw.framesUntilLaunch = random16(effects.height);
+            fw.framesLeft = 0;
+            fw.launchX = random16(effects.width);
+            fw.color = CRGB(random8(), random8(), random8());
+        }
 };
 
-#endif
\ No newline at end of file
+#endif
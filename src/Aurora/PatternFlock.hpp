@@ -80,7 +80,7 @@ class PatternFlock : public Drawable {
     }
 
     unsigned int drawFrame() {
-      effects.DimAll(230); effects.ShowFrame();
+      effects.DimAll(230);
 
       bool applyWind = random(0, 255) > 250;
       if (applyWind) {
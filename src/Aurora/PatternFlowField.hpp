@@ -24,6 +24,7 @@
 #define PatternFlowField_H // Ensure header guard is present and correct
 
 #include "EffectsLayer.hpp" // Ensure EffectsLayer is included for Drawable, Boid, PVector, and effects object
+#include "Boid.hpp"
 
 class PatternFlowField : public Drawable {
   public:
@@ -88,8 +89,6 @@ class PatternFlowField : public Drawable {
       y += speed;
       z += speed;
 
-      effects.ShowFrame();
-
       return 50;
     }
 };
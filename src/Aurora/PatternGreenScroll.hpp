@@ -5,14 +5,15 @@
 #ifndef PatternTheMatrix_H
 #define PatternTheMatrix_H
 
-// Function to generate a random greenish color for the digital rain
-CRGB generateRainColor() {
-  return CHSV(96 + random(64), 255, 255); // Greenish colors
-}
-
+#include "EffectsLayer.hpp"
 
 class PatternTheMatrix : public Drawable {
 
+    // Function to generate a random greenish color for the digital rain
+    CRGB generateRainColor() {
+      return CHSV(96 + random(64), 255, 255); // Greenish colors
+    }
+
   public:
     PatternTheMatrix() {
       name = (char *)"The Matrix";
@@ -22,15 +23,15 @@ class PatternTheMatrix : public Drawable {
     // Function to draw the digital rain effect
     void drawDigitalRain() {
       // Shift all the LEDs down by one row
-      for (int x = 0; x < VPANEL_W ; x++) {
-        for (int y = VPANEL_H - 1; y > 0; y--) {
-          effects.leds[XY(x, y)] = effects.leds[XY(x, y - 1)];
+      for (int x = 0; x < effects.width; x++) {
+        for (int y = effects.height - 1; y > 0; y--) {
+          effects.leds[effects.XY16(x, y)] = effects.leds[effects.XY16(x, y - 1)];
         }
         // Add a new drop at the top of the column randomly
         if (random(10) > 7) { // Adjust the probability to control density of rain
-          effects.leds[XY(x, 0)] = generateRainColor();
+          effects.leds[effects.XY16(x, 0)] = generateRainColor();
         } else {
-          effects.leds[XY(x, 0)] = CRGB::Black;
+          effects.leds[effects.XY16(x, 0)] = CRGB::Black;
         }
       }
     }
@@ -47,7 +48,6 @@ class PatternTheMatrix : public Drawable {
 
        drawDigitalRain();
 
-      effects.ShowFrame();
       return 0;
     }
 };
@@ -36,9 +36,9 @@ class PatternIncrementalDrift : public Drawable {
       //uint8_t dim = beatsin8(2, 230, 250);
       effects.DimAll(250); 
 
-      for (int i = 2; i <= VPANEL_W / 2; i++)
+      for (int i = 2; i <= effects.width / 2; i++)
       {
-        CRGB color = effects.ColorFromCurrentPalette((i - 2) * (240 / (VPANEL_W / 2)));
+        CRGB color = effects.ColorFromCurrentPalette((i - 2) * (240 / (effects.width / 2)));
 
         uint8_t x = effects.beatcos8((17 - i) * 2, effects.getCenterX() - i, effects.getCenterX() + i);
         uint8_t y = beatsin8((17 - i) * 2, effects.getCenterY() - i, effects.getCenterY() + i);
@@ -46,8 +46,6 @@ class PatternIncrementalDrift : public Drawable {
         effects.leds[effects.XY16(x,y)] = color; // Use effects.leds for direct CRGB assignment
       }
 
-       effects.ShowFrame();
-
       return 0;
     }
 };
@@ -24,6 +24,8 @@
 #ifndef PatternIncrementalDrift2_H
 #define PatternIncrementalDrift2_H
 
+#include "EffectsLayer.hpp"
+
 class PatternIncrementalDrift2 : public Drawable {
   public:
     PatternIncrementalDrift2() {
@@ -32,7 +34,7 @@ class PatternIncrementalDrift2 : public Drawable {
 
     unsigned int drawFrame() {
       uint8_t dim = beatsin8(2, 170, 250);
-      effects.DimAll(dim); effects.ShowFrame();
+      effects.DimAll(dim);
 
       for (int i = 2; i < VPANEL_H / 2; ++i)
       //for (uint8_t i = 0; i < 32; i++)
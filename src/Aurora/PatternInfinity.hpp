@@ -59,11 +59,12 @@ public:
 
         // draw a pixel at x,y using a color from the current palette
         CRGB color = effects.ColorFromCurrentPalette(hue);
-        // Use effects.drawTriangle to draw on the EffectsLayer's buffer (effects.leds)
-        effects.drawTriangle(x, y, x+1, y+1, x+2, y+2, effects.virtualDisp->color565(color.r, color.g, color.b));
+        // A three pixel diagonal head (the degenerate triangle x,y .. x+2,y+2), straight into
+        // effects.leds at full colour depth instead of through GFX and RGB565
+        FixVec2 head(fixFromInt(x) + FIX16_HALF, fixFromInt(y) + FIX16_HALF);
+        effects.drawLine(head, head + FixVec2(fixFromInt(2), fixFromInt(2)), color);
         ////effects.setPixelFromPaletteIndex(x, y, hue);
 
-        effects.ShowFrame();
         return 30;
     }
 };
@@ -2,6 +2,7 @@
 #define JuliaSet_H
 
 #include "EffectsLayer.hpp" // Ensure EffectsLayer is included
+#include "Shader.hpp"
 
 // Codetastic 2024
 
@@ -73,6 +74,23 @@ class PatternJuliaSet : public Drawable {
 
     float sint[256]; // precalculated sin table, for performance reasons
 
+    struct JuliaShader {
+      typedef RGBOutput Output;
+
+      const PatternJuliaSet *pattern;
+      double t;
+      float xoff, yoff;
+      float zy;
+
+      void beginRow(int y) { zy = y/64.f; }
+
+      CRGB operator()(int x) const {
+        uint32_t itcount = iteratefloat(xoff,yoff,((x-64)+1)/64.f,zy,64);
+        uint32_t itcolor = itcount?floatsqrt(itcount)*4+t*1024:0;
+        return pattern->paletteColor(itcolor);
+      }
+    };
+
   public:
     PatternJuliaSet() {
       name = (char *)"Julia Set";
@@ -90,7 +108,7 @@ class PatternJuliaSet : public Drawable {
     // https://editor.p5js.org/Kouzerumatsukite/sketches/DwTiq9D01
     // color palette originally made by piano_miles, written in p5js
     // hsv2rgb(IT, cos(4096*it)/2+0.5, 1-sin(2048*it)/2-0.5)
-    void drawPixelPalette(int x, int y, uint32_t m){
+    CRGB paletteColor(uint32_t m) const {
       float r = 0.f, g = 0.f, b = 0.f;
       if(m){
         char  n =         m>> 4                               ;
@@ -99,9 +117,8 @@ class PatternJuliaSet : public Drawable {
         r = (max(min(sint[n    &255]+0.5f,1.f),0.f)*s+(1-s))*l;
         g = (max(min(sint[n+ 85&255]+0.5f,1.f),0.f)*s+(1-s))*l;
         b = (max(min(sint[n+170&255]+0.5f,1.f),0.f)*s+(1-s))*l;
-      } // Use effects object for drawing
-      effects.leds[effects.XY16(x,y)] = CRGB(r,g,b);
-
+      }
+      return CRGB(r,g,b);
     }
 
     unsigned int drawFrame() {
@@ -111,19 +128,10 @@ class PatternJuliaSet : public Drawable {
       float cosk = (k-cos(t))/2;
       float xoff = (cos(t)*cosk+k/2-0.25);
       float yoff = (sin(t)*cosk         );
-      for(uint8_t y=0;y<VPANEL_H;y++){
-        for(uint8_t x=0;x<VPANEL_W;x++){
-          uint32_t itcount = iteratefloat(xoff,yoff,((x-64)+1)/64.f,(y)/64.f,64);
-          uint32_t itcolor = itcount?floatsqrt(itcount)*4+t*1024:0;
-          drawPixelPalette(x,y,itcolor);
-        }
-      }
+      renderShader(effects, JuliaShader{this, t, xoff, yoff, 0.f});
       
-      //blur2d(effects.leds, VPANEL_W, VPANEL_H, 64);
-      fl::XYMap matrix_map(effects.width, effects.height, false);
-      fl::blur2d(effects.leds, (uint8_t)effects.width, (uint8_t)effects.height, 64, matrix_map);
+      effects.blur(64);
 
-      effects.ShowFrame();
       return 0;      
     }
 
@@ -25,239 +25,310 @@
 #ifndef PatternMaze_H
 #define PatternMaze_H
 
+#include "EffectsLayer.hpp"
+
+#define MAZE_STEPS_PER_FRAME 24   // generator / solver steps per frame, so a frame costs the same for any maze size
+#define MAZE_HOLD_FRAMES 120      // frames the solved maze stays on screen before the next one
+#define MAZE_MAX_SIDE 255         // cells per side, keeps every cell index in a uint16_t
+
+// Generates a maze (growing tree: newest cell = recursive backtracker, random cell = Prim's),
+// then solves it from the top-left to the bottom-right cell (BFS or A*, alternating) and
+// traces the path. Cells sit on the even pixels, passages on the odd ones in between.
+//
+// All state lives in one arena allocated in start() for the canvas size:
+//   - queue: uint16_t cell indices, the growing-tree list, then the BFS queue or A* heap
+//   - cost:  uint16_t steps from the start cell, for A* and the explored colours
+//   - open:  2 bits per cell, passage to the right / down (left / up are the neighbours' bits)
+//   - back:  2 bits per cell, direction to the solver's parent
+//   - seen:  1 bit per cell
+// Each step draws only the pixels it changed, and a frame runs at most MAZE_STEPS_PER_FRAME
+// steps. Random choices come from a xorshift32 stream, so the same seed draws the same frames.
 class PatternMaze : public Drawable {
-private:
-    enum Directions {
-        None = 0,
-        Up = 1,
-        Down = 2,
-        Left = 4,
-        Right = 8,
-    };
-
-    struct Point{
-        int x;
-        int y;
-
-        static Point New(int x, int y) {
-            Point point;
-            point.x = x;
-            point.y = y;
-            return point;
-        }
+public:
+    uint32_t seed = 0; // Set before start() to replay the same mazes; 0 picks one
 
-        Point Move(Directions direction) {
-            switch (direction)
-            {
-                case Up:
-                    return New(x, y - 1);
+    PatternMaze() {
+        name = (char *)"Maze";
+    }
 
-                case Down:
-                    return New(x, y + 1);
+    ~PatternMaze() {
+        free(arena);
+    }
 
-                case Left:
-                    return New(x - 1, y);
+    void start() {
+        effects.ClearFrame();
 
-                case Right:
-                default:
-                    return New(x + 1, y);
-            }
+        free(arena);
+        cw = min(effects.width / 2, MAZE_MAX_SIDE);
+        ch = min(effects.height / 2, MAZE_MAX_SIDE);
+        cellCount = cw * ch;
+
+        size_t words = (size_t)cellCount * sizeof(uint16_t);
+        size_t pairs = (cellCount * 2 + 7) / 8;
+        size_t bits = (cellCount + 7) / 8;
+        arena = (uint8_t *)malloc(2 * words + 2 * pairs + bits);
+        if (!arena) {
+            Serial.println("Maze: not enough memory for the maze");
+            return;
         }
+        queue = (uint16_t *)arena;
+        cost = (uint16_t *)(arena + words);
+        open = arena + 2 * words;
+        back = open + pairs;
+        seen = back + pairs;
+
+        rng.state = seed ? seed : ((uint32_t)random16() << 16 | random16()) | 1;
+        algorithm = 0;
+        useAStar = false;
+        newMaze();
+    }
 
-        static Directions Opposite(Directions direction) {
-            switch (direction) {
-                case Up:
-                    return Down;
-
-                case Down:
-                    return Up;
+    void stop() {
+        free(arena);
+        arena = nullptr;
+    }
 
-                case Left:
-                    return Right;
+    unsigned int drawFrame() {
+        if (!arena) return 1000;
 
-                case Right:
-                default:
-                    return Left;
+        if (phase == HOLD) {
+            if (--holdFrames == 0) {
+                algorithm ^= 1;
+                if (!algorithm) useAStar = !useAStar;
+                newMaze();
             }
+            return 0;
         }
-    };
 
-//    int width = 16;
-//    int height = 16;
+        for (int budget = MAZE_STEPS_PER_FRAME; budget > 0 && phase != HOLD; budget--) {
+            switch (phase) {
+                case GENERATE: generateStep(); break;
+                case SOLVE:    useAStar ? aStarStep() : bfsStep(); break;
+                default:       traceStep(); break;
+            }
+        }
 
-    static const int width = VPANEL_W / 2;
-    static const int height = VPANEL_H / 2;
-    
+        return 0;
+    }
 
-    Directions grid[width][height];
+private:
+    enum Phase { GENERATE, SOLVE, TRACE, HOLD };
+    enum Direction { Right = 0, Down = 1, Left = 2, Up = 3 };
 
-    Point point;
+    uint8_t *arena = nullptr;
+    uint16_t *queue = nullptr;
+    uint16_t *cost = nullptr;
+    uint8_t *open = nullptr;
+    uint8_t *back = nullptr;
+    uint8_t *seen = nullptr;
 
-    Point cells[256];
+    int cw = 0, ch = 0;     // maze size in cells
     int cellCount = 0;
-
-    int algorithm = 0;
-    int algorithmCount = 1;
-
-    byte hue = 0;
-    byte hueOffset = 0;
-
-    Directions directions[4] = { Up, Down, Left, Right };
-
-    void removeCell(int index) {// shift cells after index down one
-        for (int i = index; i < cellCount - 1; i++) {
-            cells[i] = cells[i + 1];
+    int head = 0, tail = 0; // queue[head..tail) is the live part
+    uint16_t traceCell = 0;
+
+    Phase phase = GENERATE;
+    int algorithm = 0;      // 0: newest cell (backtracker), 1: random cell (Prim's)
+    bool useAStar = false;
+    int holdFrames = 0;
+    uint8_t hue = 0;
+    uint8_t hueOffset = 0;
+    XorShift32 rng;
+
+    // bit sets
+    bool getBit(const uint8_t *set, int i) const { return set[i >> 3] & (1 << (i & 7)); }
+    void setBit(uint8_t *set, int i) { set[i >> 3] |= 1 << (i & 7); }
+
+    // Neighbour of cell c in direction d, -1 off the maze
+    int neighbour(int c, int d) const {
+        int x = c % cw;
+        switch (d) {
+            case Right: return x + 1 < cw ? c + 1 : -1;
+            case Down:  return c + cw < cellCount ? c + cw : -1;
+            case Left:  return x > 0 ? c - 1 : -1;
+            default:    return c >= cw ? c - cw : -1;
         }
-
-        cellCount--;
     }
 
-    void shuffleDirections() {
-        for (int a = 0; a < 4; a++)
-        {
-            int r = random(a, 4);
-            Directions temp = directions[a];
-            directions[a] = directions[r];
-            directions[r] = temp;
+    // The passage between c and its neighbour in direction d is stored on the left / upper cell
+    int passageBit(int c, int d) const {
+        switch (d) {
+            case Right: return c * 2;
+            case Down:  return c * 2 + 1;
+            case Left:  return (c - 1) * 2;
+            default:    return (c - cw) * 2 + 1;
         }
     }
 
-    Point createPoint(int x, int y) {
-        Point point;
-        point.x = x;
-        point.y = y;
-        return point;
-    }
-
-    CRGB chooseColor(int index) {
-        byte h = index + hueOffset;
-                
-        switch (algorithm) {
-            case 0:
-            default:
-                return effects.ColorFromCurrentPalette(h);
+    bool isOpen(int c, int d) const { return getBit(open, passageBit(c, d)); }
 
-            case 1:
-                return effects.ColorFromCurrentPalette(hue++);
-        }
+    uint8_t backDir(int c) const { return (back[c >> 2] >> ((c & 3) * 2)) & 3; }
+    void setBackDir(int c, uint8_t d) {
+        uint8_t shift = (c & 3) * 2;
+        back[c >> 2] = (back[c >> 2] & ~(3 << shift)) | (d << shift);
     }
 
-    int chooseIndex(int max) {
-        switch (algorithm) {
-            case 0:
-            default:
-                // choose newest (recursive backtracker)
-                return max - 1;
-
-            case 1:
-                // choose random(Prim's)
-                return random(max);
-
-                // case 2:
-                //     // choose oldest (not good, so disabling)
-                //     return 0;
-        }
+    void drawCell(int c, CRGB color) {
+        effects.setPixel((c % cw) * 2, (c / cw) * 2, color);
     }
 
-    void generateMaze() {
-        while (cellCount > 1) {
-            drawNextCell();
-        }
+    void drawPassage(int c, int d, CRGB color) {
+        static const int8_t dx[4] = { 1, 0, -1, 0 };
+        static const int8_t dy[4] = { 0, 1, 0, -1 };
+        effects.setPixel((c % cw) * 2 + dx[d], (c / cw) * 2 + dy[d], color);
     }
 
-    void drawNextCell() {
-        int index = chooseIndex(cellCount);
-
-        if (index < 0)
-            return;
+    void newMaze() {
+        // Once per maze, not per frame
+        effects.ClearFrame();
+        memset(open, 0, (cellCount * 2 + 7) / 8);
+        memset(seen, 0, (cellCount + 7) / 8);
 
-        point = cells[index];
+        int first = rng.next() % cellCount;
+        setBit(seen, first);
+        queue[0] = first;
+        head = 0;
+        tail = 1;
 
-        Point imagePoint = createPoint(point.x * 2, point.y * 2);
+        hue = 0;
+        hueOffset = rng.next();
+        phase = GENERATE;
+    }
 
-        //effects.setPixel(imagePoint.x, imagePoint.y, CRGB(CRGB::Gray));
+    CRGB generatorColor(int index) {
+        if (algorithm == 0)
+            return effects.ColorFromCurrentPalette(index + hueOffset);
+        return effects.ColorFromCurrentPalette(hue++);
+    }
 
-        shuffleDirections();
+    // One growing-tree step: carve from the chosen cell into an unvisited neighbour, or retire it
+    void generateStep() {
+        int index = algorithm == 0 ? tail - 1 : rng.next() % tail;
+        int c = queue[index];
+        CRGB color = generatorColor(index);
 
-        CRGB color = chooseColor(index);
+        // Random order of the four directions
+        uint8_t order[4] = { Right, Down, Left, Up };
+        uint32_t r = rng.next();
+        std::swap(order[3], order[r % 4]);
+        std::swap(order[2], order[(r >> 8) % 3]);
+        std::swap(order[1], order[(r >> 16) & 1]);
 
         for (int i = 0; i < 4; i++) {
-            Directions direction = directions[i];
+            int n = neighbour(c, order[i]);
+            if (n >= 0 && !getBit(seen, n)) {
+                setBit(open, passageBit(c, order[i]));
+                setBit(seen, n);
+                queue[tail++] = n;
+                drawPassage(c, order[i], color);
+                return;
+            }
+        }
 
-            Point newPoint = point.Move(direction);
-            if (newPoint.x >= 0 && newPoint.y >= 0 && newPoint.x < width && newPoint.y < height && grid[newPoint.y][newPoint.x] == None) {
-                grid[point.y][point.x] = (Directions) ((int) grid[point.y][point.x] | (int) direction);
-                grid[newPoint.y][newPoint.x] = (Directions) ((int) grid[newPoint.y][newPoint.x] | (int) point.Opposite(direction));
+        // Dead end: the cell is done
+        drawCell(c, color);
+        queue[index] = queue[--tail];
+        if (tail == 0) beginSolve();
+    }
 
-                Point newImagePoint = imagePoint.Move(direction);
+    void beginSolve() {
+        memset(seen, 0, (cellCount + 7) / 8);
+        setBit(seen, 0);
+        cost[0] = 0;
+        queue[0] = 0;
+        head = 0;
+        tail = 1;
+        phase = SOLVE;
+    }
 
-                effects.setPixel(newImagePoint.x, newImagePoint.y, color);
+    // Reach n from c through direction d: record the way back and draw the step
+    void explore(int c, int d, int n) {
+        setBit(seen, n);
+        setBackDir(n, (d + 2) & 3);
+        cost[n] = cost[c] + 1;
+        CRGB color = effects.ColorFromCurrentPalette(cost[n] + hueOffset, 96);
+        drawPassage(c, d, color);
+        drawCell(n, color);
+    }
 
-                cellCount++;
-                cells[cellCount - 1] = newPoint;
+    void solved() {
+        traceCell = cellCount - 1;
+        drawCell(traceCell, CRGB::White);
+        phase = TRACE;
+    }
 
-                index = -1;
-                break;
+    void bfsStep() {
+        int c = queue[head++];
+        if (c == cellCount - 1) {
+            solved();
+            return;
+        }
+        for (int d = 0; d < 4; d++) {
+            int n = neighbour(c, d);
+            if (n >= 0 && isOpen(c, d) && !getBit(seen, n)) {
+                explore(c, d, n);
+                queue[tail++] = n;
             }
         }
+    }
 
-        if (index > -1) {
-            Point finishedPoint = cells[index];
-            imagePoint = createPoint(finishedPoint.x * 2, finishedPoint.y * 2);
-            effects.setPixel(imagePoint.x, imagePoint.y, color);
+    // A*: queue[0..tail) is a binary min-heap on cost + Manhattan distance to the goal
+    uint32_t priority(int c) const {
+        int h = (cw - 1 - c % cw) + (ch - 1 - c / cw);
+        return (uint32_t)(cost[c] + h) << 16 | (uint16_t)~cost[c]; // ties: deepest first
+    }
 
-            removeCell(index);
+    void heapPush(int c) {
+        int i = tail++;
+        while (i > 0 && priority(queue[(i - 1) / 2]) > priority(c)) {
+            queue[i] = queue[(i - 1) / 2];
+            i = (i - 1) / 2;
         }
+        queue[i] = c;
     }
 
-public:
-    PatternMaze() {
-        name = (char *)"Maze";
+    int heapPop() {
+        int top = queue[0];
+        int last = queue[--tail];
+        int i = 0;
+        for (;;) {
+            int child = 2 * i + 1;
+            if (child >= tail) break;
+            if (child + 1 < tail && priority(queue[child + 1]) < priority(queue[child])) child++;
+            if (priority(queue[child]) >= priority(last)) break;
+            queue[i] = queue[child];
+            i = child;
+        }
+        queue[i] = last;
+        return top;
     }
 
-    unsigned int drawFrame() {
-        if (cellCount < 1) {
-            
-            effects.ClearFrame();
-
-            // reset the maze grid
-            for (int y = 0; y < height; y++) {
-                for (int x = 0; x < width; x++) {
-                    grid[y][x] = None;
-                }
-            }
-
-            int x = random(width);
-            int y = random(height);
-
-            cells[0] = createPoint(x, y);
-
-            cellCount = 1;
-
-            hue = 0;
-            hueOffset = random(0, 256);
-            
+    void aStarStep() {
+        int c = heapPop();
+        if (c == cellCount - 1) {
+            solved();
+            return;
         }
-
-        drawNextCell();
-
-        if (cellCount < 1) {
-            algorithm++;
-            if (algorithm >= algorithmCount)
-                algorithm = 0;
-
-            return 0;
+        for (int d = 0; d < 4; d++) {
+            int n = neighbour(c, d);
+            if (n >= 0 && isOpen(c, d) && !getBit(seen, n)) {
+                explore(c, d, n);
+                heapPush(n);
+            }
         }
-
-        effects.ShowFrame();
-
-        return 0;
     }
 
-    void start() {
-        effects.ClearFrame();
-        cellCount = 0;
-        hue = 0;
+    // Walk the parents back from the goal, one cell per step
+    void traceStep() {
+        if (traceCell == 0) {
+            holdFrames = MAZE_HOLD_FRAMES;
+            phase = HOLD;
+            return;
+        }
+        int d = backDir(traceCell);
+        drawPassage(traceCell, d, CRGB::White);
+        traceCell = neighbour(traceCell, d);
+        drawCell(traceCell, CRGB::White);
     }
 };
 
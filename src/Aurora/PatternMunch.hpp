@@ -40,34 +40,38 @@ public:
         name = (char *)"Munch";
     }
 
+    void start() {
+        // Palette colours or black: RGB565 straight from paletteLut565, 2 bytes per pixel
+        effects.setPixelFormat(PIXEL_RGB565);
+    }
+
     unsigned int drawFrame() {
        
-        for (uint16_t x = 0; x < VPANEL_W; x++) {
-            for (uint16_t y = 0; y < VPANEL_H; y++) {
-                effects.leds[effects.XY16(x, y)] = (x ^ y ^ flip) < count ? effects.ColorFromCurrentPalette(((x ^ y) << 2) + generation) : CRGB::Black;
+        uint16_t *px = effects.frame565();
+        for (int y = 0; y < effects.height; y++) {
+            for (int x = 0; x < effects.width; x++) {
+                *px++ = (x ^ y ^ flip) < count ? effects.ColorFromCurrentPalette565(((x ^ y) << 2) + generation) : 0;
 
                 // The below is more pleasant
-               // effects.leds[XY16(x, y)] = effects.ColorFromCurrentPalette(((x ^ y) << 2) + generation) ;
+                // *px++ = effects.ColorFromCurrentPalette565(((x ^ y) << 2) + generation);
             }
         }
         
         count += dir;
         
-        if (count <= 0 || count >= VPANEL_W) {
+        if (count <= 0 || count >= effects.width) {
           dir = -dir;
         }
         
         if (count <= 0) {
           if (flip == 0)
-            flip = VPANEL_W-1;
+            flip = effects.width-1;
           else
             flip = 0;
         }
 
         generation++;
 
-        // show it ffs!
-        effects.ShowFrame();
         return 60;
     }
 };
@@ -47,9 +47,9 @@ public:
     counter = millis() / 10;
 #endif
 
-    byte x1 = 4 + effects.mapsin8(counter * 2, 0, MATRIX_WIDTH -1); // sin8 대신 effects.mapsin8 사용 및 범위 수정
-    byte x2 = 8 + effects.mapsin8(counter * 2, 0, MATRIX_HEIGHT -1); // sin8 대신 effects.mapsin8 사용 및 범위 수정
-    byte y2 = 8 + effects.mapcos8((counter * 2) / 3, 0, MATRIX_HEIGHT -1); // cos8 대신 effects.mapcos8 사용 및 범위 수정
+    byte x1 = 4 + effects.mapsin8(counter * 2, 0, effects.width -1); // sin8 대신 effects.mapsin8 사용 및 범위 수정
+    byte x2 = 8 + effects.mapsin8(counter * 2, 0, effects.height -1); // sin8 대신 effects.mapsin8 사용 및 범위 수정
+    byte y2 = 8 + effects.mapcos8((counter * 2) / 3, 0, effects.height -1); // cos8 대신 effects.mapcos8 사용 및 범위 수정
 
     effects.leds[effects.XY16(x1, x2)] = effects.ColorFromCurrentPalette(currentHue);
     effects.leds[effects.XY16(x2, y2)] = effects.ColorFromCurrentPalette(currentHue + 128);
@@ -68,7 +68,6 @@ public:
     // effects.MoveFractionalNoiseY(); // EffectsLayer에 해당 함수가 있는지 확인 필요, 없다면 주석 처리 또는 구현
 
     // patternNoiseSmearingHue++; // currentHue 사용
-    effects.ShowFrame();
     return 0;
   }
 };
@@ -80,19 +79,19 @@ public:
   }
 
   unsigned int drawFrame() {
-    effects.DimAll(230); // ShowFrame은 drawFrame의 마지막에 한번만 호출하는 것이 좋음
+    effects.DimAll(230); // ShowFrame은 drawFrame() 뒤에 ModePattern이 한 번 호출함
 
     uint8_t currentHue = effects.osci[1];
 
-    byte xx = 4 + effects.mapsin8(millis() / 9, 0, MATRIX_WIDTH -1);
-    byte yy = 4 + effects.mapcos8(millis() / 10, 0, MATRIX_HEIGHT -1);
+    byte xx = 4 + effects.mapsin8(millis() / 9, 0, effects.width -1);
+    byte yy = 4 + effects.mapcos8(millis() / 10, 0, effects.height -1);
     effects.leds[effects.XY16(xx, yy)] += effects.ColorFromCurrentPalette(currentHue);
 
-    xx = 8 + effects.mapsin8(millis() / 10, 0, MATRIX_WIDTH -1);
-    yy = 8 + effects.mapcos8(millis() / 7, 0, MATRIX_HEIGHT -1);
+    xx = 8 + effects.mapsin8(millis() / 10, 0, effects.width -1);
+    yy = 8 + effects.mapcos8(millis() / 7, 0, effects.height -1);
     effects.leds[effects.XY16(xx, yy)] += effects.ColorFromCurrentPalette(currentHue + 80);
 
-    effects.leds[effects.XY16(MATRIX_WIDTH -1, MATRIX_HEIGHT -1)] += effects.ColorFromCurrentPalette(currentHue + 160); // 중앙 대신 우하단으로 변경 (15,15는 32x32 기준)
+    effects.leds[effects.XY16(effects.width -1, effects.height -1)] += effects.ColorFromCurrentPalette(currentHue + 160); // 중앙 대신 우하단으로 변경 (15,15는 32x32 기준)
 
     effects.noise_x += 1000;
     effects.noise_y += 1000;
@@ -108,7 +107,6 @@ public:
     // effects.MoveFractionalNoiseX(4);
 
     // patternNoiseSmearingHue++;
-    effects.ShowFrame();
     return 0;
   }
 };
@@ -122,8 +120,8 @@ public:
   unsigned int drawFrame() {
     effects.DimAll(235);
 
-    for (uint8_t i = 3; i < MATRIX_WIDTH; i = i + 4) { // 32 대신 MATRIX_WIDTH 사용
-      effects.leds[effects.XY16(i, MATRIX_HEIGHT -1)] += effects.ColorFromCurrentPalette(i * 8); // 15 대신 MATRIX_HEIGHT -1 사용
+    for (uint16_t i = 3; i < effects.width; i = i + 4) { // 32 대신 effects.width 사용
+      effects.leds[effects.XY16(i, effects.height -1)] += effects.ColorFromCurrentPalette(i * 8); // 15 대신 effects.height -1 사용
     }
 
     // Noise
@@ -140,7 +138,6 @@ public:
     effects.MoveY(3);
     // effects.MoveFractionalNoiseX(4);
 
-    effects.ShowFrame();
     return 1;
   }
 };
@@ -155,7 +152,7 @@ public:
     effects.DimAll(235);
     uint8_t currentHue = effects.osci[2];
 
-    effects.leds[effects.XY16(MATRIX_WIDTH / 2, MATRIX_HEIGHT / 2)] += effects.ColorFromCurrentPalette(currentHue); // 중앙점 (15,15 대신)
+    effects.leds[effects.XY16(effects.width / 2, effects.height / 2)] += effects.ColorFromCurrentPalette(currentHue); // 중앙점 (15,15 대신)
 
     // Noise
     effects.noise_x += 1000;
@@ -171,7 +168,6 @@ public:
     // effects.MoveFractionalNoiseY();
 
     // patternNoiseSmearingHue++;
-    effects.ShowFrame();
     return 0;
   }
 };
@@ -185,8 +181,8 @@ public:
   unsigned int drawFrame() {
     effects.DimAll(235);
 
-    for (uint8_t i = 3; i < MATRIX_WIDTH; i = i + 4) { // 32 대신 MATRIX_WIDTH
-      effects.leds[effects.XY16(i, MATRIX_HEIGHT -1)] += effects.ColorFromCurrentPalette(i * 8); // 31 대신 MATRIX_HEIGHT -1
+    for (uint16_t i = 3; i < effects.width; i = i + 4) { // 32 대신 effects.width
+      effects.leds[effects.XY16(i, effects.height -1)] += effects.ColorFromCurrentPalette(i * 8); // 31 대신 effects.height -1
     }
 
     // Noise
@@ -202,7 +198,6 @@ public:
 
     effects.MoveY(4);
     // effects.MoveFractionalNoiseX(4);
-    effects.ShowFrame();
     return 0;
   }
 };
@@ -217,8 +212,8 @@ public:
     effects.DimAll(230);
 
     // draw grid of rainbow dots on top of the dimmed image
-    for (uint8_t y = 1; y < MATRIX_HEIGHT; y = y + 6) { // 32 대신 MATRIX_HEIGHT
-      for (uint8_t x = 1; x < MATRIX_WIDTH; x = x + 6) { // 32 대신 MATRIX_WIDTH
+    for (uint16_t y = 1; y < effects.height; y = y + 6) { // 32 대신 effects.height
+      for (uint16_t x = 1; x < effects.width; x = x + 6) { // 32 대신 effects.width
         effects.leds[effects.XY16(x, y)] += effects.ColorFromCurrentPalette((x * y) / 4);
       }
     }
@@ -236,12 +231,14 @@ public:
 
     effects.MoveY(3);
     // effects.MoveFractionalNoiseY(4);
-    effects.ShowFrame();
     return 0;
   }
 };
 
 class PatternPaletteSmear : public Drawable {
+private:
+  uint8_t time_offset = 0; // For base hue animation
+
 public:
   PatternPaletteSmear() {
     name = (char *)"PaletteSmear";
@@ -253,38 +250,41 @@ public:
     // effects.ClearFrame(); // 필요하다면 effects.leds 버퍼를 여기서 초기화
   }
 
-  unsigned int drawFrame() {
-    static uint8_t time_offset = 0; // For base hue animation
+  // rows [y0, y1) of step 3 below, called on both cores by rowJobs
+  void renderRows(int y0, int y1) {
+    for (uint16_t y = y0; y < y1; y++) {
+      for (uint16_t x = 0; x < effects.width; x++) { // VPANEL_W -> effects.width
+        // Base hue from x-coordinate and time_offset
+        uint8_t base_hue = ( (uint16_t)x * 128 / (effects.width - 1) + time_offset) % 255; // Max 128 from x to leave room for noise
+        
+        // Modulate hue with noise at (x, y) (0-255)
+        uint8_t hue_perturbation = effects.noise[effects.XY16(x, y)] / 2; // Noise contributes up to 127 to hue
+        uint8_t final_hue = (base_hue + hue_perturbation) % 255;
+        
+        // Y-axis brightness variation: dimmer at top (y=0), brighter at bottom
+        uint8_t paint_brightness = map(y, 0, effects.height - 1, 40, 240); // Ensure a visible gradient
+
+        CRGB new_paint = effects.ColorFromCurrentPalette(final_hue, paint_brightness);
+        effects.leds[effects.XY16(x, y)] = new_paint; // Use assignment '='
+      }
+    }
+  }
 
+  unsigned int drawFrame() {
     // 1. Update noise field - this should make the pattern irregular
     effects.noise_x += 700; // Adjust speed of noise evolution
     effects.noise_y += 700;
     // effects.noise_z += 700; // if using 3D noise for more variation
     effects.noise_scale_x = 3000; // Adjust scale for noise granularity
     effects.noise_scale_y = 3000;
-    effects.FillNoise(); // Populates effects.noise[x][y]
+    effects.FillNoise(); // Populates effects.noise
 
     // 2. Dim the existing buffer to create trails (smearing effect).
     // With direct assignment below, DimAll controls the fade/trail length.
     effects.DimAll(180); // Try a more noticeable dimming for smearing
    
     // 3. Draw the new "paint" layer, modulated by noise, overwriting pixels.
-    for (uint8_t y = 0; y < MATRIX_HEIGHT; y++) { // VPANEL_H -> MATRIX_HEIGHT
-      for (uint8_t x = 0; x < MATRIX_WIDTH; x++) { // VPANEL_W -> MATRIX_WIDTH
-        // Base hue from x-coordinate and time_offset
-        uint8_t base_hue = ( (uint16_t)x * 128 / (MATRIX_WIDTH - 1) + time_offset) % 255; // Max 128 from x to leave room for noise
-        
-        // Modulate hue with noise from effects.noise[x][y] (0-255)
-        uint8_t hue_perturbation = effects.noise[x][y] / 2; // Noise contributes up to 127 to hue
-        uint8_t final_hue = (base_hue + hue_perturbation) % 255;
-        
-        // Y-axis brightness variation: dimmer at top (y=0), brighter at bottom
-        uint8_t paint_brightness = map(y, 0, MATRIX_HEIGHT - 1, 40, 240); // Ensure a visible gradient
-
-        CRGB new_paint = effects.ColorFromCurrentPalette(final_hue, paint_brightness);
-        effects.leds[effects.XY16(x, y)] = new_paint; // Use assignment '='
-      }
-    }
+    rowJobs.render(*this, effects.height);
     time_offset += 1; // Slower base hue shift to let noise be more visible
   
     // 4. Shift the entire buffer for the "smearing" movement.
@@ -294,9 +294,6 @@ public:
     effects.MoveX(1 - MATRIX_X_OFFSET); // If MATRIX_X_OFFSET = 1, this becomes MoveX(0)
     effects.MoveY(1); // Assuming Y offset consistency is not an issue or MATRIX_Y_OFFSET is 0
 
-    // 5. Show the frame.
-    effects.ShowFrame();
-
     return 0; // Rely on ANIMATION_FPS for frame rate control
   }
 };
@@ -320,20 +317,20 @@ public:
       CRGB::Indigo // 7번째 색 추가 (선택적)
     };
 
-    uint8_t band_height = MATRIX_HEIGHT / 6; // 각 색상 밴드의 높이
+    uint8_t band_height = effects.height / 6; // 각 색상 밴드의 높이
     if (band_height == 0) band_height = 1; // 최소 높이 1
 
     uint8_t current_y = 0;
 
     for (uint8_t c = 0; c < 6; c++) { // 6가지 기본 무지개 색상
       for (uint8_t j = 0; j < band_height; j++) {
-        if (current_y >= MATRIX_HEIGHT) break;
-        for (uint8_t x = 0; x < MATRIX_WIDTH; x++) { // VPANEL_W -> MATRIX_WIDTH
+        if (current_y >= effects.height) break;
+        for (uint16_t x = 0; x < effects.width; x++) { // VPANEL_W -> effects.width
           effects.leds[effects.XY16(x, current_y)] += rainbow[c];
         }
         current_y++;
       }
-      if (current_y >= MATRIX_HEIGHT) break;
+      if (current_y >= effects.height) break;
     }
 
     // Noise
@@ -348,7 +345,6 @@ public:
 
     effects.MoveY(3);
     // effects.MoveFractionalNoiseX(4);
-    effects.ShowFrame();
     return 0;
   }
 };
@@ -39,7 +39,7 @@
 #define WAVE_BPM 25
 #define AMP_BPM 2
 #define SKEW_BPM 4
-#define WAVE_TIMEMINSKEW VPANEL_W/8
+#define WAVE_TIMEMINSKEW effects.width/8
 #define WAVE_TIMEMAXSKEW effects.getCenterX()
 
 class PatternPendulumWave : public Drawable {
@@ -52,16 +52,15 @@ class PatternPendulumWave : public Drawable {
     {
       effects.DimAll(192);
 
-      for (int x = 0; x < VPANEL_W; ++x)
+      for (int x = 0; x < effects.width; ++x)
       {
-        uint16_t amp = beatsin16(AMP_BPM, VPANEL_H/8, VPANEL_H-1);
-        uint16_t offset = (VPANEL_H - beatsin16(AMP_BPM, 0, VPANEL_H))/2;
+        uint16_t amp = beatsin16(AMP_BPM, effects.height/8, effects.height-1);
+        uint16_t offset = (effects.height - beatsin16(AMP_BPM, 0, effects.height))/2;
 
         uint8_t y = beatsin16(WAVE_BPM, 0, amp, x*beatsin16(SKEW_BPM, WAVE_TIMEMINSKEW, WAVE_TIMEMAXSKEW)) + offset;
 
         effects.leds[effects.XY16(x,y)] = effects.ColorFromCurrentPalette(x * 7); // Use effects.leds for direct CRGB assignment
       }
-      effects.ShowFrame();
       return 20;
     }
 };
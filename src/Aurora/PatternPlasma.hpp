@@ -28,29 +28,50 @@
 
 
 #include "EffectsLayer.hpp"
+#include "Shader.hpp"
 
 class PatternPlasma : public Drawable {
 private:
     int time = 0;
     int cycles = 0;
 
+    struct PlasmaShader {
+        typedef PaletteIndexOutput Output;
+
+        int time;
+        uint8_t wibble;
+        uint8_t cosTime;
+        int y;
+        int16_t rowWave;
+
+        PlasmaShader(int t) : time(t), wibble(sin8(t)), cosTime(cos8(-t)), y(0), rowWave(0) {}
+
+        void beginRow(int row) {
+            y = row;
+            rowWave = cos16(y * (128 - wibble) * 6 + time);
+        }
+
+        uint8_t operator()(int x) const {
+            int16_t v = 0;
+            v += sin16(x * wibble * 6 + time);
+            v += rowWave;
+            v += sin16(y * x * cosTime / 8);
+            return (v >> 8) + 127;
+        }
+    };
+
 public:
     PatternPlasma() {
         name = (char *)"Plasma";
     }
 
+    void start() {
+        // Pure palette indices: a byte per pixel, looked up in the upload
+        effects.setPixelFormat(PIXEL_INDEXED);
+    }
+
     unsigned int drawFrame() {
-        for (int x = 0; x < MATRIX_WIDTH; x++) {
-            for (int y = 0; y < MATRIX_HEIGHT; y++) {
-                int16_t v = 0;
-                uint8_t wibble = sin8(time);
-                v += sin16(x * wibble * 6 + time);
-                v += cos16(y * (128 - wibble) * 6 + time);
-                v += sin16(y * x * cos8(-time) / 8);
-
-                effects.setPixelFromPaletteIndex(x, y, (v >> 8) + 127);
-            }
-        }
+        renderShader(effects, PlasmaShader(time));
 
         time += 1;
         cycles++;
@@ -60,8 +81,6 @@ public:
             cycles = 0;
         }
 
-        effects.ShowFrame();
-
         return 30;
     }
 };
@@ -36,7 +36,7 @@ class PatternRadar : public Drawable {
     }
 
     unsigned int drawFrame() {
-      effects.DimAll(254); effects.ShowFrame();
+      effects.DimAll(254);
 
       for (int offset = 0; offset < effects.getCenterX(); offset++) {
         byte hue = 255 - (offset * 16 + hueoffset);
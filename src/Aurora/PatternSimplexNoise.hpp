@@ -65,16 +65,14 @@ class PatternSimplexNoise : public Drawable {
       effects.noise_y += speed;
       effects.noise_z += speed;
 
-      effects.ShowFrame();
-
       return 30;
     }
 
     // show just one layer
     void ShowNoiseLayer(byte layer, byte colorrepeat, byte colorshift) {
-      for (uint16_t i = 0; i < VPANEL_W; i++) {
-        for (uint16_t j = 0; j < VPANEL_H; j++) {
-          uint8_t pixel = effects.noise[i][j];
+      for (uint16_t j = 0; j < effects.height; j++) {
+        for (uint16_t i = 0; i < effects.width; i++) {
+          uint8_t pixel = effects.noise[effects.XY16(i, j)];
 
           // assign a color depending on the actual palette
           effects.leds[effects.XY16(i, j)] = effects.ColorFromCurrentPalette(colorrepeat * (pixel + colorshift), pixel);
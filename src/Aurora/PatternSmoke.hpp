@@ -0,0 +1,42 @@
+#ifndef PatternSmoke_H
+#define PatternSmoke_H
+
+#include "EffectsLayer.hpp"
+#include "FireSim.hpp"
+
+// FireSim with slow cooling, sparse fuel and a grey-blue heat -> colour table: a smoke plume
+class PatternSmoke : public Drawable {
+  private:
+
+    FireSim smoke;
+
+  public:
+    PatternSmoke() {
+      name = (char *)"Smoke";
+    }
+
+    void start() {
+      smoke.cooling = (192 << 8) / effects.height; // the plume fades out a third of the way up
+      smoke.fuelMax = 200;
+      smoke.gapChance = 128;                // puffs rather than a sheet
+      smoke.setPalette([](uint8_t h) {
+        uint8_t v = h < 85 ? h * 3 : 255; // smoke is thin: most of the field is well under half heat
+        return CRGB(scale8(v, 200), scale8(v, 210), v);
+      });
+      if (!smoke.begin(effects.width, effects.height))
+        Serial.println("Smoke: not enough memory for the heat field");
+      effects.ClearFrame();
+    }
+
+    void stop() {
+      smoke.end();
+    }
+
+    unsigned int drawFrame() {
+      smoke.step(effects);
+
+      return 33; // smoke rises slower than flames
+    }
+};
+
+#endif
@@ -138,8 +138,6 @@ public:
             snake->move();
             snake->draw(colors);
         }
-        
-        effects.ShowFrame();
 
         return 30;
     }
@@ -21,83 +21,80 @@
 */
 
 #ifndef PatternSpin_H
+#define PatternSpin_H
 
+#include "EffectsLayer.hpp"
+#include "FixedMath.hpp"
 
-
+// Degrees, speeds and the circle are Q16.16 (FixedMath.hpp)
 class PatternSpin : public Drawable {
 public:
     PatternSpin() {
         name = (char *)"Spin";
     }
 
-    float degrees = 0;
-    float radius = 16;
+    fix16_t degrees = 0;
+    fix16_t radius = fixFromInt(16);
 
-    float speedStart = 1;
-    float velocityStart = 0.6;
+    fix16_t speedStart = fixFromInt(1);
+    fix16_t velocityStart = fixFromFloat(0.6);
 
-    float maxSpeed = 30;
+    fix16_t maxSpeed = fixFromInt(30);
 
-    float speed = speedStart;
-    float velocity = velocityStart;
+    fix16_t speed = speedStart;
+    fix16_t velocity = velocityStart;
 
     void start() {
         speed = speedStart;
         velocity = velocityStart;
         degrees = 0;
+        // Palette colours on black, never faded: RGB565 from paletteLut565, 2 bytes per pixel
+        effects.setPixelFormat(PIXEL_RGB565);
     }
 
     unsigned int drawFrame() {
-        
 
-        CRGB color = effects.ColorFromCurrentPalette(speed * 8);
 
-        // start position
-        int x;
-        int y;
+        uint16_t color = effects.ColorFromCurrentPalette565(fixFloor(speed * 8));
 
-        // target position
-        float targetDegrees = degrees + speed;
-        float targetRadians = radians(targetDegrees);
-        int targetX = (int) (effects.getCenterX() + radius * cos(targetRadians));
-        int targetY = (int) (effects.getCenterY() - radius * sin(targetRadians));
+        const fix16_t centerX = fixFromInt(effects.getCenterX());
+        const fix16_t centerY = fixFromInt(effects.getCenterY());
 
-        float tempDegrees = degrees;
+        fix16_t tempDegrees = degrees;
 
         for (int i =0; i < 16; i++)
         {
-            float radians = radians(tempDegrees);
-            x = (int) (effects.getCenterX() + radius * cos(radians));
-            y = (int) (effects.getCenterY() - radius * sin(radians));
+            // Q16.16 degrees / 360 is the binary angle
+            fixangle_t angle = (uint32_t)tempDegrees / 360;
+            int x = fixFloor(centerX + fixMul(radius, fixCos(angle)));
+            int y = fixFloor(centerY - fixMul(radius, fixSin(angle)));
 
-            effects.setPixel(x, y, color);
-            effects.setPixel(y, x, color);
+            effects.setPixel565(x, y, color);
+            effects.setPixel565(y, x, color);
 
-            tempDegrees += 1;
-            if (tempDegrees >= 360)
+            tempDegrees += FIX16_ONE;
+            if (tempDegrees >= fixFromInt(360))
                 tempDegrees = 0;
-                
-        } 
-        
+
+        }
+
 
         degrees += speed;
 
         // add velocity to the particle each pass around the accelerator
-        if (degrees >= 360) {
+        if (degrees >= fixFromInt(360)) {
             degrees = 0;
             speed += velocity;
             if (speed <= speedStart) {
                 speed = speedStart;
-                velocity *= -1;
+                velocity = -velocity;
             }
             else if (speed > maxSpeed){
                 speed = maxSpeed - velocity;
-                velocity *= -1;
+                velocity = -velocity;
             }
         }
 
-        effects.ShowFrame();
-
         return 0;
     }
 };
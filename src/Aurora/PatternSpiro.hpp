@@ -31,8 +31,8 @@ class PatternSpiro : public Drawable {
     byte hueoffset = 0;
 
     // 크기를 줄이기 위해 반지름 값을 VPANEL_W/6, VPANEL_H/6으로 변경
-    uint8_t radiusx = VPANEL_W / 6; 
-    uint8_t radiusy = VPANEL_H / 6;
+    uint8_t radiusx = effects.width / 6; 
+    uint8_t radiusy = effects.height / 6;
     uint8_t minx = effects.getCenterX() - radiusx;
     uint8_t maxx = effects.getCenterX() + radiusx + 1;
     uint8_t miny = effects.getCenterY() - radiusy;
@@ -58,9 +58,7 @@ class PatternSpiro : public Drawable {
     };
 
     unsigned int drawFrame() {
-      //blur2d(effects.leds, VPANEL_W > 255 ? 255 : VPANEL_W, VPANEL_H > 255 ? 255 : VPANEL_H, 64);
-      fl::XYMap matrix_map(effects.width, effects.height, false);
-      fl::blur2d(effects.leds, (uint8_t)effects.width, (uint8_t)effects.height, 64, matrix_map);
+      effects.blur(64);
       boolean change = false;
       
       for (int i = 0; i < spirocount; i++) {
@@ -107,7 +105,7 @@ class PatternSpiro : public Drawable {
         if (change && !handledChange) {
           handledChange = true;
           
-          if (spirocount >= VPANEL_W || spirocount == 1) spiroincrement = !spiroincrement;
+          if (spirocount >= effects.width || spirocount == 1) spiroincrement = !spiroincrement;
 
           if (spiroincrement) {
             if(spirocount >= 4)
@@ -133,7 +131,6 @@ class PatternSpiro : public Drawable {
         hueoffset += 1;
       }
 
-      effects.ShowFrame();
       return 0;
     }
 };
@@ -2,131 +2,84 @@
 #define PatternStarfield_H
 
 #include "EffectsLayer.hpp"
+#include "ParticleSystem.hpp"
 
-struct Star
-{
-    Star() {
-        x = y = z = 0;
-        colour = CRGB::White;
-    }
-
-    float x;
-    float y;
-    float z;
-    CRGB colour;    
-};
+#define STARFIELD_STARS 100   // number of stars in the star field
+#define STARFIELD_SPREAD 25   // stars start within +-STARFIELD_SPREAD of the line of sight
+#define STARFIELD_LIFE 254    // frames a star takes to fly from maxDepth to the viewer
 
 
 // Based on https://github.com/sinoia/oled-starfield/blob/master/src/starfield.cpp
+//
+// The stars live in a particle pool: a star's age is its depth (z = maxDepth at
+// birth, 0 when it reaches the viewer), its screen position is projected from the
+// world x / y kept next to the pool, and the pool kills it once it leaves the screen.
 class PatternStarfield : public Drawable {
 
   private:
 
-    const int starCount = 100; // number of stars in the star field
-    const int maxDepth  = 32;   // maximum distance away for a star
-
-    // the star field - starCount stars represented as x, y and z co-ordinates
-    // https://www.cplusplus.com/doc/tutorial/dynamic/
-    Star * stars;
-    //CRGBPalette16 currentPalette;
+    ParticlePool<STARFIELD_STARS> stars;
+    int8_t starX[STARFIELD_STARS];   // world co-ordinates, same slots as the pool
+    int8_t starY[STARFIELD_STARS];
 
     unsigned int drawFrame() { // aka drawStars
 
         // Dim routine
-        
-		for (int16_t i = 0; i < VPANEL_W; i++) {
-			for (int16_t j = 0; j < VPANEL_H; j++) {
-
-                    uint16_t xy = effects.XY16(i, j);
-                    effects.leds[xy].nscale8(250);
-			}
-		}        
-
-        int origin_x = VPANEL_W / 2;
-        int origin_y = VPANEL_H / 2;
-
-        // Iterate through the stars reducing the z co-ordinate in order to move the
-        // star closer.
-        for (int i = 0; i < starCount; ++i) {
-            stars[i].z -= 0.1;
-            // if the star has moved past the screen (z < 0) reposition it far away
-            // with random x and y positions.
-            if (stars[i].z <= 0) 
-            {
-                stars[i].x = getRandom(-25, 25);
-                stars[i].y = getRandom(-25, 25);
-                stars[i].z = maxDepth;                
-            }
-
-            // Convert the 3D coordinates to 2D using perspective projection.
-            float k = VPANEL_W / stars[i].z;
-            int x = static_cast<int>(stars[i].x * k + origin_x);
-            int y = static_cast<int>(stars[i].y * k + origin_y);
-
-            //  Draw the star (if it is visible in the screen).
-            // Distant stars are smaller than closer stars.
-            if ((0 <= x and x < VPANEL_H) 
-                and (0 <= y and y < VPANEL_H)) {
-
-                CRGB tmp = stars[i].colour;
-                //CRGB tmp = CRGB::White;
-                byte scale = 255 -(stars[i].z*7);
-                tmp.nscale8(scale);
-
-                effects.setPixel(x,y, CRGB(tmp.r,tmp.g,tmp.b));
-            }
-            else
-            {
-                stars[i].z = -1; // set to -1 so it gets re-popualted
-            }
-        }
-
-        effects.ShowFrame();        
+        effects.scaleAll(250);
+
+        // Replace the stars that have moved past the screen with new ones far away
+        while (!stars.full())
+            spawnStar(0);
+
+        // Perspective projection, z = maxDepth * (1 - age / life) with maxDepth = 32
+        const pfix_t originX = toPfix(effects.width / 2);
+        const pfix_t originY = toPfix(effects.height / 2);
+        const int32_t k = (int32_t)effects.width * PFIX_ONE * 8;
+        stars.forEachAlive([&](uint16_t i) {
+            int32_t depth = 256 - stars.age[i];
+            stars.x[i] = originX + starX[i] * k / depth;
+            stars.y[i] = originY + starY[i] * k / depth;
+        });
+
+        // Age the stars, drop the ones off screen, draw the rest brighter as they come closer
+        stars.update(effects);
+        stars.draw(effects);
 
         return 5;
-    }  
-    
-    int getRandom(int lower, int upper) {
-        /* Generate and return a  random number between lower and upper bound */
-        return lower + static_cast<int>(rand() % (upper - lower + 1));
     }
 
-/*
-    CRGB ColorFromCurrentPalette(uint8_t index = 0, uint8_t brightness = 255, TBlendType blendType = LINEARBLEND) {
-      return ColorFromPalette(currentPalette, index, brightness, blendType);
+    void spawnStar(uint8_t age) {
+        int i = stars.spawn(0, 0, 0, 0, STARFIELD_LIFE, effects.ColorFromCurrentPalette(random8(128)));
+        if (i < 0) return;
+        starX[i] = getRandom(-STARFIELD_SPREAD, STARFIELD_SPREAD);
+        starY[i] = getRandom(-STARFIELD_SPREAD, STARFIELD_SPREAD);
+        stars.age[i] = age;
+    }
+
+    int getRandom(int lower, int upper) {
+        /* Generate and return a  random number between lower and upper bound */
+        return lower + random16(upper - lower + 1);
     }
-*/    
 
   public:
-    PatternStarfield() 
+    PatternStarfield()
     {
         name = (char *)"PatternStarfield";
+
+        stars.edge = PARTICLE_EDGE_KILL;
+        stars.drawFlags = PARTICLE_DRAW_FADE_IN;
     }
-    
+
     void start() {
-   
-        //currentPalette = RainbowColors_p;
-        //currentPalette = CloudColors_p;
-
-        // Allocate memory
-        stars = new Star[starCount];
-
-        // Initialise the star field with random stars
-        for (int i = 0; i < starCount; i++) {
-            stars[i].x = getRandom(-25, 25);
-            stars[i].y = getRandom(-25, 25);
-            stars[i].z = getRandom(0, maxDepth);
-            //stars[i].colour = ColorFromCurrentPalette(random(0, 128));
-            stars[i].colour = effects.ColorFromCurrentPalette(random(0, 128));
-        }
+        // Initialise the star field with random stars at random depths
+        stars.clear();
+        for (int i = 0; i < STARFIELD_STARS; i++)
+            spawnStar(random8(STARFIELD_LIFE));
     } // end start
 
     void stop() {
-        delete[] stars;       
     }
 
-
-
 };
 
 #endif
@@ -2,6 +2,8 @@
 #ifndef PatternTest_H
 #define PatternTest_H
 
+#include "EffectsLayer.hpp"
+
 class PatternTest : public Drawable {
   private:
 
@@ -12,7 +14,7 @@ class PatternTest : public Drawable {
 
     unsigned int drawFrame() {
 
-       matrix->fillScreen(matrix->color565(128, 0, 0));  
+      fill_solid(effects.leds, effects.num_leds, CRGB(128, 0, 0));
       return 1000;
     }
 };
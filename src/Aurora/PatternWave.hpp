@@ -37,13 +37,22 @@ private:
 
     byte rotation = 0;
 
-    uint8_t scale = 256 / VPANEL_W;
+    uint8_t scaleX = 256 / effects.width;  // quadwave8 -> column (waves along y)
+    uint8_t scaleY = 256 / effects.height; // quadwave8 -> row (waves along x)
 
-    uint8_t maxX = VPANEL_W - 1;
-    uint8_t maxY = VPANEL_H - 1;
+    uint16_t maxX = effects.width - 1;
+    uint16_t maxY = effects.height - 1;
 
     uint8_t waveCount = 1;
 
+    // The trail fade runs first, over the previous frame (DimAll() is a linear SWAR pass),
+    // and the wave is drawn after it with colours faded the same way: the same frame as
+    // drawing the wave, then DimAll(220).
+    CRGB fadedColor(uint8_t index) {
+        CRGB c = effects.ColorFromCurrentPalette(index);
+        return c.nscale8(220);
+    }
+
 public:
     PatternWave() {
         name = (char *)"Wave";
@@ -58,46 +67,46 @@ public:
     unsigned int drawFrame() {
         int n = 0;
 
+        effects.DimAll(220);
+
         switch (rotation) {
             case 0:
-                for (int x = 0; x < VPANEL_W; x++) {
-                    n = quadwave8(x * 2 + theta) / scale;
-                    effects.leds[effects.XY16(x,n)] = effects.ColorFromCurrentPalette(x + hue);
+                for (int x = 0; x < effects.width; x++) {
+                    n = quadwave8(x * 2 + theta) / scaleY;
+                    effects.leds[effects.XY16(x,n)] = fadedColor(x + hue);
                     if (waveCount == 2)
-                        effects.leds[effects.XY16(x,maxY - n)] = effects.ColorFromCurrentPalette(x + hue);
+                        effects.leds[effects.XY16(x,maxY - n)] = fadedColor(x + hue);
                 }
                 break;
 
             case 1:
-                for (int y = 0; y < VPANEL_H; y++) {
-                    n = quadwave8(y * 2 + theta) / scale;
-                    effects.leds[effects.XY16(n,y)] = effects.ColorFromCurrentPalette(y + hue);
+                for (int y = 0; y < effects.height; y++) {
+                    n = quadwave8(y * 2 + theta) / scaleX;
+                    effects.leds[effects.XY16(n,y)] = fadedColor(y + hue);
                     if (waveCount == 2)
-                        effects.leds[effects.XY16(maxX - n,y)] = effects.ColorFromCurrentPalette(y + hue);
+                        effects.leds[effects.XY16(maxX - n,y)] = fadedColor(y + hue);
                 }
                 break;
 
             case 2:
-                for (int x = 0; x < VPANEL_W; x++) {
-                    n = quadwave8(x * 2 - theta) / scale;
-                    effects.leds[effects.XY16(x,n)] = effects.ColorFromCurrentPalette(x + hue);
+                for (int x = 0; x < effects.width; x++) {
+                    n = quadwave8(x * 2 - theta) / scaleY;
+                    effects.leds[effects.XY16(x,n)] = fadedColor(x + hue);
                     if (waveCount == 2)
-                        effects.leds[effects.XY16(x,maxY - n)] = effects.ColorFromCurrentPalette(x + hue);
+                        effects.leds[effects.XY16(x,maxY - n)] = fadedColor(x + hue);
                 }
                 break;
 
             case 3:
-                for (int y = 0; y < VPANEL_H; y++) {
-                    n = quadwave8(y * 2 - theta) / scale;
-                    effects.leds[effects.XY16(n,y)] = effects.ColorFromCurrentPalette(y + hue);
+                for (int y = 0; y < effects.height; y++) {
+                    n = quadwave8(y * 2 - theta) / scaleX;
+                    effects.leds[effects.XY16(n,y)] = fadedColor(y + hue);
                     if (waveCount == 2)
-                        effects.leds[effects.XY16(maxX - n,y)] = effects.ColorFromCurrentPalette(y + hue);
+                        effects.leds[effects.XY16(maxX - n,y)] = fadedColor(y + hue);
                 }
                 break;
         }
 
-        effects.DimAll(220);
-
 
         if (thetaUpdate >= thetaUpdateFrequency) {
             thetaUpdate = 0;
@@ -115,8 +124,6 @@ public:
             hueUpdate++;
         }
 
-		effects.ShowFrame();        
-
         return 0;
     }
 };
@@ -0,0 +1,95 @@
+/*
+ * Per-pixel shader framework for EffectsLayer
+ *
+ * Patterns that compute every pixel from (x, y) and a few per-frame values used to
+ * hand-write for x / for y loops over setPixel() / setPixelFromPaletteIndex(), each
+ * call with its own bounds check and XY16() multiply. renderShader() instead walks
+ * effects.leds row by row through a raw row pointer, calls Shader::beginRow(y) once
+ * per row so row invariants are computed once, and calls the shader for each x.
+ *
+ * A shader is a small struct:
+ *
+ *   struct MyShader {
+ *     typedef PaletteIndexOutput Output;  // or RGBOutput / UpdateOutput
+ *     void beginRow(int y);               // per-row invariants
+ *     uint8_t operator()(int x);          // PaletteIndexOutput: index into the current palette
+ *     // CRGB operator()(int x);           // RGBOutput: the colour itself
+ *     // void operator()(int x, CRGB &px); // UpdateOutput: read-modify-write of the previous frame
+ *   };
+ *
+ * The Output tag picks the row loop at compile time, so an index shader gets the
+ * palette lookup inlined (one load from effects.paletteLut) and an RGB shader has
+ * none at all. On a PIXEL_INDEXED canvas an index shader stores the index itself
+ * and the lookup moves to the upload.
+ *
+ * Rows are split into bands and rendered on both cores (rowJobs). Every band works
+ * on its own copy of the shader, so beginRow() may keep row state in members; keep
+ * shaders small and point to anything large (tables, the pattern) instead.
+ */
+
+#ifndef Shader_H
+#define Shader_H
+
+#include <type_traits>
+#include "EffectsLayer.hpp"
+
+// Shader output tags
+struct PaletteIndexOutput {};
+struct RGBOutput {};
+struct UpdateOutput {};
+
+namespace shader_detail {
+
+template <class Shader>
+inline void shadeRow(EffectsLayer &fx, Shader &s, int y, PaletteIndexOutput) {
+  if (fx.pixelFormat == PIXEL_INDEXED) {
+    uint8_t *row = fx.frameIndexed() + y * fx.width;
+    for (int x = 0; x < fx.width; x++)
+      row[x] = s(x);
+    return;
+  }
+
+  CRGB *row = fx.leds + y * fx.width;
+  const CRGB *palette = fx.paletteLut;
+  for (int x = 0; x < fx.width; x++)
+    row[x] = palette[s(x)];
+}
+
+template <class Shader>
+inline void shadeRow(EffectsLayer &fx, Shader &s, int y, RGBOutput) {
+  CRGB *row = fx.leds + y * fx.width;
+  for (int x = 0; x < fx.width; x++)
+    row[x] = s(x);
+}
+
+template <class Shader>
+inline void shadeRow(EffectsLayer &fx, Shader &s, int y, UpdateOutput) {
+  CRGB *row = fx.leds + y * fx.width;
+  for (int x = 0; x < fx.width; x++)
+    s(x, row[x]);
+}
+
+} // namespace shader_detail
+
+// Shade rows [y0, y1) with this copy of the shader
+template <class Shader>
+inline void renderShaderRows(EffectsLayer &fx, Shader &s, int y0, int y1) {
+  for (int y = y0; y < y1; y++) {
+    s.beginRow(y);
+    shader_detail::shadeRow(fx, s, y, typename Shader::Output());
+  }
+}
+
+// Shade the whole frame, on both cores
+template <class Shader>
+inline void renderShader(EffectsLayer &fx, Shader &&shader) {
+  typedef typename std::decay<Shader>::type ShaderType;
+  const ShaderType &proto = shader;
+  auto band = [&fx, &proto](int y0, int y1) {
+    ShaderType local(proto);
+    renderShaderRows(fx, local, y0, y1);
+  };
+  rowJobs.forEachBand(fx.height, band);
+}
+
+#endif
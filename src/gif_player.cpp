@@ -10,6 +10,8 @@ GifPlayer::GifPlayer() {
     m_utils = nullptr;
     m_matrix = nullptr;
     pFrameBuffer = nullptr;
+    fbWidth = 0;
+    fbHeight = 0;
     currentSource = GIF_BUILTIN;
     gifBackgroundIndex = 0;
     currentFileIndex = 0;
@@ -26,7 +28,7 @@ GifPlayer::~GifPlayer() {
     end();
 }
 
-bool GifPlayer::begin(Utils* utils, MatrixPanel_I2S_DMA* matrix) {
+bool GifPlayer::begin(Utils* utils, MatrixDisplay* matrix) {
     // Serial.println("Initializing GIF Player...");  // DEBUG
     
     m_utils = utils;
@@ -44,7 +46,9 @@ bool GifPlayer::begin(Utils* utils, MatrixPanel_I2S_DMA* matrix) {
     }
 
     // Allocate frame buffer - attempt to use PSRAM first
-    size_t bufferSize = m_matrix->width() * m_matrix->height();
+    fbWidth = m_matrix->width();
+    fbHeight = m_matrix->height();
+    size_t bufferSize = fbWidth * fbHeight;
     
     // ESP32 with PSRAM support for larger frame buffers
     #ifdef ESP32
@@ -213,12 +217,12 @@ void GifPlayer::renderFrameToMatrix() {
             // Render only non-background pixels (core rendering logic)
             if (pixelIndex != gifBackgroundIndex) {
                 uint16_t color = currentPalette[pixelIndex];
-                m_matrix->drawPixel(setPhysicalX(x), y, color);
+                m_matrix->drawPixel(x, y, color);
                 renderedPixels++;
                 
                 // Debug output for first few pixels (disabled in production)
                 // if (shouldDebug && renderedPixels <= 3) {
-                //     Serial.printf("DEBUG: Pixel (%d,%d) index:%d color:0x%04X\n", (x + 1) % MATRIX_WIDTH,
+                //     Serial.printf("DEBUG: Pixel (%d,%d) index:%d color:0x%04X\n", x,
                 //                   y, pixelIndex, color);
                 // }
             }
@@ -304,7 +308,6 @@ bool GifPlayer::play() {
     // Serial.println("DEBUG: Clearing matrix buffers...");
     m_matrix->fillScreen(0);
     m_utils->displayShow(); 
-    delay(50);
     
     // Initialize frame buffer and palette safely
     memset(pFrameBuffer, 0, m_matrix->width() * m_matrix->height());
@@ -392,8 +395,7 @@ bool GifPlayer::play() {
         if (!verifyFirstFrameRender()) {
             Serial.println("WARNING: First frame rendering verification failed");
         }
-        m_utils->displayShow(); // Display the rendered frame
-        delay(50); // Short delay after displaying the frame
+        m_utils->displayShow(); // Display the rendered frame (returns once the flip is scanned out)
 
         return true; // Playback initiated successfully (either animated or static)
     }
@@ -575,7 +577,6 @@ void GifPlayer::update() {
         //     Serial.println("DEBUG: renderFrameToMatrix - Copying frame to matrix."); 
         // }
         
-        delay(10);
         m_utils->displayShow(); 
     } else if (result < 0) { 
         Serial.printf("ERROR: GIF playback error: result=%d, lastError=%d\n", result, gif.getLastError());
@@ -592,7 +593,7 @@ void GifPlayer::update() {
 void GifPlayer::debugFrameBuffer() {
     #ifdef DEBUG_GIF_PLAYER
     Serial.println("DEBUG: Frame buffer contents:");
-    for (int i = 0; i < 10 && i < MATRIX_WIDTH * MATRIX_HEIGHT; i++) {
+    for (int i = 0; i < 10 && i < fbWidth * fbHeight; i++) {
         Serial.printf("  [%d] = %02X\n", i, pFrameBuffer[i]);
     }
     #endif
@@ -615,7 +616,7 @@ void GifPlayer::debugPalette() {
 
 bool GifPlayer::verifyFirstFrameRender() {
     int nonZeroPixels = 0;
-    for (int i = 0; i < MATRIX_WIDTH * MATRIX_HEIGHT; i++) {
+    for (int i = 0; i < fbWidth * fbHeight; i++) {
         if (pFrameBuffer[i] != 0) {
             nonZeroPixels++;
         }
@@ -686,7 +687,7 @@ void IRAM_ATTR GifPlayer::GIFDraw(GIFDRAW *pDraw) {
     // This prevents duplicate object rendering that causes visual artifacts
     if (s_instance->currentSource == GIF_FILE && 
         pDraw->iX == 0 && pDraw->iY == 0 && 
-        pDraw->iWidth == MATRIX_WIDTH && pDraw->ucHasTransparency == 0) {
+        pDraw->iWidth == s_instance->fbWidth && pDraw->ucHasTransparency == 0) {
         // Skip rendering background layer to avoid duplication
         return;
     }
@@ -698,14 +699,16 @@ void IRAM_ATTR GifPlayer::GIFDraw(GIFDRAW *pDraw) {
     int actualY, drawWidth, drawHeight;
 
     // Clamp drawing dimensions to matrix bounds
-    drawWidth = (pDraw->iWidth > MATRIX_WIDTH) ? MATRIX_WIDTH : pDraw->iWidth;
-    drawHeight = (pDraw->iHeight > MATRIX_HEIGHT) ? MATRIX_HEIGHT : pDraw->iHeight;
+    const int fbWidth = s_instance->fbWidth;
+    const int fbHeight = s_instance->fbHeight;
+    drawWidth = (pDraw->iWidth > fbWidth) ? fbWidth : pDraw->iWidth;
+    drawHeight = (pDraw->iHeight > fbHeight) ? fbHeight : pDraw->iHeight;
 
     // Calculate absolute Y coordinate in frame buffer
     actualY = pDraw->iY + pDraw->y;
     
     // Skip if drawing outside matrix bounds
-    if (actualY < 0 || actualY >= MATRIX_HEIGHT) {
+    if (actualY < 0 || actualY >= fbHeight) {
         return;
     }
     
@@ -725,14 +728,14 @@ void IRAM_ATTR GifPlayer::GIFDraw(GIFDRAW *pDraw) {
     
     // Calculate frame buffer position with correct X offset
     sourcePixels = pDraw->pPixels;
-    destBuffer = s_instance->pFrameBuffer + actualY * MATRIX_WIDTH + pDraw->iX;
+    destBuffer = s_instance->pFrameBuffer + actualY * fbWidth + pDraw->iX;
     
     // Copy pixels with bounds checking and transparency handling
     for (int i = 0; i < drawWidth; i++) {
         int bufferX = pDraw->iX + i;
         
         // Only write within matrix width bounds
-        if (bufferX < MATRIX_WIDTH) {
+        if (bufferX < fbWidth) {
             uint8_t pixelIndex = *sourcePixels++;
             // Write non-transparent pixels to frame buffer
             // Restore original logic: write pixel if it's for a static image OR if it's not background/transparent for animated GIFs
@@ -800,10 +803,10 @@ void GifPlayer::debugFrameBufferState(const char* context) {
     Serial.printf("DEBUG: Background index: %d\n", gifBackgroundIndex);
     
     // Check data from first two rows (for x=0, x=1 comparison)
-    for (int y = 0; y < 2 && y < MATRIX_HEIGHT; y++) {
+    for (int y = 0; y < 2 && y < fbHeight; y++) {
         Serial.printf("DEBUG: Row %d: ", y);
-        for (int x = 0; x < 10 && x < MATRIX_WIDTH; x++) {
-            int bufferIndex = y * MATRIX_WIDTH + x;
+        for (int x = 0; x < 10 && x < fbWidth; x++) {
+            int bufferIndex = y * fbWidth + x;
             Serial.printf("[%d:%02X] ", x, pFrameBuffer[bufferIndex]);
         }
         Serial.println();
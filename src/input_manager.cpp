@@ -0,0 +1,273 @@
+/**
+ * @file input_manager.cpp
+ * @brief Implementation of the interrupt-driven, merged input event stream
+ *
+ * @doc Button edges are captured by GPIO CHANGE interrupts and stored with a
+ * micros() timestamp. update() replays those edges in order through a per-button
+ * debounce state machine: a level change is only accepted once no further edge
+ * has arrived for BUTTON_DEBOUNCE_MS. The accepted event is stamped with the
+ * FIRST edge of the bounce burst, so the measured latency covers the debounce
+ * window as well as any time the main loop spent blocked.
+ */
+
+#include "input_manager.h"
+#include <hal/gpio_ll.h>   // IRAM-safe pin level read inside the ISR
+
+InputManager* InputManager::s_instance = nullptr;
+portMUX_TYPE InputManager::s_edgeMux = portMUX_INITIALIZER_UNLOCKED;
+
+static const uint32_t DEBOUNCE_US = BUTTON_DEBOUNCE_MS * 1000UL;
+static const uint32_t LONG_PRESS_US = BUTTON_LONG_PRESS_MS * 1000UL;
+static const uint32_t REPEAT_US = BUTTON_REPEAT_MS * 1000UL;
+
+static const char* const SOURCE_NAMES[] = { "BUTTON", "IR", "MQTT" };
+
+// CONSTRUCTOR AND INITIALIZATION
+// ============================================================================
+
+InputManager::InputManager() : edgeHead(0), edgeTail(0), edgesDropped(0),
+                               eventHead(0), eventTail(0), nextMqttSlot(0), mqttPending(0)
+{
+    memset(buttons, 0, sizeof(buttons));
+    memset(mqttPayloads, 0, sizeof(mqttPayloads));
+    memset(latencyStats, 0, sizeof(latencyStats));
+    buttons[INPUT_BUTTON_UP].pin = BUTTON_UP_PIN;
+    buttons[INPUT_BUTTON_DOWN].pin = BUTTON_DOWN_PIN;
+}
+
+/**
+ * @doc Attach edge interrupts to both navigation buttons.
+ * The current pin level seeds the debounced state so a button held during
+ * boot does not generate a spurious press.
+ */
+void InputManager::setup() {
+    s_instance = this;
+
+    for (uint8_t i = 0; i < INPUT_BUTTON_COUNT; i++) {
+        buttons[i].pressed = (digitalRead(buttons[i].pin) == LOW);
+    }
+
+    attachInterrupt(digitalPinToInterrupt(BUTTON_UP_PIN), onButtonUpEdge, CHANGE);
+    attachInterrupt(digitalPinToInterrupt(BUTTON_DOWN_PIN), onButtonDownEdge, CHANGE);
+
+    Serial.println("InputManager: Button interrupts attached.");
+}
+
+// ISR CONTEXT
+// ============================================================================
+
+void IRAM_ATTR InputManager::onButtonUpEdge() {
+    pushEdge(INPUT_BUTTON_UP, BUTTON_UP_PIN);
+}
+
+void IRAM_ATTR InputManager::onButtonDownEdge() {
+    pushEdge(INPUT_BUTTON_DOWN, BUTTON_DOWN_PIN);
+}
+
+/**
+ * @doc Store one timestamped edge. Runs in interrupt context: no logging,
+ * no allocation. When the ring is full the edge is counted and dropped.
+ */
+void IRAM_ATTR InputManager::pushEdge(uint8_t button, uint8_t pin) {
+    InputManager* self = s_instance;
+    if (!self) return;
+
+    uint32_t now = micros();
+    uint8_t level = (uint8_t)gpio_ll_get_level(&GPIO, (gpio_num_t)pin);
+
+    portENTER_CRITICAL_ISR(&s_edgeMux);
+    uint16_t head = self->edgeHead;
+    uint16_t next = (head + 1) & (INPUT_EDGE_QUEUE_SIZE - 1);
+    if (next != self->edgeTail) {
+        self->edges[head].button = button;
+        self->edges[head].level = level;
+        self->edges[head].timestamp_us = now;
+        self->edgeHead = next;
+    } else {
+        self->edgesDropped++;
+    }
+    portEXIT_CRITICAL_ISR(&s_edgeMux);
+}
+
+// BUTTON STATE MACHINE
+// ============================================================================
+
+/**
+ * @doc Drain the edge ring, settle pending debounces and emit hold events.
+ */
+void InputManager::update() {
+    Edge edge;
+    for (;;) {
+        portENTER_CRITICAL(&s_edgeMux);
+        bool available = (edgeTail != edgeHead);
+        if (available) {
+            edge = edges[edgeTail];
+            edgeTail = (edgeTail + 1) & (INPUT_EDGE_QUEUE_SIZE - 1);
+        }
+        portEXIT_CRITICAL(&s_edgeMux);
+        if (!available) break;
+        processEdge(edge);
+    }
+
+    if (edgesDropped) {
+        portENTER_CRITICAL(&s_edgeMux);
+        latencyStats[(uint8_t)InputSource::BUTTON].dropped += edgesDropped;
+        edgesDropped = 0;
+        portEXIT_CRITICAL(&s_edgeMux);
+    }
+
+    uint32_t now = micros();
+    for (uint8_t i = 0; i < INPUT_BUTTON_COUNT; i++) {
+        ButtonState& st = buttons[i];
+
+        // Last edge has been stable long enough - accept it
+        if (st.candidatePending && (now - st.lastEdge_us) >= DEBOUNCE_US) {
+            commitCandidate(i);
+        }
+
+        // Long press, then auto-repeat while held
+        if (st.pressed && (int32_t)(now - st.nextRepeat_us) >= 0) {
+            pushEvent(InputSource::BUTTON,
+                      st.longPressSent ? InputEventType::REPEAT : InputEventType::LONG_PRESS,
+                      i, st.nextRepeat_us);
+            st.longPressSent = true;
+            st.nextRepeat_us += REPEAT_US;
+            // After a long stall, do not replay every missed repeat
+            if ((int32_t)(now - st.nextRepeat_us) >= 0) st.nextRepeat_us = now + REPEAT_US;
+        }
+    }
+}
+
+/**
+ * @doc Feed one raw edge into the debounce state machine.
+ * Edges are replayed in capture order, so a complete press/release that
+ * happened while the loop was blocked is still recognised.
+ */
+void InputManager::processEdge(const Edge& edge) {
+    ButtonState& st = buttons[edge.button];
+
+    // The previous burst settled before this edge arrived
+    if (st.candidatePending && (edge.timestamp_us - st.lastEdge_us) >= DEBOUNCE_US) {
+        commitCandidate(edge.button);
+    }
+
+    if (!st.candidatePending) {
+        st.candidatePending = true;
+        st.burstStart_us = edge.timestamp_us;
+    }
+    st.candidatePressed = (edge.level == LOW);
+    st.lastEdge_us = edge.timestamp_us;
+}
+
+void InputManager::commitCandidate(uint8_t button) {
+    ButtonState& st = buttons[button];
+    st.candidatePending = false;
+    if (st.candidatePressed == st.pressed) return; // Bounced back to the stable level
+
+    st.pressed = st.candidatePressed;
+    if (st.pressed) {
+        st.pressTime_us = st.burstStart_us;
+        st.nextRepeat_us = st.pressTime_us + LONG_PRESS_US;
+        st.longPressSent = false;
+        pushEvent(InputSource::BUTTON, InputEventType::PRESS, button, st.burstStart_us);
+    } else {
+        // Hold that started and ended while update() was not running
+        if (!st.longPressSent && (st.burstStart_us - st.pressTime_us) >= LONG_PRESS_US) {
+            pushEvent(InputSource::BUTTON, InputEventType::LONG_PRESS, button, st.pressTime_us + LONG_PRESS_US);
+        }
+        pushEvent(InputSource::BUTTON, InputEventType::RELEASE, button, st.burstStart_us);
+    }
+}
+
+// MERGED EVENT QUEUE
+// ============================================================================
+
+bool InputManager::pushEvent(InputSource source, InputEventType type, uint32_t code, uint32_t timestamp_us) {
+    uint8_t next = (eventHead + 1) & (INPUT_EVENT_QUEUE_SIZE - 1);
+    if (next == eventTail) {
+        latencyStats[(uint8_t)source].dropped++;
+        return false;
+    }
+    events[eventHead] = { source, type, code, timestamp_us };
+    eventHead = next;
+    return true;
+}
+
+void InputManager::postIRCommand(uint32_t command, uint32_t timestamp_us) {
+    pushEvent(InputSource::IR, InputEventType::PRESS, command, timestamp_us);
+}
+
+/**
+ * @doc Copy an MQTT payload into the next slot. The slot after the newest queued
+ * payload is free only while fewer than MQTT_SLOTS - 1 payloads are queued: the last
+ * one, if any, still belongs to the event being dispatched. Otherwise the message is
+ * dropped rather than overwriting a payload that has not been read yet.
+ */
+void InputManager::postMqttMessage(const uint8_t* payload, unsigned int length) {
+    uint32_t now = micros();
+    if (length >= INPUT_MQTT_PAYLOAD_SIZE) {
+        Serial.printf("InputManager: MQTT payload truncated (%u bytes)\n", length);
+        length = INPUT_MQTT_PAYLOAD_SIZE - 1;
+    }
+
+    if (mqttPending >= MQTT_SLOTS - 1) {
+        latencyStats[(uint8_t)InputSource::MQTT].dropped++;
+        Serial.println("InputManager: MQTT message dropped, all payload slots pending");
+        return;
+    }
+
+    uint8_t slot = nextMqttSlot;
+    memcpy(mqttPayloads[slot], payload, length);
+    mqttPayloads[slot][length] = '\0';
+
+    if (pushEvent(InputSource::MQTT, InputEventType::PRESS, slot, now)) {
+        nextMqttSlot = (nextMqttSlot + 1) % MQTT_SLOTS;
+        mqttPending++;
+    }
+}
+
+bool InputManager::poll(InputEvent& event) {
+    if (eventTail == eventHead) return false;
+    event = events[eventTail];
+    eventTail = (eventTail + 1) & (INPUT_EVENT_QUEUE_SIZE - 1);
+    if (event.source == InputSource::MQTT) mqttPending--;
+    return true;
+}
+
+const char* InputManager::getMqttPayload(const InputEvent& event) const {
+    if (event.source != InputSource::MQTT || event.code >= MQTT_SLOTS) return "";
+    return mqttPayloads[event.code];
+}
+
+// LATENCY MEASUREMENT
+// ============================================================================
+
+/**
+ * @doc Latency = dispatch completion time minus physical event time.
+ */
+void InputManager::recordLatency(const InputEvent& event) {
+    uint32_t latency = micros() - event.timestamp_us;
+    InputLatencyStats& s = latencyStats[(uint8_t)event.source];
+    s.count++;
+    s.last_us = latency;
+    s.total_us += latency;
+    if (latency > s.max_us) s.max_us = latency;
+}
+
+void InputManager::resetLatencyStats() {
+    memset(latencyStats, 0, sizeof(latencyStats));
+}
+
+void InputManager::printLatencyStats() const {
+    Serial.println("Input latency (us):");
+    for (uint8_t i = 0; i < (uint8_t)InputSource::SOURCE_COUNT; i++) {
+        const InputLatencyStats& s = latencyStats[i];
+        Serial.printf("  %-6s n=%lu last=%lu avg=%lu max=%lu dropped=%lu\n",
+                      SOURCE_NAMES[i],
+                      (unsigned long)s.count,
+                      (unsigned long)s.last_us,
+                      (unsigned long)(s.count ? s.total_us / s.count : 0),
+                      (unsigned long)s.max_us,
+                      (unsigned long)s.dropped);
+    }
+}
@@ -0,0 +1,24 @@
+#include "ir_keymap.h"
+
+IRKeymap::IRKeymap() {
+    memset(m_actions, 0, sizeof(m_actions));
+}
+
+void IRKeymap::setGlobal(const IRBinding* bindings, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        if (bindings[i].key >= IR_KEY_COUNT) continue;
+        for (int mode = 0; mode < MODE_ENUM_COUNT; mode++) {
+            m_actions[mode][bindings[i].key] = bindings[i].action;
+        }
+    }
+}
+
+void IRKeymap::setMode(DisplayMode mode, const IRBinding* bindings, size_t count) {
+    if ((unsigned)mode >= MODE_ENUM_COUNT) return;
+
+    for (size_t i = 0; i < count; i++) {
+        if (bindings[i].key < IR_KEY_COUNT) {
+            m_actions[mode][bindings[i].key] = bindings[i].action;
+        }
+    }
+}
@@ -2,6 +2,45 @@
 #include "config.h" // Include config.h for pin definitions and IR_CODE_MAP
 #include "utils.h"  // Include utils.h for Utils class definition
 
+// Default code -> key table, compiled from IR_CODE_MAP at build time.
+// C++11 constexpr functions are a single return statement, so the search is recursive.
+static constexpr uint8_t defaultKeyForCode(unsigned code, size_t i = 0) {
+    return i == IR_CODE_MAP_SIZE ? (uint8_t)IR_KEY_NONE
+         : IR_CODE_MAP[i].code == code ? (uint8_t)i
+         : defaultKeyForCode(code, i + 1);
+}
+
+static constexpr bool codesUnique(size_t i = 0, size_t j = 1) {
+    return i + 1 >= IR_CODE_MAP_SIZE ? true
+         : j == IR_CODE_MAP_SIZE ? codesUnique(i + 1, i + 2)
+         : IR_CODE_MAP[i].code != IR_CODE_MAP[j].code && codesUnique(i, j + 1);
+}
+static_assert(codesUnique(), "Two IR_CODE_MAP entries share a code");
+
+#define IR_KEYS_4(c)  defaultKeyForCode(c), defaultKeyForCode(c + 1), defaultKeyForCode(c + 2), defaultKeyForCode(c + 3)
+#define IR_KEYS_16(c) IR_KEYS_4(c), IR_KEYS_4(c + 4), IR_KEYS_4(c + 8), IR_KEYS_4(c + 12)
+#define IR_KEYS_64(c) IR_KEYS_16(c), IR_KEYS_16(c + 16), IR_KEYS_16(c + 32), IR_KEYS_16(c + 48)
+static constexpr uint8_t IR_DEFAULT_KEYMAP[256] = {
+    IR_KEYS_64(0), IR_KEYS_64(64), IR_KEYS_64(128), IR_KEYS_64(192)
+};
+#undef IR_KEYS_64
+#undef IR_KEYS_16
+#undef IR_KEYS_4
+
+// The IR_xxx code defines and the IRKey enum must describe the same IR_CODE_MAP entries
+static_assert(IR_DEFAULT_KEYMAP[IR_POWER] == IR_KEY_POWER && IR_DEFAULT_KEYMAP[IR_UP] == IR_KEY_UP &&
+              IR_DEFAULT_KEYMAP[IR_LIGHT] == IR_KEY_LIGHT && IR_DEFAULT_KEYMAP[IR_LEFT] == IR_KEY_LEFT &&
+              IR_DEFAULT_KEYMAP[IR_SOUND] == IR_KEY_SOUND && IR_DEFAULT_KEYMAP[IR_RIGHT] == IR_KEY_RIGHT &&
+              IR_DEFAULT_KEYMAP[IR_UNDO] == IR_KEY_UNDO && IR_DEFAULT_KEYMAP[IR_DOWN] == IR_KEY_DOWN &&
+              IR_DEFAULT_KEYMAP[IR_REDO] == IR_KEY_REDO && IR_DEFAULT_KEYMAP[IR_PLUS] == IR_KEY_PLUS &&
+              IR_DEFAULT_KEYMAP[IR_0] == IR_KEY_0 && IR_DEFAULT_KEYMAP[IR_MINUS] == IR_KEY_MINUS &&
+              IR_DEFAULT_KEYMAP[IR_1] == IR_KEY_1 && IR_DEFAULT_KEYMAP[IR_2] == IR_KEY_2 &&
+              IR_DEFAULT_KEYMAP[IR_3] == IR_KEY_3 && IR_DEFAULT_KEYMAP[IR_4] == IR_KEY_4 &&
+              IR_DEFAULT_KEYMAP[IR_5] == IR_KEY_5 && IR_DEFAULT_KEYMAP[IR_6] == IR_KEY_6 &&
+              IR_DEFAULT_KEYMAP[IR_7] == IR_KEY_7 && IR_DEFAULT_KEYMAP[IR_8] == IR_KEY_8 &&
+              IR_DEFAULT_KEYMAP[IR_9] == IR_KEY_9,
+              "IRKey order does not match IR_CODE_MAP");
+
 // IRManager setup function
 // Initializes the IR receiver pin and stores the pointer to the Utils instance.
 void IRManager::setup(Utils* utils_ptr) {
@@ -30,6 +69,7 @@ void IRManager::setup(Utils* utils_ptr) {
     // Initialize command variables.
     lastCommand = 0;
     lastReceiveTime = 0;
+    lastCommandTime_us = 0;
     newCommandAvailable = false;
     scanMode = false;
     // soundFeedbackEnabled는 utils 사용 가능 여부에 따라 위에서 초기화됩니다.
@@ -44,6 +84,7 @@ void IRManager::setup(Utils* utils_ptr) {
         // Copy code, name, and set configured flag to true by default from config.
         buttonMappings[i] = {IR_CODE_MAP[i].code, IR_CODE_MAP[i].name}; 
     }
+    memcpy(keyOfCode, IR_DEFAULT_KEYMAP, sizeof(keyOfCode));
 
     Serial.println("\nIR Manager initialized (Non-blocking State Machine)");
     // Serial.printf("IR Receiver Pin: %d\n", irPin); // Log the actual pin number.
@@ -174,6 +215,7 @@ void IRManager::updateReadNonBlocking() {
                         if (command != lastCommand || (currentTime_ms - lastReceiveTime) > COMMAND_TIMEOUT) {
                             lastCommand = command;
                             lastReceiveTime = currentTime_ms;
+                            lastCommandTime_us = micros();
                             newCommandAvailable = true;
                             if (soundFeedbackEnabled && utils) utils->playSingleTone();
                             Serial.printf("IR NEC Command: 0x%02X (Addr: 0x%02X)\n", command, address);
@@ -260,7 +302,7 @@ void IRManager::configureCode(const char* buttonName, uint32_t code) {
     int index = findButtonIndex(buttonName);
     if (index >= 0) {
         // Store the command byte of the code.
-        buttonMappings[index].code = code & 0xFF; 
+        remapKey((IRKey)index, code & 0xFF);
         Serial.printf("Configured %s: 0x%02X\n", buttonName, buttonMappings[index].code);
         
         // Play success tone if enabled and Utils is available.
@@ -283,7 +325,11 @@ void IRManager::configureCode(const char* buttonName, uint32_t code) {
 void IRManager::printCodeMappings() const { 
     Serial.println("----- IR Code Mappings -----");
     for (int i = 0; i < NUM_BUTTONS; i++) {
-        Serial.printf("%-8s: 0x%02X\n", buttonMappings[i].name, buttonMappings[i].code);
+        if (keyOfCode[buttonMappings[i].code] == i) {
+            Serial.printf("%-8s: 0x%02X\n", buttonMappings[i].name, buttonMappings[i].code);
+        } else {
+            Serial.printf("%-8s: --\n", buttonMappings[i].name); // Code taken over by another key
+        }
     }
     Serial.println("------------------------------");
 }
@@ -294,6 +340,7 @@ void IRManager::resetToDefaults() {
     for (int i = 0; i < NUM_BUTTONS; i++) {
         buttonMappings[i] = {IR_CODE_MAP[i].code, IR_CODE_MAP[i].name}; 
     }
+    memcpy(keyOfCode, IR_DEFAULT_KEYMAP, sizeof(keyOfCode));
     Serial.println("IR mappings reset to defaults from config.h");
     
     // Play reset tone if enabled and Utils is available.
@@ -303,30 +350,44 @@ void IRManager::resetToDefaults() {
     }
 }
 
-// Check if a specific button name corresponds to the last received command.
+// Move a key to a new command byte.
+// Both tables are updated in place, so this is safe to call while commands are dispatched.
+void IRManager::remapKey(IRKey key, uint8_t code) {
+    if (key >= IR_KEY_COUNT) return;
+
+    // The key's old code no longer means this key
+    if (keyOfCode[buttonMappings[key].code] == key) {
+        keyOfCode[buttonMappings[key].code] = IR_KEY_NONE;
+    }
+    // A key that had the new code loses it (printCodeMappings() shows it as unmapped)
+    keyOfCode[code] = key;
+    buttonMappings[key].code = code;
+}
+
+// Find the key for a button name, case-insensitively (learning console input is upper-cased).
+IRKey IRManager::keyForName(const char* buttonName) const {
+    for (int i = 0; i < NUM_BUTTONS; ++i) {
+        if (strcasecmp(buttonMappings[i].name, buttonName) == 0) {
+            return (IRKey)i;
+        }
+    }
+    return IR_KEY_NONE;
+}
+
+// Check if a specific key corresponds to the last received command.
 // This method is less useful with the new async update approach.
 // The main loop should check hasNewCommand() and getLastCommand()
-// and then compare the command code to the desired button code using findButtonIndexByCode().
-bool IRManager::isButtonPressed(const char* buttonName) {
-    // Check if a new command is available and find the button index by name.
-    if (!newCommandAvailable) return false;
-    
-    int index = findButtonIndex(buttonName);
-    // If the button name is found and configured, compare its code with the last received command.
-    if (index >= 0) { // lastCommand는 이미 command 바이트만 저장
-        return lastCommand == buttonMappings[index].code;
-    }
-    return false; // Button not found, not configured, or no new command.
+// and then look the key up with keyForCode().
+bool IRManager::isButtonPressed(IRKey key) const {
+    // lastCommand는 이미 command 바이트만 저장
+    return newCommandAvailable && key != IR_KEY_NONE && keyOfCode[lastCommand & 0xFF] == key;
 }
 
-// Get the IR code associated with a specific button name.
-uint32_t IRManager::getButtonCode(const char* buttonName) {
-    // Find the button index by name.
-    int index = findButtonIndex(buttonName);
-    // Return the code if found, otherwise return an invalid code (0xFF).
-    // 0xFFFFFFFF를 사용하여 오류 또는 찾지 못함을 나타내는 것이 더 명확할 수 있습니다.
-    if (index >= 0) {
-        return buttonMappings[index].code;
+// Get the IR code associated with a specific key.
+uint32_t IRManager::getButtonCode(IRKey key) const {
+    // Return the code if the key is mapped, otherwise return an invalid code.
+    if (key < IR_KEY_COUNT && keyOfCode[buttonMappings[key].code] == key) {
+        return buttonMappings[key].code;
     }
     return 0xFFFFFFFF; // 찾지 못했을 때의 반환 값
 }
@@ -440,6 +501,7 @@ void IRManager::readRawCodeYahboom(unsigned long timeout_ms) {
         lastCommand = rawCommand;
         newCommandAvailable = true;
         lastReceiveTime = millis();
+        lastCommandTime_us = micros();
         Serial.printf("IR : Code 0x%02X received.\n", rawCommand);
         if (soundFeedbackEnabled && utils) utils->playSingleTone();
         // if (scanMode) {
@@ -457,14 +519,8 @@ void IRManager::readRawCodeYahboom(unsigned long timeout_ms) {
 }
 
 // Helper method to find the index of a button mapping by its IR code.
-int IRManager::findButtonIndexByCode(uint32_t code) {
-    // 코드의 command 바이트 부분만 비교하도록 합니다.
-    uint8_t commandByte = code & 0xFF;
-    // Iterate through the button mappings array.
-    for (int i = 0; i < NUM_BUTTONS; ++i) {
-        if (buttonMappings[i].code == commandByte) { // 저장된 버튼 코드와 비교
-            return i; // Return the index if found.
-        }
-    }
-    return -1; // Return -1 if not found.
+int IRManager::findButtonIndexByCode(uint32_t code) const {
+    // 코드의 command 바이트 부분만 사용합니다.
+    IRKey key = keyForCode(code);
+    return key == IR_KEY_NONE ? -1 : key; // Return -1 if not found.
 }
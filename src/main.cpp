@@ -25,6 +25,9 @@
 #include "config.h"
 #include "utils.h"
 #include "ir_manager.h"
+#include "ir_keymap.h"
+#include "input_manager.h"
+#include "telemetry.h"
 
 // Display mode class headers
 #include "mode_clock.h"
@@ -45,8 +48,9 @@
 #include <PubSubClient.h>
 #include <ArduinoJson.h>
 
-// LED matrix display driver
+// LED matrix display driver and the panel-wall surface the modes draw on
 #include <ESP32-HUB75-MatrixPanel-I2S-DMA.h> 
+#include "matrix_display.h"
 
 // --- GLOBAL SYSTEM VARIABLES ---
 
@@ -54,9 +58,12 @@
 DisplayMode currentMode;                     // Currently active display mode
 Utils utils;                                 // Hardware utility and display management
 IRManager irManager;                         // Infrared remote control handler
+IRKeymap irKeymap;                           // Per-mode IR key -> action tables
+InputManager inputManager;                   // Merged button / IR / MQTT event stream
 
 // Hardware interface objects
-MatrixPanel_I2S_DMA *dma_display = nullptr; // LED matrix display controller
+MatrixPanel_I2S_DMA *dma_display = nullptr; // LED matrix display controller (HUB75 DMA chain)
+MatrixDisplay *matrix_display = nullptr;     // Whole panel wall as one surface, used by all modes
 WiFiClient wifiClient;                       // WiFi network client
 PubSubClient mqttClient(wifiClient);         // MQTT communication client
 
@@ -85,6 +92,12 @@ char g_defaultInitialDisplayMode[16] = DEFAULT_INITIAL_DISPLAY_MODE;
 char g_defaultPendingMode[16] = DEFAULT_PENDING_MODE;
 unsigned long g_idleTimeoutMqtt = DEFAULT_IDLE_TIMEOUT_MQTT;
 unsigned long g_globalIdleTimeoutMs = DEFAULT_GLOBAL_IDLE_TIMEOUT_MS;
+uint32_t g_displayClockHz = 0;               // HUB75 output clock, 0 = not tuned yet
+int g_displayColorDepth = MATRIX_COLOR_DEPTH; // HUB75 colour depth (bit planes)
+int g_displayMinRefreshHz = DISPLAY_TARGET_REFRESH_HZ; // min_refresh_rate passed to the driver
+int g_panelRows = MATRIX_PANEL_ROWS;         // Panel wall layout: rows of panels
+int g_panelCols = MATRIX_PANEL_COLS;         // Panel wall layout: columns of panels
+int g_panelChainType = MATRIX_CHAIN_TYPE;    // Panel wall layout: cable routing (PANEL_CHAIN_TYPE)
 
 // Configuration file path
 const char* CONFIG_FILE_PATH = "/config.json";
@@ -111,15 +124,18 @@ bool modeChangeByIR = false;                 // IR-triggered mode change flag
 
 void handleModeChangeRequest(const char* modeString);
 void setupMatrixDisplay();
+bool tuneDisplayTiming(const HUB75_I2S_CFG& baseConfig);
 void connectWiFi();
 void ensureNetworkAndTime();
 bool connectMQTT();
 void processJsonMessage(const char* jsonString);
-void handleButtonActions();
+void processInputEvents();
+void handleButtonEvent(const InputEvent& event);
 void mqttCallback(char* topic, byte* payload, unsigned int length); // NOLINT(bugprone-easily-swappable-parameters)
 void maintainMqttConnections();
 void setupTime();
 void handleIRCommand(uint32_t command);
+void registerIRKeymaps();
 void switchMode(DisplayMode newMode, bool activateMode = true);
 void updateCurrentMode();
 void saveConfiguration();
@@ -171,7 +187,7 @@ static uint16_t interpolateColor(uint16_t color1, uint16_t color2, float ratio)
  * @param display Pointer to the matrix display driver
  * @param util_obj Pointer to utilities object for color conversion and text positioning
  */
-static void drawSetupProgressBar(uint8_t progress, unsigned long startTime, MatrixPanel_I2S_DMA* display, Utils* util_obj) {
+static void drawSetupProgressBar(uint8_t progress, unsigned long startTime, MatrixDisplay* display, Utils* util_obj) {
     if (!display || !util_obj) return;
 
     // Clear display before drawing progress update
@@ -185,7 +201,7 @@ static void drawSetupProgressBar(uint8_t progress, unsigned long startTime, Matr
     // Progress bar dimensions and positioning
     int barBaseX = 2;
     int barY = 62;
-    int barWidthMax = MATRIX_WIDTH - (2 * barBaseX);
+    int barWidthMax = display->width() - (2 * barBaseX);
     int barHeight = 1;
 
     // Calculate current progress bar width
@@ -207,12 +223,12 @@ static void drawSetupProgressBar(uint8_t progress, unsigned long startTime, Matr
     display->setTextColor(colorWhite);
     
     const char* systemText = "SYSTEM";
-    int system_x = util_obj->calculateTextCenterX(systemText, MATRIX_WIDTH);
+    int system_x = util_obj->calculateTextCenterX(systemText, display->width());
     display->setCursor(system_x, 18);
     display->print(systemText);
 
     const char* readyText = "READY";
-    int ready_x = util_obj->calculateTextCenterX(readyText, MATRIX_WIDTH);
+    int ready_x = util_obj->calculateTextCenterX(readyText, display->width());
     display->setCursor(ready_x, 30);
     display->print(readyText);
 
@@ -229,12 +245,12 @@ static void drawSetupProgressBar(uint8_t progress, unsigned long startTime, Matr
     display->getTextBounds(timeText, 0, 0, &x1, &y1, &w, &h);
     
     // Right-align time text with margin
-    int textX_logical = MATRIX_WIDTH - w - 2;
+    int textX_logical = display->width() - w - 2;
     int textY_top = 55;
 
     // Draw progress bar if there's any progress
     if (currentBarWidth > 0) {
-        display->fillRect(setPhysicalX(barBaseX), barY, currentBarWidth, barHeight, barColor);
+        display->fillRect(barBaseX, barY, currentBarWidth, barHeight, barColor);
     }
     
     // Draw elapsed time display
@@ -271,7 +287,7 @@ void loadConfiguration() {
             return;
         }
 
-        StaticJsonDocument<512> docConfig; // Increased size to be safe
+        StaticJsonDocument<1024> docConfig; // Increased size to be safe
         DeserializationError error = deserializeJson(docConfig, configFile);
         configFile.close();
 
@@ -303,6 +319,21 @@ void loadConfiguration() {
         g_globalIdleTimeoutMs = docConfig["globalIdleTimeoutMs"] | g_globalIdleTimeoutMs;
         strlcpy(g_defaultInitialDisplayMode, docConfig["defaultInitialDisplayMode"] | g_defaultInitialDisplayMode, sizeof(g_defaultInitialDisplayMode));
         strlcpy(g_defaultPendingMode, docConfig["defaultPendingMode"] | g_defaultPendingMode, sizeof(g_defaultPendingMode));
+        g_displayClockHz = docConfig["displayClockHz"] | g_displayClockHz;
+        g_displayColorDepth = docConfig["displayColorDepth"] | g_displayColorDepth;
+        g_displayMinRefreshHz = docConfig["displayMinRefreshHz"] | g_displayMinRefreshHz;
+        g_panelRows = docConfig["panelRows"] | g_panelRows;
+        g_panelCols = docConfig["panelCols"] | g_panelCols;
+        g_panelChainType = docConfig["panelChainType"] | g_panelChainType;
+        // Fall back to the config.h layout if the stored one is not usable
+        if (g_panelRows < 1 || g_panelCols < 1 || g_panelRows * g_panelCols > MATRIX_MAX_PANELS ||
+            g_panelChainType < CHAIN_NONE || g_panelChainType >= CHAIN_RUNTIME ||
+            (g_panelRows > 1 && g_panelChainType == CHAIN_NONE)) {
+            Serial.printf("Invalid panel layout %dx%d (chain type %d). Using defaults.\n", g_panelRows, g_panelCols, g_panelChainType);
+            g_panelRows = MATRIX_PANEL_ROWS;
+            g_panelCols = MATRIX_PANEL_COLS;
+            g_panelChainType = MATRIX_CHAIN_TYPE;
+        }
 
         Serial.printf("Configuration loaded from LittleFS: (%s)\n", CONFIG_FILE_PATH);
         // Serial.println("--- DEBUG: loadConfiguration() successfully loaded and parsed config.json ---");
@@ -324,6 +355,10 @@ void loadConfiguration() {
     Serial.printf(" - Default Pending Mode: %s\n", g_defaultPendingMode);
     Serial.printf(" - MQTT Idle Timeout: %lu ms\n", g_idleTimeoutMqtt);
     Serial.printf(" - Global Idle Timeout: %lu ms\n", g_globalIdleTimeoutMs);
+    Serial.printf(" - Display Timing: %lu Hz clock, %d bit depth, min %d Hz refresh%s\n",
+                  (unsigned long)g_displayClockHz, g_displayColorDepth, g_displayMinRefreshHz,
+                  g_displayClockHz ? "" : " (not tuned)");
+    Serial.printf(" - Panel Layout: %d x %d panels, chain type %d\n", g_panelRows, g_panelCols, g_panelChainType);
 }
 
 /**
@@ -353,6 +388,12 @@ void saveConfiguration() {
     doc["globalIdleTimeoutMs"] = g_globalIdleTimeoutMs;
     doc["defaultInitialDisplayMode"] = g_defaultInitialDisplayMode;
     doc["defaultPendingMode"] = g_defaultPendingMode;
+    doc["displayClockHz"] = g_displayClockHz;
+    doc["displayColorDepth"] = g_displayColorDepth;
+    doc["displayMinRefreshHz"] = g_displayMinRefreshHz;
+    doc["panelRows"] = g_panelRows;
+    doc["panelCols"] = g_panelCols;
+    doc["panelChainType"] = g_panelChainType;
     
     if (serializeJson(doc, configFile) == 0) {
         Serial.println(F("Failed to write to config file"));
@@ -400,8 +441,8 @@ void handleModeChangeRequest(const char* modeString) {
 
         switch(targetMode) {
             case MODE_PATTERN:
-                if (subMode >= 1 && subMode <= MAX_PATTERNS) {
-                    modePattern.setPattern(static_cast<PatternType>(subMode - 1));
+                if (subMode >= 1 && subMode <= ModePattern::patternCount()) {
+                    modePattern.setPattern(subMode - 1);
                 } // No default activation, setup is enough
                 break;
             case MODE_IMAGE:
@@ -440,16 +481,72 @@ void handleModeChangeRequest(const char* modeString) {
 
 // --- Main Function Implementations ---
 
+/**
+ * @brief Picks the HUB75 clock / colour depth / refresh rate from the driver's timing model.
+ *
+ * Sweeps the allowed output clocks and colour depths (config.h DISPLAY_TUNE_*), taking for each
+ * pair the BCM transition bit the driver itself will choose for DISPLAY_TARGET_REFRESH_HZ, and
+ * keeps the combination with the highest effective colour depth that stays within the DMA
+ * memory budget. Only the model is evaluated, nothing is allocated. The result is stored in the
+ * g_display* globals and persisted to config.json.
+ *
+ * @param baseConfig Panel geometry and buffering to tune for
+ * @return true if a configuration meeting the target was found
+ */
+bool tuneDisplayTiming(const HUB75_I2S_CFG& baseConfig) {
+    static const uint32_t clocks[] = { HUB75_I2S_CFG::HZ_8M, HUB75_I2S_CFG::HZ_16M, HUB75_I2S_CFG::HZ_20M };
+    uint8_t numClocks = 0;
+    while (numClocks < sizeof(clocks) / sizeof(clocks[0]) && clocks[numClocks] <= DISPLAY_TUNE_MAX_CLOCK_HZ) numClocks++;
+
+    HUB75TunerLimits limits;
+    limits.target_refresh_hz = DISPLAY_TARGET_REFRESH_HZ;
+    limits.min_depth = DISPLAY_TUNE_MIN_DEPTH;
+    limits.max_depth = DISPLAY_TUNE_MAX_DEPTH;
+    limits.clocks = clocks;
+    limits.num_clocks = numClocks;
+    limits.max_memory_bytes = DISPLAY_TUNE_MAX_DMA_KB * 1024UL;
+
+    Serial.printf("Display tuner: target > %d Hz, depth %d-%d, DMA budget %d KB\n",
+                  DISPLAY_TARGET_REFRESH_HZ, DISPLAY_TUNE_MIN_DEPTH, DISPLAY_TUNE_MAX_DEPTH, DISPLAY_TUNE_MAX_DMA_KB);
+
+    HUB75TunerCandidate best;
+    bool found = hub75_tune(MatrixPanel_I2S_DMA::getTimingParams(baseConfig), limits, best,
+        [](const HUB75TunerCandidate& c) {
+            Serial.printf("  %2lu MHz depth %2d tbit %d -> %4lu Hz, %3lu KB%s\n",
+                          (unsigned long)(c.clk_hz / 1000000), c.color_depth, c.transition_bit,
+                          (unsigned long)c.result.refresh_hz, (unsigned long)(c.result.total_bytes / 1024),
+                          c.feasible ? "" : "  (rejected)");
+        });
+
+    if (!found) {
+        Serial.println("Display tuner: no configuration meets the target. Keeping defaults.");
+        return false;
+    }
+
+    g_displayClockHz = best.clk_hz;
+    g_displayColorDepth = best.color_depth;
+    g_displayMinRefreshHz = DISPLAY_TARGET_REFRESH_HZ;
+
+    Serial.printf("Display tuner: chose %lu Hz clock, %d bit depth (transition bit %d). Predicted %lu Hz refresh, %lu bytes DMA memory.\n",
+                  (unsigned long)best.clk_hz, best.color_depth, best.transition_bit,
+                  (unsigned long)best.result.refresh_hz, (unsigned long)best.result.total_bytes);
+    saveConfiguration();
+    return true;
+}
+
 /**
  * @brief Initializes and configures the LED matrix display hardware.
  * 
  * Sets up the HUB75 LED matrix panel using ESP32-HUB75-MatrixPanel-DMA library.
  * Configures display parameters like dimensions, chain length, and DMA settings.
- * Enables the display and sets initial brightness level.
+ * Enables the display and sets initial brightness level, then wraps the chain in
+ * the MatrixDisplay that maps the configured panel layout onto it.
  */
 void setupMatrixDisplay() {
-    Serial.printf("\nInitializing %dx%d display...\n", MATRIX_WIDTH, MATRIX_HEIGHT);
-    HUB75_I2S_CFG mxconfig(MATRIX_WIDTH, MATRIX_HEIGHT, MATRIX_CHAIN);
+    int chainLength = g_panelRows * g_panelCols;
+    Serial.printf("\nInitializing %dx%d display (%d x %d panels of %dx%d)...\n",
+                  g_panelCols * MATRIX_WIDTH, g_panelRows * MATRIX_HEIGHT, g_panelRows, g_panelCols, MATRIX_WIDTH, MATRIX_HEIGHT);
+    HUB75_I2S_CFG mxconfig(MATRIX_WIDTH, MATRIX_HEIGHT, chainLength);
     // Use pin definitions from config.h
     mxconfig.gpio.r1 = R1_PIN; mxconfig.gpio.g1 = G1_PIN; mxconfig.gpio.b1 = B1_PIN;
     mxconfig.gpio.r2 = R2_PIN; mxconfig.gpio.g2 = G2_PIN; mxconfig.gpio.b2 = B2_PIN;
@@ -458,15 +555,33 @@ void setupMatrixDisplay() {
     mxconfig.gpio.clk = CLK_PIN; mxconfig.gpio.lat = LAT_PIN; mxconfig.gpio.oe = OE_PIN;
 
     mxconfig.double_buff = !FORCE_SINGLE_BUFFER; // Use config.h setting
-    mxconfig.i2sspeed = HUB75_I2S_CFG::HZ_10M;   // Or other configured speed
+
+    // Clock, colour depth and refresh target come from the timing tuner (persisted in config.json)
+    if (g_displayClockHz == 0 && !tuneDisplayTiming(mxconfig)) {
+        g_displayClockHz = HUB75_I2S_CFG::HZ_10M;
+    }
+    mxconfig.i2sspeed = (HUB75_I2S_CFG::clk_speed)g_displayClockHz;
+    mxconfig.setPixelColorDepthBits(g_displayColorDepth);
+    mxconfig.min_refresh_rate = g_displayMinRefreshHz;
+
+    HUB75TimingParams timing = MatrixPanel_I2S_DMA::getTimingParams(mxconfig);
+    timing.transition_bit = hub75_transition_bit(timing, mxconfig.min_refresh_rate);
+    HUB75TimingResult predicted = hub75_timing_model(timing);
 
     dma_display = new MatrixPanel_I2S_DMA(mxconfig);
 
     if (dma_display && dma_display->begin()) {
-        Serial.printf("Display: %dx%d initialized successfully\n", MATRIX_WIDTH, MATRIX_HEIGHT);
+        Serial.printf("Display: %dx%d chain initialized successfully\n", MATRIX_WIDTH * chainLength, MATRIX_HEIGHT);
+        Serial.printf("Display: refresh %d Hz (model %lu Hz), transition bit %d, DMA memory %lu bytes (model)\n",
+                      dma_display->calculated_refresh_rate, (unsigned long)predicted.refresh_hz,
+                      dma_display->getLsbMsbTransitionBit(), (unsigned long)predicted.total_bytes);
         dma_display->setBrightness8(g_panelBrightness); // Set default brightness (config.h)
+        dma_display->setDither(MATRIX_DITHER_FRAMES);   // Hide banding from the reduced colour depth
         dma_display->clearScreen();
         dma_display->flipDMABuffer(); // Display initial buffer
+
+        matrix_display = new MatrixDisplay(dma_display, g_panelRows, g_panelCols, (PANEL_CHAIN_TYPE)g_panelChainType);
+        Serial.printf("Display: %dx%d surface, chain type %d\n", matrix_display->width(), matrix_display->height(), g_panelChainType);
     } else {
         Serial.println("Display: Initialization FAILED!");
         // Handle display initialization failure (e.g., infinite loop or retry)
@@ -512,22 +627,25 @@ void setup() {
     setupMatrixDisplay();
 
     // 2. utils.setup() - This will show "SYSTEM READY". Progress: 5%
-    utils.setup(dma_display);        // Initialize Utils by passing the display pointer and run displayColortest if defined. 
-                                                //'dma_display' is a pointer to MatrixPanel_I2S_DMA object.
+    utils.setup(matrix_display);     // Initialize Utils by passing the display pointer and run displayColortest if defined. 
+                                                //'matrix_display' is the MatrixDisplay wrapping the MatrixPanel_I2S_DMA chain.
     Serial.println("Display, GPIO and Utils initialized");
 
+    // Button pins are configured by utils.setup(); attach their edge interrupts now
+    inputManager.setup();
+
     // After "SYSTEM READY" is displayed by utils.setup(),
     // remove the screen initialization code to keep "SYSTEM READY" displayed.
 
     // Initial progress bar display (0%) after "SYSTEM READY"
-    drawSetupProgressBar(totalProgress, setupStartTime, dma_display, &utils);
+    drawSetupProgressBar(totalProgress, setupStartTime, matrix_display, &utils);
 
     // Account for setupMatrixDisplay
     totalProgress += 10;
-    drawSetupProgressBar(totalProgress, setupStartTime, dma_display, &utils);
+    drawSetupProgressBar(totalProgress, setupStartTime, matrix_display, &utils);
     // Account for utils.setup
     totalProgress += 5;
-    drawSetupProgressBar(totalProgress, setupStartTime, dma_display, &utils);
+    drawSetupProgressBar(totalProgress, setupStartTime, matrix_display, &utils);
 
     // Log the time taken to set the module ------------------------------------------
     // currentTime = millis();
@@ -536,9 +654,11 @@ void setup() {
 
     // Initialize IRManager (pass Utils object address)
     irManager.setup(&utils);          // 'utils' is a just object and make pointer variable with '&' for Utils object.
+    registerIRKeymaps();
+    modeIRScan.applyLearnedKeys(&irManager); // Remote keys relearned in IR Scan mode override config.h codes
     // 3. irManager.setup(). Progress: 5%
     totalProgress += 5;
-    drawSetupProgressBar(totalProgress, setupStartTime, dma_display, &utils);
+    drawSetupProgressBar(totalProgress, setupStartTime, matrix_display, &utils);
     Serial.println("IRManager initialized");
 
     // In main.cpp setup() function, after irManager.setup(&utils);
@@ -565,7 +685,7 @@ void setup() {
     connectWiFi();
     if (WiFi.status() == WL_CONNECTED) {
         totalProgress += 20;
-        drawSetupProgressBar(totalProgress, setupStartTime, dma_display, &utils);
+        drawSetupProgressBar(totalProgress, setupStartTime, matrix_display, &utils);
     } else {
         Serial.println("Setup: WiFi connection failed. Progress for MQTT/NTP might be affected.");
     }
@@ -574,7 +694,7 @@ void setup() {
     if (WiFi.status() == WL_CONNECTED) {
         if (connectMQTT()) {
             totalProgress += 20;
-            drawSetupProgressBar(totalProgress, setupStartTime, dma_display, &utils);
+            drawSetupProgressBar(totalProgress, setupStartTime, matrix_display, &utils);
         } else {
             Serial.println("Setup: MQTT connection failed.");
         }
@@ -585,7 +705,7 @@ void setup() {
         setupTime();
         totalProgress += 20; // Credit NTP attempt
         if(totalProgress > 80) totalProgress = 80; // Cap if previous steps failed
-        drawSetupProgressBar(totalProgress, setupStartTime, dma_display, &utils);
+        drawSetupProgressBar(totalProgress, setupStartTime, matrix_display, &utils);
     }
 
     // Log the time taken to set the module ------------------------------------------
@@ -599,7 +719,7 @@ void setup() {
     // 5. Mode setups. Progress: 10%
     totalProgress += 10;
     if(totalProgress > 90) totalProgress = 90;
-    drawSetupProgressBar(totalProgress, setupStartTime, dma_display, &utils);
+    drawSetupProgressBar(totalProgress, setupStartTime, matrix_display, &utils);
 
     // Log the time taken to set the module ------------------------------------------
     // currentTime = millis();
@@ -611,7 +731,7 @@ void setup() {
     utils.playScaleTone();
     totalProgress += 5;
     if(totalProgress > 95) totalProgress = 95;
-    drawSetupProgressBar(totalProgress, setupStartTime, dma_display, &utils);
+    drawSetupProgressBar(totalProgress, setupStartTime, matrix_display, &utils);
     Serial.println("Setup and initialization complete!");
 
     // Log the time taken to set the module ------------------------------------------
@@ -620,7 +740,7 @@ void setup() {
     // lastLogTime = currentTime;
 
     // Display progress at 100% and wait briefly
-    drawSetupProgressBar(100, setupStartTime, dma_display, &utils);
+    drawSetupProgressBar(100, setupStartTime, matrix_display, &utils);
     delay(1000); // Display 100% for a second
 
     // Switch to initial mode - this call is moved to the end of setup()
@@ -630,6 +750,9 @@ void setup() {
     // Serial.printf("--- Setup - Initial Mode Switched: %lu ms, Total: %lu ms\n\n", currentTime - lastLogTime, currentTime - setupStartTime);
     // Serial.printf("--- Total Setup Time: %lu ms\n\n", currentTime - setupStartTime);
 
+    // First memory sample (boot baseline) and the DMA memory the display driver holds
+    telemetry.begin(dma_display);
+
     g_setupCompleteTime = millis(); // Record the time setup completes
     g_systemInitializing = true;    // Ensure it's true as setup finishes
     lastUserActivityTime = millis(); // Initialize last activity time
@@ -669,19 +792,30 @@ void loop() {
     // Check and handle network and time synchronization status
     ensureNetworkAndTime(); 
 
-    // Let Utils handle its internal button debouncing and state regarding UP/DOWN buttons to change modes
-    utils.handleButtons();
-    // Call the new function to process button actions
-    handleButtonActions(); 
+    // Drain button edges captured by GPIO interrupts and run the debounce state machine
+    inputManager.update();
 
     // Execute the main funtion for the current mode
     // This will call the run() function of the currently active mode
-    // and pass handleIRCommand as the IR command handler.
+    // and post any decoded IR command into the input event stream.
+    uint32_t modeStart = micros();
     updateCurrentMode();
+    telemetry.recordFrame(micros() - modeStart, (uint8_t)currentMode);
 
-    // Maintain MQTT connection
+    // Maintain MQTT connection (received messages are posted into the input event stream)
     maintainMqttConnections(); 
 
+    // Dispatch button, IR and MQTT events in arrival order
+    processInputEvents();
+
+    // Sample heap / stack telemetry and publish the periodic MQTT report when due
+    telemetry.update();
+
+    // IR learning waits on the user at the serial console, which is activity too
+    if (currentMode == MODE_IR_SCAN && modeIRScan.isLearning()) {
+        lastUserActivityTime = millis();
+    }
+
     // Check for global idle timeout to switch to default mode
     int pendingMainMode = atoi(g_defaultPendingMode);
     if ((int)currentMode != pendingMainMode && (millis() - lastUserActivityTime > g_globalIdleTimeoutMs)) {
@@ -697,29 +831,72 @@ void loop() {
 }
 // Helper functions for main loop operations
 /**
- * @brief Processes button actions received from the Utils module.
+ * @brief Dispatches all pending events from the merged input stream.
  *
- * Checks for button press events (NEXT_MODE/PREV_MODE) from hardware GPIO buttons,
- * calculates target display mode, and triggers mode switching. Updates user activity
- * timestamp for idle timeout management.
+ * Button, IR and MQTT inputs are queued by InputManager with the timestamp of
+ * their physical origin. Each event is routed to its handler here, and the
+ * end-to-end latency (origin -> handler completion) is recorded per source.
  */
-void handleButtonActions() {
-    // Check for button actions from Utils
-    ButtonAction actionFromUtils = utils.getButtonAction(); // Changed: Utils::ButtonAction -> ButtonAction
-    if (actionFromUtils != ButtonAction::NONE) { // Changed: Utils::ButtonAction::NONE -> ButtonAction::NONE
-        DisplayMode targetMode = currentMode;
-        lastUserActivityTime = millis(); // User pressed a button
-
-        if (actionFromUtils == ButtonAction::NEXT_MODE) { // Changed
-            targetMode = (DisplayMode)((((int)currentMode - 1 + 1) % (int)MODE_MAX) + 1);
-            Serial.printf("Main: Processing NEXT_MODE to %d from Utils button press.\n", (int)targetMode);
-        } else if (actionFromUtils == ButtonAction::PREV_MODE) { // Changed
-            targetMode = (DisplayMode)((((int)currentMode - 1 - 1 + (int)MODE_MAX) % (int)MODE_MAX) + 1);
-            Serial.printf("Main: Processing PREV_MODE to %d from Utils button press.\n", (int)targetMode);
+void processInputEvents() {
+    InputEvent event;
+    while (inputManager.poll(event)) {
+        switch (event.source) {
+            case InputSource::BUTTON:
+                handleButtonEvent(event);
+                break;
+            case InputSource::IR:
+                lastUserActivityTime = millis(); // User sent an IR command
+                // While a key is being learned the code belongs to ModeIRScan, not the mode switcher
+                if (currentMode == MODE_IR_SCAN && modeIRScan.handleIRCode(event.code)) break;
+                handleIRCommand(event.code);
+                break;
+            case InputSource::MQTT:
+                lastUserActivityTime = millis(); // MQTT message received is considered an activity
+                utils.playDoubleTone();
+                processJsonMessage(inputManager.getMqttPayload(event));
+                break;
+            default:
+                break;
         }
-        if (targetMode != currentMode) { // Simplified condition: if target is different, switch.
-            switchMode(targetMode, true); // Explicitly activate the new mode
+
+        inputManager.recordLatency(event);
+        if (event.source == InputSource::MQTT) {
+            telemetry.recordMqttMessage(inputManager.getLatencyStats(event.source).last_us);
+        }
+#if INPUT_LOG_LATENCY
+        if (event.type != InputEventType::RELEASE) {
+            Serial.printf("Input: source %d type %d latency %lu us\n", (int)event.source, (int)event.type,
+                          (unsigned long)inputManager.getLatencyStats(event.source).last_us);
         }
+#endif
+    }
+}
+
+/**
+ * @brief Handles debounced button events from the input stream.
+ *
+ * UP moves to the next display mode and DOWN to the previous one. Holding a
+ * button keeps stepping: one LONG_PRESS after BUTTON_LONG_PRESS_MS, then a
+ * REPEAT every BUTTON_REPEAT_MS. RELEASE events are ignored.
+ *
+ * @param event Button event (event.code is an InputButton)
+ */
+void handleButtonEvent(const InputEvent& event) {
+    if (event.type == InputEventType::RELEASE) return;
+
+    DisplayMode targetMode = currentMode;
+    lastUserActivityTime = millis(); // User pressed a button
+    if (utils.isSoundFeedbackEnabled()) utils.playSingleTone(); // Audio feedback
+
+    if (event.code == INPUT_BUTTON_UP) {
+        targetMode = (DisplayMode)((((int)currentMode - 1 + 1) % (int)MODE_MAX) + 1);
+        Serial.printf("Main: Processing NEXT_MODE to %d from button.\n", (int)targetMode);
+    } else if (event.code == INPUT_BUTTON_DOWN) {
+        targetMode = (DisplayMode)((((int)currentMode - 1 - 1 + (int)MODE_MAX) % (int)MODE_MAX) + 1);
+        Serial.printf("Main: Processing PREV_MODE to %d from button.\n", (int)targetMode);
+    }
+    if (targetMode != currentMode) {
+        switchMode(targetMode, true); // Explicitly activate the new mode
     }
 }
 
@@ -759,44 +936,44 @@ void switchMode(DisplayMode newMode, bool activateMode) {
     // Setup new mode - call setup() or activate() depending on the mode entered
     switch (newMode) {
         case MODE_CLOCK:
-                                modeClock.setup(&utils, dma_display);
+                                modeClock.setup(&utils, matrix_display);
                                 break;
         case MODE_MQTT:
-                                modeMqtt.setup(&utils, dma_display);
+                                modeMqtt.setup(&utils, matrix_display);
                                 // ModeMqtt.setup() should handle resetting its internal flags
                                 break;
         case MODE_COUNTDOWN:
-                                modeCountdown.setup(&utils, dma_display);
+                                modeCountdown.setup(&utils, matrix_display);
                                 // ModeCountdown.setup() should handle resetting its internal flags, timer and sand glass
                                 break;
         case MODE_PATTERN:
-                                modePattern.setup(&utils, dma_display);
+                                modePattern.setup(&utils, matrix_display);
                                 // ModePattern.setup() should set the initial pattern
                                 break;
         case MODE_IMAGE:
-                                modeImage.setup(&utils, dma_display);
+                                modeImage.setup(&utils, matrix_display);
                                 if (activateMode) {
                                     modeImage.activate();
                                 }
                                 break;
         case MODE_GIF:
-                                modeGif.setup(&utils, dma_display);
+                                modeGif.setup(&utils, matrix_display);
                                 if (activateMode) {
                                     modeGif.activate();
                                 }
                                 break;
         case MODE_FONT:
-                                modeFont.setup(&utils, dma_display);
+                                modeFont.setup(&utils, matrix_display);
                                 if (activateMode) {
                                     modeFont.activate();
                                 }
                                 break;
         case MODE_SYSINFO:
-                                modeSysinfo.setup(&utils, dma_display);
+                                modeSysinfo.setup(&utils, matrix_display);
                                 // ModeSysinfo.setup() should set the initial info screen
                                 break;
         case MODE_IR_SCAN:
-                                modeIRScan.setup(&utils, dma_display, &irManager);
+                                modeIRScan.setup(&utils, matrix_display, &irManager);
                                 // ModeIRScan.setup() prepares for IR scanning,
                                 // its run() method might contain the main blocking loop if USE_RUN_INTERNAL_LOOP is true
                                 break;
@@ -807,141 +984,113 @@ void switchMode(DisplayMode newMode, bool activateMode) {
     modeChangeByIR = false; // Reset IR request flag
 }
 
+// IR remote actions ---------------------------------------------------------
+// Registered per mode in registerIRKeymaps(); handleIRCommand() looks them up.
+
+/**
+ * @brief Switches to a mode requested from the remote, with the preview screen.
+ */
+static void switchModeByIR(DisplayMode targetMode) {
+    modeChangeByIR = true; // Always perform changes due to IR (restarts the current mode)
+    lastUserActivityTime = millis(); // Update activity time for mode switch
+    if (SHOW_MODE_PREVIEW && targetMode != currentMode) { // Show preview only if mode actually changes
+        utils.showModePreview(targetMode, utils.getShortModeName(targetMode));
+    }
+    switchMode(targetMode, true); // Explicitly activate
+}
+
+template <DisplayMode M>
+static void irSelectMode() { switchModeByIR(M); }
+
+static void irNextMode() {
+    switchModeByIR((DisplayMode)((((int)currentMode - 1 + 1) % MODE_MAX) + 1)); // MODE_MAX is already (COUNT-1)
+}
+
+static void irPrevMode() {
+    switchModeByIR((DisplayMode)((((int)currentMode - 1 - 1 + MODE_MAX) % MODE_MAX) + 1));
+}
+
+static void irPower() {
+    Serial.println("IR: POWER command received - (Standby logic can be implemented here)");
+    // Example: utils.enterStandby();
+}
+
+static void irSound() {
+    utils.enableBuzzer(!utils.isSoundFeedbackEnabled());
+    Serial.printf("IR: SOUND command received - Buzzer %s\n", utils.isSoundFeedbackEnabled() ? "ON" : "OFF");
+}
+
+// Sub-mode navigation within the current mode (no full mode switch), with feedback tone
+static void irSubModeTone() {
+    if (utils.isSoundFeedbackEnabled()) utils.playSingleTone();
+}
+static void irPrevPattern() { irSubModeTone(); modePattern.prevPattern(); }
+static void irNextPattern() { irSubModeTone(); modePattern.nextPattern(); }
+static void irPrevImage()   { irSubModeTone(); modeImage.prevImage(); }
+static void irNextImage()   { irSubModeTone(); modeImage.nextImage(); }
+static void irPrevGif()     { irSubModeTone(); modeGif.prevGif(); }
+static void irNextGif()     { irSubModeTone(); modeGif.nextGif(); }
+static void irPrevFont()    { irSubModeTone(); modeFont.prevFont(); }
+static void irNextFont()    { irSubModeTone(); modeFont.nextFont(); }
+static void irPrevInfo()    { irSubModeTone(); modeSysinfo.prevInfo(); }
+static void irNextInfo()    { irSubModeTone(); modeSysinfo.nextInfo(); }
+
+static constexpr IRBinding IR_GLOBAL_KEYS[] = {
+    {IR_KEY_1, irSelectMode<MODE_CLOCK>},
+    {IR_KEY_2, irSelectMode<MODE_MQTT>},
+    {IR_KEY_3, irSelectMode<MODE_COUNTDOWN>},
+    {IR_KEY_4, irSelectMode<MODE_PATTERN>},
+    {IR_KEY_5, irSelectMode<MODE_IMAGE>},
+    {IR_KEY_6, irSelectMode<MODE_GIF>},
+    {IR_KEY_7, irSelectMode<MODE_FONT>},
+    {IR_KEY_8, irSelectMode<MODE_SYSINFO>},
+    {IR_KEY_9, irSelectMode<MODE_IR_SCAN>},
+    {IR_KEY_UP, irNextMode},
+    {IR_KEY_DOWN, irPrevMode},
+    {IR_KEY_POWER, irPower},
+    {IR_KEY_SOUND, irSound},
+};
+static constexpr IRBinding IR_PATTERN_KEYS[] = { {IR_KEY_LEFT, irPrevPattern}, {IR_KEY_RIGHT, irNextPattern} };
+static constexpr IRBinding IR_IMAGE_KEYS[]   = { {IR_KEY_LEFT, irPrevImage},   {IR_KEY_RIGHT, irNextImage} };
+static constexpr IRBinding IR_GIF_KEYS[]     = { {IR_KEY_LEFT, irPrevGif},     {IR_KEY_RIGHT, irNextGif} };
+static constexpr IRBinding IR_FONT_KEYS[]    = { {IR_KEY_LEFT, irPrevFont},    {IR_KEY_RIGHT, irNextFont} };
+static constexpr IRBinding IR_SYSINFO_KEYS[] = { {IR_KEY_LEFT, irPrevInfo},    {IR_KEY_RIGHT, irNextInfo} };
+
+/**
+ * @brief Builds the [mode][key] action table used by handleIRCommand().
+ */
+void registerIRKeymaps() {
+    irKeymap.setGlobal(IR_GLOBAL_KEYS);
+    irKeymap.setMode(MODE_PATTERN, IR_PATTERN_KEYS);
+    irKeymap.setMode(MODE_IMAGE, IR_IMAGE_KEYS);
+    irKeymap.setMode(MODE_GIF, IR_GIF_KEYS);
+    irKeymap.setMode(MODE_FONT, IR_FONT_KEYS);
+    irKeymap.setMode(MODE_SYSINFO, IR_SYSINFO_KEYS);
+}
+
 /**
  * @brief Processes IR remote control commands and triggers appropriate actions.
  * 
- * Handles mode switching (IR_1-9 for direct modes, IR_UP/DOWN for sequential),
- * sub-mode navigation (IR_LEFT/RIGHT for patterns, images, fonts, etc.),
- * and system functions (IR_POWER, IR_SOUND). Updates user activity timestamp
- * and provides audio feedback if enabled.
+ * The command byte is translated to a remote key (IRManager's code -> key table,
+ * which follows keys learned at runtime) and the key to the current mode's action
+ * (irKeymap): two array lookups instead of a switch per mode. Mode switching
+ * (1-9 for direct modes, UP/DOWN for sequential), sub-mode navigation (LEFT/RIGHT
+ * for patterns, images, fonts, etc.) and system functions (POWER, SOUND) are all
+ * registered in registerIRKeymaps(). Keys without an action play the error tone.
  * 
  * @param command 32-bit IR command code received from remote control
  */
 void handleIRCommand(uint32_t command) {
     Serial.printf("Processing IR Command: 0x%02X\n", command);
 
-    DisplayMode modeBeforeIRHandling = currentMode; // Store currentMode at the beginning of IR handling
-    DisplayMode targetMode = currentMode; // Default target mode is the current mode
-    modeChangeByIR = false; // Reset flag: true only if an actual mode switch is intended
-
-    switch (command) {
-        case IR_1: targetMode = MODE_CLOCK;     modeChangeByIR = true; break;
-        case IR_2: targetMode = MODE_MQTT;      modeChangeByIR = true; break;
-        case IR_3: targetMode = MODE_COUNTDOWN; modeChangeByIR = true; break;
-        case IR_4: targetMode = MODE_PATTERN;   modeChangeByIR = true; break; // Was MODE_ANIMATION
-        case IR_5: targetMode = MODE_IMAGE;     modeChangeByIR = true; break; // Image mode
-        case IR_6: targetMode = MODE_GIF;       modeChangeByIR = true; break; // GIF mode
-        case IR_7: targetMode = MODE_FONT;      modeChangeByIR = true; break; // Shifted
-        case IR_8: targetMode = MODE_SYSINFO;   modeChangeByIR = true; break; // Shifted
-        // Assuming IR_9 is defined in config.h for MODE_IR_SCAN
-        case IR_9: targetMode = MODE_IR_SCAN;   modeChangeByIR = true; break; // Shifted
-
-        case IR_UP:
-            targetMode = (DisplayMode)((((int)currentMode - 1 + 1) % MODE_MAX) + 1); // MODE_MAX is already (COUNT-1)
-            modeChangeByIR = true;
-            break;
-        case IR_DOWN:
-            targetMode = (DisplayMode)((((int)currentMode - 1 - 1 + MODE_MAX) % MODE_MAX) + 1);
-            modeChangeByIR = true;
-            break;
-
-        // Change sub-mode or feature within the current mode
-        case IR_LEFT: // refer to definition of config.h for actual IR code
-            
-            if (currentMode == MODE_PATTERN) { // Was MODE_ANIMATION
-                if (utils.isSoundFeedbackEnabled()) utils.playSingleTone(); // Feedback for pattern change
-                modePattern.prevPattern(); // Renamed method
-                lastUserActivityTime = millis(); // Consider pattern change as user activity
-                // modeChangeByIR remains false, so no full mode switch occurs
-            } else if (currentMode == MODE_IMAGE) {
-                if (utils.isSoundFeedbackEnabled()) utils.playSingleTone();
-                modeImage.prevImage();
-                lastUserActivityTime = millis(); // Consider image change as user activity
-                // modeChangeByIR remains false, so no full mode switch occurs
-            } else if (currentMode == MODE_GIF) {
-                if (utils.isSoundFeedbackEnabled()) utils.playSingleTone();
-                modeGif.prevGif();
-                lastUserActivityTime = millis(); // Consider pattern change as user activity
-                // modeChangeByIR remains false, so no full mode switch occurs
-            } else if (currentMode == MODE_FONT) {
-                // If in MODE_FONT, switch to next font
-                if (utils.isSoundFeedbackEnabled()) utils.playSingleTone(); // Feedback for pattern change
-                modeFont.prevFont();
-                lastUserActivityTime = millis(); // Consider font change as user activity
-                // modeChangeByIR remains false, so no full mode switch occurs
-            } else if (currentMode == MODE_SYSINFO) {
-                // If in MODE_SYSINFO, switch to previous info screen
-                if (utils.isSoundFeedbackEnabled()) utils.playSingleTone(); // Feedback for info change
-                modeSysinfo.prevInfo();
-                lastUserActivityTime = millis(); // Consider info change as user activity
-                // modeChangeByIR remains false, so no full mode switch occurs
-            } else {
-                // Serial.println("IR: LEFT command received - No action in current mode");
-                if (utils.isSoundFeedbackEnabled()) utils.playErrorTone(); // Feedback for no action
-            }
-            break;
-        case IR_RIGHT: // refer to definition of config.h for actual IR code
-            if (currentMode == MODE_PATTERN) { // Was MODE_ANIMATION
-                if (utils.isSoundFeedbackEnabled()) utils.playSingleTone(); // Feedback for pattern change
-                modePattern.nextPattern(); // Renamed method
-                lastUserActivityTime = millis(); // Consider pattern change as user activity
-                // modeChangeByIR remains false, so no full mode switch occurs
-            } else if (currentMode == MODE_IMAGE) {
-                if (utils.isSoundFeedbackEnabled()) utils.playSingleTone();
-                modeImage.nextImage();
-                lastUserActivityTime = millis(); // Consider image change as user activity
-                // modeChangeByIR remains false, so no full mode switch occurs
-            } else if (currentMode == MODE_GIF) {
-                if (utils.isSoundFeedbackEnabled()) utils.playSingleTone();
-                modeGif.nextGif();
-                // modeChangeByIR remains false, so no full mode switch occurs
-            } else if (currentMode == MODE_FONT) {
-                // If in MODE_FONT, switch to next font
-                if (utils.isSoundFeedbackEnabled()) utils.playSingleTone(); // Feedback for pattern change
-                modeFont.nextFont();
-                lastUserActivityTime = millis(); // Consider font change as user activity
-                // modeChangeByIR remains false, so no full mode switch occurs
-            } else if (currentMode == MODE_SYSINFO) {
-                // If in MODE_SYSINFO, switch to next info screen
-                if (utils.isSoundFeedbackEnabled()) utils.playSingleTone(); // Feedback for info change
-                modeSysinfo.nextInfo();
-                lastUserActivityTime = millis(); // Consider info change as user activity
-                // modeChangeByIR remains false, so no full mode switch occurs
-            } else {
-                // Serial.println("IR: RIGHT command received - No action in current mode");
-                if (utils.isSoundFeedbackEnabled()) utils.playErrorTone(); // Feedback for no action
-            }
-            break;
-        case IR_POWER:
-            Serial.println("IR: POWER command received - (Standby logic can be implemented here)");
-            // Example: utils.enterStandby();
-            break;
-        case IR_SOUND:
-            // Use Utils class's isSoundFeedbackEnabled() (assumed to be declared in utils.h)
-            if (utils.isSoundFeedbackEnabled()) {
-                utils.enableBuzzer(false);
-            } else {
-                utils.enableBuzzer(true);
-            }
-            Serial.printf("IR: SOUND command received - Buzzer %s\n", utils.isSoundFeedbackEnabled() ? "ON" : "OFF");
-            break;
-
-        default:
-            Serial.printf("IR: Unknown command 0x%02X - ignoring\n", command);
-            if (utils.isSoundFeedbackEnabled()) utils.playErrorTone();
-            break;
-    }
-
-    // Perform mode switch only if modeChangeByIR is true
-    if (modeChangeByIR) {
-        lastUserActivityTime = millis(); // Update activity time for mode switch
-        if (SHOW_MODE_PREVIEW && targetMode != modeBeforeIRHandling) { // Show preview only if mode actually changes
-            utils.showModePreview(targetMode, utils.getShortModeName(targetMode));
-            switchMode(targetMode, true); // Explicitly activate after preview
-        } else { // Switch mode without preview (or if it's a restart of the same mode)
-            switchMode(targetMode, true); // Explicitly activate
-        }
+    modeChangeByIR = false; // Reset flag: set only by an action that switches modes
+    IRAction action = irKeymap.action(currentMode, irManager.keyForCode(command));
+    if (!action) {
+        Serial.printf("IR: No action for command 0x%02X in mode %d - ignoring\n", command, (int)currentMode);
+        if (utils.isSoundFeedbackEnabled()) utils.playErrorTone(); // Feedback for no action
+        return;
     }
+    action();
 }
 
 
@@ -1120,34 +1269,22 @@ bool connectMQTT() {
 /**
  * @brief MQTT message reception callback handler.
  * 
- * Called automatically when MQTT messages are received on subscribed topics.
- * Converts payload to null-terminated string and forwards to JSON message
- * processor. Updates activity timestamp and provides audio feedback.
+ * Called from mqttClient.loop() when messages are received on subscribed topics.
+ * The payload is copied into the input event stream; activity tracking, audio
+ * feedback and JSON processing happen when processInputEvents() dispatches it.
  * 
  * @param topic MQTT topic that received the message
  * @param payload Raw message payload data
  * @param length Length of payload in bytes
  */
 void mqttCallback(char* topic, byte* payload, unsigned int length) {
-    // Serial.println("mqttCallback: Entered function."); // Callback start log
-    lastUserActivityTime = millis(); // MQTT message received is considered an activity
-    
-    char jsonString[length + 1]; // Buffer for JSON string
-    memcpy(jsonString, payload, length);
-    jsonString[length] = '\0';
-    // Serial.printf("mqttCallback: Received payload (len %u): %s\n", length, jsonString); // Payload log
-
-    Serial.printf("MQTT TOPIC [%s]: %s\n", topic, jsonString);
-    if (jsonString) {
-        // Log the received JSON message
-        utils.playDoubleTone();
-    } else {
+    if (length == 0) {
         Serial.println("MQTT: Received empty or null payload.");
-        return; // Exit if payload is empty
+        return;
     }
 
-    processJsonMessage(jsonString);
-    // Serial.println("mqttCallback: Exiting function."); // Callback end log
+    Serial.printf("MQTT TOPIC [%s]: %.*s\n", topic, (int)length, (const char*)payload);
+    inputManager.postMqttMessage(payload, length);
 }
 
 
@@ -1287,7 +1424,7 @@ void setupTime() {
  * @brief Executes the run() method of the currently active display mode.
  * 
  * Routes execution to the appropriate mode handler based on currentMode.
- * Also processes any pending IR commands received by the IRManager.
+ * Also queues any pending IR command received by the IRManager.
  * Handles unknown modes by switching back to clock mode as fallback.
  */
 void updateCurrentMode() {
@@ -1307,11 +1444,10 @@ void updateCurrentMode() {
             break;
     }
 
-    // Check and process new IR commands received by IRManager
+    // Post new IR commands received by IRManager into the input event stream
     if (irManager.hasNewCommand()) {
-        lastUserActivityTime = millis(); // User sent an IR command
-        handleIRCommand(irManager.getLastCommand());
-        irManager.clearCommand(); // Clear command flag after processing
+        inputManager.postIRCommand(irManager.getLastCommand(), irManager.getLastCommandTime());
+        irManager.clearCommand(); // Clear command flag once queued
     }
 }
 
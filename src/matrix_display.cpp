@@ -0,0 +1,75 @@
+/**
+ * @file matrix_display.cpp
+ * @brief Implementation of the chained-panel display surface
+ */
+
+#include "matrix_display.h"
+
+MatrixDisplay::MatrixDisplay(MatrixPanel_I2S_DMA* driver, uint8_t panelRows, uint8_t panelCols,
+                             PANEL_CHAIN_TYPE chainType, int xOffset)
+    : VirtualMatrixPanel_T<CHAIN_RUNTIME>(panelRows, panelCols, MATRIX_WIDTH, MATRIX_HEIGHT),
+      m_driver(driver), m_panelRows(panelRows), m_panelCols(panelCols),
+      m_columns(panelCols * MATRIX_WIDTH), m_columnLut(nullptr)
+{
+    setDisplay(*driver);
+    setChainType(chainType);
+
+    // Column offset is a property of each panel, so it wraps within the panel rather than the wall
+    m_columnLut = new uint16_t[m_columns];
+    for (uint16_t x = 0; x < m_columns; x++) {
+        int panelX = x % MATRIX_WIDTH;
+        int shifted = ((panelX + xOffset) % MATRIX_WIDTH + MATRIX_WIDTH) % MATRIX_WIDTH;
+        m_columnLut[x] = (x - panelX) + shifted;
+    }
+
+    if (!setRemapTable(true)) {
+        Serial.println("MatrixDisplay: Not enough memory for the remap table, using per-pixel mapping");
+    }
+}
+
+MatrixDisplay::~MatrixDisplay() {
+    delete[] m_columnLut;
+}
+
+void MatrixDisplay::drawPixel(int16_t x, int16_t y, uint16_t color) {
+    if ((uint16_t)x >= m_columns) return;
+    VirtualMatrixPanel_T<CHAIN_RUNTIME>::drawPixel(m_columnLut[x], y, color);
+}
+
+void MatrixDisplay::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    if (x < 0) { w += x; x = 0; }
+    if (x + w > m_columns) w = m_columns - x;
+
+    // The offset rotates the columns of each panel, so a span stays contiguous up to a panel edge or the wrap point
+    while (w > 0) {
+        int16_t n = 1;
+        while (n < w && m_columnLut[x + n] == m_columnLut[x] + n) n++;
+        VirtualMatrixPanel_T<CHAIN_RUNTIME>::drawFastHLine(m_columnLut[x], y, n, color);
+        x += n;
+        w -= n;
+    }
+}
+
+void MatrixDisplay::scrollLeft(int16_t x, int16_t y, int16_t w, int16_t h) {
+    if (x < 0) { w += x; x = 0; }
+    if (x + w > m_columns) w = m_columns - x;
+    if (y < 0) { h += y; y = 0; }
+    if (y + h > height()) h = height() - y;
+    if (w <= 0 || h <= 0) return;
+
+    for (int16_t row = y; row < y + h; row++) {
+        // Each electrical position is looked up once: it is the source of one move and the target of the next
+        calcPhysicalToElectricalCoords(m_columnLut[x], row);
+        VirtualCoords dst = coords;
+        for (int16_t col = x + 1; col < x + w; col++) {
+            calcPhysicalToElectricalCoords(m_columnLut[col], row);
+            m_driver->movePixelDMA(coords.x, coords.y, dst.x, dst.y);
+            dst = coords;
+        }
+    }
+}
+
+void MatrixDisplay::drawPixelRGB888(int16_t x, int16_t y, uint8_t r, uint8_t g, uint8_t b) {
+    if ((uint16_t)x >= m_columns) return;
+    VirtualMatrixPanel_T<CHAIN_RUNTIME>::drawPixelRGB888(m_columnLut[x], y, r, g, b);
+}
@@ -10,7 +10,7 @@
 #include "font_manager.h"
 #include "common.h"
 #include "utils.h"
-#include <ESP32-HUB75-MatrixPanel-I2S-DMA.h>
+#include "matrix_display.h"
 
 // Static color constants for time period themes
 const uint16_t ModeClock::COLOR_ERROR = Utils::hexToRgb565(0xFF0000);      // Red for errors
@@ -22,7 +22,7 @@ const uint16_t ModeClock::COLOR_NIGHT = Utils::hexToRgb565(0x808080);      // Gr
 /**
  * @doc Initializes clock display mode with required dependencies.
  */
-void ModeClock::setup(Utils* utils_ptr, MatrixPanel_I2S_DMA* matrix_ptr) {
+void ModeClock::setup(Utils* utils_ptr, MatrixDisplay* matrix_ptr) {
     m_utils = utils_ptr;
     m_matrix = matrix_ptr;
     lastUpdate = 0;
@@ -165,13 +165,13 @@ void ModeClock::drawSecondBar() {
     
     // Clear the entire progress bar area
     for (int x = startX; x <= endX; x++) {
-        m_matrix->drawPixel(setPhysicalX(x), 62, m_utils->hexToRgb565(0x000000));
+        m_matrix->drawPixel(x, 62, m_utils->hexToRgb565(0x000000));
     }
     
     // Draw gradient-colored progress bar
     for (int x = 0; x < barWidth; x++) {
         uint16_t gradientColor = getGradientColor(x, barPixels);
-        m_matrix->drawPixel(setPhysicalX(startX + x), 62, gradientColor);
+        m_matrix->drawPixel(startX + x, 62, gradientColor);
     }
 }
 
@@ -349,7 +349,7 @@ void ModeClock::drawColonOnly() {
     uint16_t timeColor = getTimeBasedColor();
     
     m_matrix->setTextColor(showColon ? timeColor : 0x0000);
-    m_matrix->setCursor(setPhysicalX(colonX), 33);
+    m_matrix->setCursor(colonX, 33);
     m_matrix->print(':');
     
     // Reset to default font
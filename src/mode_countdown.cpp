@@ -1,7 +1,7 @@
 #include "mode_countdown.h"
 #include "common.h"
 #include "utils.h"
-#include <ESP32-HUB75-MatrixPanel-I2S-DMA.h>
+#include "matrix_display.h"
 #include <Adafruit_PixelDust.h>
 #include <Adafruit_LIS3DH.h>
 #include <Adafruit_Sensor.h>
@@ -20,7 +20,7 @@ uint16_t colors[N_COLORS];
 uint32_t prevTime = 0; // Used for frames-per-second throttle - EXACTLY like Adafruit example
 // bool independantSandboxEnable = false; // REMOVE THIS GLOBAL VARIABLE
 
-void ModeCountdown::setup(Utils* utils_ptr, MatrixPanel_I2S_DMA* matrix_ptr) {
+void ModeCountdown::setup(Utils* utils_ptr, MatrixDisplay* matrix_ptr) {
     m_utils = utils_ptr;
     m_matrix = matrix_ptr;
 
@@ -158,10 +158,9 @@ void ModeCountdown::sandBox() {
         
         // sim_y will have values from 0 to sandSimHeight-1
         // Assume PixelDust library returns valid coordinates
-        // Assume X-axis correction with (sim_x + 1) % MATRIX_WIDTH is already applied
         if(sim_x >= 0 && sim_x < MATRIX_WIDTH && sim_y >= 0 && sim_y < sandSimHeight) {
-            // Apply global X_OFFSET for physical display and wrap around
-            dimension_t screen_x_corrected = setPhysicalX(sim_x);
+            // MatrixDisplay applies the panel column offset
+            dimension_t screen_x_corrected = sim_x;
             dimension_t screen_y_to_draw = sim_y + sand_draw_offset_y;
 
             // Safety check: ensure screen_y_to_draw does not exceed actual matrix height
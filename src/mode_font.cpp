@@ -2,13 +2,13 @@
 #include "font_manager.h"
 #include "common.h"
 #include "utils.h"
-#include <ESP32-HUB75-MatrixPanel-I2S-DMA.h>
+#include "matrix_display.h"
 
 static const char* const SAMPLE_TEXT_CONTENT = "ABCXYZ123890!@#$";
 const int SAMPLE_TEXT_Y_POS = 22; // Y position for the sample text
 const unsigned long SCROLL_INTERVAL_MS = 50; // Scroll speed in milliseconds
 
-void ModeFont::setup(Utils* utils_ptr, MatrixPanel_I2S_DMA* matrix_ptr) {
+void ModeFont::setup(Utils* utils_ptr, MatrixDisplay* matrix_ptr) {
     m_utils = utils_ptr;
     m_matrix = matrix_ptr;
     
@@ -38,7 +38,7 @@ void ModeFont::run() {
             sampleTextScrollX--;
             // When text fully scrolled left (its right edge is at or past screen left edge)
             if (sampleTextScrollX + sampleTextWidth < 0) {
-                sampleTextScrollX = MATRIX_WIDTH - 3; // Reset to scroll in from physical X=62 (logical X=61)
+                sampleTextScrollX = m_matrix->width() - 3; // Reset to scroll in from the right mask edge
             }
             lastSampleTextScrollTime = currentTime;
         }
@@ -54,7 +54,7 @@ void ModeFont::run() {
         if (currentTime - lastFontNameScrollTime >= SCROLL_INTERVAL_MS) {
             fontNameScrollX--;
             if (fontNameScrollX + fontNameWidth < 0) {
-                fontNameScrollX = MATRIX_WIDTH - 3; // Reset to scroll in from physical X=62 (logical X=61)
+                fontNameScrollX = m_matrix->width() - 3; // Reset to scroll in from the right mask edge
             }
             lastFontNameScrollTime = currentTime;
         }
@@ -89,7 +89,7 @@ void ModeFont::displayFont() {
     if (m_utils) {
         m_utils->setCursorTopBased(currentFontNameX, 4, false);
     } else {
-        m_matrix->setCursor(setPhysicalX(currentFontNameX), 4); // Fallback
+        m_matrix->setCursor(currentFontNameX, 4); // Fallback
     }
     m_matrix->print(fontInfo.name);
     
@@ -112,7 +112,7 @@ void ModeFont::displayFont() {
     if (m_utils) {
         m_utils->setCursorTopBased(currentSampleTextX, SAMPLE_TEXT_Y_POS, true);
     } else {
-        m_matrix->setCursor(setPhysicalX(currentSampleTextX), SAMPLE_TEXT_Y_POS); // Fallback
+        m_matrix->setCursor(currentSampleTextX, SAMPLE_TEXT_Y_POS); // Fallback
     }
     m_matrix->print(SAMPLE_TEXT_CONTENT);
     
@@ -127,24 +127,20 @@ void ModeFont::displayFont() {
     int16_t x1_idx, y1_idx; // Renamed to avoid conflict
     uint16_t w_idx, h_idx;  // Renamed to avoid conflict
     m_matrix->getTextBounds(indexStr, 0, 0, &x1_idx, &y1_idx, &w_idx, &h_idx);
-    int indexX = MATRIX_WIDTH - w_idx - 2; // 2px margin from right
+    int indexX = m_matrix->width() - w_idx - 2; // 2px margin from right
     if (indexX < 0) indexX = 0; // Prevent negative X, ensure it's at least 0
 
     if (m_utils) {
         m_utils->setCursorTopBased(indexX, 54, false);
     } else {
-        m_matrix->setCursor(setPhysicalX(indexX), 54); // Fallback
+        m_matrix->setCursor(indexX, 54); // Fallback
     }
     m_matrix->print(indexStr);
 
-    // Apply masks to ensure scrolling text is only visible in logical X=2 to X=61.
-    // MATRIX_X_OFFSET is assumed to be 1 as per config.h.
-    // Physical columns 0, 1, 2 should be black.
-    // Physical column 63 should be black.
-    // Text visible physical columns: 3 to 62.
-
-    m_matrix->fillRect(0, 0, 2 + MATRIX_X_OFFSET, MATRIX_HEIGHT, 0); // Left border (blacks out physical 0, 1, 2 if MATRIX_X_OFFSET=1)
-    m_matrix->fillRect(MATRIX_WIDTH - 1, 0, 1, MATRIX_HEIGHT, 0);    // Right border (blacks out physical 63 if MATRIX_WIDTH=64)
+    // Apply masks to ensure scrolling text is only visible in logical X=2 to X=width-3.
+    // Coordinates are logical, MatrixDisplay applies MATRIX_X_OFFSET.
+    m_matrix->fillRect(0, 0, 2, m_matrix->height(), 0);                      // Left border
+    m_matrix->fillRect(m_matrix->width() - 2, 0, 2, m_matrix->height(), 0);  // Right border
 
     if (m_utils) {
         m_utils->displayShow();
@@ -180,7 +176,7 @@ void ModeFont::updateFontMetricsAndScrollState() {
     m_matrix->getTextBounds(SAMPLE_TEXT_CONTENT, 0, 0, &st_x1, &st_y1, &st_w, &st_h);
     sampleTextWidth = st_w;
 
-    if (FONT_SAMPLE_TEXT_SCROLL_ENABLED && sampleTextWidth > MATRIX_WIDTH) {
+    if (FONT_SAMPLE_TEXT_SCROLL_ENABLED && sampleTextWidth > m_matrix->width()) {
         isSampleTextScrolling = true;
         // sampleTextScrollX will be set to 2 for initial display, then scroll.
     } else {
@@ -200,7 +196,7 @@ void ModeFont::updateFontMetricsAndScrollState() {
     m_matrix->getTextBounds(fontInfo.name, 0, 0, &fn_x1, &fn_y1, &fn_w, &fn_h);
     fontNameWidth = fn_w;
 
-    if (FONT_NAME_SCROLL_ENABLED && fontNameWidth > MATRIX_WIDTH) {
+    if (FONT_NAME_SCROLL_ENABLED && fontNameWidth > m_matrix->width()) {
         isFontNameScrolling = true;
         // fontNameScrollX will be set to 2 for initial display, then scroll.
     } else {
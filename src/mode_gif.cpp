@@ -24,7 +24,7 @@ ModeGIF::~ModeGIF() {
  * @param utils_ptr Pointer to utility functions
  * @param matrix_ptr Pointer to the LED matrix display
  */
-void ModeGIF::setup(Utils* utils_ptr, MatrixPanel_I2S_DMA* matrix_ptr) {
+void ModeGIF::setup(Utils* utils_ptr, MatrixDisplay* matrix_ptr) {
     // Serial.println("Setting up GIF Mode");  // DEBUG
     
     m_utils = utils_ptr;
@@ -26,6 +26,8 @@ ModeImage::ModeImage() {
     isInitialized = false;
     imageLoaded = false;
     imageBuffer = nullptr;
+    bufferWidth = 0;
+    bufferHeight = 0;
     imageWidth = 0;
     imageHeight = 0;
     displayWidth = 0;
@@ -49,7 +51,7 @@ ModeImage::~ModeImage() {
  * @param utils_ptr Pointer to utility functions and display management
  * @param matrix_ptr Pointer to LED matrix panel interface
  */
-void ModeImage::setup(Utils* utils_ptr, MatrixPanel_I2S_DMA* matrix_ptr) {
+void ModeImage::setup(Utils* utils_ptr, MatrixDisplay* matrix_ptr) {
     Serial.println("Setting up Image Mode");
 
     m_utils = utils_ptr;
@@ -68,7 +70,9 @@ void ModeImage::setup(Utils* utils_ptr, MatrixPanel_I2S_DMA* matrix_ptr) {
     }
     
     // Allocate RGB565 frame buffer for image processing
-    imageBuffer = (uint16_t*)malloc(MATRIX_WIDTH * MATRIX_HEIGHT * sizeof(uint16_t));
+    bufferWidth = m_matrix->width();
+    bufferHeight = m_matrix->height();
+    imageBuffer = (uint16_t*)malloc(bufferWidth * bufferHeight * sizeof(uint16_t));
     if (!imageBuffer) {
         Serial.println("Image Mode: Failed to allocate image buffer");
         return;
@@ -256,7 +260,7 @@ bool ModeImage::loadImage(ImageContentType imageType) {
                  displayWidth, displayHeight, offsetX, offsetY, scaleX, scaleY);
     
     // Initialize image buffer with transparent/black pixels
-    memset(imageBuffer, 0, MATRIX_WIDTH * MATRIX_HEIGHT * sizeof(uint16_t));
+    memset(imageBuffer, 0, bufferWidth * bufferHeight * sizeof(uint16_t));
     Serial.println("LoadImage: Image buffer cleared.");
 
     uint8_t* tempRawBuffer = nullptr;
@@ -325,7 +329,7 @@ bool ModeImage::loadImage(ImageContentType imageType) {
 
                     // Extract and convert pixel color
                     uint16_t rgb565 = getPixelColor(tempRawBuffer, sourceX, sourceY, imageWidth, pixelType, bpp);
-                    imageBuffer[(offsetY + y) * MATRIX_WIDTH + (offsetX + x)] = rgb565;
+                    imageBuffer[(offsetY + y) * bufferWidth + (offsetX + x)] = rgb565;
                 }
             }
             
@@ -367,19 +371,19 @@ void ModeImage::renderImage() {
             // Calculate logical buffer coordinates
             int logicalY = offsetY + y;
             int logicalX = offsetX + x;
-            int bufferIndex = logicalY * MATRIX_WIDTH + logicalX;
+            int bufferIndex = logicalY * bufferWidth + logicalX;
             
             // Bounds check for buffer access
-            if (bufferIndex < 0 || bufferIndex >= (MATRIX_WIDTH * MATRIX_HEIGHT)) continue;
+            if (bufferIndex < 0 || bufferIndex >= (bufferWidth * bufferHeight)) continue;
             
             uint16_t pixel = imageBuffer[bufferIndex];
             
             // Only render non-transparent pixels
             if (pixel != 0x0000) {
                 // Validate physical display coordinates
-                if (logicalX >= 0 && logicalX < MATRIX_WIDTH && 
-                    logicalY >= 0 && logicalY < MATRIX_HEIGHT) {
-                    m_matrix->drawPixel(setPhysicalX(logicalX), logicalY, pixel);
+                if (logicalX >= 0 && logicalX < bufferWidth && 
+                    logicalY >= 0 && logicalY < bufferHeight) {
+                    m_matrix->drawPixel(logicalX, logicalY, pixel);
                 }
             }
         }
@@ -406,13 +410,13 @@ void ModeImage::displayInfo() {
     
     // Display mode name (centered)
     String modeName = "IMAGE";
-    int x = m_utils->calculateTextCenterX(modeName.c_str(), MATRIX_WIDTH);
+    int x = m_utils->calculateTextCenterX(modeName.c_str(), m_matrix->width());
     m_matrix->setCursor(x, 20);
     m_matrix->print(modeName);
     
     // Display current image name (centered)
     String imageName = getImageDisplayName(currentImage);
-    x = m_utils->calculateTextCenterX(imageName.c_str(), MATRIX_WIDTH);
+    x = m_utils->calculateTextCenterX(imageName.c_str(), m_matrix->width());
     m_matrix->setCursor(x, 35);
     m_matrix->print(imageName);
     
@@ -425,10 +429,10 @@ void ModeImage::displayInfo() {
  */
 void ModeImage::calculateDisplayParameters() {
     // Calculate initial scaling factors
-    float calculatedScaleX = (float)MATRIX_WIDTH / imageWidth;
-    float calculatedScaleY = (float)MATRIX_HEIGHT / imageHeight;
+    float calculatedScaleX = (float)bufferWidth / imageWidth;
+    float calculatedScaleY = (float)bufferHeight / imageHeight;
     
-    if (imageWidth <= MATRIX_WIDTH && imageHeight <= MATRIX_HEIGHT) {
+    if (imageWidth <= bufferWidth && imageHeight <= bufferHeight) {
         // Image fits within matrix dimensions - no scaling needed
         this->scaleX = 1.0f;
         this->scaleY = 1.0f;
@@ -443,8 +447,8 @@ void ModeImage::calculateDisplayParameters() {
     displayHeight = (int)(imageHeight * this->scaleY);
     
     // Calculate centering offsets
-    offsetX = (MATRIX_WIDTH - displayWidth) / 2;
-    offsetY = (MATRIX_HEIGHT - displayHeight) / 2;
+    offsetX = (bufferWidth - displayWidth) / 2;
+    offsetY = (bufferHeight - displayHeight) / 2;
     
     // Hardware offset correction is applied during rendering, not here
     useMatrixXOffset = true;
@@ -466,10 +470,10 @@ void ModeImage::drawPixels(int y, int width, uint8_t *pixels, int pixelType, int
     
     // Calculate target display row with vertical offset
     int displayY = offsetY + y;
-    if (displayY < 0 || displayY >= MATRIX_HEIGHT) return;
+    if (displayY < 0 || displayY >= bufferHeight) return;
 
     // Determine processing bounds for current line
-    int pixelsToProcess = std::min((int)imageWidth, MATRIX_WIDTH);
+    int pixelsToProcess = std::min((int)imageWidth, (int)bufferWidth);
     pixelsToProcess = std::min(pixelsToProcess, width);
 
     // Calculate source pixel format byte size
@@ -485,7 +489,7 @@ void ModeImage::drawPixels(int y, int width, uint8_t *pixels, int pixelType, int
         int displayX = offsetX + x;
         
         // Skip pixels outside matrix bounds
-        if (displayX < 0 || displayX >= MATRIX_WIDTH) continue;
+        if (displayX < 0 || displayX >= bufferWidth) continue;
         
         // Extract raw pixel data for current position
         uint8_t* currentPixelData = pixels + (x * bytesPerSourcePixel);
@@ -524,8 +528,8 @@ void ModeImage::drawPixels(int y, int width, uint8_t *pixels, int pixelType, int
         }
         
         // Store converted pixel in image buffer
-        size_t bufferIndex = (size_t)displayY * MATRIX_WIDTH + displayX;
-        if (bufferIndex < (MATRIX_WIDTH * MATRIX_HEIGHT)) {
+        size_t bufferIndex = (size_t)displayY * bufferWidth + displayX;
+        if (bufferIndex < (size_t)(bufferWidth * bufferHeight)) {
             imageBuffer[bufferIndex] = rgb565;
         }
     }
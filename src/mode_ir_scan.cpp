@@ -2,7 +2,12 @@
 #include "common.h"
 #include "utils.h"
 #include "ir_manager.h"
-#include <ESP32-HUB75-MatrixPanel-I2S-DMA.h>
+#include "matrix_display.h"
+#include <LittleFS.h>
+
+// IR_KEYS_FILE layout: 'I' 'R' 'K' version, key count, then per key the command
+// byte, the name length and the name without terminator (2 + name bytes per key)
+static const uint8_t KEYS_FILE_MAGIC[4] = {'I', 'R', 'K', 1};
 
 /**
  * @brief Constructor for ModeIRScan class
@@ -10,7 +15,8 @@
  * Initializes the IR scan mode with default values and prepares
  * the learning key storage array.
  */
-ModeIRScan::ModeIRScan() : m_irManager(nullptr), selectedMode(YAHBOOM_BLOCKING_MODE), 
+ModeIRScan::ModeIRScan() : m_irManager(nullptr), selectedMode(NEC_NON_BLOCKING_MODE), 
+                           scanArmed(false), previousReceiveMode(IRManager::IRReceiveMode::NEC_NON_BLOCKING),
                            isFirstRun(true), duplicateIRCode(0) {
     totalLearnedKeys = 0;
     strcpy(currentKeyName, "");
@@ -20,85 +26,133 @@ ModeIRScan::ModeIRScan() : m_irManager(nullptr), selectedMode(YAHBOOM_BLOCKING_M
  * @brief Initialize the IR scan mode with required component references
  * 
  * Sets up the mode with pointers to utility functions, matrix display,
- * and IR manager. Initializes all internal state variables and storage arrays.
+ * and IR manager. Initializes all internal state variables and loads the
+ * keys learned in earlier sessions from IR_KEYS_FILE.
  */
-void ModeIRScan::setup(Utils* utils_ptr, MatrixPanel_I2S_DMA* matrix_ptr, IRManager* irManager_ptr) {
+void ModeIRScan::setup(Utils* utils_ptr, MatrixDisplay* matrix_ptr, IRManager* irManager_ptr) {
     m_utils = utils_ptr;
     m_matrix = matrix_ptr;
     m_irManager = irManager_ptr;
     
     learningState = READY;
-    selectedMode = YAHBOOM_BLOCKING_MODE; 
+    displayedState = READY;
+    // NEC는 loop를 막지 않음. YAHBOOM은 MODE 1로 선택 가능하지만 수신 대기 중 loop가 최대 100ms씩 멈춤
+    selectedMode = NEC_NON_BLOCKING_MODE; 
+    scanArmed = false;
+    isFirstRun = true;
     totalLearnedKeys = 0;
     
     // Initialize input buffer for real-time processing
     bufferIndex = 0;
     inputBuffer[0] = '\0';
+    lastWasCR = false;
     
-    // Initialize IR scan state management
-    scanState = ScanState::WAITING_FOR_INPUT;
+    // Initialize IR scan timing
     scanStartTime = 0;
-    irScanInitiated = false;
 
     // Initialize learned key storage array
-    for (int i = 0; i < 50; i++) {
+    for (int i = 0; i < IR_LEARN_MAX_KEYS; i++) {
         keys[i].isValid = false;
         strcpy(keys[i].keyName, "");
         keys[i].irCode = 0;
     }
+    loadKeys();
 
     Serial.println("IR Scan mode ready.");
 }
 
+/**
+ * @brief Load learned keys at boot and apply the ones that name a remote key
+ * 
+ * A learned key called like an IR_CODE_MAP entry (UP, LEFT, 1, ...) replaces
+ * that entry's code, so the name lookup happens here once and dispatch stays
+ * a table lookup.
+ */
+void ModeIRScan::applyLearnedKeys(IRManager* irManager_ptr) {
+    m_irManager = irManager_ptr;
+    totalLearnedKeys = 0;
+    for (int i = 0; i < IR_LEARN_MAX_KEYS; i++) {
+        keys[i].isValid = false;
+        strcpy(keys[i].keyName, "");
+        keys[i].irCode = 0;
+    }
+    if (!loadKeys()) {
+        return;
+    }
+    for (int i = 0; i < IR_LEARN_MAX_KEYS; i++) {
+        applyKey(i);
+    }
+}
+
+/**
+ * @brief Point the IR manager's remote key of the same name at a learned code
+ */
+void ModeIRScan::applyKey(int index) {
+    if (!m_irManager || !keys[index].isValid) {
+        return;
+    }
+    IRKey key = m_irManager->keyForName(keys[index].keyName);
+    if (key != IR_KEY_NONE) {
+        m_irManager->remapKey(key, (uint8_t)keys[index].irCode);
+        Serial.printf("IR key %s remapped to 0x%02X\n", keys[index].keyName, keys[index].irCode);
+    }
+}
+
 /**
  * @brief Main execution loop for IR scan mode
  * 
- * Handles the initial display and guide on first run, then manages
- * different operational states including READY state for command input
- * and internal loop for active learning processes.
+ * Handles the initial display and guide on first run, then advances the
+ * learning state machine by one step: reads whatever serial input has
+ * arrived and checks the scan timeout. IR codes are delivered separately
+ * through handleIRCode(), so this never waits and returns to the main loop
+ * in every state.
  */
 void ModeIRScan::run() {
     if (isFirstRun) {
         // Display initial state and show usage guide on first execution
-        updateDisplay();
+        scanProcessDisplay("READY");
+        displayedState = learningState;
         showGuide();
         isFirstRun = false;
     }
 
-    if (learningState == READY) {
-        // Handle READY state: Process serial input and receive IR signals from main loop
-        // Process real-time user input
+    if (learningState != EXIT_MODE) {
         handleRealTimeInput();
-        updateDisplay();
-    } else if (learningState != EXIT_MODE) {
-        // Enter internal loop only when transitioning from READY via SCAN command
-        // and not in a final EXIT state.
-        runInternalLoop();
     }
+
+    if (learningState == SCAN) {
+        checkScanTimeout();
+    }
+
+    // Any way out of SCAN (DONE, timeout, duplicate prompt, MODE ...) ends the scan
+    if (scanArmed && learningState != SCAN) {
+        stopIRScan();
+    }
+
+    updateDisplay();
 }
 
 /**
- * @brief Internal processing loop for active learning operations
+ * @brief Offer a decoded IR code from the input queue to the learning process
  * 
- * Continues processing until EXIT_MODE is reached, handling real-time input
- * and IR scanning operations with periodic display updates.
+ * In READY and EXIT states the code is left to the main loop, so the remote
+ * still switches modes. While learning, every code is consumed: in SCAN it
+ * is learned for the current key name, otherwise it is ignored.
  */
-void ModeIRScan::runInternalLoop() {
-    // Continue loop until EXIT_MODE is requested
-    while (learningState != EXIT_MODE && learningState != READY) {
-        handleRealTimeInput();
-        
-        if (learningState == SCAN) {
-            handleIRScan();
-        }
-        
-        updateDisplay();
-        delay(10);
+bool ModeIRScan::handleIRCode(uint32_t code) {
+    if (!isLearning()) {
+        return false;
     }
-    
-    if (learningState == EXIT_MODE) {
-        Serial.println("Exiting IR Scan internal loop...");
+
+    if (learningState != SCAN) {
+        Serial.printf("\nIR code 0x%02X ignored - not scanning.\n", code);
+        showPrompt();
+        return true;
     }
+
+    Serial.printf("\nIR code received: 0x%02X\n", code);
+    processReceivedCode(code);
+    return true;
 }
 
 /**
@@ -177,11 +231,7 @@ void ModeIRScan::handleKeyNameInput(const String& input) {
     if (isValidKeyName(input.c_str())) {
         strcpy(currentKeyName, input.c_str());
         learningState = SCAN;
-        
-        // Initialize scan state variables
-        scanState = ScanState::WAITING_FOR_INPUT;
-        scanStartTime = 0;
-        irScanInitiated = false;
+        startIRScan();
         
         Serial.printf("\nLearning '%s' - press IR button now\n", currentKeyName);
         updateDisplay();
@@ -212,7 +262,7 @@ void ModeIRScan::handleModeCommand() {
     learningState = MODE_SELECT;
     const char* currentModeStr = (selectedMode == YAHBOOM_BLOCKING_MODE) ? "YAHBOOM-Blocking" : "NEC-Non-blocking";
     Serial.printf("Current mode: %s\n", currentModeStr);
-    Serial.println("Select mode: 1=YAHBOOM-Blocking, 2=NEC-Non-blocking");
+    Serial.println("Select mode: 1=YAHBOOM-Blocking (stalls the loop up to 100ms), 2=NEC-Non-blocking");
     Serial.println("---------------------------------------------------------------------");
     showPrompt();
 }
@@ -263,92 +313,50 @@ void ModeIRScan::handleDuplicateChoice(const String& input) {
 }
 
 /**
- * @brief Main IR signal scanning and reception handler
+ * @brief Arm the IR receiver for the selected mode and start the scan timeout
  * 
- * Manages the IR scanning process using state machine logic to handle
- * both blocking and non-blocking IR reception modes with timeout handling.
+ * The main loop keeps reading the receiver in whichever mode is set here and
+ * posts decoded codes to the input queue, from where they reach handleIRCode().
  */
-void ModeIRScan::handleIRScan() {
-    if (!m_irManager) return;
-    
-    bool codeReceived = false;
-    uint32_t receivedCode = 0;
-    
-    // State-based scan control
-    switch (scanState) {
-        case ScanState::WAITING_FOR_INPUT:
-            // Initialize scan process
-            scanState = ScanState::SCANNING_IR;
-            scanStartTime = millis();
-            irScanInitiated = false;
-            // Fall through to SCANNING_IR
-            
-        case ScanState::SCANNING_IR:
-            if (selectedMode == YAHBOOM_BLOCKING_MODE) {
-                if (!irScanInitiated) {
-                    // Blocking mode: Initialize scan once
-                    m_irManager->setReceiveMode(IRManager::IRReceiveMode::YAHBOOM_BLOCKING);
-                    m_irManager->enableScanMode(true);
-                    m_irManager->clearCommand();
-                    irScanInitiated = true;
-                }
-                
-                // Check for timeout (10 seconds)
-                if (millis() - scanStartTime > 10000) {
-                    scanState = ScanState::WAITING_FOR_INPUT;
-                    irScanInitiated = false;
-                    learningState = KEY_INPUT;
-                    Serial.println("IR scan timeout. Ready for next key name.");
-                    showPrompt();
-                    return;
-                }
-                
-                // Check for received IR signal with short timeout
-                m_irManager->readRawCodeYahboom(100);
-                
-                if (m_irManager->hasNewCommand()) {
-                    receivedCode = m_irManager->getLastCommand();
-                    codeReceived = true;
-                    scanState = ScanState::PROCESSING_RESULT;
-                }
-            } else {
-                // NEC non-blocking mode
-                if (!irScanInitiated) {
-                    m_irManager->setReceiveMode(IRManager::IRReceiveMode::NEC_NON_BLOCKING);
-                    m_irManager->enableScanMode(true);
-                    irScanInitiated = true;
-                }
-                
-                // Check for timeout (10 seconds)
-                if (millis() - scanStartTime > 10000) {
-                    scanState = ScanState::WAITING_FOR_INPUT;
-                    irScanInitiated = false;
-                    learningState = KEY_INPUT;
-                    Serial.println("IR scan timeout. Ready for next key name.");
-                    showPrompt();
-                    return;
-                }
-                
-                m_irManager->updateReadNonBlocking();
-                
-                if (m_irManager->hasNewCommand()) {
-                    receivedCode = m_irManager->getLastCommand();
-                    codeReceived = true;
-                    Serial.printf("IR code (NEC) received: 0x%02X\n", receivedCode);
-                    scanState = ScanState::PROCESSING_RESULT;
-                }
-            }
-            break;
-            
-        case ScanState::PROCESSING_RESULT:
-            // Reset to waiting state after result processing
-            scanState = ScanState::WAITING_FOR_INPUT;
-            irScanInitiated = false;
-            break;
+void ModeIRScan::startIRScan() {
+    if (m_irManager) {
+        if (!scanArmed) {
+            previousReceiveMode = m_irManager->getCurrentReceiveMode();
+            scanArmed = true;
+        }
+        m_irManager->setReceiveMode(selectedMode == YAHBOOM_BLOCKING_MODE
+                                        ? IRManager::IRReceiveMode::YAHBOOM_BLOCKING
+                                        : IRManager::IRReceiveMode::NEC_NON_BLOCKING);
+        m_irManager->enableScanMode(true);
+        m_irManager->clearCommand();
     }
-    
-    if (codeReceived) {
-        processReceivedCode(receivedCode);
+    scanStartTime = millis();
+}
+
+/**
+ * @brief Disarm the IR receiver and restore the receive mode active before the scan
+ * 
+ * Called by run() as soon as the learning state leaves SCAN, and by cleanup().
+ */
+void ModeIRScan::stopIRScan() {
+    if (!scanArmed) {
+        return;
+    }
+    scanArmed = false;
+    if (m_irManager) {
+        m_irManager->enableScanMode(false);
+        m_irManager->setReceiveMode(previousReceiveMode);
+    }
+}
+
+/**
+ * @brief Return to key name input when no IR code arrived in time
+ */
+void ModeIRScan::checkScanTimeout() {
+    if (millis() - scanStartTime > IR_LEARN_TIMEOUT_MS) {
+        learningState = KEY_INPUT;
+        Serial.println("IR scan timeout. Ready for next key name.");
+        showPrompt();
     }
 }
 
@@ -359,9 +367,6 @@ void ModeIRScan::handleIRScan() {
  * storing the new key or prompting for confirmation to overwrite existing keys.
  */
 void ModeIRScan::processReceivedCode(uint32_t code) {
-    // Clear IR command immediately after processing to prevent reprocessing in main loop
-    m_irManager->clearCommand();
-    
     // Check for duplicate IR codes
     if (isDuplicateCode(code)) {
         Serial.printf("Warning: Code 0x%02X already exists!\n", code);
@@ -383,10 +388,6 @@ void ModeIRScan::processReceivedCode(uint32_t code) {
     // Continue SCAN mode: Return to KEY_INPUT state for next key name
     learningState = KEY_INPUT;
     
-    // Reset scan state variables
-    scanState = ScanState::WAITING_FOR_INPUT;
-    irScanInitiated = false;
-    
     updateDisplay();
     showPrompt();
 }
@@ -395,7 +396,7 @@ void ModeIRScan::processReceivedCode(uint32_t code) {
  * @brief Store a learned IR key in the internal storage array
  * 
  * Stores the provided key name and IR code, either updating an existing
- * key or creating a new entry if space is available.
+ * key or creating a new entry if space is available, and saves the table.
  */
 bool ModeIRScan::storeKey(const char* keyName, uint32_t irCode) {
     int index = findKeyIndex(keyName);
@@ -415,6 +416,8 @@ bool ModeIRScan::storeKey(const char* keyName, uint32_t irCode) {
     keys[index].irCode = irCode;
 
     Serial.printf("Key '%s' stored with code 0x%02X\n", keys[index].keyName, keys[index].irCode);
+    saveKeys();
+    applyKey(index);
     return true;
 }
 
@@ -449,7 +452,7 @@ bool ModeIRScan::isValidKeyName(const char* keyName) {
  * Returns the index if found, -1 if not found.
  */
 int ModeIRScan::findKeyIndex(const char* keyName) {
-    for (int i = 0; i < 50; i++) {
+    for (int i = 0; i < IR_LEARN_MAX_KEYS; i++) {
         if (keys[i].isValid && strcasecmp(keys[i].keyName, keyName) == 0) {
             return i;
         }
@@ -464,7 +467,7 @@ int ModeIRScan::findKeyIndex(const char* keyName) {
  * a new learned key. Returns the index if found, -1 if storage is full.
  */
 int ModeIRScan::findEmptySlot() {
-    for (int i = 0; i < 50; i++) {
+    for (int i = 0; i < IR_LEARN_MAX_KEYS; i++) {
         if (!keys[i].isValid) {
             return i;
         }
@@ -479,7 +482,7 @@ int ModeIRScan::findEmptySlot() {
  * IR code has already been stored.
  */
 bool ModeIRScan::isDuplicateCode(uint32_t irCode) {
-    for (int i = 0; i < 50; i++) {
+    for (int i = 0; i < IR_LEARN_MAX_KEYS; i++) {
         if (keys[i].isValid && keys[i].irCode == irCode) {
             return true;
         }
@@ -519,13 +522,13 @@ void ModeIRScan::showSummary() {
     if (totalLearnedKeys == 0) {
         Serial.println("No keys learned yet.");
     } else {
-        for (int i = 0; i < 50; i++) {
+        for (int i = 0; i < IR_LEARN_MAX_KEYS; i++) {
             if (keys[i].isValid) {
                 Serial.printf("    %s = 0x%02X\n", keys[i].keyName, keys[i].irCode);
             }
         }
     }
-    Serial.printf("Total: %d/50\n", totalLearnedKeys);
+    Serial.printf("Total: %d/%d\n", totalLearnedKeys, IR_LEARN_MAX_KEYS);
     showPrompt();
 }
 
@@ -545,7 +548,7 @@ void ModeIRScan::updateCodes() {
     if (totalLearnedKeys == 0) {
         Serial.println("No keys to update.");
     } else {
-        for (int i = 0; i < 50; i++) {
+        for (int i = 0; i < IR_LEARN_MAX_KEYS; i++) {
             if (keys[i].isValid && keys[i].irCode != 0) {
                 Serial.printf("#define IR_%s    0x%02X                    // %s button code\n", 
                     keys[i].keyName, keys[i].irCode, keys[i].keyName);
@@ -568,22 +571,106 @@ void ModeIRScan::updateCodes() {
  * @brief Clear all learned IR keys from storage
  * 
  * Resets the entire learned keys array and counter, effectively
- * clearing all previously stored IR key mappings.
+ * clearing all previously stored IR key mappings, in IR_KEYS_FILE and
+ * the IR manager's code table too.
  */
 void ModeIRScan::clearKeys() {
     // Reset all key storage slots
-    for (int i = 0; i < 50; i++) {
+    for (int i = 0; i < IR_LEARN_MAX_KEYS; i++) {
         keys[i].isValid = false;
         strcpy(keys[i].keyName, "");
         keys[i].irCode = 0;
     }
     totalLearnedKeys = 0;
+    saveKeys();
+    if (m_irManager) {
+        m_irManager->resetToDefaults(); // Remote keys go back to their config.h codes
+    }
     
     Serial.println("All learned keys cleared.");
     m_utils->playSingleTone();
     showPrompt();
 }
 
+/**
+ * @brief Load learned keys from IR_KEYS_FILE
+ * 
+ * Expects the key slots to be empty. A missing file leaves them empty; a
+ * truncated or corrupt one is ignored as a whole.
+ */
+bool ModeIRScan::loadKeys() {
+    if (!LittleFS.exists(IR_KEYS_FILE)) {
+        return false;
+    }
+    File file = LittleFS.open(IR_KEYS_FILE, "r");
+    if (!file) {
+        return false;
+    }
+
+    uint8_t magic[sizeof(KEYS_FILE_MAGIC)];
+    uint8_t count = 0;
+    bool ok = file.read(magic, sizeof(magic)) == sizeof(magic) &&
+              memcmp(magic, KEYS_FILE_MAGIC, sizeof(magic)) == 0 &&
+              file.read(&count, 1) == 1 && count <= IR_LEARN_MAX_KEYS;
+
+    for (int i = 0; ok && i < count; i++) {
+        uint8_t head[2];    // command byte, name length
+        ok = file.read(head, 2) == 2 && head[1] < sizeof(keys[i].keyName) &&
+             file.read((uint8_t*)keys[i].keyName, head[1]) == head[1];
+        if (ok) {
+            keys[i].keyName[head[1]] = '\0';
+            keys[i].irCode = head[0];
+            ok = keys[i].isValid = isValidKeyName(keys[i].keyName);
+        }
+    }
+    file.close();
+
+    if (!ok) {
+        for (int i = 0; i < IR_LEARN_MAX_KEYS; i++) {
+            keys[i].isValid = false;
+            strcpy(keys[i].keyName, "");
+            keys[i].irCode = 0;
+        }
+        Serial.println("Ignoring invalid " IR_KEYS_FILE);
+        return false;
+    }
+
+    totalLearnedKeys = count;
+    Serial.printf("Loaded %d learned keys from " IR_KEYS_FILE "\n", totalLearnedKeys);
+    return true;
+}
+
+/**
+ * @brief Write learned keys to IR_KEYS_FILE
+ * 
+ * The table is written to a temporary file first and renamed over the old
+ * one, so a reset during the write leaves the previous table intact.
+ */
+bool ModeIRScan::saveKeys() {
+    File file = LittleFS.open(IR_KEYS_FILE ".tmp", "w");
+    if (!file) {
+        Serial.println("Failed to open " IR_KEYS_FILE " for writing.");
+        return false;
+    }
+
+    bool ok = file.write(KEYS_FILE_MAGIC, sizeof(KEYS_FILE_MAGIC)) == sizeof(KEYS_FILE_MAGIC) &&
+              file.write((uint8_t)totalLearnedKeys) == 1;
+    for (int i = 0; ok && i < IR_LEARN_MAX_KEYS; i++) {
+        if (!keys[i].isValid) continue;
+        uint8_t head[2] = {(uint8_t)keys[i].irCode, (uint8_t)strlen(keys[i].keyName)};
+        ok = file.write(head, 2) == 2 &&
+             file.write((const uint8_t*)keys[i].keyName, head[1]) == head[1];
+    }
+    file.close();
+
+    if (!ok || !LittleFS.rename(IR_KEYS_FILE ".tmp", IR_KEYS_FILE)) {
+        LittleFS.remove(IR_KEYS_FILE ".tmp");
+        Serial.println("Failed to save learned keys.");
+        return false;
+    }
+    return true;
+}
+
 /**
  * @brief Display appropriate input prompt based on current learning state
  * 
@@ -617,23 +704,24 @@ void ModeIRScan::showPrompt() {
 /**
  * @brief Update the LED matrix display with current operational status
  * 
- * Periodically updates the matrix display with the current learning state
- * to provide visual feedback to the user.
+ * Redraws the matrix when the learning state has changed since it was
+ * last shown, to provide visual feedback to the user.
  */
 void ModeIRScan::updateDisplay() {
-    static unsigned long lastUpdate = 0;
-    if (millis() - lastUpdate > 1000) {
-        const char* stateText = "READY";
-        switch (learningState) {
-            case SCAN: stateText = "SCAN"; break;
-            case KEY_INPUT: stateText = "INPUT"; break;
-            case MODE_SELECT: stateText = "MODE"; break;
-            case DUPLICATE_CONFIRM: stateText = "CONFIRM"; break;
-            case READY: stateText = "READY"; break;
-        }
-        scanProcessDisplay(stateText);
-        lastUpdate = millis();
+    if (learningState == displayedState) {
+        return;
     }
+    const char* stateText = "READY";
+    switch (learningState) {
+        case SCAN: stateText = "SCAN"; break;
+        case KEY_INPUT: stateText = "INPUT"; break;
+        case MODE_SELECT: stateText = "MODE"; break;
+        case DUPLICATE_CONFIRM: stateText = "CONFIRM"; break;
+        case READY: stateText = "READY"; break;
+        case EXIT_MODE: stateText = "DONE"; break;
+    }
+    scanProcessDisplay(stateText);
+    displayedState = learningState;
 }
 
 /**
@@ -673,6 +761,7 @@ void ModeIRScan::scanProcessDisplay(const char* phaseText) {
  */
 void ModeIRScan::cleanup() {
     Serial.println("IR Scan mode cleanup.");
+    stopIRScan();
     if (m_irManager) {
         // Clear any learned commands from IR scan mode
         m_irManager->clearCommand();
@@ -701,80 +790,68 @@ void ModeIRScan::cleanup() {
 /**
  * @brief Handle real-time keyboard input with immediate character echo
  * 
- * Processes individual characters from serial input, handling backspace,
+ * Processes the characters already in the serial buffer, handling backspace,
  * enter key, and printable characters. Provides immediate echo feedback
- * and processes complete lines when enter is pressed.
+ * and processes a complete line when enter is pressed. Returns as soon as
+ * the buffer is empty, never waiting for more input.
  */
 bool ModeIRScan::handleRealTimeInput() {
-    if (!Serial.available()) {
-        return false;
-    }
-    
-    char c = Serial.read();
-    
-    // Handle backspace and delete characters
-    if (c == '\b' || c == 127) {
-        if (bufferIndex > 0) {
-            bufferIndex--;
-            inputBuffer[bufferIndex] = '\0';
-            // Echo backspace sequence to terminal
-            Serial.print("\b \b");
+    while (Serial.available()) {
+        char c = Serial.read();
+        
+        // Handle backspace and delete characters
+        if (c == '\b' || c == 127) {
+            if (bufferIndex > 0) {
+                bufferIndex--;
+                inputBuffer[bufferIndex] = '\0';
+                // Echo backspace sequence to terminal
+                Serial.print("\b \b");
+            }
+            continue;
         }
-        return false;
-    }
-    
-    static bool lastWasCR = false;
 
-    // Handle enter key (newline or carriage return)
-    if (c == '\n' || c == '\r') {
-        // Skip LF if previous character was CR (Windows CR+LF handling)
-        if (c == '\n' && lastWasCR) {
-            lastWasCR = false;
-            return false;
+        // Handle enter key (newline or carriage return)
+        if (c == '\n' || c == '\r') {
+            // Skip LF if previous character was CR (Windows CR+LF handling)
+            if (c == '\n' && lastWasCR) {
+                lastWasCR = false;
+                continue;
+            }
+            
+            lastWasCR = (c == '\r');
+            
+            if (bufferIndex > 0) {
+                // Process completed input, leaving any further lines for the next run()
+                inputBuffer[bufferIndex] = '\0';
+                String input = String(inputBuffer);
+                input.trim();
+                input.toUpperCase();
+                
+                bufferIndex = 0;
+                inputBuffer[0] = '\0';
+                
+                processUserInput(input);
+                return true;
+            }
+            // Only output newline once
+            Serial.println();
+            continue;
         }
+        lastWasCR = false;
         
-        lastWasCR = (c == '\r');
-        
-        if (bufferIndex > 0) {
-            // Process completed input
+        // Handle printable ASCII characters
+        // Protect buffer overflow
+        if (c >= 32 && c <= 126 && bufferIndex < 63) {
+            inputBuffer[bufferIndex] = c;
+            bufferIndex++;
             inputBuffer[bufferIndex] = '\0';
-            String input = String(inputBuffer);
-            input.trim();
-            input.toUpperCase();
-            
+            Serial.print(c);
+        } else if (bufferIndex >= 63) {
+            // Buffer overflow warning
+            Serial.println("\nInput too long!");
             bufferIndex = 0;
             inputBuffer[0] = '\0';
-            
-            processUserInput(input);
-            return true;
-        } else {
-            // Only output newline once
-            Serial.println();
-            return false;
         }
     }
-    lastWasCR = false;
-    
-    // Handle printable ASCII characters
-    // Protect buffer overflow
-    if (c >= 32 && c <= 126 && bufferIndex < 63) {
-        inputBuffer[bufferIndex] = c;
-        bufferIndex++;
-        inputBuffer[bufferIndex] = '\0';
-        Serial.print(c);
-    } else if (bufferIndex >= 63) {
-        // Buffer overflow warning
-        Serial.println("\nInput too long!");
-        bufferIndex = 0;
-        inputBuffer[0] = '\0';
-    }
-
-    // Clarify the meaning of return values
-    if (bufferIndex > 0) {
-        // Process completed input
-        return true;
-    } else {
-        // Process empty input (newline only)
-        return false; 
-    }
+    return false;
 }
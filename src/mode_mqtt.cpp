@@ -4,10 +4,10 @@
 #include "common.h"
 #include "font_manager.h"
 #include "utils.h"
-#include <ESP32-HUB75-MatrixPanel-I2S-DMA.h> // For MatrixPanel_I2S_DMA
+#include "matrix_display.h"
 #include <ArduinoJson.h>
 
-void ModeMqtt::setup(Utils* utils_ptr, MatrixPanel_I2S_DMA* matrix_ptr) {
+void ModeMqtt::setup(Utils* utils_ptr, MatrixDisplay* matrix_ptr) {
     m_utils = utils_ptr;
     m_matrix = matrix_ptr;
 
@@ -79,7 +79,7 @@ void ModeMqtt::run() {
         // Clear right margin: from (scroll_text_physical_start_x + scroll_max_width) to MATRIX_WIDTH
         int scroll_text_physical_end_x = scroll_text_logical_start_x + scroll_max_width;
         if (scroll_text_physical_end_x < MATRIX_WIDTH) {
-            m_matrix->fillRect(setPhysicalX(scroll_text_physical_end_x), scroll_text_y,
+            m_matrix->fillRect(scroll_text_physical_end_x, scroll_text_y,
                                MATRIX_WIDTH - scroll_text_physical_end_x, scroll_display_height,
                                0); // Black
         }
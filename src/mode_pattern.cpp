@@ -1,62 +1,144 @@
 #include "mode_pattern.h" // Renamed from mode_animation.h
 #include "common.h"
 #include "utils.h"
-#include <ESP32-HUB75-MatrixPanel-I2S-DMA.h>
-
-// #include "Aurora/Boid.hpp" // Boid.hpp는 PatternFlock에서 사용될 수 있으므로 주석 처리 유지
+#include "matrix_display.h"
+#include <new>
+
+// Aurora patterns (only this file constructs them, through the registry below)
+#include "Aurora/PatternCube.hpp"
+#include "Aurora/PatternPlasma.hpp"
+#include "Aurora/PatternFlock.hpp"
+#include "Aurora/PatternSpiral.hpp"
+#include "Aurora/PatternNoiseSmearing.hpp"
+#include "Aurora/PatternStarfield.hpp"
+#include "Aurora/PatternIncrementalDrift.hpp"
+#include "Aurora/PatternIncrementalDrift2.hpp"
+#include "Aurora/PatternMunch.hpp"
+#include "Aurora/PatternPendulumWave.hpp"
+#include "Aurora/PatternSpiro.hpp"
+#include "Aurora/PatternWave.hpp"
+#include "Aurora/PatternRain.hpp"
+#include "Aurora/PatternJuliaSetFractal.hpp"
+#include "Aurora/PatternAttract.hpp"
+#include "Aurora/PatternBounce.hpp"
+#include "Aurora/PatternElectricMandala.hpp"
+#include "Aurora/PatternFlowField.hpp"
+#include "Aurora/PatternInfinity.hpp"
+#include "Aurora/PatternRadar.hpp"
+#include "Aurora/PatternSimplexNoise.hpp"
+#include "Aurora/PatternSnake.hpp"
+#include "Aurora/PatternSpin.hpp"
+#include "Aurora/PatternFireworks.hpp"
+#include "Aurora/PatternFireKoz.hpp"
+#include "Aurora/PatternSmoke.hpp"
+#include "Aurora/PatternMaze.hpp"
+#include "Aurora/PatternStardustBurst.hpp" // by GEMINI
+#include "Aurora/PatternGreenScroll.hpp"
+#include "Aurora/PatternTest.hpp"
 
 // Global EffectsLayer object definition
-// MATRIX_WIDTH and MATRIX_HEIGHT must be defined in common.h or config.h.
+// Starts at one panel (config.h), resized to the display in setup()
 EffectsLayer effects(MATRIX_WIDTH, MATRIX_HEIGHT);
 
 // AVAILABLE_BOID_COUNT must be defined in Boid.hpp or similar
 Boid boids[AVAILABLE_BOID_COUNT];
 
+// PATTERN REGISTRY
+// ============================================================================
+
+template <class P>
+static Drawable* createPattern() {
+    return new (std::nothrow) P();
+}
+
+// Patterns that also allocate in start() (FireKoz / Smoke's heat fields, Maze's arena) report only their object size
+template <class P>
+static constexpr PatternEntry registerPattern(const char* name) {
+    return { name, &createPattern<P>, sizeof(P) };
+}
+
+// Order is the 4.N numbering: keep existing entries where they are and append new ones
+static constexpr PatternEntry patternRegistry[] = {
+    registerPattern<PatternCube>("Cube"),                       // 4.1
+    registerPattern<PatternPlasma>("Plasma"),
+    registerPattern<PatternFlock>("Flock"),
+    registerPattern<PatternSpiral>("Spiral"),
+    registerPattern<PatternPaletteSmear>("PaletteSmear"),
+    registerPattern<PatternStarfield>("Starfield"),
+    registerPattern<PatternIncrementalDrift>("IncrDrift"),
+    registerPattern<PatternMunch>("Munch"),
+    registerPattern<PatternPendulumWave>("PendulumWave"),
+    registerPattern<PatternSpiro>("Spiro"),                     // 4.10
+    registerPattern<PatternWave>("Wave"),
+    registerPattern<PatternRain>("Rain"),
+    registerPattern<PatternJuliaSet>("JuliaSet"),
+    registerPattern<PatternAttract>("Attract"),
+    registerPattern<PatternBounce>("Bounce"),
+    registerPattern<PatternElectricMandala>("ElectricMandala"),
+    registerPattern<PatternFlowField>("FlowField"),
+    registerPattern<PatternInfinity>("Infinity"),
+    registerPattern<PatternRadar>("Radar"),
+    registerPattern<PatternSimplexNoise>("SimplexNoise"),       // 4.20
+    registerPattern<PatternSnake>("Snake"),
+    registerPattern<PatternSpin>("Spin"),
+    registerPattern<PatternFirework>("Fireworks"),
+    registerPattern<PatternFireKoz>("FireKoz"),
+    registerPattern<PatternMaze>("Maze"),
+    registerPattern<PatternStardustBurst>("StardustBurst"),
+    registerPattern<PatternIncrementalDrift2>("IncrDriftRose"),
+    registerPattern<PatternTheMatrix>("TheMatrix"),
+    registerPattern<PatternMultipleStream>("MultipleStream"),
+    registerPattern<PatternMultipleStream2>("MultipleStream2"), // 4.30
+    registerPattern<PatternMultipleStream3>("MultipleStream3"),
+    registerPattern<PatternMultipleStream4>("MultipleStream4"),
+    registerPattern<PatternMultipleStream5>("MultipleStream5"),
+    registerPattern<PatternMultipleStream8>("MultipleStream8"),
+    registerPattern<PatternRainbowFlag>("RainbowFlag"),
+    registerPattern<PatternTest>("Test"),
+    registerPattern<PatternSmoke>("Smoke"),
+};
+
+static constexpr int PATTERN_COUNT = sizeof(patternRegistry) / sizeof(patternRegistry[0]);
+static_assert(PATTERN_COUNT > 0, "Pattern registry is empty");
+
+int ModePattern::patternCount() {
+    return PATTERN_COUNT;
+}
+
+const PatternEntry& ModePattern::patternEntry(int index) {
+    return patternRegistry[(unsigned)index < PATTERN_COUNT ? index : 0];
+}
+
 ModePattern::ModePattern() : // Renamed from ModeAnimation
-    m_utils(nullptr), m_matrix(nullptr), lastUpdate(0),
-    currentPatternIndex(0), lastPatternChangeTime(0), // Renamed variables
+    m_utils(nullptr), m_matrix(nullptr), activePattern(nullptr),
+    outgoingPattern(nullptr), transitionStart(0), transitionLength(0),
+    currentPatternIndex(0), uploadWarned(false), lastPatternChangeTime(0), // Renamed variables
     patternChangeInterval(10 * 60 * 1000), // Initialize to default 10 minutes, was auroraPatternChangeInterval
     animationHue(0), animationBrightness(128), lastAnimationUpdate(0),
-    currentAnimation(0) { // animationMode is commented out
-    // Initialization of drawablePatterns array in the constructor is performed in setup
+    currentAnimation(0), lastUpdate(0) { // animationMode is commented out
+    // Patterns are constructed on their first frame, see activatePattern()
 }
 
-void ModePattern::setup(Utils* utils_ptr, MatrixPanel_I2S_DMA* matrix_ptr) { // Renamed
+void ModePattern::setup(Utils* utils_ptr, MatrixDisplay* matrix_ptr) { // Renamed
     m_utils = utils_ptr;
     m_matrix = matrix_ptr;
     lastUpdate = 0;
 
-    // Set EffectsLayer's virtualDisp to point to m_matrix
+    // Set EffectsLayer's virtualDisp to point to m_matrix, and size the pattern canvas to the whole panel chain
+    // (before the patterns are created, some of them size their buffers from effects.width / effects.height)
     effects.virtualDisp = m_matrix;
+    effects.resize(m_matrix->width(), m_matrix->height());
+
+    // Patterns with renderRows() split their frames across both cores (no-op if the worker is already running)
+    if (ROW_JOBS_ENABLE) {
+        rowJobs.begin(ROW_JOBS_BAND_ROWS);
+    }
 
-    // Create Pattern objects and assign them to the array (was Aurora pattern)
-    drawablePatterns[0] = new PatternCube();
-    drawablePatterns[1] = new PatternPlasma();
-    drawablePatterns[2] = new PatternFlock();
-    drawablePatterns[3] = new PatternSpiral();
-    drawablePatterns[4] = new PatternPaletteSmear();
-    drawablePatterns[5] = new PatternStarfield();
-    // drawablePatterns[6] = new PatternAttract();
-    // drawablePatterns[7] = new PatternElectricMandala();
-    // drawablePatterns[8] = new PatternFlowField();
-    drawablePatterns[6] = new PatternIncrementalDrift();
-    // drawablePatterns[10] = new PatternInfinity();
-    drawablePatterns[7] = new PatternMunch();
-    drawablePatterns[8] = new PatternPendulumWave();
-    // drawablePatterns[13] = new PatternRadar();
-    // drawablePatterns[14] = new PatternSimplexNoise();
-    // drawablePatterns[15] = new PatternSnake();
-    drawablePatterns[9] = new PatternSpiro();
-    drawablePatterns[10] = new PatternWave();
-    drawablePatterns[11] = new PatternRain();
-    drawablePatterns[12] = new PatternJuliaSet(); 
-    // drawablePatterns[20] = new PatternFirework(); 
-    // drawablePatterns[21] = new PatternStardustBurst(); 
+    // No pattern is constructed here: the selected one is created on its first frame (a 4.N request
+    // right after mode entry then never builds pattern 1 only to delete it again)
     // GIF pattern is now a separate mode
+    releasePattern();
     currentPatternIndex = 0; // Start with the first pattern
-    if (drawablePatterns[currentPatternIndex]) { // Renamed
-        drawablePatterns[currentPatternIndex]->start(); // Renamed
-    }
     lastPatternChangeTime = millis(); // Renamed
 
     // Initialize existing variables (if necessary)
@@ -65,7 +147,7 @@ void ModePattern::setup(Utils* utils_ptr, MatrixPanel_I2S_DMA* matrix_ptr) { //
     // lastAnimationUpdate = 0; // lastAnimationUpdate may not be directly used by Aurora patterns
     currentAnimation = 0; // Existing animation index, currently not used
 
-    Serial.println("Pattern mode setup complete (Drawable Patterns Ready)"); // Renamed
+    Serial.printf("Pattern mode setup complete (%d patterns registered)\n", PATTERN_COUNT); // Renamed
 }
 
 // Mathematical HSV to RGB565 conversion
@@ -107,17 +189,9 @@ void ModePattern::run() { // Renamed
 
 void ModePattern::cleanup() { // Renamed
     Serial.println("Pattern mode cleanup"); // Renamed
-    if (drawablePatterns[currentPatternIndex]) { // Renamed
-        drawablePatterns[currentPatternIndex]->stop(); // Renamed
-    }
-
-    // Deallocate dynamically allocated Pattern objects
-    for (int i = 0; i < MAX_PATTERNS; ++i) { // MAX_PATTERNS used
-        if (drawablePatterns[i]) { // Renamed
-            delete drawablePatterns[i]; // Renamed
-            drawablePatterns[i] = nullptr; // Renamed
-        }
-    }
+    endTransition();
+    releasePattern();
+    effects.freeTransitionBuffer(); // Give the PSRAM back to the other modes
     if (m_matrix && m_utils) {
         m_matrix->fillScreen(0);
         m_utils->displayShow();
@@ -128,11 +202,46 @@ void ModePattern::updateAnimation() { // Renamed, consider renaming to updatePat
     unsigned long currentTime = millis();
     unsigned int frameDelay = 0;
 
-    if (drawablePatterns[currentPatternIndex]) { // Renamed
+    if (activatePattern()) {
+        uint32_t uploads = effects.frameUploads;
+        unsigned long frameStart = micros();
+
+        // During a transition the outgoing pattern keeps animating on its own canvas (leds2)
+        if (outgoingPattern) {
+            effects.swapCanvas();
+            outgoingPattern->drawFrame();
+            effects.swapCanvas();
+        }
+
         // Call the current Pattern's drawFrame()
         // drawFrame() typically returns the recommended frame delay time.
-        frameDelay = drawablePatterns[currentPatternIndex]->drawFrame(); // Renamed
-        // effects.ShowFrame() is called inside each pattern's drawFrame().
+        frameDelay = activePattern->drawFrame();
+
+        // Frame contract: patterns only draw into effects.leds, the frame is uploaded exactly once here
+        if (PATTERN_UPLOAD_CHECK && effects.frameUploads != uploads && !uploadWarned) {
+            Serial.printf("Pattern %s: drawFrame() uploaded %u time(s) itself, frames are uploaded by ModePattern\n",
+                          patternRegistry[currentPatternIndex].name, (unsigned)(effects.frameUploads - uploads));
+            uploadWarned = true;
+        }
+
+        if (outgoingPattern) {
+            unsigned long elapsed = currentTime - transitionStart;
+            uint16_t amount = elapsed >= transitionLength ? 256 : elapsed * 256 / transitionLength;
+            effects.ShowFrame(amount, PATTERN_TRANSITION_STYLE);
+
+            if (amount >= 256) {
+                endTransition();
+            } else if (micros() - frameStart > 1000000UL / ANIMATION_FPS) {
+                // Two patterns per frame don't fit the frame budget: halve what is left of the transition
+                unsigned long remaining = (transitionLength - elapsed) / 2;
+                transitionLength = elapsed + remaining;
+                Serial.printf("Pattern transition over the frame budget (%lu us), %lu ms left\n",
+                              micros() - frameStart, remaining);
+            }
+        } else {
+            effects.ShowFrame();
+        }
+
         // After that, the content drawn on m_matrix's back buffer is sent to the actual screen.
         if (m_utils) m_utils->displayShow();
     }
@@ -200,89 +309,96 @@ void ModePattern::updateAnimation() { // Renamed, consider renaming to updatePat
 }
 
 void ModePattern::nextPattern() { // Renamed
-    if (drawablePatterns[currentPatternIndex]) { // Renamed
-        drawablePatterns[currentPatternIndex]->stop(); // Renamed
-    }
-    currentPatternIndex = (currentPatternIndex + 1) % MAX_PATTERNS; // Renamed, MAX_PATTERNS used
-    if (drawablePatterns[currentPatternIndex]) { // Renamed
-        drawablePatterns[currentPatternIndex]->start(); // Renamed
-    }
-    if (m_matrix) m_matrix->fillScreen(0);
-    lastPatternChangeTime = millis(); // Renamed
-    Serial.printf("Switched to next Pattern: %d (%s)\n", currentPatternIndex + 1, drawablePatterns[currentPatternIndex] ? drawablePatterns[currentPatternIndex]->name : "Unknown"); // Renamed
+    selectPattern((currentPatternIndex + 1) % PATTERN_COUNT);
+    Serial.printf("Switched to next Pattern: %d (%s)\n", currentPatternIndex + 1, patternRegistry[currentPatternIndex].name); // Renamed
     // if (m_utils && m_utils->isSoundFeedbackEnabled()) m_utils->playSingleTone();
 }
 
 void ModePattern::prevPattern() { // Renamed
-    if (drawablePatterns[currentPatternIndex]) { // Renamed
-        drawablePatterns[currentPatternIndex]->stop(); // Renamed
-    }
-    currentPatternIndex = (currentPatternIndex - 1 + MAX_PATTERNS) % MAX_PATTERNS; // Renamed, MAX_PATTERNS used
-    if (drawablePatterns[currentPatternIndex]) { // Renamed
-        drawablePatterns[currentPatternIndex]->start(); // Renamed
-    }
-    if (m_matrix) m_matrix->fillScreen(0);
-    lastPatternChangeTime = millis(); // Renamed
-    Serial.printf("Switched to previous Pattern: %d (%s)\n", currentPatternIndex + 1, drawablePatterns[currentPatternIndex] ? drawablePatterns[currentPatternIndex]->name : "Unknown"); // Renamed
+    selectPattern((currentPatternIndex - 1 + PATTERN_COUNT) % PATTERN_COUNT);
+    Serial.printf("Switched to previous Pattern: %d (%s)\n", currentPatternIndex + 1, patternRegistry[currentPatternIndex].name); // Renamed
     // if (m_utils && m_utils->isSoundFeedbackEnabled()) m_utils->playSingleTone();
 }
 
-void ModePattern::setPattern(PatternType mode) { // Renamed, parameter type changed
-    int newIndex = static_cast<int>(mode);
-
+void ModePattern::setPattern(int index) { // Renamed, takes a registry index
     // Validate mode index
-    if (newIndex < 0 || newIndex >= MAX_PATTERNS) { // MAX_PATTERNS used
-        Serial.printf("Invalid pattern mode: %d. Valid range: 0-%d\n", newIndex, MAX_PATTERNS - 1); // Renamed
+    if (index < 0 || index >= PATTERN_COUNT) {
+        Serial.printf("Invalid pattern mode: %d. Valid range: 0-%d\n", index, PATTERN_COUNT - 1); // Renamed
         return;
     }
 
-    // Stop current pattern if running
-    if (drawablePatterns[currentPatternIndex]) { // Renamed
-        drawablePatterns[currentPatternIndex]->stop(); // Renamed
+    selectPattern(index);
+    Serial.printf("MQTT: Set pattern to %s (index: %d)\n", patternRegistry[index].name, index); // Renamed
+    // if (m_utils && m_utils->isSoundFeedbackEnabled()) m_utils->playSingleTone();
+}
+
+// Switch to another pattern, the new one is constructed on the next frame
+//
+// With PATTERN_TRANSITION_MS the running pattern is kept as the outgoing one: its last frame moves
+// to leds2 and it goes on drawing there, the incoming pattern starts on a black leds, and
+// updateAnimation() mixes the two in the upload. Both share everything else in effects (palette,
+// noise, oscillators) for the length of the transition.
+void ModePattern::selectPattern(int index) {
+    // Changing again mid-transition drops the pattern that was already on its way out
+    endTransition();
+
+    if (PATTERN_TRANSITION_MS > 0 && activePattern && effects.allocateTransitionBuffer()) {
+        outgoingPattern = activePattern;
+        activePattern = nullptr;
+        effects.swapCanvas();
+        effects.ClearFrame();
+        transitionStart = millis();
+        transitionLength = PATTERN_TRANSITION_MS;
+    } else {
+        releasePattern();
+        // Clear screen
+        if (m_matrix) m_matrix->fillScreen(0);
     }
 
-    // Switch to new pattern
-    currentPatternIndex = newIndex; // Renamed
+    currentPatternIndex = index;
+    uploadWarned = false;
+    lastPatternChangeTime = millis(); // Renamed
+}
 
-    // Start new pattern if available
-    if (drawablePatterns[currentPatternIndex]) { // Renamed
-        drawablePatterns[currentPatternIndex]->start(); // Renamed
+bool ModePattern::activatePattern() {
+    if (activePattern) return true;
+
+    const PatternEntry& entry = patternRegistry[currentPatternIndex];
+    // Full-size CRGB canvas first; a pattern that wants another canvas format sets it in start()
+    activePattern = effects.setPixelFormat(PIXEL_CRGB) ? entry.create() : nullptr;
+    if (!activePattern && outgoingPattern) {
+        // Both patterns don't fit: finish the transition and try the same pattern again on its own
+        Serial.printf("Pattern %s: not enough memory during the transition, cutting\n", entry.name);
+        endTransition();
+        return false;
     }
+    if (!activePattern) {
+        // Move on to the next pattern (tried on the next frame) rather than showing a blank screen
+        Serial.printf("Pattern %s: not enough memory (%u bytes needed, %u free), skipping\n",
+                      entry.name, (unsigned)entry.bytes, (unsigned)ESP.getFreeHeap());
+        selectPattern((currentPatternIndex + 1) % PATTERN_COUNT);
+        return false;
+    }
+    activePattern->start();
+    Serial.printf("Pattern %s started (%u bytes, %u heap free)\n",
+                  entry.name, (unsigned)entry.bytes, (unsigned)ESP.getFreeHeap());
+    return true;
+}
 
-    // Clear screen and reset timer
-    if (m_matrix) m_matrix->fillScreen(0);
-    lastPatternChangeTime = millis(); // Renamed
+void ModePattern::releasePattern() {
+    if (!activePattern) return;
 
-    // Get pattern name for logging
-    const char* patternNames[MAX_PATTERNS] = { // MAX_PATTERNS used
-        "Cube",             // ANIM_CUBE
-        "Plasma",           // ANIM_PLASMA
-        "Flock",            // ANIM_FLOCK
-        "Spiral",           // ANIM_SPIRAL
-        "PaletteSmear",     // ANIM_PALETTE_SMEAR (was ANIM_NOISE)
-        "Starfield",        // ANIM_STARFIELD
-        // "Attract",          // ANIM_ATTRACT
-        // "ElectricMandala",  // ANIM_ELECTRIC_MANDALA
-        // "FlowField",        // ANIM_FLOW_FIELD
-        "IncrDrift",        // ANIM_INCREMENTAL_DRIFT
-        // "Infinity",         // ANIM_INFINITY
-        "Munch",            // ANIM_MUNCH
-        "PendulumWave",     // ANIM_PENDULUM_WAVE
-        // "Radar",            // ANIM_RADAR
-        // "SimplexNoise",     // ANIM_SIMPLEX_NOISE
-        // "Snake",            // ANIM_SNAKE
-        "Spiro",            // ANIM_SPIRO
-        "Wave",             // ANIM_WAVE
-        "Rain",             // ANIM_RAIN
-        "JuliaSet",         // ANIM_JULIA_SET
-        // "Fireworks",        // ANIM_FIREWORKS
-        // "StardustBurst"    // ANIM_STARDUST_BURST (New pattern name)
-            
-    };
-    const char* selectedPatternName = (newIndex >= 0 && newIndex < MAX_PATTERNS && patternNames[newIndex] != nullptr) ? patternNames[newIndex] : "Unknown"; // Renamed
+    activePattern->stop();
+    delete activePattern;
+    activePattern = nullptr;
+}
 
-    Serial.printf("MQTT: Set pattern to %s (index: %d)\n", selectedPatternName, newIndex); // Renamed
-    // if (m_utils && m_utils->isSoundFeedbackEnabled()) m_utils->playSingleTone();
+void ModePattern::endTransition() {
+    if (!outgoingPattern) return;
+
+    outgoingPattern->stop();
+    delete outgoingPattern;
+    outgoingPattern = nullptr;
 }
 
 // Keep the existing animation functions as they are.
@@ -293,12 +409,14 @@ void ModePattern::setPattern(PatternType mode) { // Renamed, parameter type chan
 
 bool ModePattern::drawPlasma() { // Renamed
     static float time = 0;
+    const int width = m_matrix->width();
+    const int height = m_matrix->height();
     m_matrix->fillScreen(0);
 
-    for (int y = 0; y < MATRIX_HEIGHT; y++) {
-        for (int x = 0; x < MATRIX_WIDTH; x++) {
-            float dx = (x - (float)MATRIX_WIDTH / 2.0) * 0.1;
-            float dy = (y - (float)MATRIX_HEIGHT / 2.0) * 0.1;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            float dx = (x - (float)width / 2.0) * 0.1;
+            float dy = (y - (float)height / 2.0) * 0.1;
 
             float plasma = sin(dx + time) +
                           sin(dy + time * 1.2) +
@@ -308,7 +426,7 @@ bool ModePattern::drawPlasma() { // Renamed
             uint8_t hue = (uint8_t)((plasma + 4.0) * 32.0); // Normalize plasma to hue range
             uint16_t color = hsv2rgb565(hue, 255, animationBrightness);
 
-            m_matrix->drawPixel(setPhysicalX(x), y, color); // Apply X-shift
+            m_matrix->drawPixel(x, y, color);
         }
     }
 
@@ -322,13 +440,15 @@ bool ModePattern::drawPlasma() { // Renamed
 }
 
 bool ModePattern::drawRainbow() { // Renamed
+    const int width = m_matrix->width();
+    const int height = m_matrix->height();
     m_matrix->fillScreen(0);
 
-    for (int y = 0; y < MATRIX_HEIGHT; y++) {
-        for (int x = 0; x < MATRIX_WIDTH; x++) {
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
             uint8_t pixelHue = animationHue + (x * 2) + (y * 1);
             uint16_t color = hsv2rgb565(pixelHue, 255, animationBrightness);
-            m_matrix->drawPixel(setPhysicalX(x), y, color); // Apply X-shift
+            m_matrix->drawPixel(x, y, color);
         }
     }
 
@@ -344,7 +464,8 @@ bool ModePattern::drawRainbow() { // Renamed
 
 bool ModePattern::drawTetris() { // Renamed
     // Static variables for Tetris game state
-    static uint8_t tetrisGrid[MATRIX_HEIGHT][MATRIX_WIDTH];
+    static uint8_t* tetrisGrid = nullptr; // width * height cells, reallocated if the display size changes
+    static int gridWidth = 0, gridHeight = 0;
     static int currentBlockX, currentBlockY;
     static int currentBlockW, currentBlockH;
     static uint8_t currentBlockColor;
@@ -355,11 +476,22 @@ bool ModePattern::drawTetris() { // Renamed
 
     static bool gameInitialized = false;
 
+    const int width = m_matrix->width();
+    const int height = m_matrix->height();
+    if (!tetrisGrid || gridWidth != width || gridHeight != height) {
+        free(tetrisGrid);
+        tetrisGrid = (uint8_t*)malloc(width * height);
+        if (!tetrisGrid) return false;
+        gridWidth = width;
+        gridHeight = height;
+        gameInitialized = false;
+    }
+
     // Lambda function to spawn a new block
     auto spawnNewBlock = [&]() {
         currentBlockW = random(1, 5); // Width: 1 to 4 columns
         currentBlockH = random(1, 4); // Height: 1 to 3 rows (original comment was 1-2 col, 1-3 row)
-        currentBlockX = random(0, MATRIX_WIDTH - currentBlockW + 1); // Ensure block fits horizontally
+        currentBlockX = random(0, width - currentBlockW + 1); // Ensure block fits horizontally
         currentBlockY = 0; // Start from the top
         currentBlockColor = random(1, 8); // 7 distinct colors (1-7)
 
@@ -372,8 +504,8 @@ bool ModePattern::drawTetris() { // Renamed
                 int checkY = currentBlockY + r_offset;
                 int checkX = currentBlockX + c_offset;
                 // Ensure check is within bounds
-                if (checkY >= 0 && checkY < MATRIX_HEIGHT && checkX >= 0 && checkX < MATRIX_WIDTH) {
-                    if (tetrisGrid[checkY][checkX] != 0) {
+                if (checkY >= 0 && checkY < height && checkX >= 0 && checkX < width) {
+                    if (tetrisGrid[checkY * width + checkX] != 0) {
                         collisionAtSpawn = true;
                         break;
                     }
@@ -393,7 +525,7 @@ bool ModePattern::drawTetris() { // Renamed
 
     // Initialize or reset game if it's the first run or game over
     if (!gameInitialized || gameIsOver) {
-        memset(tetrisGrid, 0, sizeof(tetrisGrid)); // Clear the grid
+        memset(tetrisGrid, 0, width * height);      // Clear the grid
         gameIsOver = false;                        // Reset game over flag for the new game
         isBlockFalling = false;                    // No block is falling initially
         gameInitialized = true;                    // Mark as initialized
@@ -417,12 +549,12 @@ bool ModePattern::drawTetris() { // Renamed
             lastDropTime = millis();
 
             bool canMoveDown = true;
-            if (currentBlockY + currentBlockH >= MATRIX_HEIGHT) { // Block's bottom edge is at or past the matrix bottom
+            if (currentBlockY + currentBlockH >= height) { // Block's bottom edge is at or past the matrix bottom
                 canMoveDown = false;
             } else {
                 // Check collision with existing blocks directly below the current block
                 for (int c_offset = 0; c_offset < currentBlockW; ++c_offset) {
-                    if (tetrisGrid[currentBlockY + currentBlockH][currentBlockX + c_offset] != 0) {
+                    if (tetrisGrid[(currentBlockY + currentBlockH) * width + currentBlockX + c_offset] != 0) {
                         canMoveDown = false;
                         break;
                     }
@@ -437,16 +569,16 @@ bool ModePattern::drawTetris() { // Renamed
                     for (int c_offset = 0; c_offset < currentBlockW; ++c_offset) {
                         int placeY = currentBlockY + r_offset;
                         int placeX = currentBlockX + c_offset;
-                        if (placeY >= 0 && placeY < MATRIX_HEIGHT && placeX >= 0 && placeX < MATRIX_WIDTH) {
-                            tetrisGrid[placeY][placeX] = currentBlockColor;
+                        if (placeY >= 0 && placeY < height && placeX >= 0 && placeX < width) {
+                            tetrisGrid[placeY * width + placeX] = currentBlockColor;
                         }
                     }
                 }
                 isBlockFalling = false; // Block has landed
 
                 // Check for game over (top row filled)
-                for (int c = 0; c < MATRIX_WIDTH; ++c) {
-                    if (tetrisGrid[0][c] != 0) {
+                for (int c = 0; c < width; ++c) {
+                    if (tetrisGrid[c] != 0) {
                         gameIsOver = true;
                         break;
                     }
@@ -480,12 +612,12 @@ bool ModePattern::drawTetris() { // Renamed
 
 
     // Draw landed blocks from tetrisGrid
-    for (int r = 0; r < MATRIX_HEIGHT; ++r) {
-        for (int c = 0; c < MATRIX_WIDTH; ++c) {
-            if (tetrisGrid[r][c] != 0) {
-                uint8_t hue = tetrisGrid[r][c] * 36; // Simple color mapping
+    for (int r = 0; r < height; ++r) {
+        for (int c = 0; c < width; ++c) {
+            if (tetrisGrid[r * width + c] != 0) {
+                uint8_t hue = tetrisGrid[r * width + c] * 36; // Simple color mapping
                 uint16_t color = hsv2rgb565(hue, 255, 200); // Fixed saturation and brightness
-                m_matrix->drawPixel(setPhysicalX(c), r, color); // Apply X-shift
+                m_matrix->drawPixel(c, r, color);
             }
         }
     }
@@ -498,8 +630,8 @@ bool ModePattern::drawTetris() { // Renamed
             for (int c_offset = 0; c_offset < currentBlockW; ++c_offset) {
                 int drawY = currentBlockY + r_offset;
                 int drawX = currentBlockX + c_offset;
-                if (drawY >= 0 && drawY < MATRIX_HEIGHT && drawX >= 0 && drawX < MATRIX_WIDTH) {
-                     m_matrix->drawPixel(setPhysicalX(drawX), drawY, color); // Apply X-shift
+                if (drawY >= 0 && drawY < height && drawX >= 0 && drawX < width) {
+                     m_matrix->drawPixel(drawX, drawY, color);
                 }
             }
         }
@@ -1,21 +1,58 @@
 #include "mode_sysinfo.h"
 #include "common.h"
 #include "utils.h"
-#include <ESP32-HUB75-MatrixPanel-I2S-DMA.h>
+#include "matrix_display.h"
+#include "telemetry.h"
+#include "font_manager.h"
 #include <WiFi.h>
 #include "version.h"
 
-void ModeSysinfo::setup(Utils* utils_ptr, MatrixPanel_I2S_DMA* matrix_ptr) {
+// PERF 페이지: 12행 스트립 5개 (1행 간격), 왼쪽에 값, 오른쪽 그래프는 샘플당 한 열씩 스크롤
+// 스케일은 고정 (자동 스케일이면 스크롤 대신 다시 그려야 함)
+static const int PERF_LABEL_W = 19;                 // Org_01 숫자 3개
+static const int PERF_STRIP_H = 12;
+static const int PERF_STRIP_STEP = 13;
+static const uint32_t PERF_FRAME_FULL_US = 2 * 1000000UL / ANIMATION_FPS; // 프레임 예산의 2배
+static const uint32_t PERF_LOOPS_FULL = 250;        // loop()는 delay(5)가 있어 ~200/s가 상한
+static const uint32_t PERF_MQTT_FULL = 4;           // 샘플당 메시지 수
+static const uint32_t PERF_MQTT_LATENCY_FULL_MS = 100;
+static const uint32_t PERF_REFRESH_FULL_HZ = 2 * DISPLAY_TARGET_REFRESH_HZ;
+
+enum PerfStrip { PERF_FRAME, PERF_LOOPS, PERF_CPU, PERF_MQTT, PERF_REFRESH, PERF_STRIP_COUNT };
+static const char* const PERF_STRIP_NAMES[PERF_STRIP_COUNT] = { "FT", "LP", "CPU", "MQ", "HZ" };
+
+// 프레임 시간 막대 색: DisplayMode 별
+static const uint32_t PERF_MODE_COLORS[MODE_ENUM_COUNT] = {
+    0x404040, 0x00C0FF, 0x00FF60, 0xFF8000, 0xC040FF, 0xFFFF00, 0xFF4080, 0x80FF00, 0x00FFFF, 0xFF0000
+};
+
+// 0..PERF_STRIP_H 픽셀, 0이 아닌 값은 최소 1픽셀
+static int perfBarHeight(uint32_t value, uint32_t fullScale) {
+    if (value == 0) return 0;
+    uint32_t h = (uint64_t)value * PERF_STRIP_H / fullScale;
+    return h < 1 ? 1 : (h > PERF_STRIP_H ? PERF_STRIP_H : h);
+}
+
+void ModeSysinfo::setup(Utils* utils_ptr, MatrixDisplay* matrix_ptr) {
     m_utils = utils_ptr;
     m_matrix = matrix_ptr;
     currentInfoMode = INFO_SYSINFO; // Start with the first info screen
     lastUpdate = 0;
+    lastPerfSeq = 0;
     Serial.println("System info mode setup complete");
 }
 
 void ModeSysinfo::run() {
     unsigned long currentTime = millis();
     
+    // PERF는 1초마다 다시 그리지 않고 새 telemetry 샘플마다 한 열씩 스크롤
+    if (currentInfoMode == INFO_PERF) {
+        if (telemetry.perfSeq() != lastPerfSeq) {
+            scrollPerfInfo();
+        }
+        return;
+    }
+    
     // Update every 1 second
     if (currentTime - lastUpdate >= 1000) {
         displayCurrentInfo();
@@ -59,6 +96,12 @@ void ModeSysinfo::displayCurrentInfo() {
         case INFO_MEMORY:
             displayMemoryInfo();
             break;
+        case INFO_HEAP:
+            displayHeapGraph();
+            break;
+        case INFO_PERF:
+            displayPerfInfo();
+            break;
     }
     
     m_utils->displayShow();
@@ -154,16 +197,175 @@ void ModeSysinfo::displayMemoryInfo() {
     // 본문: white, left-align-2px, start_y=20, 줄간격 12px
     m_matrix->setTextColor(m_utils->hexToRgb565(0xFFFFFF)); // White
     
-    // Free (F) - KB 단위
+    // 화면을 그릴 때마다 현재 값으로 갱신 (히스토리/MQTT 주기는 그대로)
+    telemetry.refreshHeap();
+    const HeapCapsStats& heap = telemetry.internal();
+
+    // Free (F) / Min-ever free (M) - 내부 힙, KB 단위
     m_utils->setCursorTopBased(2, 20, false);
-    m_matrix->printf("F:%dK", ESP.getFreeHeap() / 1024);
+    m_matrix->printf("F:%luK", (unsigned long)(heap.free / 1024));
     
-    // Allocated (A) - KB 단위
     m_utils->setCursorTopBased(2, 32, false);
-    uint32_t allocated = ESP.getHeapSize() - ESP.getFreeHeap();
-    m_matrix->printf("A:%dK", allocated / 1024);
+    m_matrix->printf("M:%luK", (unsigned long)(heap.minFree / 1024));
     
-    // Total (T) - KB 단위
+    // PSRAM free (P) - KB 단위
     m_utils->setCursorTopBased(2, 44, false);
-    m_matrix->printf("T:%dK", ESP.getHeapSize() / 1024);
+    m_matrix->printf("P:%luK", (unsigned long)(telemetry.psram().free / 1024));
+}
+
+void ModeSysinfo::displayHeapGraph() {
+    // 상단 타이틀: cyan, center-align, y=4
+    m_matrix->setFont();
+    m_matrix->setTextSize(1);
+    m_matrix->setTextColor(m_utils->hexToRgb565(0x00FFFF)); // Cyan
+    
+    const char* title = "HEAP";
+    int title_x = m_utils->calculateTextCenterX(title, MATRIX_WIDTH);
+    m_utils->setCursorTopBased(title_x, 4, false);
+    m_matrix->print(title);
+    
+    // Largest block (B) - KB 단위, fragmentation % (현재 값, 그래프는 샘플 히스토리)
+    telemetry.refreshHeap();
+    const HeapCapsStats& heap = telemetry.internal();
+    m_matrix->setTextColor(m_utils->hexToRgb565(0xFFFFFF)); // White
+    m_utils->setCursorTopBased(2, 16, false);
+    m_matrix->printf("B:%luK %u%%", (unsigned long)(heap.largest / 1024), heap.fragPercent());
+    
+    // 그래프: 샘플당 1열, 오른쪽이 최신. 막대 = free, 점 = largest block
+    const int graphTop = 28;
+    const int graphHeight = MATRIX_HEIGHT - graphTop;
+    const int count = min((int)telemetry.historyCount(), MATRIX_WIDTH);
+    if (count == 0) return;
+    const int first = telemetry.historyCount() - count;
+    
+    // 세로축은 보이는 구간의 min(largest) .. max(free)에 맞춤 (느린 누수도 기울기로 보이도록)
+    uint16_t lo = 0xFFFF, hi = 0;
+    for (int i = 0; i < count; i++) {
+        const TelemetryPoint& p = telemetry.point(first + i);
+        lo = min(lo, p.internalLargestKB);
+        hi = max(hi, p.internalFreeKB);
+    }
+    const int range = max(hi - lo, 1);
+    
+    const uint16_t barColor = m_utils->hexToRgb565(0x006040);   // Dark green
+    const uint16_t blockColor = m_utils->hexToRgb565(0xFFC000); // Amber
+    for (int i = 0; i < count; i++) {
+        const TelemetryPoint& p = telemetry.point(first + i);
+        int x = MATRIX_WIDTH - count + i;
+        int freeH = 1 + (p.internalFreeKB - lo) * (graphHeight - 1) / range;
+        int blockH = 1 + (p.internalLargestKB - lo) * (graphHeight - 1) / range;
+        m_matrix->drawFastVLine(x, MATRIX_HEIGHT - freeH, freeH, barColor);
+        m_matrix->drawPixel(x, MATRIX_HEIGHT - blockH, blockColor);
+    }
+}
+
+void ModeSysinfo::displayPerfInfo() {
+    // 히스토리 전체를 그림 (페이지 진입, 샘플 누락 시). 최신 샘플이 오른쪽 끝
+    const int columns = MATRIX_WIDTH - PERF_LABEL_W;
+    const int count = min((int)telemetry.perfCount(), columns);
+    const int first = telemetry.perfCount() - count;
+    for (int i = 0; i < count; i++) {
+        drawPerfColumn(MATRIX_WIDTH - count + i, telemetry.perf(first + i));
+    }
+    if (count > 0) {
+        drawPerfLabels(telemetry.perf(telemetry.perfCount() - 1));
+    }
+    lastPerfSeq = telemetry.perfSeq();
+}
+
+void ModeSysinfo::scrollPerfInfo() {
+    // 샘플을 놓쳤으면 (다른 페이지였거나 loop가 막혔던 경우) 전체를 다시 그림
+    if (telemetry.perfSeq() - lastPerfSeq != 1) {
+        displayCurrentInfo();
+        return;
+    }
+    lastPerfSeq = telemetry.perfSeq();
+    const PerfSample& s = telemetry.perf(telemetry.perfCount() - 1);
+    
+    // 화면에 떠 있는 프레임에서 시작해 그래프 영역을 DMA 버퍼 안에서 한 열 밀고,
+    // 새 열과 값만 그림 (fillScreen / 텍스트 전체 다시 그리기 없음)
+    m_matrix->driver()->copyFrontToBackBuffer();
+    m_matrix->scrollLeft(PERF_LABEL_W, 0, MATRIX_WIDTH - PERF_LABEL_W, MATRIX_HEIGHT);
+    drawPerfColumn(MATRIX_WIDTH - 1, s);
+    drawPerfLabels(s);
+    
+    m_utils->displayShow();
+}
+
+void ModeSysinfo::drawPerfColumn(int x, const PerfSample& s) {
+    for (int strip = 0; strip < PERF_STRIP_COUNT; strip++) {
+        m_matrix->drawFastVLine(x, strip * PERF_STRIP_STEP, PERF_STRIP_H, 0);
+    }
+    
+    // FT: mode run() 최대 시간, 모드 색 막대. 스케일을 넘으면 맨 위 빨간 점
+    int bottom = PERF_FRAME * PERF_STRIP_STEP + PERF_STRIP_H;
+    int h = perfBarHeight(s.frameMaxUs, PERF_FRAME_FULL_US);
+    uint32_t modeColor = s.mode < MODE_ENUM_COUNT ? PERF_MODE_COLORS[s.mode] : 0xFFFFFF;
+    if (h > 0) m_matrix->drawFastVLine(x, bottom - h, h, m_utils->hexToRgb565(modeColor));
+    if (s.frameMaxUs > PERF_FRAME_FULL_US) m_matrix->drawPixel(x, bottom - PERF_STRIP_H, m_utils->hexToRgb565(0xFF0000));
+    
+    // LP: loop 반복/초
+    bottom = PERF_LOOPS * PERF_STRIP_STEP + PERF_STRIP_H;
+    h = perfBarHeight(s.loopsPerSec, PERF_LOOPS_FULL);
+    if (h > 0) m_matrix->drawFastVLine(x, bottom - h, h, m_utils->hexToRgb565(0x4060C0));
+    
+    // CPU: 코어별 점 (core 0 = cyan, core 1 = orange)
+    bottom = PERF_CPU * PERF_STRIP_STEP + PERF_STRIP_H;
+    const uint32_t coreColors[2] = { 0x00FFFF, 0xFF8000 };
+    for (int core = 0; core < 2; core++) {
+        if (s.cpuLoad[core] == Telemetry::CPU_LOAD_UNKNOWN) continue;
+        int y = bottom - 1 - s.cpuLoad[core] * (PERF_STRIP_H - 1) / 100;
+        m_matrix->drawPixel(x, y, m_utils->hexToRgb565(coreColors[core]));
+    }
+    
+    // MQ: 메시지 수 막대 + 평균 지연 점
+    bottom = PERF_MQTT * PERF_STRIP_STEP + PERF_STRIP_H;
+    h = perfBarHeight(s.mqttMessages, PERF_MQTT_FULL);
+    if (h > 0) m_matrix->drawFastVLine(x, bottom - h, h, m_utils->hexToRgb565(0x008040));
+    if (s.mqttMessages > 0) {
+        int latencyH = max(perfBarHeight(s.mqttLatencyMs, PERF_MQTT_LATENCY_FULL_MS), 1);
+        m_matrix->drawPixel(x, bottom - latencyH, m_utils->hexToRgb565(0xFFFF00));
+    }
+    
+    // HZ: DMA 실제 리프레시
+    bottom = PERF_REFRESH * PERF_STRIP_STEP + PERF_STRIP_H;
+    h = perfBarHeight(s.refreshHz, PERF_REFRESH_FULL_HZ);
+    if (h > 0) m_matrix->drawFastVLine(x, bottom - h, h, m_utils->hexToRgb565(0x806000));
+}
+
+void ModeSysinfo::drawPerfLabels(const PerfSample& s) {
+    m_matrix->fillRect(0, 0, PERF_LABEL_W, MATRIX_HEIGHT, 0);
+    m_matrix->setFont(FontManager::getFont(FontType::FONT_ORG_R_6));
+    m_matrix->setTextSize(1);
+    
+    uint32_t values[PERF_STRIP_COUNT];
+    values[PERF_FRAME] = s.frameMaxUs / 1000;
+    values[PERF_LOOPS] = s.loopsPerSec;
+    values[PERF_CPU] = 0;
+    for (int core = 0; core < 2; core++) {
+        if (s.cpuLoad[core] != Telemetry::CPU_LOAD_UNKNOWN && s.cpuLoad[core] > values[PERF_CPU]) {
+            values[PERF_CPU] = s.cpuLoad[core]; // 더 바쁜 코어
+        }
+    }
+    values[PERF_MQTT] = s.mqttLatencyMs;
+    values[PERF_REFRESH] = s.refreshHz;
+    
+    // 스트립마다 1줄: 이름 (회색), 2줄: 값 (흰색, 최대 3자리)
+    for (int strip = 0; strip < PERF_STRIP_COUNT; strip++) {
+        int top = strip * PERF_STRIP_STEP;
+        m_matrix->setTextColor(m_utils->hexToRgb565(0x808080)); // Grey
+        m_utils->setCursorTopBased(0, top, true);
+        m_matrix->print(PERF_STRIP_NAMES[strip]);
+        
+        m_matrix->setTextColor(m_utils->hexToRgb565(0xFFFFFF)); // White
+        m_utils->setCursorTopBased(0, top + 6, true);
+        if (strip == PERF_FRAME && s.frameMaxUs < 10000) {
+            m_matrix->printf("%lu.%lu", (unsigned long)(s.frameMaxUs / 1000), (unsigned long)(s.frameMaxUs / 100 % 10));
+        } else if (strip == PERF_CPU && values[PERF_CPU] == 0 && s.cpuLoad[0] == Telemetry::CPU_LOAD_UNKNOWN) {
+            m_matrix->print("-");
+        } else {
+            m_matrix->printf("%lu", (unsigned long)min(values[strip], (uint32_t)999));
+        }
+    }
+    m_matrix->setFont();
 }
\ No newline at end of file
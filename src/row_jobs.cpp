@@ -0,0 +1,164 @@
+/**
+ * @file row_jobs.cpp
+ * @brief Implementation of the dual-core fork-join row-band renderer
+ *
+ * @doc On the ESP32 the worker blocks in ulTaskNotifyTake() between frames, so
+ * it costs nothing while no pattern is running. A frame is published through
+ * plain members; the task notification that wakes the worker (and the one that
+ * reports back) enters a critical section, which orders those writes.
+ */
+
+#include "row_jobs.h"
+
+RowJobs rowJobs;
+
+RowJobs::RowJobs() : m_fn(nullptr), m_ctx(nullptr), m_rows(0), m_bandRows(4),
+                     m_nextRow(0), m_workerRows(0), m_running(false), m_stop(false)
+#ifdef ARDUINO
+                     , m_worker(nullptr), m_caller(nullptr)
+#else
+                     , m_startSeq(0), m_doneSeq(0), m_seenSeq(0)
+#endif
+{
+}
+
+RowJobs::~RowJobs() {
+    end();
+}
+
+// WORKER LIFECYCLE
+// ============================================================================
+
+bool RowJobs::begin(uint8_t bandRows) {
+    m_bandRows = bandRows ? bandRows : 1;
+    if (m_running) return true;
+
+    m_stop = false;
+#ifdef ARDUINO
+    // The loop task runs at priority 1, the worker matches it so WiFi (core 0, priority 23) still preempts it
+    BaseType_t otherCore = xPortGetCoreID() ^ 1;
+    if (xTaskCreatePinnedToCore(workerTask, "row_jobs", 4096, this, 1, &m_worker, otherCore) != pdPASS) {
+        m_worker = nullptr;
+        Serial.println("RowJobs: Failed to create worker task, rendering on one core");
+        return false;
+    }
+    Serial.printf("RowJobs: Worker started on core %d\n", (int)otherCore);
+#else
+    m_seenSeq = m_startSeq.load();
+    m_worker = std::thread(&RowJobs::workerLoop, this);
+#endif
+    m_running = true;
+    return true;
+}
+
+void RowJobs::end() {
+    if (!m_running) return;
+
+    m_stop = true;
+    signalWorker();
+    waitForDone();
+#ifndef ARDUINO
+    m_worker.join();
+#endif
+    m_running = false;
+}
+
+#ifdef ARDUINO
+void RowJobs::workerTask(void* arg) {
+    static_cast<RowJobs*>(arg)->workerLoop();
+    vTaskDelete(nullptr);
+}
+#endif
+
+void RowJobs::workerLoop() {
+    while (true) {
+        waitForWork();
+        if (m_stop) {
+            signalDone();
+            return;
+        }
+        m_workerRows = drain();
+        signalDone();
+    }
+}
+
+// FRAME
+// ============================================================================
+
+/**
+ * @doc One fork-join. Runs serially when the worker is not running, or when the
+ * frame is a single band and waking the other core would only add latency.
+ */
+void RowJobs::run(int rows, BandFn fn, void* ctx) {
+    if (!m_running || rows <= m_bandRows) {
+        m_workerRows = 0;
+        fn(ctx, 0, rows);
+        return;
+    }
+
+    m_fn = fn;
+    m_ctx = ctx;
+    m_rows = rows;
+    m_nextRow.store(0, std::memory_order_relaxed);
+
+    signalWorker();
+    drain();
+    waitForDone();
+}
+
+int RowJobs::drain() {
+    int done = 0;
+    while (true) {
+        int y0 = m_nextRow.fetch_add(m_bandRows, std::memory_order_relaxed);
+        if (y0 >= m_rows) return done;
+        int y1 = y0 + m_bandRows < m_rows ? y0 + m_bandRows : m_rows;
+        m_fn(m_ctx, y0, y1);
+        done += y1 - y0;
+    }
+}
+
+// BARRIER
+// ============================================================================
+
+#ifdef ARDUINO
+
+void RowJobs::signalWorker() {
+    m_caller = xTaskGetCurrentTaskHandle();
+    xTaskNotifyGive(m_worker);
+}
+
+void RowJobs::waitForWork() {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+}
+
+void RowJobs::signalDone() {
+    xTaskNotifyGive(m_caller);
+}
+
+void RowJobs::waitForDone() {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+}
+
+#else
+
+// Host: sequence counters, spinning with yield() (frames are short and back to back in a benchmark)
+void RowJobs::signalWorker() {
+    m_startSeq.fetch_add(1, std::memory_order_release);
+}
+
+void RowJobs::waitForWork() {
+    while (m_startSeq.load(std::memory_order_acquire) == m_seenSeq)
+        std::this_thread::yield();
+    m_seenSeq++;
+}
+
+void RowJobs::signalDone() {
+    m_doneSeq.fetch_add(1, std::memory_order_release);
+}
+
+void RowJobs::waitForDone() {
+    while (m_doneSeq.load(std::memory_order_acquire) != m_startSeq.load(std::memory_order_relaxed))
+        std::this_thread::yield();
+}
+
+#endif
@@ -0,0 +1,332 @@
+/**
+ * @file telemetry.cpp
+ * @brief Implementation of the memory telemetry collector and its MQTT report
+ *
+ * @doc All heap_caps_* queries take the heap lock for a few microseconds and the
+ * stack high-water mark scans the unused part of each stack, so sampling runs from
+ * the main loop (never an ISR or timer callback) and only every TELEMETRY_SAMPLE_MS.
+ * refreshHeap() re-reads just the three heap_caps figures for the sysinfo pages.
+ * The performance counters are plain increments in the loop; they are turned into
+ * rates once per TELEMETRY_PERF_MS.
+ */
+
+#include "telemetry.h"
+#include "common.h"
+#include <esp_heap_caps.h>
+#include <ESP32-HUB75-MatrixPanel-I2S-DMA.h>
+
+// Idle time from the FreeRTOS run-time stats when the build keeps them
+#define TELEMETRY_RUN_TIME_STATS (configGENERATE_RUN_TIME_STATS && configUSE_TRACE_FACILITY)
+
+#if TELEMETRY_RUN_TIME_STATS
+static const UBaseType_t MAX_TASKS = 32;
+static TaskStatus_t s_taskStatus[MAX_TASKS];   // static: ~1.5 KB, too much for the loop task's stack
+#else
+#include <esp_freertos_hooks.h>
+#include <esp_timer.h>
+#include <esp_idf_version.h>
+#if ESP_IDF_VERSION_MAJOR >= 5
+#include <esp_cpu.h>
+#define IDLE_WAIT_FOR_INTR() esp_cpu_wait_for_intr()
+#else
+#include <hal/cpu_hal.h>
+#define IDLE_WAIT_FOR_INTR() cpu_hal_waiti()
+#endif
+
+// Microseconds each core's idle task spent waiting for an interrupt (wraps; only differences are used)
+static volatile uint32_t s_idleUs[2];
+static volatile int64_t s_waitStart[2];  // Start of the wait in progress, 0 when not waiting
+static volatile int64_t s_waitTick[2];   // First tick interrupt since s_waitStart, 0 if none yet
+
+// Tick hook: the first tick of a wait ends the idle time it can account
+static void IRAM_ATTR markWaitTick() {
+    BaseType_t core = xPortGetCoreID();
+    if (s_waitStart[core] && !s_waitTick[core]) s_waitTick[core] = esp_timer_get_time();
+}
+
+/**
+ * @doc Idle hook that does the idle task's wait itself and times it. The core is idle
+ * from the start of the wait until the interrupt that ends it. If that interrupt wakes
+ * a task, the idle task only gets back here once the task blocks, so the wait is cut
+ * at the first tick since it started. Tick-driven work is therefore counted exactly. A
+ * task woken by another interrupt that blocks again before the next tick still counts
+ * as idle.
+ */
+static bool accountIdleWait() {
+    BaseType_t core = xPortGetCoreID();
+    // Masked, so no task switch falls between the timestamp and the wait; waiti unmasks and sleeps at once
+    portDISABLE_INTERRUPTS();
+    s_waitTick[core] = 0;
+    int64_t start = esp_timer_get_time();
+    s_waitStart[core] = start;
+    IDLE_WAIT_FOR_INTR();
+    portENABLE_INTERRUPTS();
+
+    int64_t end = esp_timer_get_time();
+    s_waitStart[core] = 0;
+    if (s_waitTick[core] && s_waitTick[core] < end) end = s_waitTick[core];
+    s_idleUs[core] += (uint32_t)(end - start);
+    return false; // already waited: the idle task must not wait again
+}
+#endif
+
+Telemetry telemetry;
+
+// Tasks whose stack high-water mark is reported; the idle tasks are looked up per core
+static const char* const WATCHED_TASKS[Telemetry::TASK_COUNT] = {
+    "loopTask", "row_jobs", "tiT", "wifi", "IDLE0", "IDLE1"
+};
+
+Telemetry::Telemetry() : m_dmaDisplayBytes(0), m_head(0), m_count(0), m_lastSample(0), m_lastReport(0),
+                         m_display(nullptr), m_perfStart(0), m_loops(0), m_frameTotalUs(0), m_frameMaxUs(0),
+                         m_mode(0), m_mqttCount(0), m_mqttLatencyUs(0), m_lastVsync(0), m_lastIdleTotal(0),
+                         m_perfHead(0), m_perfCount(0), m_perfSeq(0)
+{
+    memset(&m_internal, 0, sizeof(m_internal));
+    memset(&m_dma, 0, sizeof(m_dma));
+    memset(&m_psram, 0, sizeof(m_psram));
+    memset(m_history, 0, sizeof(m_history));
+    memset(m_perf, 0, sizeof(m_perf));
+    memset(m_lastIdle, 0, sizeof(m_lastIdle));
+    for (uint8_t i = 0; i < TASK_COUNT; i++) {
+        m_tasks[i].name = WATCHED_TASKS[i];
+        m_tasks[i].freeBytes = 0;
+        m_tasks[i].found = false;
+    }
+}
+
+void Telemetry::begin(MatrixPanel_I2S_DMA* display) {
+    m_display = display;
+    m_dmaDisplayBytes = display ? display->getDmaMemoryBytes() : 0;
+    m_lastVsync = display ? display->getVsyncCount() : 0;
+
+#if !TELEMETRY_RUN_TIME_STATS
+    for (UBaseType_t core = 0; core < portNUM_PROCESSORS && core < 2; core++) {
+        esp_register_freertos_tick_hook_for_cpu(markWaitTick, core);
+        esp_register_freertos_idle_hook_for_cpu(accountIdleWait, core);
+    }
+#endif
+    readIdleTime(m_lastIdle, m_lastIdleTotal);
+    m_perfStart = micros();
+
+    sample();
+    m_lastReport = millis();
+    print();
+}
+
+void Telemetry::update() {
+    if (micros() - m_perfStart >= TELEMETRY_PERF_MS * 1000UL) {
+        samplePerf();
+    }
+
+    unsigned long now = millis();
+
+    if (now - m_lastSample >= TELEMETRY_SAMPLE_MS) {
+        sample();
+    }
+
+    if (TELEMETRY_REPORT_MS > 0 && now - m_lastReport >= TELEMETRY_REPORT_MS) {
+        m_lastReport = now;
+        publish();
+    }
+}
+
+void Telemetry::readCaps(uint32_t caps, HeapCapsStats& out) {
+    out.total = heap_caps_get_total_size(caps);
+    out.free = heap_caps_get_free_size(caps);
+    out.largest = heap_caps_get_largest_free_block(caps);
+    out.minFree = heap_caps_get_minimum_free_size(caps);
+}
+
+void Telemetry::refreshHeap() {
+    readCaps(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT, m_internal);
+    readCaps(MALLOC_CAP_DMA, m_dma);
+    readCaps(MALLOC_CAP_SPIRAM, m_psram);
+}
+
+void Telemetry::sample() {
+    m_lastSample = millis();
+
+    refreshHeap();
+
+    // Handles are looked up every time: row_jobs only exists while patterns render on two cores
+    for (uint8_t i = 0; i < TASK_COUNT; i++) {
+        TaskHandle_t handle;
+        if (i >= TASK_COUNT - 2) {
+            handle = xTaskGetIdleTaskHandleForCPU(i - (TASK_COUNT - 2));
+        } else {
+            handle = xTaskGetHandle(m_tasks[i].name);
+        }
+        m_tasks[i].found = handle != nullptr;
+        // ESP-IDF stacks are byte-addressed, so the high-water mark is already in bytes
+        m_tasks[i].freeBytes = handle ? uxTaskGetStackHighWaterMark(handle) : 0;
+    }
+
+    TelemetryPoint& p = m_history[m_head];
+    p.internalFreeKB = m_internal.free / 1024;
+    p.internalLargestKB = m_internal.largest / 1024;
+    p.psramFreeKB = m_psram.free / 1024;
+    p.internalFrag = m_internal.fragPercent();
+    p.dmaFrag = m_dma.fragPercent();
+
+    m_head = (m_head + 1) % TELEMETRY_HISTORY;
+    if (m_count < TELEMETRY_HISTORY) m_count++;
+}
+
+void Telemetry::recordFrame(uint32_t modeUs, uint8_t mode) {
+    m_loops++;
+    m_frameTotalUs += modeUs;
+    if (modeUs > m_frameMaxUs) m_frameMaxUs = modeUs;
+    m_mode = mode;
+}
+
+void Telemetry::recordMqttMessage(uint32_t latencyUs) {
+    m_mqttCount++;
+    m_mqttLatencyUs += latencyUs;
+}
+
+/**
+ * @doc Idle time of each core and the time base it is measured against, in the
+ * same (arbitrary) unit: run-time stats timer counts, or microseconds for the idle hook.
+ */
+bool Telemetry::readIdleTime(uint32_t idle[2], uint32_t& total) {
+#if TELEMETRY_RUN_TIME_STATS
+    UBaseType_t n = uxTaskGetSystemState(s_taskStatus, MAX_TASKS, &total);
+    if (n == 0) return false; // More tasks than MAX_TASKS
+    for (uint8_t core = 0; core < portNUM_PROCESSORS && core < 2; core++) {
+        TaskHandle_t handle = xTaskGetIdleTaskHandleForCPU(core);
+        idle[core] = 0;
+        for (UBaseType_t i = 0; i < n; i++) {
+            if (s_taskStatus[i].xHandle == handle) idle[core] = s_taskStatus[i].ulRunTimeCounter;
+        }
+    }
+#else
+    total = (uint32_t)esp_timer_get_time();
+    idle[0] = s_idleUs[0];
+    idle[1] = s_idleUs[1];
+#endif
+    return true;
+}
+
+void Telemetry::samplePerf() {
+    uint32_t now = micros();
+    uint32_t elapsedUs = now - m_perfStart;
+    m_perfStart = now;
+
+    PerfSample& s = m_perf[m_perfHead];
+    s.frameMaxUs = m_frameMaxUs;
+    s.frameAvgUs = m_loops ? m_frameTotalUs / m_loops : 0;
+    s.loopsPerSec = min<uint64_t>((uint64_t)m_loops * 1000000 / elapsedUs, 0xFFFF);
+    s.mqttMessages = min<uint32_t>(m_mqttCount, 0xFFFF);
+    s.mqttLatencyMs = m_mqttCount ? min<uint32_t>(m_mqttLatencyUs / m_mqttCount / 1000, 0xFFFF) : 0;
+    s.mode = m_mode;
+
+    // Frames actually scanned out where the DMA backend counts them (S3), else the driver's computed rate
+    uint32_t vsync = m_display ? m_display->getVsyncCount() : 0;
+    if (vsync != m_lastVsync) {
+        s.refreshHz = min<uint64_t>((uint64_t)(vsync - m_lastVsync) * 1000000 / elapsedUs, 0xFFFF);
+    } else {
+        s.refreshHz = m_display ? m_display->calculated_refresh_rate : 0;
+    }
+    m_lastVsync = vsync;
+
+    s.cpuLoad[0] = s.cpuLoad[1] = CPU_LOAD_UNKNOWN;
+    uint32_t idle[2] = { 0, 0 };
+    uint32_t total = 0;
+    if (readIdleTime(idle, total)) {
+        uint32_t span = total - m_lastIdleTotal;
+        for (uint8_t core = 0; span && core < portNUM_PROCESSORS && core < 2; core++) {
+            uint32_t idleSpan = idle[core] - m_lastIdle[core];
+            s.cpuLoad[core] = idleSpan >= span ? 0 : 100 - (uint8_t)((uint64_t)idleSpan * 100 / span);
+            m_lastIdle[core] = idle[core];
+        }
+        m_lastIdleTotal = total;
+    }
+
+    m_loops = m_frameTotalUs = m_frameMaxUs = 0;
+    m_mqttCount = m_mqttLatencyUs = 0;
+
+    m_perfHead = (m_perfHead + 1) % TELEMETRY_HISTORY;
+    if (m_perfCount < TELEMETRY_HISTORY) m_perfCount++;
+    m_perfSeq++;
+}
+
+/**
+ * @doc Compact JSON report. Heaps are [total, free, largest, minFree] in bytes:
+ * {"dev":"D101","up":3600,"int":[..],"dma":[..],"psram":[..],"frag":[int,dma],
+ *  "stack":{"loopTask":2960,...},"hub75":98304,"perf":[loops/s,frameMaxUs,cpu0,cpu1,refreshHz]}
+ */
+size_t Telemetry::formatReport(char* buf, size_t len) const {
+    StaticJsonDocument<1024> doc;
+    doc["dev"] = g_deviceId;
+    doc["up"] = millis() / 1000;
+
+    const HeapCapsStats* heaps[] = { &m_internal, &m_dma, &m_psram };
+    const char* const heapKeys[] = { "int", "dma", "psram" };
+    for (uint8_t h = 0; h < 3; h++) {
+        JsonArray a = doc.createNestedArray(heapKeys[h]);
+        a.add(heaps[h]->total);
+        a.add(heaps[h]->free);
+        a.add(heaps[h]->largest);
+        a.add(heaps[h]->minFree);
+    }
+
+    JsonArray frag = doc.createNestedArray("frag");
+    frag.add(m_internal.fragPercent());
+    frag.add(m_dma.fragPercent());
+
+    JsonObject stack = doc.createNestedObject("stack");
+    for (uint8_t i = 0; i < TASK_COUNT; i++) {
+        if (m_tasks[i].found) stack[m_tasks[i].name] = m_tasks[i].freeBytes;
+    }
+
+    doc["hub75"] = m_dmaDisplayBytes;
+
+    if (m_perfCount) {
+        const PerfSample& p = perf(m_perfCount - 1);
+        JsonArray a = doc.createNestedArray("perf");
+        a.add(p.loopsPerSec);
+        a.add(p.frameMaxUs);
+        a.add(p.cpuLoad[0]);
+        a.add(p.cpuLoad[1]);
+        a.add(p.refreshHz);
+    }
+
+    return serializeJson(doc, buf, len);
+}
+
+bool Telemetry::publish() {
+    if (!mqttClient.connected()) return false;
+
+    char topic[sizeof(g_mqttTopic) + sizeof(TELEMETRY_TOPIC_SUFFIX)];
+    snprintf(topic, sizeof(topic), "%s%s", g_mqttTopic, TELEMETRY_TOPIC_SUFFIX);
+
+    char payload[512];
+    size_t length = formatReport(payload, sizeof(payload));
+    if (length == 0) return false;
+
+    // Streamed: the report may be larger than PubSubClient's buffer (INPUT_MQTT_PAYLOAD_SIZE)
+    if (!mqttClient.beginPublish(topic, length, false)) return false;
+    mqttClient.write((const uint8_t*)payload, length);
+    return mqttClient.endPublish();
+}
+
+void Telemetry::print() const {
+    const HeapCapsStats* heaps[] = { &m_internal, &m_dma, &m_psram };
+    const char* const heapNames[] = { "internal", "DMA", "PSRAM" };
+
+    Serial.println("Telemetry (bytes):");
+    for (uint8_t h = 0; h < 3; h++) {
+        Serial.printf("  %-8s total=%lu free=%lu largest=%lu min=%lu frag=%u%%\n",
+                      heapNames[h],
+                      (unsigned long)heaps[h]->total,
+                      (unsigned long)heaps[h]->free,
+                      (unsigned long)heaps[h]->largest,
+                      (unsigned long)heaps[h]->minFree,
+                      heaps[h]->fragPercent());
+    }
+    for (uint8_t i = 0; i < TASK_COUNT; i++) {
+        if (m_tasks[i].found) Serial.printf("  stack %-8s free=%lu\n", m_tasks[i].name, (unsigned long)m_tasks[i].freeBytes);
+    }
+    Serial.printf("  HUB75 DMA memory=%lu\n", (unsigned long)m_dmaDisplayBytes);
+}
@@ -9,7 +9,7 @@ TextRenderer::TextRenderer()
       hScrollFontType(FONT_PRIMARY), hActiveScrollFont(nullptr), hScrollSpeedMillis(100),
       hScrollDirection(SCROLL_HORIZONTAL_LEFT), hLastScrollUpdateTime(0),
       hScrollTextPixelWidth(0), hScrollFontPixelHeight(0), hScrollFontAscent(0),
-      hScrollingActiveFlag(false), hScrollLoopFlag(true), hScrollWindowWidth(MATRIX_WIDTH),
+      hScrollingActiveFlag(false), hScrollLoopFlag(true), hScrollWindowWidth(0),
       // Vertical scroll init (ported from Utils)
       verticalScrollingActive(false), scrollTextBuffer(""),
       scrollTextX(0), scrollTextY(0), scrollTextMaxWidth(0), scrollTextColor(0), currentAppliedFontType(FONT_DEFAULT),
@@ -19,7 +19,7 @@ TextRenderer::TextRenderer()
       isWaitingBeforeScroll(false), isWaitingAfterCycleEnd(false) {
 }
 
-void TextRenderer::setup(MatrixPanel_I2S_DMA* matrixPtr, FontManager* fontManagerPtr) {
+void TextRenderer::setup(MatrixDisplay* matrixPtr, FontManager* fontManagerPtr) {
     matrix = matrixPtr;
     fontManager = fontManagerPtr;
     if (!matrix) {
@@ -175,7 +175,7 @@ void TextRenderer::startHorizontalScroll(const String& textVal, int16_t yPos, ui
     hScrollFontType = type;
     hScrollDirection = directionVal;
     hScrollLoopFlag = loop;
-    hScrollWindowWidth = scrollW > 0 ? scrollW : MATRIX_WIDTH;
+    hScrollWindowWidth = scrollW > 0 ? scrollW : matrix->width();
 
     calculateHorizontalScrollTextDimensions();
 
@@ -188,7 +188,7 @@ void TextRenderer::startHorizontalScroll(const String& textVal, int16_t yPos, ui
 
 
     if (hScrollTargetY == -1) {
-        hScrollTargetY = (MATRIX_HEIGHT / 2) + (hScrollFontPixelHeight / 2) - getFontDescent(hScrollFontType);
+        hScrollTargetY = (matrix->height() / 2) + (hScrollFontPixelHeight / 2) - getFontDescent(hScrollFontType);
     }
 
     switch (hScrollDirection) {
@@ -420,8 +420,8 @@ void TextRenderer::drawWrappedTextInternal(const char* text, int x, int y_top_of
             currentLineDrawingTopY < (scrollTextY + displayableScrollHeight)) {
             for (size_t i = 0; i < currentLineBuffer.length(); ++i) {
                 char charToPrint = currentLineBuffer[i];
-                int physicalPrintX = setPhysicalX(charPrintX);
-                int viewportPhysXStart = setPhysicalX(scrollTextX);
+                int physicalPrintX = charPrintX;
+                int viewportPhysXStart = scrollTextX;
                 int viewportPhysXEnd = viewportPhysXStart + scrollTextMaxWidth;
 
                 if (physicalPrintX >= viewportPhysXStart && physicalPrintX < viewportPhysXEnd) {
@@ -524,14 +524,14 @@ void TextRenderer::drawWrappedText(const char* text, int x, int y, int maxWidthV
         isWaitingAfterCycleEnd = false;
         lastScrollActionTime = millis();
 
-        matrix->fillRect(setPhysicalX(scrollTextX), scrollTextY, scrollTextMaxWidth, displayableScrollHeight, 0);
+        matrix->fillRect(scrollTextX, scrollTextY, scrollTextMaxWidth, displayableScrollHeight, 0);
         drawWrappedTextInternal(scrollTextBuffer.c_str(), scrollTextX, scrollTextY - currentScrollYOffset, scrollTextMaxWidth, scrollTextColor, scrollTextAlign, scrollCharSpacing, scrollLineSpacing, scrollIsCustomFont);
         // displayShow() is called by Utils after this
     } else {
         verticalScrollingActive = false;
-        displayableScrollHeight = (displayAreaHeightVal > 0) ? displayAreaHeightVal : MATRIX_HEIGHT;
+        displayableScrollHeight = (displayAreaHeightVal > 0) ? displayAreaHeightVal : matrix->height();
         // Clear the area where text will be drawn if not scrolling to avoid artifacts
-        matrix->fillRect(setPhysicalX(x), y, maxWidthVal, displayableScrollHeight, 0);
+        matrix->fillRect(x, y, maxWidthVal, displayableScrollHeight, 0);
         drawWrappedTextInternal(text, x, y, maxWidthVal, color, align, charSpacingVal, lineSpacingVal, isCustomFontVal);
         // displayShow() is called by Utils
     }
@@ -587,7 +587,7 @@ void TextRenderer::updateVerticalScroll() {
         }
     }
 
-    matrix->fillRect(setPhysicalX(scrollTextX), scrollTextY, scrollTextMaxWidth, displayableScrollHeight, 0);
+    matrix->fillRect(scrollTextX, scrollTextY, scrollTextMaxWidth, displayableScrollHeight, 0);
     // Font is already set above
     drawWrappedTextInternal(scrollTextBuffer.c_str(), scrollTextX, scrollTextY - currentScrollYOffset, scrollTextMaxWidth, scrollTextColor, scrollTextAlign, scrollCharSpacing, scrollLineSpacing, scrollIsCustomFont);
     
@@ -89,11 +89,7 @@ uint16_t Utils::rgb888to565(uint8_t r, uint8_t g, uint8_t b) {
  */
 Utils::Utils() : m_matrix(nullptr),
                 buzzerEnabled(DEFAULT_BUZZER_ENABLED),
-                lastButtonCheck(0),
-                lastButtonUpState(false),
-                lastButtonDownState(false),
-                buzzerVolume(DEFAULT_BUZZER_VOLUME),
-                pendingButtonAction(ButtonAction::NONE)
+                buzzerVolume(DEFAULT_BUZZER_VOLUME)
                 // FontManager and TextRenderer instances are default-constructed
 {
     // All member variables initialized in initialization list
@@ -106,9 +102,9 @@ Utils::Utils() : m_matrix(nullptr),
  * It initializes GPIO pins, I2C communication, and sets up the FontManager
  * and TextRenderer subsystems.
  * 
- * @param matrix_ptr Pointer to the initialized MatrixPanel_I2S_DMA instance
+ * @param matrix_ptr Pointer to the initialized MatrixDisplay instance
  */
-void Utils::setup(MatrixPanel_I2S_DMA* matrix_ptr) {
+void Utils::setup(MatrixDisplay* matrix_ptr) {
     m_matrix = matrix_ptr;
 
     Serial.println("\nUtils: Initializing GPIO pins...");
@@ -147,39 +143,6 @@ void Utils::setup(MatrixPanel_I2S_DMA* matrix_ptr) {
 // DISPLAY INITIALIZATION AND TESTING
 // ============================================================================
 
-/**
- * @doc Initialize the LED matrix display with optimal configuration
- * Sets up the HUB75 LED matrix with all required GPIO pins and configuration
- * parameters. This function configures the display for maximum performance
- * with the Matrix Portal S3 hardware.
- */
-void Utils::setupDisplay() { 
-    Serial.printf("Utils: Initializing %dx%d display...\n", MATRIX_WIDTH, MATRIX_HEIGHT);
-    
-    // Create HUB75 configuration with matrix dimensions
-    HUB75_I2S_CFG mxconfig(MATRIX_WIDTH, MATRIX_HEIGHT, MATRIX_CHAIN);
-    
-    // Configure all RGB data pins for upper and lower half of matrix
-    mxconfig.gpio.r1 = R1_PIN; mxconfig.gpio.g1 = G1_PIN; mxconfig.gpio.b1 = B1_PIN;
-    mxconfig.gpio.r2 = R2_PIN; mxconfig.gpio.g2 = G2_PIN; mxconfig.gpio.b2 = B2_PIN;
-    
-    // Configure address and control pins
-    mxconfig.gpio.a = A_PIN; mxconfig.gpio.b = B_PIN; mxconfig.gpio.c = C_PIN;
-    mxconfig.gpio.d = D_PIN; mxconfig.gpio.e = E_PIN;
-    mxconfig.gpio.clk = CLK_PIN; mxconfig.gpio.lat = LAT_PIN; mxconfig.gpio.oe = OE_PIN;
-    
-    // Set buffer and timing configuration
-    mxconfig.double_buff = !FORCE_SINGLE_BUFFER;  // Enable double buffering unless forced single
-    mxconfig.i2sspeed = HUB75_I2S_CFG::HZ_10M;    // Set I2S speed to 10MHz for optimal performance
-
-    // Initialize the matrix with configuration
-    if (m_matrix && m_matrix->begin()) {
-        Serial.printf("Utils: Display %dx%d initialized successfully\n", MATRIX_WIDTH, MATRIX_HEIGHT);
-    } else {
-        Serial.println("Utils: Display Initialization FAILED!");
-    }
-}
-
 /**
  * @doc Helper function for smooth color interpolation between two 8-bit components
  * Used internally by enhanced color test for smooth color transitions.
@@ -364,14 +327,14 @@ void Utils::showModePreview(DisplayMode mode, const char* modeName) {
     m_matrix->setTextColor(hexToRgb565(0xFFFFFF));
     String modeNumStr = String((int)mode);
     int modeNum_x = calculateTextCenterX(modeNumStr.c_str(), MATRIX_WIDTH);
-    m_matrix->setCursor(setPhysicalX(modeNum_x), 4);
+    m_matrix->setCursor(modeNum_x, 4);
     m_matrix->print(modeNumStr);
 
     // Display mode name in cyan
     m_matrix->setTextColor(hexToRgb565(0x00FFFF));
     const char* shortName = getShortModeName(mode);
     int shortName_x = calculateTextCenterX(shortName, MATRIX_WIDTH);
-    m_matrix->setCursor(setPhysicalX(shortName_x), 20);
+    m_matrix->setCursor(shortName_x, 20);
     m_matrix->print(shortName);
     
     // Show preview and hold for specified time
@@ -379,59 +342,9 @@ void Utils::showModePreview(DisplayMode mode, const char* modeName) {
     delay(MODE_PREVIEW_TIME);
 }
 
-// BUTTON EVENT SYSTEM
+// BUTTON STATE QUERIES
 // ============================================================================
 
-/**
- * @doc Retrieve and clear pending button action
- * Returns the current pending button action and clears it atomically.
- * This ensures each button press is processed exactly once.
- * 
- * @return Current pending button action, or ButtonAction::NONE if no action pending
- */
-ButtonAction Utils::getButtonAction() {
-    ButtonAction action = pendingButtonAction;
-    if (action != ButtonAction::NONE) {
-        pendingButtonAction = ButtonAction::NONE;  // Clear pending action
-    }
-    return action;
-}
-
-/**
- * @doc Process button state changes and generate button actions
- * Implements debounced button handling with edge detection to prevent
- * multiple triggers from a single button press. Should be called regularly
- * from the main loop to ensure responsive button handling.
- */
-void Utils::handleButtons() {
-    unsigned long currentTime = millis();
-    
-    // Only check buttons if no action is pending and debounce time has elapsed
-    if (pendingButtonAction == ButtonAction::NONE && 
-        (currentTime - lastButtonCheck >= 50)) {
-        
-        // Read current button states
-        bool currentUpState = isButtonUpPressed();
-        bool currentDownState = isButtonDownPressed();
-        
-        // Detect rising edge (button press) for UP button
-        if (currentUpState && !lastButtonUpState) {
-            pendingButtonAction = ButtonAction::NEXT_MODE;
-            if (buzzerEnabled) playSingleTone();  // Audio feedback
-        } 
-        // Detect rising edge (button press) for DOWN button
-        else if (currentDownState && !lastButtonDownState) {
-            pendingButtonAction = ButtonAction::PREV_MODE;
-            if (buzzerEnabled) playSingleTone();  // Audio feedback
-        }
-        
-        // Update button state history for next iteration
-        lastButtonUpState = currentUpState;
-        lastButtonDownState = currentDownState;
-        lastButtonCheck = currentTime;
-    }
-}
-
 /**
  * @doc Check if UP button is currently pressed
  * Reads the hardware state of the UP button pin. Button is active LOW
@@ -665,7 +578,9 @@ void Utils::setStatusLED(bool state) {
  * changes visible on the LED matrix.
  */
 void Utils::displayShow() {
-    if (m_matrix) m_matrix->flipDMABuffer();
+    if (!m_matrix) return;
+    m_matrix->flipDMABuffer();
+    m_matrix->waitForFlip(DISPLAY_FLIP_TIMEOUT_MS);
 }
 
 /**
@@ -860,7 +775,7 @@ int Utils::calculateTextTopY(const char* text, int desiredTopY, bool isCustomFon
  */
 void Utils::setCursorTopBased(int x, int y) {
     if (!m_matrix) return;
-    m_matrix->setCursor(setPhysicalX(x), y);
+    m_matrix->setCursor(x, y);
 }
 
 /**
@@ -878,7 +793,7 @@ void Utils::setCursorTopBased(int x, int y, bool isCustomFont) {
     
     if (!isCustomFont) {
         // System font: Y coordinate is top position
-        m_matrix->setCursor(setPhysicalX(x), y);
+        m_matrix->setCursor(x, y);
     } else {
         // Custom font: Calculate baseline from desired top position
         int16_t x1_calc, y1_calc_bounds;
@@ -887,7 +802,7 @@ void Utils::setCursorTopBased(int x, int y, bool isCustomFont) {
         
         // Calculate baseline Y from top position
         int baselineY = y - y1_calc_bounds;  // y1_calc_bounds is negative offset
-        m_matrix->setCursor(setPhysicalX(x), baselineY);
+        m_matrix->setCursor(x, baselineY);
     }
 }
 